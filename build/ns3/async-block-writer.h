@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_BLOCK_WRITER_H
+#define ASYNC_BLOCK_WRITER_H
+
+#include <ostream>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \brief Buffer records in large blocks, and write the blocks
+ * to a stream, optionally from a background thread.
+ *
+ * Writing each record of a trace file with several small stream writes
+ * makes tracing on many devices I/O bound.  An AsyncBlockWriter collects
+ * the serialized records in blocks of at least the block size, and
+ * writes each block with a single write.  In asynchronous mode the
+ * blocks are handed over to a writer thread shared by all the
+ * asynchronous block writers, so the simulation thread only copies
+ * the records into memory.
+ *
+ * The records are opaque bytes: the block writer is used by the pcap
+ * files (PcapFile, PcapNgFile) and by the NetAnim XML output.  The
+ * stream must not be used directly until Flush () returns.
+ * NS_FATAL_ERROR and failed assertions flush all the block writers
+ * before the streams, see FlushAll ().
+ * Without thread support the blocks are written synchronously.
+ */
+class AsyncBlockWriter
+{
+public:
+  /**
+   * \param [in] os The stream to write to.
+   * \param [in] blockSize The minimum size of the blocks written, in bytes.
+   * \param [in] async Whether to write from the writer thread.
+   */
+  AsyncBlockWriter (std::ostream *os, uint32_t blockSize, bool async);
+  /** Write all the records, as Flush (). */
+  ~AsyncBlockWriter ();
+
+  /**
+   * Reserve space for a record at the end of the current block.
+   *
+   * \param [in] size The size of the record, in bytes.
+   * \returns The address where the caller must write the record.
+   */
+  uint8_t * Append (uint32_t size);
+  /**
+   * Write the records appended so far, and wait until they are
+   * written to the stream.
+   */
+  void Flush (void);
+
+  /** \returns \c true if blocks are written from the writer thread. */
+  bool IsAsync (void) const;
+
+  /**
+   * Flush () all the block writers.
+   *
+   * This is registered with FatalImpl::RegisterFlushHook () while
+   * block writers exist, so that the records they buffer are written
+   * before the streams are flushed on fatal errors.
+   */
+  static void FlushAll (void);
+
+private:
+  /** Hand the current block over for writing. */
+  void Submit (void);
+
+  std::ostream *m_os;               //!< The stream
+  uint32_t m_blockSize;             //!< The minimum block size
+  bool m_async;                     //!< Write from the writer thread
+  std::vector<uint8_t> *m_block;    //!< The current block
+  uint32_t m_used;                  //!< The bytes used in the current block
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_BLOCK_WRITER_H */
@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief Write the "+ - d r" device traces in a compact binary format.
+ *
+ * The ascii traces print every packet with Packet::Print, which
+ * deserializes and formats all of its headers on the simulation hot
+ * path, and produces gigabytes of text.  A BinaryTraceWriter instead
+ * stores, for each traced event, its type, its time, its context and
+ * the packet metadata items: the name of each header and trailer, which
+ * is written once to a string table like the contexts, and the raw
+ * header and trailer bytes.  Payloads are stored by size only.
+ *
+ * The records are collected in blocks which are compressed with zlib
+ * when it is available.  BinaryTraceReader reads the records back, and
+ * formats them as the ascii trace sinks would have done, which is what
+ * the binary-trace-to-ascii program does.
+ *
+ * Binary trace streams are created by AsciiTraceHelper::CreateBinaryFileStream ().
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+public:
+  /**
+   * \param os The stream to write to, which must outlive the writer.
+   * \param compress Whether to compress the blocks, if zlib is available.
+   */
+  BinaryTraceWriter (std::ostream *os, bool compress);
+  /** Write the last block. */
+  ~BinaryTraceWriter ();
+
+  /**
+   * Write a trace record.
+   *
+   * \param op The trace operation: '+', '-', 'd' or 'r'.
+   * \param ns The time, in nanoseconds.
+   * \param context The trace context, or 0 if the trace has no context.
+   * \param p The packet.
+   */
+  void Write (char op, int64_t ns, std::string const *context, Ptr<const Packet> p);
+  /** Write the records buffered so far. */
+  void Flush (void);
+
+  /** \returns true if the blocks are compressed. */
+  bool IsCompressed (void) const;
+
+private:
+  /**
+   * Get the string table id of a string, writing its definition if needed.
+   * \param s The string.
+   * \returns The string id.
+   */
+  uint32_t Intern (std::string const &s);
+  /**
+   * Append a variable length integer to the current block.
+   * \param v The value.
+   */
+  void PutVarint (uint64_t v);
+  /** Write the current block. */
+  void WriteBlock (void);
+
+  std::ostream *m_os;                           //!< The output stream
+  bool m_compress;                              //!< Compress the blocks
+  std::vector<uint8_t> m_block;                 //!< The current block
+  std::vector<uint8_t> m_compressed;            //!< The compression buffer
+  std::map<std::string, uint32_t> m_strings;    //!< The string table
+  int64_t m_lastNs;                             //!< The time of the last record
+};
+
+/**
+ * \brief Read the records written by a BinaryTraceWriter.
+ */
+class BinaryTraceReader
+{
+public:
+  /** A packet metadata item. */
+  struct Item
+  {
+    /** The item type, as in PacketMetadata::Item. */
+    enum {
+      PAYLOAD,
+      HEADER,
+      TRAILER
+    } type;
+    bool isFragment;            //!< Part of a header, trailer or payload
+    std::string name;           //!< The header or trailer TypeId name
+    uint32_t trimmedFromStart;  //!< The fragment start
+    uint32_t size;              //!< The item or fragment size
+    std::vector<uint8_t> data;  //!< The serialized header or trailer
+  };
+  /** A trace record. */
+  struct Record
+  {
+    char op;                    //!< The trace operation
+    int64_t ns;                 //!< The time, in nanoseconds
+    bool hasContext;            //!< Whether the trace has a context
+    std::string context;        //!< The trace context
+    std::vector<Item> items;    //!< The packet items
+  };
+
+  BinaryTraceReader ();
+
+  /**
+   * Open a binary trace file.
+   * \param filename The file name.
+   * \returns false if the file can't be opened or is not a binary trace.
+   */
+  bool Open (std::string const &filename);
+  /**
+   * Read the next record.
+   * \param [out] record The record.
+   * \returns false at the end of the file, or if the file is corrupted.
+   */
+  bool Read (Record &record);
+
+  /**
+   * Write a record as the corresponding ascii trace sink would.
+   *
+   * The headers and trailers are printed by their Print method, so the
+   * program must link the modules which define them.
+   *
+   * \param os The output stream.
+   * \param record The record.
+   */
+  static void PrintAscii (std::ostream &os, Record const &record);
+
+private:
+  /** \returns false if no block could be read. */
+  bool ReadBlock (void);
+  /**
+   * Read a variable length integer from the current block.
+   * \param [out] v The value.
+   * \returns false if the block is truncated.
+   */
+  bool GetVarint (uint64_t &v);
+  /**
+   * Look up a string of the string table.
+   * \param [in] id The string id.
+   * \param [out] s The string.
+   * \returns false if the string is not defined.
+   */
+  bool GetString (uint64_t id, std::string &s) const;
+
+  std::ifstream m_file;                 //!< The file
+  bool m_compressed;                    //!< The blocks are compressed
+  std::vector<uint8_t> m_block;         //!< The current block
+  uint32_t m_offset;                    //!< The read offset in the block
+  std::vector<std::string> m_strings;   //!< The string table
+  int64_t m_lastNs;                     //!< The time of the last record
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -0,0 +1,157 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Nicola Baldo  <nbaldo@cttc.es>
+ */
+
+
+#ifndef EPC_TFT_CLASSIFIER_H
+#define EPC_TFT_CLASSIFIER_H
+
+
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/epc-tft.h"
+#include "ns3/sgi-hashmap.h"
+
+#include <map>
+#include <vector>
+
+
+namespace ns3 {
+
+class EpcTft;
+class Packet;
+
+/**
+ * \brief classifies IP packets accoding to Traffic Flow Templates (TFTs)
+ * 
+ * \note this implementation works with IPv4 only.
+ */
+class EpcTftClassifier : public SimpleRefCount<EpcTftClassifier>
+{
+public:
+  
+  EpcTftClassifier ();
+  
+  /** 
+   * add a TFT to the Classifier
+   * 
+   * \param tft the TFT to be added
+   * 
+   */
+  void Add (Ptr<EpcTft> tft, uint32_t id);
+
+  /** 
+   * delete an existing TFT from the classifier
+   * 
+   * \param id the identifier of the TFT to be deleted
+   */
+  void Delete (uint32_t id);
+  
+
+  /** 
+   * classify an IP packet
+   * 
+   * \param p the IP packet. It is assumed that the outmost header is an IPv4 header.
+   * 
+   * \return the identifier (>0) of the first TFT that matches with the IP packet; 0 if no TFT matched.
+   */
+  uint32_t Classify (Ptr<Packet> p, EpcTft::Direction direction);
+
+  /** 
+   * classify an IP packet from the bytes of its headers, without
+   * copying the packet nor deserializing the headers.
+   *
+   * The result is also stored in a flow table indexed by the
+   * addresses, ports and type of service of the packet, so that the
+   * next packets of the same flow are classified without evaluating
+   * the TFTs. The table is a small direct-mapped cache in front of a
+   * hash map holding all the flows; the hash map is flushed when it
+   * reaches MAX_FLOWS flows. Both are flushed whenever a TFT is added
+   * or deleted, hence the TFTs must not be modified after being added.
+   * 
+   * \param headers the first bytes of the IP packet, starting with the IPv4 header
+   * \param size the number of bytes in headers
+   * \param direction the direction of the packet
+   * 
+   * \return the identifier (>0) of the first TFT that matches with the IP packet; 0 if no TFT matched.
+   */
+  uint32_t Classify (const uint8_t *headers, uint32_t size, EpcTft::Direction direction);
+  
+protected:
+
+  /** 
+   * \param direction the direction of the packet
+   * \param remoteAddress the remote address of the packet
+   * \param localAddress the local address of the packet
+   * \param remotePort the remote port of the packet
+   * \param localPort the local port of the packet
+   * \param tos the type of service of the packet
+   * 
+   * \return the identifier (>0) of the first TFT that matches; 0 if no TFT matched.
+   */
+  uint32_t Match (EpcTft::Direction direction, Ipv4Address remoteAddress, Ipv4Address localAddress,
+                  uint16_t remotePort, uint16_t localPort, uint8_t tos);
+  
+  std::map <uint32_t, Ptr<EpcTft> > m_tftMap;
+
+  /// the key of a flow: direction, remote and local addresses and ports, type of service
+  struct FlowKey
+  {
+    uint8_t bytes[14];  ///< the fields, in the order above
+
+    /**
+     * \param o the other key
+     * \return true if the keys are equal
+     */
+    bool operator == (const FlowKey &o) const;
+  };
+
+  /// the hash of a FlowKey
+  struct FlowKeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    size_t operator() (const FlowKey &key) const;
+  };
+
+  /// an entry of the direct-mapped cache of the flow table
+  struct FlowEntry
+  {
+    FlowKey key;      ///< the key of the flow
+    bool valid;       ///< whether the entry holds a flow
+    uint32_t id;      ///< the identifier of the matching TFT, or 0
+  };
+
+  /// the maximum number of flows in m_flowMap, which is flushed beyond it
+  static const uint32_t MAX_FLOWS = 1024;
+
+  /// the direct-mapped cache, allocated on first use, indexed by the hash of the key
+  std::vector<FlowEntry> m_flowTable;
+  /// all the flows classified since the last flush, looked up on a cache miss
+  sgi::hash_map<FlowKey, uint32_t, FlowKeyHash> m_flowMap;
+  
+};
+
+
+
+} // namespace ns3
+  
+#endif /* TFT_CLASSIFIER_H */ 
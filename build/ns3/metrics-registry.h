@@ -0,0 +1,236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * \file
+ * \ingroup metrics
+ * ns3::Metric and ns3::MetricsRegistry declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \defgroup metrics Live metrics
+ *
+ * Counters and gauges updated in place in a memory area which can be
+ * mapped to a file, so that an external tool can follow a long
+ * simulation while it runs, without disturbing it.
+ *
+ * The metrics are registered by name in a table of MetricsRegistry::
+ * CAPACITY slots.  The table lives in anonymous memory until
+ * MetricsRegistry::Enable () maps it to a file; the \c NS_METRICS_FILE
+ * environment variable does the same when the first metric is
+ * registered.  The file holds, in the byte order of the host:
+ *
+ * - a 64 byte header: the 32 bit magic number 0x6e736d72, the 16 bit
+ *   major and minor version numbers 1 and 0, the 32 bit capacity and
+ *   number of metrics, the 64 bit wall clock time of the creation of
+ *   the table, in microseconds since the epoch, and the 32 bit process
+ *   id;
+ * - then CAPACITY slots of 64 bytes: the null terminated name of the
+ *   metric, on 40 bytes, its 32 bit type, 1 for a counter and 2 for a
+ *   gauge, 4 padding bytes, then the 64 bit integer value of a counter
+ *   and the double value of a gauge.
+ *
+ * The number of metrics is incremented after the slot of a new metric
+ * is written.  The values are written with plain aligned stores, so
+ * that a reader sees each value either before or after an update.
+ *
+ * A child forked by SimulatorFork::Fork () writes its metrics to a
+ * file of its own, see MetricsRegistry::ReopenInChild ().
+ *
+ * The simulator core registers:
+ * - \c simulator/events: the events executed by DefaultSimulatorImpl;
+ * - \c simulator/pending-events: the size of its scheduler, a gauge;
+ * - \c simulator/time-steps: its simulation time, in time steps.
+ *
+ * The rate of events and the ratio of the simulation time to the wall
+ * clock time come from two readings of the file.
+ */
+
+/**
+ * \ingroup metrics
+ * The slot of a metric in the table.
+ */
+struct MetricSlot
+{
+  char name[40];          //!< The null terminated name
+  uint32_t type;          //!< The Metric::Type
+  uint32_t reserved;      //!< Padding
+  volatile int64_t count; //!< The value of a counter
+  volatile double value;  //!< The value of a gauge
+};
+
+/**
+ * \ingroup metrics
+ * A handle on a counter or a gauge of the MetricsRegistry.
+ *
+ * The handles of the same name share the same slot, so that, e.g., the
+ * counters of all the instances of a class add up.  The updates are
+ * single stores to the slot, cheap enough for the hottest code; they
+ * are not atomic, so a metric should be updated from a single thread.
+ *
+ * The TraceValue () and TraceEvent () templates are trace sinks, so
+ * that a metric can follow a trace source:
+ * \code
+ *   static Metric drops ("wifi/phy-rx-drops");
+ *   Config::ConnectWithoutContext ("/NodeList/ * /DeviceList/ * /Phy/PhyRxDrop",
+ *     MakeCallback (&Metric::TraceEvent<Ptr<const Packet> >, &drops));
+ * \endcode
+ */
+class Metric
+{
+public:
+  /** The kinds of metric. */
+  enum Type
+  {
+    COUNTER = 1,  //!< An integer, usually increasing
+    GAUGE = 2     //!< A double, going up and down
+  };
+
+  /** Create a handle which is not registered, and updates a scratch slot. */
+  Metric ();
+  /**
+   * Register a metric, or get a handle on the metric of this name.
+   *
+   * \param [in] name The name of the metric, truncated to 39 characters.
+   * \param [in] type The type of a new metric.
+   */
+  Metric (const std::string &name, enum Type type = COUNTER);
+
+  /** Add one to a counter. */
+  void Increment (void)
+  {
+    m_slot->count = m_slot->count + 1;
+  }
+  /**
+   * Add to a counter.
+   * \param [in] n The value to add.
+   */
+  void Add (int64_t n)
+  {
+    m_slot->count = m_slot->count + n;
+  }
+  /**
+   * Set a counter.
+   * \param [in] count The new value.
+   */
+  void SetCount (int64_t count)
+  {
+    m_slot->count = count;
+  }
+  /**
+   * Set a gauge.
+   * \param [in] value The new value.
+   */
+  void Set (double value)
+  {
+    m_slot->value = value;
+  }
+  /** \returns The value of a counter. */
+  int64_t GetCount (void) const
+  {
+    return m_slot->count;
+  }
+  /** \returns The value of a gauge. */
+  double GetValue (void) const
+  {
+    return m_slot->value;
+  }
+  /** \returns The name of the metric. */
+  std::string GetName (void) const;
+
+  /**
+   * Trace sink setting a gauge to the new value of a TracedValue.
+   * \param [in] oldValue The previous value.
+   * \param [in] newValue The new value.
+   */
+  template <typename T>
+  void TraceValue (T oldValue, T newValue)
+  {
+    Set (newValue);
+  }
+  /**
+   * Trace sink counting the calls of a trace source with one argument.
+   * \param [in] arg The argument of the trace source.
+   */
+  template <typename T>
+  void TraceEvent (T arg)
+  {
+    Increment ();
+  }
+
+private:
+  MetricSlot *m_slot;     //!< The slot of the metric
+};
+
+/**
+ * \ingroup metrics
+ * The table of the metrics.
+ */
+class MetricsRegistry
+{
+public:
+  /** The number of slots of the table. */
+  static const uint32_t CAPACITY = 4096;
+
+  /**
+   * Map the table to a file, with the metrics registered so far.
+   *
+   * The file is created or truncated.  The handles on the metrics stay
+   * valid: the table is mapped at the same address.  Without \c mmap
+   * support this only logs a warning.
+   *
+   * \param [in] fileName The name of the file.
+   */
+  static void Enable (const std::string &fileName);
+  /**
+   * Move the table of a forked child to a file of its own.
+   *
+   * The child would otherwise update the slots of the file of its
+   * parent.  The name of the new file is the name of the file of the
+   * parent, followed by a dot and the process id of the child.  This
+   * does nothing if the table is not mapped to a file.
+   * SimulatorFork::Fork () calls this in each child.
+   */
+  static void ReopenInChild (void);
+  /** \returns The name of the file of the table, or an empty string. */
+  static std::string GetFileName (void);
+  /** \returns The number of metrics registered. */
+  static uint32_t GetN (void);
+
+private:
+  friend class Metric;
+  /**
+   * Get the slot of a metric, registering it if needed.
+   *
+   * \param [in] name The name of the metric.
+   * \param [in] type The type of a new metric.
+   * \returns The slot of the metric.
+   */
+  static MetricSlot * Lookup (const std::string &name, enum Metric::Type type);
+};
+
+} // namespace ns3
+
+#endif /* METRICS_REGISTRY_H */
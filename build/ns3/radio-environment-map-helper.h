@@ -0,0 +1,254 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2012 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Nicola Baldo <nbaldo@cttc.es>
+ */
+
+
+#ifndef RADIO_ENVIRONMENT_MAP_HELPER_H
+#define RADIO_ENVIRONMENT_MAP_HELPER_H
+
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/vector.h>
+#include <fstream>
+#include <vector>
+
+
+namespace ns3 {
+
+class RemSpectrumPhy;
+class Node;
+class NetDevice;
+class SpectrumChannel;
+//class BuildingsMobilityModel;
+class MobilityModel;
+class SpectrumValue;
+class SpectrumModel;
+class SpectrumSignalParameters;
+class AntennaModel;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
+
+/** 
+ * \ingroup lte
+ *
+ * Generates a 2D map of the SINR from the strongest transmitter in the
+ * downlink of an LTE FDD system. For instructions on usage, please refer to
+ * the User Documentation.
+ */
+class RadioEnvironmentMapHelper : public Object
+{
+public:  
+
+  RadioEnvironmentMapHelper ();
+  virtual ~RadioEnvironmentMapHelper ();
+  
+  // inherited from Object
+  virtual void DoDispose (void);
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** 
+   * \return the bandwidth (in num of RBs) over which SINR is calculated
+   */
+  uint8_t GetBandwidth () const;
+
+  /** 
+   *
+   * \param bw  the bandwidth (in num of RBs) over which SINR is calculated
+   */
+  void SetBandwidth (uint8_t bw);
+
+  /** 
+   * Deploy the RemSpectrumPhy objects that generate the map according to the specified settings.
+   * 
+   */
+  void Install ();
+
+private:
+
+  /**
+   * Scheduled by Install() to perform the actual generation of map.
+   *
+   * If control channel is used for SINR calculation (the default), the delay
+   * is 2.6 milliseconds from the start of simulation. Otherwise, if data
+   * channel is used, the delay is 500.1 milliseconds from the start of
+   * simulation.
+   *
+   * The method will divide the whole map into parts (each contains at most a
+   * certain number of SINR listening points), and then call RunOneIteration()
+   * on each part, one by one.
+   */
+  void DelayedInstall ();
+
+  /**
+   * Mobilize all the listeners to a specified area. Afterwards, schedule a
+   * call to PrintAndReset() in 0.5 milliseconds.
+   *
+   * \param xMin X coordinate of the first SINR listening point to deploy.
+   * \param xMax X coordinate of the last SINR listening point to deploy.
+   * \param yMin Y coordinate of the first SINR listening point to deploy.
+   * \param yMax Y coordinate of the last SINR listening point to deploy.
+   */
+  void RunOneIteration (double xMin, double xMax, double yMin, double yMax);
+
+  /// Go through every listener, write the computed SINR, and then reset it.
+  void PrintAndReset ();
+
+  /// Called when the map generation procedure has been completed.
+  void Finalize ();
+
+  /**
+   * Trace sink of the signals transmitted on the channel, recording the
+   * DL signals of the subframe used by the offline computation.
+   *
+   * \param params The parameters of the signal.
+   */
+  void CaptureSignal (Ptr<SpectrumSignalParameters> params);
+
+  /**
+   * Scheduled by DelayedInstall() when the `Offline` attribute is set, to
+   * compute the whole map from the signals recorded by CaptureSignal().
+   *
+   * The points are computed and written by blocks of
+   * `MaxPointsPerIteration` points, each block being shared among
+   * `NumThreads` threads.
+   */
+  void RunOffline ();
+
+  /// A DL signal recorded for the offline computation.
+  struct OfflineSignal
+  {
+    /// The PSD, converted to the spectrum model of the map.
+    Ptr<SpectrumValue> psd;
+    /// The TX antenna, or null.
+    Ptr<AntennaModel> txAntenna;
+    /// The mobility model of the transmitter, or null.
+    Ptr<MobilityModel> txMobility;
+  };
+
+  /// A thread computing a part of a block of points of the offline map.
+  struct OfflineWorker
+  {
+    /// The helper.
+    RadioEnvironmentMapHelper *helper;
+    /// The first point of the block to compute.
+    uint32_t first;
+    /// The point after the last one to compute.
+    uint32_t last;
+    /// The position of the listener, moved from point to point.
+    Ptr<MobilityModel> rxMobility;
+    /// The mobility models of the transmitters, one per signal.
+    std::vector<Ptr<MobilityModel> > txMobility;
+    /// Compute the points of the worker.
+    void Run (void);
+  };
+
+  /**
+   * Compute the SINR of a point of the offline map.
+   *
+   * \param worker The thread computing the point.
+   * \param point The position of the point.
+   * \return The SINR.
+   */
+  double CalcOfflineSinr (OfflineWorker &worker, const Vector &point);
+
+  /**
+   * Compute the SINR of the points of a block of the offline map, then
+   * write them to the output file.
+   *
+   * \param workers The threads computing the block.
+   */
+  void ComputeOfflineBlock (std::vector<OfflineWorker> &workers);
+
+  /// A complete Radio Environment Map is composed of many of this structure.
+  struct RemPoint 
+  {
+    /// Simplified listener which compute SINR over the DL channel.
+    Ptr<RemSpectrumPhy> phy;
+    /// Position of the listener in the environment.
+    Ptr<MobilityModel> bmm;
+  };
+
+  /// List of listeners in the environment.
+  std::list<RemPoint> m_rem;
+
+  double m_xMin;   ///< The `XMin` attribute.
+  double m_xMax;   ///< The `XMax` attribute.
+  uint16_t m_xRes; ///< The `XRes` attribute.
+  double m_xStep;  ///< Distance along X axis between adjacent listening points.
+
+  double m_yMin;   ///< The `YMin` attribute.
+  double m_yMax;   ///< The `YMax` attribute.
+  uint16_t m_yRes; ///< The `YRes` attribute.
+  double m_yStep;  ///< Distance along Y axis between adjacent listening points.
+
+  uint32_t m_maxPointsPerIteration;  ///< The `MaxPointsPerIteration` attribute.
+
+  uint16_t m_earfcn;     ///< The `Earfcn` attribute.
+  uint16_t m_bandwidth;  ///< The `Bandwidth` attribute.
+ 
+  double m_z;  ///< The `Z` attribute.
+
+  std::string m_channelPath;  ///< The `ChannelPath` attribute.
+  std::string m_outputFile;   ///< The `OutputFile` attribute.
+
+  bool m_stopWhenDone;   ///< The `StopWhenDone` attribute.
+  
+  /// The channel object taken from the `ChannelPath` attribute.
+  Ptr<SpectrumChannel> m_channel;
+
+  double m_noisePower;  ///< The `NoisePower` attribute.
+
+  std::ofstream m_outFile;  ///< Stream the output to a file.
+
+  bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
+  int32_t m_rbId;         ///< The `RbId` attribute.
+
+  bool m_offline;         ///< The `Offline` attribute.
+  uint32_t m_numThreads;  ///< The `NumThreads` attribute.
+
+  /// The spectrum model of the map.
+  Ptr<const SpectrumModel> m_rxSpectrumModel;
+  /// The start of the recording of the signals of the offline map.
+  Time m_captureStart;
+  /// The DL signals recorded for the offline map.
+  std::vector<OfflineSignal> m_offlineSignals;
+  /// The widths of the bands of the spectrum model of the map, in Hz.
+  std::vector<double> m_bandWidths;
+  /// The propagation loss model of the channel, or null.
+  Ptr<PropagationLossModel> m_propagationLoss;
+  /// The spectrum propagation loss model of the channel, or null.
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+  /// The `MaxLossDb` attribute of the channel.
+  double m_maxLossDb;
+  /// The points of the offline map block being computed.
+  std::vector<Vector> m_offlinePoints;
+  /// The SINR of the points of the offline map block being computed.
+  std::vector<double> m_offlineSinr;
+
+}; // end of `class RadioEnvironmentMapHelper`
+
+
+} // end of `namespace ns3`
+
+#endif /* RADIO_ENVIRONMENT_MAP_HELPER_H */
@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WINDOW_COLLECTOR_H
+#define WINDOW_COLLECTOR_H
+
+#include <map>
+#include "ns3/data-collection-object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup stats
+ *
+ * A collector which reduces the values of a probe to one record of
+ * statistics per time window.
+ *
+ * The simulation time is cut in windows of Interval, starting at time
+ * 0.  The values received during a window are counted, summed, and
+ * recorded in a log-linear histogram, in the spirit of HDR histograms:
+ * the values are grouped in 128 buckets per power of two, so that the
+ * percentiles are within 0.4% of the exact ones, whatever the range of
+ * the values.  At the end of each window which received values, the
+ * collector fires its Output trace source with the end time of the
+ * window, in seconds, the number of values, their sum, minimum,
+ * maximum, mean and the Percentile percentile.  The windows without
+ * values produce no record.
+ *
+ * The trace sinks of this class are those of TimeSeriesAdaptor, so
+ * that the collector can be connected to the Output trace source of
+ * the typed probes, or to OutputBytes for the packet probes.  Output
+ * can be connected to FileAggregator::Write7d (), and the Count, Sum,
+ * Min, Max, Mean and Percentile trace sources, which output the end
+ * time of the window and one of the statistics, to the Write2d ()
+ * sinks of the other aggregators.
+ */
+class WindowCollector : public DataCollectionObject
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  WindowCollector ();
+  virtual ~WindowCollector ();
+
+  /**
+   * \brief Trace sink for receiving data from double valued trace
+   * sources.
+   * \param oldData the original value.
+   * \param newData the new value.
+   */
+  void TraceSinkDouble (double oldData, double newData);
+
+  /**
+   * \brief Trace sink for receiving data from bool valued trace
+   * sources.
+   * \param oldData the original value.
+   * \param newData the new value.
+   */
+  void TraceSinkBoolean (bool oldData, bool newData);
+
+  /**
+   * \brief Trace sink for receiving data from uint8_t valued trace
+   * sources.
+   * \param oldData the original value.
+   * \param newData the new value.
+   */
+  void TraceSinkUinteger8 (uint8_t oldData, uint8_t newData);
+
+  /**
+   * \brief Trace sink for receiving data from uint16_t valued trace
+   * sources.
+   * \param oldData the original value.
+   * \param newData the new value.
+   */
+  void TraceSinkUinteger16 (uint16_t oldData, uint16_t newData);
+
+  /**
+   * \brief Trace sink for receiving data from uint32_t valued trace
+   * sources.
+   * \param oldData the original value.
+   * \param newData the new value.
+   */
+  void TraceSinkUinteger32 (uint32_t oldData, uint32_t newData);
+
+  /**
+   * \brief Adds a value to the current window.
+   * \param value the value.
+   */
+  void Add (double value);
+
+  /**
+   * \brief Outputs the record of the current window now, before its
+   * end, e.g. at the end of the simulation.
+   */
+  void Flush (void);
+
+  /**
+   * TracedCallback signature for the Output trace.
+   *
+   * \param [in] time The end of the window, in seconds.
+   * \param [in] count The number of values.
+   * \param [in] sum The sum of the values.
+   * \param [in] min The minimum value.
+   * \param [in] max The maximum value.
+   * \param [in] mean The mean of the values.
+   * \param [in] percentile The Percentile percentile of the values.
+   */
+  typedef void (* OutputTracedCallback)
+    (const double time, const double count, const double sum, const double min,
+     const double max, const double mean, const double percentile);
+
+  /**
+   * TracedCallback signature for the traces of a single statistic.
+   *
+   * \param [in] time The end of the window, in seconds.
+   * \param [in] value The statistic.
+   */
+  typedef void (* StatisticTracedCallback) (const double time, const double value);
+
+private:
+  virtual void DoDispose (void);
+
+  /// Fires the traces of the current window and resets the statistics.
+  void EndWindow (void);
+
+  /**
+   * \param fraction the fraction of the values below the percentile.
+   * \return the percentile of the values of the window.
+   */
+  double GetPercentile (double fraction) const;
+
+  /**
+   * \param value a value.
+   * \return the histogram bucket of the value.
+   */
+  static int32_t GetBucket (double value);
+
+  /**
+   * \param bucket a histogram bucket.
+   * \return the middle of the values of the bucket.
+   */
+  static double GetBucketValue (int32_t bucket);
+
+  Time m_interval;                        //!< The window duration
+  double m_percentile;                    //!< The percentile to output
+  EventId m_endWindow;                    //!< The end of the current window
+  uint32_t m_count;                       //!< The number of values of the window
+  double m_sum;                           //!< The sum of the values of the window
+  double m_min;                           //!< The minimum value of the window
+  double m_max;                           //!< The maximum value of the window
+  std::map<int32_t, uint32_t> m_histogram; //!< The value counts by bucket
+
+  /// The records of the windows
+  TracedCallback<double, double, double, double, double, double, double> m_output;
+  TracedCallback<double, double> m_countTrace;      //!< The value counts
+  TracedCallback<double, double> m_sumTrace;        //!< The sums
+  TracedCallback<double, double> m_minTrace;        //!< The minimums
+  TracedCallback<double, double> m_maxTrace;        //!< The maximums
+  TracedCallback<double, double> m_meanTrace;       //!< The means
+  TracedCallback<double, double> m_percentileTrace; //!< The percentiles
+};
+
+} // namespace ns3
+
+#endif // WINDOW_COLLECTOR_H
@@ -22,13 +22,16 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 #include "pointer.h"
+#include "string.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <fstream>
 
 
 /**
@@ -53,11 +56,21 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("ProfileFile",
+                   "If not empty, account the wall clock time of each event "
+                   "and write the profile to this file at Destroy, "
+                   "and flamegraph folded stacks to this file name plus \".folded\".",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profileFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl ()
+  : m_eventsMetric ("simulator/events"),
+    m_pendingMetric ("simulator/pending-events", Metric::GAUGE),
+    m_timeMetric ("simulator/time-steps")
 {
   NS_LOG_FUNCTION (this);
   m_stop = false;
@@ -73,11 +86,13 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_unscheduledEvents = 0;
   m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
+  m_profiler = 0;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_profiler;
 }
 
 void
@@ -106,6 +121,38 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  WriteProfile ();
+}
+
+void
+DefaultSimulatorImpl::WriteProfile (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_profiler == 0)
+    {
+      return;
+    }
+  std::ofstream report (m_profileFile.c_str ());
+  if (report.good ())
+    {
+      m_profiler->WriteReport (report);
+    }
+  else
+    {
+      NS_LOG_WARN ("Cannot open profile file " << m_profileFile);
+    }
+  std::string folded = m_profileFile + ".folded";
+  std::ofstream stacks (folded.c_str ());
+  if (stacks.good ())
+    {
+      m_profiler->WriteFolded (stacks);
+    }
+  else
+    {
+      NS_LOG_WARN ("Cannot open profile file " << folded);
+    }
+  delete m_profiler;
+  m_profiler = 0;
 }
 
 void
@@ -144,7 +191,19 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  m_eventsMetric.Increment ();
+  m_pendingMetric.Set (m_unscheduledEvents);
+  m_timeMetric.SetCount (m_currentTs);
+  if (m_profiler == 0)
+    {
+      next.impl->Invoke ();
+    }
+  else
+    {
+      m_profiler->Start ();
+      next.impl->Invoke ();
+      m_profiler->Stop (m_currentContext, next.impl);
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -192,6 +251,10 @@ DefaultSimulatorImpl::Run (void)
   NS_LOG_FUNCTION (this);
   // Set the current threadId as the main threadId
   m_main = SystemThread::Self();
+  if (!m_profileFile.empty () && m_profiler == 0)
+    {
+      m_profiler = new EventProfiler ();
+    }
   ProcessEventsWithContext ();
   m_stop = false;
 
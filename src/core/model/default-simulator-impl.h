@@ -26,10 +26,12 @@
 #include "event-impl.h"
 #include "system-thread.h"
 #include "ns3/system-mutex.h"
+#include "metrics-registry.h"
 
 #include "ptr.h"
 
 #include <list>
+#include <string>
 
 /**
  * \file
@@ -39,10 +41,19 @@
 
 namespace ns3 {
 
+class EventProfiler;
+
 /**
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * Setting the \c ProfileFile attribute enables an EventProfiler,
+ * which accounts the wall clock time spent in each event by callback
+ * target and by context.  At Destroy () the sorted report is written to
+ * that file, and the flamegraph folded stacks to the same file name
+ * with a ".folded" suffix.  The heap allocations of the events are also
+ * counted when ns-3 is configured with \c --enable-heap-profiling.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -75,6 +86,8 @@ private:
   virtual void DoDispose (void);
   void ProcessOneEvent (void);
   void ProcessEventsWithContext (void);
+  /** Write the profiler results, if enabled, and delete the profiler. */
+  void WriteProfile (void);
  
   struct EventWithContext {
     uint32_t context;
@@ -100,6 +113,18 @@ private:
   int m_unscheduledEvents;
 
   SystemThread::ThreadId m_main;
+
+  /** Name of the profile report file, empty if profiling is disabled. */
+  std::string m_profileFile;
+  /** The event profiler, or 0 if profiling is disabled. */
+  EventProfiler *m_profiler;
+
+  /** The number of events executed, the simulator/events metric. */
+  Metric m_eventsMetric;
+  /** The size of the scheduler, the simulator/pending-events metric. */
+  Metric m_pendingMetric;
+  /** The simulation time, the simulator/time-steps metric. */
+  Metric m_timeMetric;
 };
 
 } // namespace ns3
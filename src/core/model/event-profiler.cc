@@ -0,0 +1,444 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "log.h"
+#include "ns3/core-config.h"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <typeinfo>
+#include <vector>
+
+#if (__GNUC__ >= 3)
+#include <cxxabi.h>
+#endif
+#include <cstdlib>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+#ifdef NS3_HEAP_PROFILING
+
+/*
+ * Replacements of the global allocation functions which count the
+ * allocations, enabled by --enable-heap-profiling.  The array and
+ * nothrow forms go through the plain form.
+ */
+
+#if __cplusplus >= 201103L
+#define NS_HEAP_THROW_BAD_ALLOC
+#define NS_HEAP_THROW_NOTHING noexcept
+#else
+#define NS_HEAP_THROW_BAD_ALLOC throw (std::bad_alloc)
+#define NS_HEAP_THROW_NOTHING throw ()
+#endif
+
+namespace {
+
+/** Number of calls to the global operator new. */
+volatile uint64_t g_heapAllocations = 0;
+
+} // unnamed namespace
+
+void *
+operator new (std::size_t size) NS_HEAP_THROW_BAD_ALLOC
+{
+#if defined (__GNUC__)
+  __sync_fetch_and_add (&g_heapAllocations, 1);
+#else
+  g_heapAllocations++;
+#endif
+  if (size == 0)
+    {
+      size = 1;
+    }
+  void *p;
+  while ((p = std::malloc (size)) == 0)
+    {
+      std::new_handler handler = std::set_new_handler (0);
+      std::set_new_handler (handler);
+      if (handler == 0)
+        {
+          throw std::bad_alloc ();
+        }
+      handler ();
+    }
+  return p;
+}
+
+void *
+operator new (std::size_t size, const std::nothrow_t &) NS_HEAP_THROW_NOTHING
+{
+  try
+    {
+      return operator new (size);
+    }
+  catch (...)
+    {
+      return 0;
+    }
+}
+
+void *
+operator new[] (std::size_t size) NS_HEAP_THROW_BAD_ALLOC
+{
+  return operator new (size);
+}
+
+void *
+operator new[] (std::size_t size, const std::nothrow_t &nothrow) NS_HEAP_THROW_NOTHING
+{
+  return operator new (size, nothrow);
+}
+
+void
+operator delete (void *p) NS_HEAP_THROW_NOTHING
+{
+  std::free (p);
+}
+
+void
+operator delete (void *p, const std::nothrow_t &) NS_HEAP_THROW_NOTHING
+{
+  std::free (p);
+}
+
+void
+operator delete[] (void *p) NS_HEAP_THROW_NOTHING
+{
+  std::free (p);
+}
+
+void
+operator delete[] (void *p, const std::nothrow_t &) NS_HEAP_THROW_NOTHING
+{
+  std::free (p);
+}
+
+#endif /* NS3_HEAP_PROFILING */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace {
+
+/**
+ * Demangle a type name.
+ * \param [in] mangled The mangled name.
+ * \returns The demangled name, or \p mangled if it can't be demangled.
+ */
+std::string
+Demangle (const char *mangled)
+{
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, 0, 0, &status);
+  if (status == 0)
+    {
+      std::string ret = demangled;
+      std::free (demangled);
+      return ret;
+    }
+#endif
+  return mangled;
+}
+
+/**
+ * Get a readable name for the callback target of an event type.
+ *
+ * The events built by MakeEvent () are local classes of the MakeEvent ()
+ * templates: the target is the type of the first function argument,
+ * which is the function or member function pointer.
+ *
+ * \param [in] mangled The mangled name of the event type.
+ * \returns The callback target type, or the demangled type name.
+ */
+std::string
+TargetName (const char *mangled)
+{
+  std::string name = Demangle (mangled);
+  std::string::size_type start = name.find ("MakeEvent");
+  if (start == std::string::npos || start + 9 >= name.size ()
+      || (name[start + 9] != '<' && name[start + 9] != '('))
+    {
+      return name;
+    }
+  // Skip the template arguments, then take the first function argument
+  bool inArguments = false;
+  int depth = 0;
+  for (std::string::size_type i = start + 9; i < name.size (); ++i)
+    {
+      char c = name[i];
+      if (c == '<' || c == '(' || c == '[')
+        {
+          if (depth == 0 && c == '(')
+            {
+              inArguments = true;
+              start = i + 1;
+            }
+          depth++;
+        }
+      else if (c == '>' || c == ')' || c == ']')
+        {
+          depth--;
+          if (inArguments && depth == 0)
+            {
+              return name.substr (start, i - start);
+            }
+        }
+      else if (inArguments && depth == 1 && c == ',')
+        {
+          return name.substr (start, i - start);
+        }
+    }
+  return name;
+}
+
+/**
+ * Order named counters by decreasing time.
+ * \param [in] a The first counters.
+ * \param [in] b The second counters.
+ * \returns \c true if \p a should be reported before \p b.
+ */
+template <typename T>
+bool
+ByDecreasingTime (const T &a, const T &b)
+{
+  return a.second.ns > b.second.ns;
+}
+
+} // unnamed namespace
+
+EventProfiler::Stats::Stats ()
+  : count (0),
+    ns (0),
+    allocs (0)
+{
+}
+
+EventProfiler::EventProfiler ()
+  : m_last (m_stats.end ()),
+    m_start (0),
+    m_startAllocs (0),
+    m_count (0),
+    m_ns (0),
+    m_allocs (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_created = GetWallClockNs ();
+}
+
+uint64_t
+EventProfiler::GetWallClockNs (void)
+{
+#if defined (HAVE_RT) && defined (CLOCK_MONOTONIC)
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+  return (uint64_t)((std::clock () * 1e9) / CLOCKS_PER_SEC);
+#endif
+}
+
+uint64_t
+EventProfiler::GetHeapAllocations (void)
+{
+#ifdef NS3_HEAP_PROFILING
+  return g_heapAllocations;
+#else
+  return 0;
+#endif
+}
+
+bool
+EventProfiler::IsCountingAllocations (void)
+{
+#ifdef NS3_HEAP_PROFILING
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+EventProfiler::Start (void)
+{
+  m_startAllocs = GetHeapAllocations ();
+  m_start = GetWallClockNs ();
+}
+
+void
+EventProfiler::Stop (uint32_t context, const EventImpl *event)
+{
+  uint64_t delta = GetWallClockNs () - m_start;
+  uint64_t allocs = GetHeapAllocations () - m_startAllocs;
+  Key key (context, typeid (*event).name ());
+  // Consecutive events are often of the same kind
+  if (m_last == m_stats.end () || m_last->first != key)
+    {
+      m_last = m_stats.insert (std::make_pair (key, Stats ())).first;
+    }
+  m_last->second.count++;
+  m_last->second.ns += delta;
+  m_last->second.allocs += allocs;
+  m_count++;
+  m_ns += delta;
+  m_allocs += allocs;
+}
+
+uint64_t
+EventProfiler::GetEventCount (void) const
+{
+  return m_count;
+}
+
+uint64_t
+EventProfiler::GetEventCount (uint32_t context) const
+{
+  uint64_t count = 0;
+  for (StatsMap::const_iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      if (i->first.first == context)
+        {
+          count += i->second.count;
+        }
+    }
+  return count;
+}
+
+std::string
+EventProfiler::GetTargetName (const EventImpl *event)
+{
+  return TargetName (typeid (*event).name ());
+}
+
+std::string
+EventProfiler::GetContextName (uint32_t context)
+{
+  if (context == 0xffffffff)
+    {
+      return "no context";
+    }
+  std::ostringstream oss;
+  oss << "node " << context;
+  return oss.str ();
+}
+
+void
+EventProfiler::WriteSection (std::ostream &os, const std::string &title,
+                             const NamedStats &stats) const
+{
+  typedef std::pair<std::string, Stats> Entry;
+  std::vector<Entry> sorted (stats.begin (), stats.end ());
+  std::stable_sort (sorted.begin (), sorted.end (), ByDecreasingTime<Entry>);
+
+  os << std::endl << "# " << title << std::endl
+     << std::setw (12) << "count"
+     << std::setw (14) << "total (s)"
+     << std::setw (12) << "mean (us)";
+  if (IsCountingAllocations ())
+    {
+      os << std::setw (12) << "allocs"
+         << std::setw (12) << "allocs/ev";
+    }
+  os << std::setw (9) << "share"
+     << "  " << title << std::endl;
+  for (std::vector<Entry>::const_iterator i = sorted.begin ();
+       i != sorted.end (); ++i)
+    {
+      const Stats &s = i->second;
+      os << std::setw (12) << s.count
+         << std::setw (14) << std::fixed << std::setprecision (6) << s.ns / 1e9
+         << std::setw (12) << std::setprecision (3) << s.ns / 1e3 / s.count;
+      if (IsCountingAllocations ())
+        {
+          os << std::setw (12) << s.allocs
+             << std::setw (12) << std::setprecision (2) << (double)s.allocs / s.count;
+        }
+      os << std::setw (8) << std::setprecision (2)
+         << (m_ns > 0 ? 100.0 * s.ns / m_ns : 0.0) << "%"
+         << "  " << i->first << std::endl;
+    }
+}
+
+void
+EventProfiler::WriteReport (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  NamedStats byTarget;
+  NamedStats byContext;
+  std::map<const char *, std::string> names;
+  for (StatsMap::const_iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      const char *type = i->first.second;
+      std::map<const char *, std::string>::iterator name = names.find (type);
+      if (name == names.end ())
+        {
+          name = names.insert (std::make_pair (type, TargetName (type))).first;
+        }
+      Stats &target = byTarget[name->second];
+      target.count += i->second.count;
+      target.ns += i->second.ns;
+      target.allocs += i->second.allocs;
+      Stats &context = byContext[GetContextName (i->first.first)];
+      context.count += i->second.count;
+      context.ns += i->second.ns;
+      context.allocs += i->second.allocs;
+    }
+
+  std::ios_base::fmtflags flags = os.flags ();
+  double wall = (GetWallClockNs () - m_created) / 1e9;
+  os << "# Event profile: " << m_count << " events, "
+     << std::fixed << std::setprecision (6) << m_ns / 1e9 << " s in events, "
+     << wall << " s wall clock";
+  if (IsCountingAllocations ())
+    {
+      os << ", " << m_allocs << " heap allocations in events";
+    }
+  os << std::endl;
+  WriteSection (os, "callback target", byTarget);
+  WriteSection (os, "context", byContext);
+  os.flags (flags);
+}
+
+void
+EventProfiler::WriteFolded (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this);
+  NamedStats stacks;
+  for (StatsMap::const_iterator i = m_stats.begin (); i != m_stats.end (); ++i)
+    {
+      std::string stack = GetContextName (i->first.first) + ";" + TargetName (i->first.second);
+      Stats &s = stacks[stack];
+      s.count += i->second.count;
+      s.ns += i->second.ns;
+    }
+  for (NamedStats::const_iterator i = stacks.begin (); i != stacks.end (); ++i)
+    {
+      os << i->first << " " << (i->second.ns + 500) / 1000 << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Wall clock accounting of the events executed by a simulator.
+ *
+ * The simulator calls Start() before invoking each event and Stop()
+ * after it returns.  Events are classified by their callback target
+ * type, which is the function or member function pointer type given to
+ * MakeEvent() (or the dynamic type of the event for other EventImpl
+ * subclasses), and by the context (node id) they run in.
+ *
+ * When ns-3 is configured with \c --enable-heap-profiling, the
+ * profiler also counts the heap allocations (calls to the global
+ * operator new) made by each event.  This replaces the global operator
+ * new of the programs linked with the core module, so it is a build
+ * time option, see IsCountingAllocations().  Allocations made by other
+ * threads while an event runs are accounted to that event.
+ *
+ * The results are written either as a report sorted by decreasing
+ * wall clock time, or as "folded stacks" (one line per context and
+ * target, with the time in microseconds) which can be rendered
+ * directly by flamegraph.pl.
+ *
+ * This is enabled in ns3::DefaultSimulatorImpl by the
+ * \c ProfileFile attribute.
+ */
+class EventProfiler
+{
+public:
+  EventProfiler ();
+
+  /** Note the start of an event. */
+  void Start (void);
+  /**
+   * Account the time since Start() to an event.
+   *
+   * \param [in] context The context the event ran in.
+   * \param [in] event The event, which must not have been released yet.
+   */
+  void Stop (uint32_t context, const EventImpl *event);
+
+  /** \returns The number of events accounted. */
+  uint64_t GetEventCount (void) const;
+  /**
+   * \param [in] context The context.
+   * \returns The number of events accounted in \p context.
+   */
+  uint64_t GetEventCount (uint32_t context) const;
+
+  /**
+   * Write the report, sorted by decreasing wall clock time,
+   * by callback target and by context.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void WriteReport (std::ostream &os) const;
+  /**
+   * Write the results in the folded stacks format used by flamegraph.pl.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void WriteFolded (std::ostream &os) const;
+
+  /**
+   * Get a readable name for the callback target type of an event.
+   *
+   * \param [in] event The event.
+   * \returns The function pointer type of a MakeEvent() event, or the
+   *          demangled dynamic type of \p event.
+   */
+  static std::string GetTargetName (const EventImpl *event);
+
+  /**
+   * \returns \c true if the heap allocations of the events are counted,
+   *          which is the case when ns-3 is configured with
+   *          \c --enable-heap-profiling.
+   */
+  static bool IsCountingAllocations (void);
+
+private:
+  /** Counters for one class of events. */
+  struct Stats
+  {
+    Stats ();
+    uint64_t count;   //!< Number of events
+    uint64_t ns;      //!< Cumulative wall clock time, in ns
+    uint64_t allocs;  //!< Number of heap allocations
+  };
+  /**
+   * Events are classified by context and by the mangled name of their type.
+   * Type names are compared by address, and merged by value when reporting.
+   */
+  typedef std::pair<uint32_t, const char *> Key;
+  /** Container for the counters. */
+  typedef std::map<Key, Stats> StatsMap;
+  /** Counters merged by name, for reporting. */
+  typedef std::map<std::string, Stats> NamedStats;
+
+  /** \returns The current wall clock time, in ns. */
+  static uint64_t GetWallClockNs (void);
+  /**
+   * \returns The number of heap allocations made so far by the program,
+   *          or 0 if they are not counted.
+   */
+  static uint64_t GetHeapAllocations (void);
+  /**
+   * Get the name used in the reports for a context.
+   * \param [in] context The context.
+   * \returns The context name.
+   */
+  static std::string GetContextName (uint32_t context);
+  /**
+   * Write one section of the report.
+   * \param [in,out] os The output stream.
+   * \param [in] title The section title.
+   * \param [in] stats The counters to write.
+   */
+  void WriteSection (std::ostream &os, const std::string &title,
+                     const NamedStats &stats) const;
+
+  StatsMap m_stats;                 //!< Counters per context and type
+  StatsMap::iterator m_last;        //!< Last counters updated
+  uint64_t m_start;                 //!< Start of the current event, in ns
+  uint64_t m_startAllocs;           //!< Heap allocations at the start of the current event
+  uint64_t m_count;                 //!< Total number of events
+  uint64_t m_ns;                    //!< Total event time, in ns
+  uint64_t m_allocs;                //!< Total event heap allocations
+  uint64_t m_created;               //!< Creation time, in ns
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -31,7 +31,8 @@
 /**
  * \file
  * \ingroup fatalimpl
- * \brief Implementation of RegisterStream(), UnregisterStream(), and FlushStreams(); see Implementation note!
+ * \brief Implementation of RegisterStream(), UnregisterStream(),
+ * RegisterFlushHook(), UnregisterFlushHook() and FlushStreams(); see Implementation note!
  *
  * \note Implementation.
  *
@@ -92,6 +93,23 @@ std::list<std::ostream*> *GetStreamList (void)
   return *pstreams;
 }
 
+/** A function called on abnormal exit. */
+typedef void (*FlushHook)(void);
+
+/**
+ * \ingroup fatalimpl
+ * \brief Static variable pointing to the list of hooks
+ * to be called on fatal errors.
+ *
+ * \returns The address of the static pointer.
+ */
+std::list<FlushHook> **PeekHookList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  static std::list<FlushHook> *hooks = 0;
+  return &hooks;
+}
+
 /**
  * \ingroup fatalimpl
  * \brief Destructor for the list of fatal streams.
@@ -115,6 +133,9 @@ struct destructor
     std::list<std::ostream*> **pstreams = PeekStreamList ();
     delete *pstreams;
     *pstreams = 0;
+    std::list<FlushHook> **phooks = PeekHookList ();
+    delete *phooks;
+    *phooks = 0;
   }
 };
 }  // anonymous namespace
@@ -143,6 +164,36 @@ UnregisterStream (std::ostream* stream)
     }
 }
 
+void
+RegisterFlushHook (void (*hook)(void))
+{
+  NS_LOG_FUNCTION (hook);
+  std::list<FlushHook> **pl = PeekHookList ();
+  if (*pl == 0)
+    {
+      *pl = new std::list<FlushHook> ();
+    }
+  (*pl)->remove (hook);
+  (*pl)->push_back (hook);
+}
+
+void
+UnregisterFlushHook (void (*hook)(void))
+{
+  NS_LOG_FUNCTION (hook);
+  std::list<FlushHook> **pl = PeekHookList ();
+  if (*pl == 0)
+    {
+      return;
+    }
+  (*pl)->remove (hook);
+  if ((*pl)->empty ())
+    {
+      delete *pl;
+      *pl = 0;
+    }
+}
+
 /**
  * \ingroup fatalimpl
  * Anonymous namespace for fatal streams signal hander.
@@ -172,6 +223,22 @@ void
 FlushStreams (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  /* Write the messages of the asynchronous log sink, if any, before
+   * the program terminates. */
+  LogFlushAsyncSink ();
+
+  /* Let the registered hooks hand their buffered data over to the
+   * streams.  A hook may unregister itself, so call them from a copy. */
+  std::list<FlushHook> **ph = PeekHookList ();
+  if (*ph != 0)
+    {
+      std::list<FlushHook> hooks = **ph;
+      for (std::list<FlushHook>::iterator i = hooks.begin (); i != hooks.end (); ++i)
+        {
+          (*i)();
+        }
+    }
+
   std::list<std::ostream*> **pl = PeekStreamList ();
   if (*pl == 0)
     {
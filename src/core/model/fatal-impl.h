@@ -26,7 +26,8 @@
 /**
  * \file
  * \ingroup fatalimpl
- * \brief Declaration of RegisterStream(), UnregisterStream(), and FlushStreams().
+ * \brief Declaration of RegisterStream(), UnregisterStream(),
+ * RegisterFlushHook(), UnregisterFlushHook() and FlushStreams().
  */
 
 /**
@@ -72,6 +73,31 @@ void RegisterStream (std::ostream* stream);
  */
 void UnregisterStream (std::ostream* stream);
 
+/**
+ * \ingroup fatalimpl
+ *
+ * \brief Register a function to be called on abnormal exit.
+ *
+ * The hooks are called by FlushStreams(), before the streams are
+ * flushed, so that objects buffering data in front of a stream
+ * (such as the block writers of the pcap files) can hand it over
+ * to the stream first.  Registering the same hook twice has no effect.
+ *
+ * \param hook The function to call on abnormal exit.
+ */
+void RegisterFlushHook (void (*hook)(void));
+
+/**
+ * \ingroup fatalimpl
+ *
+ * \brief Unregister a function registered by RegisterFlushHook().
+ *
+ * If the hook is not registered, nothing will happen.
+ *
+ * \param hook The function to unregister.
+ */
+void UnregisterFlushHook (void (*hook)(void));
+
 /**
  * \ingroup fatalimpl
  *
@@ -88,6 +114,10 @@ void UnregisterStream (std::ostream* stream);
  * skip the bad \c ostream* and continue to flush the next stream.
  * The function will then terminate raising \c SIGIOT (aka \c SIGABRT)
  *
+ * The messages of the asynchronous log sink are written first,
+ * see LogFlushAsyncSink(), then the hooks registered with
+ * RegisterFlushHook() are called.
+ *
  * DO NOT call this function until the program is ready to crash.
  */
 void FlushStreams (void);
@@ -240,7 +240,14 @@ public:
    *
    * \see Invert()
    */
-  void MulByInvert (const int64x64_t & o);
+  inline void MulByInvert (const int64x64_t & o)
+  {
+    bool negResult = _v < 0;
+    uint128_t a = negResult ? -_v : _v;
+    uint128_t result = UmulByInvert (a, o._v);
+
+    _v = negResult ? -result : result;
+  }
 
   /**
    * Compute the inverse of an integer value.
@@ -284,6 +291,78 @@ private:
    * \param [in] o The divisor.
    */
   void Div (const int64x64_t & o);
+  /**
+   * Inline fast path for Mul(), when one factor is a small integer.
+   *
+   * Time arithmetic mostly multiplies integer tick counts by
+   * integer conversion factors.  When one factor has no fractional
+   * part and fits in 32 bits, and the other is less than 2^31
+   * in magnitude, the Q64.64 product is just the native 128-bit
+   * product, which can neither overflow nor lose precision.
+   *
+   * \param [in] o The other factor.
+   * \return \c true if the product was computed,
+   *         \c false if Mul() must be used instead.
+   */
+  inline bool MulFast (const int64x64_t & o)
+  {
+    if (IsSmallInteger (o._v) && IsSmall (_v))
+      {
+        _v *= (o._v >> 64);
+        return true;
+      }
+    if (IsSmallInteger (_v) && IsSmall (o._v))
+      {
+        _v = (_v >> 64) * o._v;
+        return true;
+      }
+    return false;
+  }
+  /**
+   * Inline fast path for Div(), when the divisor is an integer.
+   *
+   * Dividing a Q64.64 value by an integer \c n is the native
+   * 128-bit division by \c n, truncated toward zero exactly as Udiv()
+   * truncates the magnitude.
+   *
+   * \param [in] o The divisor.
+   * \return \c true if the quotient was computed,
+   *         \c false if Div() must be used instead.
+   */
+  inline bool DivFast (const int64x64_t & o)
+  {
+    const int128_t n = o._v >> 64;
+    // Leave -1 to Div(), which handles the most negative value.
+    if ( ((o._v & HP_MASK_LO) == 0) && (n != 0) && (n != -1) )
+      {
+        _v /= n;
+        return true;
+      }
+    return false;
+  }
+  /**
+   * Test if a Q64.64 value is an integer which fits in 32 bits.
+   *
+   * \param [in] v The Q64.64 value.
+   * \return \c true if \pname{v} is an integer in [-2^31, 2^31).
+   */
+  static inline bool IsSmallInteger (const int128_t v)
+  {
+    const int128_t hi = v >> 64;
+    return ((v & HP_MASK_LO) == 0) && (hi == (int32_t)hi);
+  }
+  /**
+   * Test if a Q64.64 value is less than 2^31 in magnitude,
+   * so the product with a 32-bit integer fits in 127 bits.
+   *
+   * \param [in] v The Q64.64 value.
+   * \return \c true if \pname{v} is in [-2^31, 2^31).
+   */
+  static inline bool IsSmall (const int128_t v)
+  {
+    const int128_t top = v >> 95;
+    return (top == 0) || (top == -1);
+  }
   /**
    * Unsigned multiplication of Q64.64 values.
    *
@@ -326,7 +405,20 @@ private:
    *
    * \see Invert()
    */
-  static uint128_t UmulByInvert (const uint128_t a, const uint128_t b);
+  static inline uint128_t UmulByInvert (const uint128_t a, const uint128_t b)
+  {
+    uint128_t result, ah, bh, al, bl;
+    uint128_t hi, mid;
+    ah = a >> 64;
+    bh = b >> 64;
+    al = a & HP_MASK_LO;
+    bl = b & HP_MASK_LO;
+    hi = ah * bh;
+    mid = ah * bl + al * bh;
+    mid >>= 64;
+    result = hi + mid;
+    return result;
+  }
 
   /**
    * Construct from an integral type.
@@ -390,7 +482,10 @@ inline int64x64_t & operator -= (int64x64_t & lhs, const int64x64_t & rhs)
  */
 inline int64x64_t & operator *= (int64x64_t & lhs, const int64x64_t & rhs)
 {
-  lhs.Mul (rhs);
+  if (!lhs.MulFast (rhs))
+    {
+      lhs.Mul (rhs);
+    }
   return lhs;
 }
 /**
@@ -399,7 +494,10 @@ inline int64x64_t & operator *= (int64x64_t & lhs, const int64x64_t & rhs)
  */
 inline int64x64_t & operator /= (int64x64_t & lhs, const int64x64_t & rhs)
 {
-  lhs.Div (rhs);
+  if (!lhs.DivFast (rhs))
+    {
+      lhs.Div (rhs);
+    }
   return lhs;
 }
 
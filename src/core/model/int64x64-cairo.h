@@ -274,6 +274,48 @@ private:
    * \param [in] o The divisor.
    */
   void Div (const int64x64_t & o);
+  /**
+   * Inline fast path for Mul(), when both factors are small integers.
+   *
+   * When neither factor has a fractional part and both fit in 32 bits
+   * the product is a native 64-bit integer product.
+   *
+   * \param [in] o The other factor.
+   * \return \c true if the product was computed,
+   *         \c false if Mul() must be used instead.
+   */
+  inline bool MulFast (const int64x64_t & o)
+  {
+    const int64_t a = (int64_t)_v.hi;
+    const int64_t b = (int64_t)o._v.hi;
+    if ( (_v.lo == 0) && (o._v.lo == 0)
+         && (a == (int32_t)a) && (b == (int32_t)b) )
+      {
+        _v.hi = a * b;
+        return true;
+      }
+    return false;
+  }
+  /**
+   * Inline fast path for Div(), when both operands are integers
+   * and the divisor divides the dividend exactly.
+   *
+   * \param [in] o The divisor.
+   * \return \c true if the quotient was computed,
+   *         \c false if Div() must be used instead.
+   */
+  inline bool DivFast (const int64x64_t & o)
+  {
+    const int64_t a = (int64_t)_v.hi;
+    const int64_t b = (int64_t)o._v.hi;
+    if ( (_v.lo == 0) && (o._v.lo == 0)
+         && (b > 0) && (a % b == 0) )
+      {
+        _v.hi = a / b;
+        return true;
+      }
+    return false;
+  }
   /**
    * Unsigned multiplication of Q64.64 values.
    *
@@ -372,7 +414,10 @@ inline int64x64_t & operator -= (int64x64_t & lhs, const int64x64_t & rhs)
  */
 inline int64x64_t & operator *= (int64x64_t & lhs, const int64x64_t & rhs)
 {
-  lhs.Mul (rhs);
+  if (!lhs.MulFast (rhs))
+    {
+      lhs.Mul (rhs);
+    }
   return lhs;
 }
 /**
@@ -381,7 +426,10 @@ inline int64x64_t & operator *= (int64x64_t & lhs, const int64x64_t & rhs)
  */
 inline int64x64_t & operator /= (int64x64_t & lhs, const int64x64_t & rhs)
 {
-  lhs.Div (rhs);
+  if (!lhs.DivFast (rhs))
+    {
+      lhs.Div (rhs);
+    }
   return lhs;
 }
 
@@ -34,6 +34,19 @@
 #include <cstdlib>
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <sys/time.h>
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
 /**
  * \file
  * \ingroup logging
@@ -73,6 +86,498 @@ public:
  */
 static PrintList g_printList;
 
+/**
+ * \ingroup logging
+ * The stream buffer of the asynchronous log sink, installed in
+ * \c std::clog.
+ *
+ * Each thread writing to the stream buffer gets a ring buffer, with a
+ * single producer, the thread, and a single consumer, the log sink
+ * thread.  The characters of a message are gathered in the pending
+ * string of the thread ring buffer, and copied to the ring buffer when
+ * the stream is flushed, which \c std::endl does at the end of each
+ * log message.  The positions in the ring buffers only grow; each is
+ * written by a single thread, and read by the other one after a
+ * memory barrier.  The characters are written to the file under a
+ * mutex, by the sink thread or by Drain (), which the fatal error
+ * handlers call, so that the messages before a crash are not lost.
+ * The ring of a thread which exits is freed once written.
+ *
+ * In a child process forked while the sink is enabled, there is no
+ * sink thread: the child writes its ring when it is full, when the
+ * sink is drained or disabled.
+ *
+ * This is private to the logging implementation.
+ */
+class LogSinkBuffer : public std::streambuf
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] fileName The file to write, or "-" for the standard error.
+   * \param [in] ringSize The size of the ring buffer of each thread.
+   */
+  LogSinkBuffer (const std::string &fileName, uint32_t ringSize);
+  /** Destructor, writing all the messages. */
+  virtual ~LogSinkBuffer ();
+  /** Write all the published messages, and the pending ones of this thread. */
+  void Drain (void);
+
+protected:
+  virtual int overflow (int c);
+  virtual std::streamsize xsputn (const char *s, std::streamsize n);
+  virtual int sync (void);
+
+private:
+#ifdef HAVE_PTHREAD_H
+  /** The ring buffer of a logging thread. */
+  struct Ring
+  {
+    std::vector<char> data;       //!< The buffer
+    volatile uint64_t head;       //!< The characters published by the thread
+    volatile uint64_t tail;       //!< The characters written by the sink thread
+    std::string pending;          //!< The message being formatted
+    volatile bool orphan;         //!< The thread has exited
+    Ring *next;                   //!< The next ring of the list
+  };
+  /** \returns The ring buffer of the calling thread, created if needed. */
+  Ring * GetRing (void);
+  /**
+   * Copy the pending characters of a ring to its buffer.
+   * \param [in] ring The ring buffer of the calling thread.
+   */
+  void Publish (Ring *ring);
+  /**
+   * Write the published characters of all the rings, and free the
+   * rings of the threads which exited.  Must be called with the mutex
+   * locked.
+   * \returns \c true if anything was written.
+   */
+  bool WriteRings (void);
+  /**
+   * Publish the pending characters of a thread which exits, and mark
+   * its ring to be freed.
+   * \param [in] arg The ring buffer of the thread.
+   */
+  static void ReleaseRing (void *arg);
+  /**
+   * Continue without the sink thread in a forked child process.
+   */
+  static void ForkChild (void);
+  /**
+   * Write a memory area to the file.
+   * \param [in] data The area.
+   * \param [in] size The size of the area.
+   */
+  void WriteFile (const char *data, uint64_t size);
+  /**
+   * The log sink thread main function.
+   * \param [in] arg The LogSinkBuffer.
+   * \returns 0.
+   */
+  static void * Run (void *arg);
+
+  uint32_t m_ringSize;            //!< The size of the new ring buffers
+  pthread_key_t m_key;            //!< The ring buffer of each thread
+  pthread_mutex_t m_mutex;        //!< Protects the list and the writes to the file
+  Ring * volatile m_rings;        //!< The list of ring buffers
+  int m_fd;                       //!< The file descriptor
+  volatile bool m_stop;           //!< Stop the sink thread
+  bool m_threaded;                //!< The sink thread runs in this process
+  pthread_t m_thread;             //!< The log sink thread
+#else
+  std::ofstream m_file;           //!< The file
+  std::ostream *m_os;             //!< The stream written
+#endif
+};
+
+/**
+ * \ingroup logging
+ * The asynchronous log sink, if enabled.
+ * This is private to the logging implementation.
+ */
+static LogSinkBuffer *g_logSink = 0;
+/**
+ * \ingroup logging
+ * The stream buffer of \c std::clog before the log sink was enabled.
+ * This is private to the logging implementation.
+ */
+static std::streambuf *g_logSinkPrevious = 0;
+
+#ifdef HAVE_PTHREAD_H
+
+LogSinkBuffer::LogSinkBuffer (const std::string &fileName, uint32_t ringSize)
+  : m_ringSize (ringSize),
+    m_rings (0),
+    m_fd (2),
+    m_stop (false),
+    m_threaded (true)
+{
+  if (fileName != "-")
+    {
+      m_fd = open (fileName.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (m_fd < 0)
+        {
+          NS_FATAL_ERROR ("Could not open log file " << fileName);
+        }
+    }
+  static bool atForkRegistered = false;
+  if (!atForkRegistered)
+    {
+      pthread_atfork (0, 0, &LogSinkBuffer::ForkChild);
+      atForkRegistered = true;
+    }
+  pthread_mutex_init (&m_mutex, 0);
+  pthread_key_create (&m_key, &LogSinkBuffer::ReleaseRing);
+  pthread_create (&m_thread, 0, &LogSinkBuffer::Run, this);
+}
+
+LogSinkBuffer::~LogSinkBuffer ()
+{
+  Publish (GetRing ());
+  m_stop = true;
+  if (m_threaded)
+    {
+      pthread_join (m_thread, 0);
+    }
+  pthread_mutex_lock (&m_mutex);
+  WriteRings ();
+  pthread_mutex_unlock (&m_mutex);
+  if (m_fd != 2)
+    {
+      close (m_fd);
+    }
+  pthread_key_delete (m_key);
+  pthread_mutex_destroy (&m_mutex);
+  while (m_rings != 0)
+    {
+      Ring *ring = m_rings;
+      m_rings = ring->next;
+      delete ring;
+    }
+}
+
+LogSinkBuffer::Ring *
+LogSinkBuffer::GetRing (void)
+{
+  Ring *ring = static_cast<Ring *> (pthread_getspecific (m_key));
+  if (ring == 0)
+    {
+      ring = new Ring;
+      ring->data.resize (m_ringSize);
+      ring->head = 0;
+      ring->tail = 0;
+      ring->orphan = false;
+      pthread_setspecific (m_key, ring);
+      // Push the ring on the list read by the sink thread
+      pthread_mutex_lock (&m_mutex);
+      ring->next = m_rings;
+      m_rings = ring;
+      pthread_mutex_unlock (&m_mutex);
+    }
+  return ring;
+}
+
+void
+LogSinkBuffer::Publish (Ring *ring)
+{
+  const char *data = ring->pending.data ();
+  uint64_t left = ring->pending.size ();
+  uint64_t size = ring->data.size ();
+  while (left > 0)
+    {
+      uint64_t head = ring->head;
+      __sync_synchronize ();
+      uint64_t space = size - (head - ring->tail);
+      if (space == 0)
+        {
+          if (m_threaded)
+            {
+              // Wait for the sink thread to write the ring
+              sched_yield ();
+            }
+          else
+            {
+              pthread_mutex_lock (&m_mutex);
+              WriteRings ();
+              pthread_mutex_unlock (&m_mutex);
+            }
+          continue;
+        }
+      uint64_t n = std::min (space, left);
+      uint64_t start = head % size;
+      uint64_t first = std::min (n, size - start);
+      std::memcpy (&ring->data[start], data, first);
+      std::memcpy (&ring->data[0], data + first, n - first);
+      // Write the characters before publishing them
+      __sync_synchronize ();
+      ring->head = head + n;
+      data += n;
+      left -= n;
+    }
+  ring->pending.clear ();
+}
+
+bool
+LogSinkBuffer::WriteRings (void)
+{
+  bool written = false;
+  Ring **link = const_cast<Ring **> (&m_rings);
+  while (*link != 0)
+    {
+      Ring *ring = *link;
+      bool orphan = ring->orphan;
+      // Read the position after the orphan flag
+      __sync_synchronize ();
+      uint64_t head = ring->head;
+      // Read the characters after their publication
+      __sync_synchronize ();
+      uint64_t tail = ring->tail;
+      if (head != tail)
+        {
+          uint64_t size = ring->data.size ();
+          uint64_t start = tail % size;
+          uint64_t first = std::min (head - tail, size - start);
+          WriteFile (&ring->data[start], first);
+          WriteFile (&ring->data[0], head - tail - first);
+          // Read the characters before releasing their space
+          __sync_synchronize ();
+          ring->tail = head;
+          written = true;
+        }
+      if (orphan)
+        {
+          // The thread published everything before exiting
+          *link = ring->next;
+          delete ring;
+          continue;
+        }
+      link = &ring->next;
+    }
+  return written;
+}
+
+void
+LogSinkBuffer::ReleaseRing (void *arg)
+{
+  Ring *ring = static_cast<Ring *> (arg);
+  if (g_logSink != 0)
+    {
+      g_logSink->Publish (ring);
+    }
+  // Publish the characters before the ring is freed
+  __sync_synchronize ();
+  ring->orphan = true;
+}
+
+void
+LogSinkBuffer::ForkChild (void)
+{
+  if (g_logSink == 0)
+    {
+      return;
+    }
+  // The mutex may have been locked by a thread of the parent, and the
+  // characters published in the parent are written by the parent
+  pthread_mutex_init (&g_logSink->m_mutex, 0);
+  g_logSink->m_threaded = false;
+  for (Ring *ring = g_logSink->m_rings; ring != 0; ring = ring->next)
+    {
+      ring->tail = ring->head;
+    }
+}
+
+void
+LogSinkBuffer::WriteFile (const char *data, uint64_t size)
+{
+  while (size > 0)
+    {
+      ssize_t n = write (m_fd, data, size);
+      if (n <= 0)
+        {
+          return;
+        }
+      data += n;
+      size -= n;
+    }
+}
+
+void *
+LogSinkBuffer::Run (void *arg)
+{
+  LogSinkBuffer *sink = static_cast<LogSinkBuffer *> (arg);
+  for (;;)
+    {
+      bool stop = sink->m_stop;
+      __sync_synchronize ();
+      pthread_mutex_lock (&sink->m_mutex);
+      bool written = sink->WriteRings ();
+      pthread_mutex_unlock (&sink->m_mutex);
+      if (!written)
+        {
+          if (stop)
+            {
+              return 0;
+            }
+          usleep (1000);
+        }
+    }
+}
+
+void
+LogSinkBuffer::Drain (void)
+{
+  Publish (GetRing ());
+  // Write the rings now rather than wait for the sink thread, which
+  // may not run again before a fatal error terminates the program
+  pthread_mutex_lock (&m_mutex);
+  WriteRings ();
+  pthread_mutex_unlock (&m_mutex);
+}
+
+int
+LogSinkBuffer::overflow (int c)
+{
+  if (c != EOF)
+    {
+      GetRing ()->pending.push_back (static_cast<char> (c));
+    }
+  return c;
+}
+
+std::streamsize
+LogSinkBuffer::xsputn (const char *s, std::streamsize n)
+{
+  GetRing ()->pending.append (s, n);
+  return n;
+}
+
+int
+LogSinkBuffer::sync (void)
+{
+  Publish (GetRing ());
+  return 0;
+}
+
+#else /* HAVE_PTHREAD_H */
+
+LogSinkBuffer::LogSinkBuffer (const std::string &fileName, uint32_t ringSize)
+  : m_os (&std::cerr)
+{
+  if (fileName != "-")
+    {
+      m_file.open (fileName.c_str ());
+      if (!m_file.is_open ())
+        {
+          NS_FATAL_ERROR ("Could not open log file " << fileName);
+        }
+      m_os = &m_file;
+    }
+}
+
+LogSinkBuffer::~LogSinkBuffer ()
+{
+  m_os->flush ();
+}
+
+void
+LogSinkBuffer::Drain (void)
+{
+  m_os->flush ();
+}
+
+int
+LogSinkBuffer::overflow (int c)
+{
+  if (c != EOF)
+    {
+      m_os->put (static_cast<char> (c));
+    }
+  return c;
+}
+
+std::streamsize
+LogSinkBuffer::xsputn (const char *s, std::streamsize n)
+{
+  m_os->write (s, n);
+  return n;
+}
+
+int
+LogSinkBuffer::sync (void)
+{
+  // The messages are not flushed one by one
+  return 0;
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * \ingroup logging
+ * Enable the log sink from the \c NS_LOG_FILE environment variable,
+ * and disable it at the end of the program.
+ * This is private to the logging implementation.
+ */
+class LogSinkEnvironment
+{
+public:
+  LogSinkEnvironment ();   //!< Constructor, enables the log sink if requested.
+  ~LogSinkEnvironment ();  //!< Destructor, disables the log sink.
+};
+
+LogSinkEnvironment::LogSinkEnvironment ()
+{
+#ifdef HAVE_GETENV
+  char *envVar = getenv ("NS_LOG_FILE");
+  if (envVar != 0 && std::strlen (envVar) != 0)
+    {
+      LogEnableAsyncSink (envVar);
+    }
+#endif
+}
+
+LogSinkEnvironment::~LogSinkEnvironment ()
+{
+  LogDisableAsyncSink ();
+}
+
+/**
+ * \ingroup logging
+ * Handler for the \c NS_LOG_FILE environment variable.
+ * This is private to the logging implementation.
+ */
+static LogSinkEnvironment g_logSinkEnvironment;
+
+void
+LogEnableAsyncSink (const std::string &fileName, uint32_t ringSize)
+{
+  LogDisableAsyncSink ();
+  std::clog.flush ();
+  g_logSink = new LogSinkBuffer (fileName, std::max (ringSize, (uint32_t)1));
+  g_logSinkPrevious = std::clog.rdbuf (g_logSink);
+}
+
+void
+LogFlushAsyncSink (void)
+{
+  if (g_logSink != 0)
+    {
+      g_logSink->Drain ();
+    }
+}
+
+void
+LogDisableAsyncSink (void)
+{
+  if (g_logSink != 0)
+    {
+      std::clog.rdbuf (g_logSinkPrevious);
+      delete g_logSink;
+      g_logSink = 0;
+      g_logSinkPrevious = 0;
+    }
+}
+
   
 /* static */
 LogComponent::ComponentList *
@@ -113,7 +618,8 @@ PrintList::PrintList ()
 LogComponent::LogComponent (const std::string & name,
                             const std::string & file,
                             const enum LogLevel mask /* = 0 */)
-  : m_levels (0), m_mask (mask), m_name (name), m_file (file)
+  : m_levels (0), m_mask (mask), m_name (name), m_file (file),
+    m_rateLimit (0), m_rateCount (0), m_rateDropped (0), m_rateWindowStart (0)
 {
   EnvVarCheck ();
 
@@ -255,6 +761,10 @@ LogComponent::EnvVarCheck (void)
                     {
                       level |= LOG_LEVEL_ALL | LOG_PREFIX_ALL;
                     }
+                  else if (lev.compare (0, 5, "rate=") == 0)
+                    {
+                      SetRateLimit (std::atoi (lev.c_str () + 5));
+                    }
 
                   pre_pipe = false;
                 } while (next_lev != std::string::npos);
@@ -287,6 +797,42 @@ LogComponent::SetMask (const enum LogLevel level)
   m_mask |= level;
 }
 
+void
+LogComponent::SetRateLimit (uint32_t messagesPerSecond)
+{
+  m_rateLimit = messagesPerSecond;
+  m_rateCount = 0;
+  m_rateDropped = 0;
+  m_rateWindowStart = 0;
+}
+
+bool
+LogComponent::CheckRateLimit (void)
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  int64_t now = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+  if (m_rateCount == 0 || now - m_rateWindowStart >= 1000000)
+    {
+      // Start a new window with this message
+      if (m_rateDropped > 0)
+        {
+          std::clog << m_name << ": " << m_rateDropped
+                    << " messages dropped by the rate limit" << std::endl;
+        }
+      m_rateWindowStart = now;
+      m_rateCount = 0;
+      m_rateDropped = 0;
+    }
+  if (m_rateCount < m_rateLimit)
+    {
+      m_rateCount++;
+      return true;
+    }
+  m_rateDropped++;
+  return false;
+}
+
 void 
 LogComponent::Enable (const enum LogLevel level)
 {
@@ -383,6 +929,20 @@ LogComponentEnableAll (enum LogLevel level)
     }
 }
 
+void
+LogComponentSetRateLimit (char const *name, uint32_t messagesPerSecond)
+{
+  LogComponent::ComponentList *components = LogComponent::GetComponentList ();
+  LogComponent::ComponentList::const_iterator i = components->find (name);
+  if (i == components->end ())
+    {
+      LogComponentPrintList ();
+      NS_FATAL_ERROR ("Logging component \"" << name <<
+                      "\" not found. See above for a list of available log components");
+    }
+  i->second->SetRateLimit (messagesPerSecond);
+}
+
 void 
 LogComponentDisable (char const *name, enum LogLevel level)
 {
@@ -585,6 +1145,9 @@ static void CheckEnvironmentVariables (void)
                       || lev == "level_all"
                       || lev == "*"
                       || lev == "**"
+                      || (lev.compare (0, 5, "rate=") == 0
+                          && lev.size () > 5
+                          && lev.find_first_not_of ("0123456789", 5) == std::string::npos)
 		     )
                     {
                       continue;
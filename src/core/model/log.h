@@ -304,6 +304,50 @@ void LogSetNodePrinter (LogNodePrinter np);
 LogNodePrinter LogGetNodePrinter (void);
 
 
+/**
+ * Write the log messages to a file from a background thread.
+ *
+ * From this call on, the messages written to \c std::clog by each
+ * thread, including the NS_LOG messages, are appended to a ring buffer
+ * of this thread, without locking, and the log sink thread writes them
+ * to the file in large blocks.  The messages of each thread keep their
+ * order, and a thread waits when its ring buffer is full.  The messages
+ * are still formatted by the logging thread, but neither written nor
+ * flushed one by one.
+ *
+ * The sink can also be enabled by setting the \c NS_LOG_FILE
+ * environment variable to the name of the file, or to "-" for the
+ * standard error.  The sink writes all its messages when it is
+ * disabled, or at the end of the program.  Without thread support,
+ * the messages are written synchronously.
+ *
+ * \param [in] fileName The file to write, or "-" for the standard error.
+ * \param [in] ringSize The size of the ring buffer of each logging
+ *                      thread, in bytes.
+ */
+void LogEnableAsyncSink (const std::string &fileName, uint32_t ringSize = 1 << 20);
+/**
+ * Write the log messages to the log sink file, and wait until they
+ * are written.
+ */
+void LogFlushAsyncSink (void);
+/**
+ * Write the log messages to the log sink file, stop the log sink
+ * thread, and log to the original \c std::clog stream again.
+ */
+void LogDisableAsyncSink (void);
+
+/**
+ * Limit the number of messages logged by a log component.
+ *
+ * \param [in] name The log component name.
+ * \param [in] messagesPerSecond The maximum number of messages per
+ *             second of wall clock time, or 0 for no limit.
+ * \see LogComponent::SetRateLimit
+ */
+void LogComponentSetRateLimit (char const *name, uint32_t messagesPerSecond);
+
+
 /**
  * A single log component configuration.
  */
@@ -371,6 +415,26 @@ public:
    * \param level The LogLevel to block.
    */
   void SetMask (const enum LogLevel level);
+  /**
+   * Limit the number of messages logged per second of wall clock time.
+   *
+   * The messages beyond the limit in a one second window are dropped,
+   * and their number is logged with the first message of the next
+   * window.  The \c NS_LOG environment variable sets the limit with
+   * the \c rate=N option, e.g. \c NS_LOG='WifiPhy=info|rate=100'.
+   *
+   * \param [in] messagesPerSecond The limit, or 0 for no limit.
+   */
+  void SetRateLimit (uint32_t messagesPerSecond);
+  /**
+   * Count a message against the rate limit.
+   *
+   * \return \c true if the message may be logged.
+   */
+  bool AllowMessage (void)
+  {
+    return m_rateLimit == 0 || CheckRateLimit ();
+  }
 
   /**
    * LogComponent name map.
@@ -401,11 +465,21 @@ private:
    * LogComponent.
    */
   void EnvVarCheck (void);
+  /**
+   * Count a message against a non null rate limit.
+   *
+   * \return \c true if the message may be logged.
+   */
+  bool CheckRateLimit (void);
   
   int32_t     m_levels;  //!< Enabled LogLevels.
   int32_t     m_mask;    //!< Blocked LogLevels.
   std::string m_name;    //!< LogComponent name.
   std::string m_file;    //!< File defining this LogComponent.
+  uint32_t    m_rateLimit;        //!< Messages allowed per second, or 0.
+  uint32_t    m_rateCount;        //!< Messages of the current window.
+  uint32_t    m_rateDropped;      //!< Messages dropped in the current window.
+  int64_t     m_rateWindowStart;  //!< Start of the current window, in us.
 
 };  // class LogComponent
 
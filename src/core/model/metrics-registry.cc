@@ -0,0 +1,260 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "metrics-registry.h"
+#include "log.h"
+#include "fatal-error.h"
+#include "ns3/core-config.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <sys/time.h>
+
+#ifdef HAVE_UNISTD_H
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup metrics
+ * ns3::Metric and ns3::MetricsRegistry implementations.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MetricsRegistry");
+
+const uint32_t MetricsRegistry::CAPACITY;
+
+namespace {
+
+/** The magic number of the table. */
+const uint32_t METRICS_MAGIC = 0x6e736d72;
+
+/**
+ * \ingroup metrics
+ * The header of the table.
+ */
+struct MetricsHeader
+{
+  uint32_t magic;           //!< METRICS_MAGIC
+  uint16_t versionMajor;    //!< The major version, 1
+  uint16_t versionMinor;    //!< The minor version, 0
+  uint32_t capacity;        //!< The number of slots
+  volatile uint32_t n;      //!< The number of metrics
+  int64_t startTime;        //!< The creation time, in us since the epoch
+  int32_t pid;              //!< The process id
+  uint8_t reserved[36];     //!< Padding to 64 bytes
+};
+
+/**
+ * \ingroup metrics
+ * The table of the metrics.
+ */
+struct MetricsTable
+{
+  MetricsHeader header;                         //!< The header
+  MetricSlot slots[MetricsRegistry::CAPACITY];  //!< The slots
+};
+
+/**
+ * \ingroup metrics
+ * The slot of the handles which are not registered, and of the metrics
+ * beyond the capacity.
+ */
+MetricSlot g_scratchSlot;
+
+/**
+ * \ingroup metrics
+ * \returns The name of the file of the table.
+ */
+std::string &
+GetMetricsFileName (void)
+{
+  static std::string fileName;
+  return fileName;
+}
+
+/**
+ * \ingroup metrics
+ * Get the table, created when first needed.
+ *
+ * The table is created in anonymous memory, then mapped to the file
+ * named by the \c NS_METRICS_FILE environment variable, if set.
+ *
+ * \returns The table.
+ */
+MetricsTable *
+GetMetricsTable (void)
+{
+  static MetricsTable *table = 0;
+  if (table != 0)
+    {
+      return table;
+    }
+#ifdef HAVE_UNISTD_H
+  void *area = mmap (0, sizeof (MetricsTable), PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANON, -1, 0);
+  if (area == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("Could not allocate the metrics table");
+    }
+  table = static_cast<MetricsTable *> (area);
+#else
+  table = static_cast<MetricsTable *> (std::calloc (1, sizeof (MetricsTable)));
+#endif
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  table->header.magic = METRICS_MAGIC;
+  table->header.versionMajor = 1;
+  table->header.versionMinor = 0;
+  table->header.capacity = MetricsRegistry::CAPACITY;
+  table->header.n = 0;
+  table->header.startTime = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+#ifdef HAVE_UNISTD_H
+  table->header.pid = getpid ();
+#endif
+
+  char *envVar = std::getenv ("NS_METRICS_FILE");
+  if (envVar != 0 && std::strlen (envVar) != 0)
+    {
+      MetricsRegistry::Enable (envVar);
+    }
+  return table;
+}
+
+} // anonymous namespace
+
+
+Metric::Metric ()
+  : m_slot (&g_scratchSlot)
+{
+}
+
+Metric::Metric (const std::string &name, enum Type type)
+  : m_slot (MetricsRegistry::Lookup (name, type))
+{
+}
+
+std::string
+Metric::GetName (void) const
+{
+  return m_slot->name;
+}
+
+
+void
+MetricsRegistry::Enable (const std::string &fileName)
+{
+  NS_LOG_FUNCTION (fileName);
+  MetricsTable *table = GetMetricsTable ();
+#ifdef HAVE_UNISTD_H
+  int fd = open (fileName.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      NS_FATAL_ERROR ("Could not open metrics file " << fileName);
+    }
+  // Write the metrics registered so far, then map the file in place of
+  // the table, so that the slots keep their addresses
+  const char *data = reinterpret_cast<const char *> (table);
+  size_t left = sizeof (MetricsTable);
+  while (left > 0)
+    {
+      ssize_t written = write (fd, data, left);
+      if (written <= 0)
+        {
+          NS_FATAL_ERROR ("Could not write metrics file " << fileName);
+        }
+      data += written;
+      left -= written;
+    }
+  void *area = mmap (table, sizeof (MetricsTable), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_FIXED, fd, 0);
+  close (fd);
+  if (area != table)
+    {
+      NS_FATAL_ERROR ("Could not map metrics file " << fileName);
+    }
+  GetMetricsFileName () = fileName;
+#else
+  NS_LOG_WARN ("Metrics file " << fileName << " not supported on this platform");
+#endif
+}
+
+void
+MetricsRegistry::ReopenInChild (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+#ifdef HAVE_UNISTD_H
+  std::string fileName = GetMetricsFileName ();
+  if (fileName.empty ())
+    {
+      // The anonymous table is already copied on write
+      return;
+    }
+  std::ostringstream oss;
+  oss << fileName << "." << getpid ();
+  Enable (oss.str ());
+  GetMetricsTable ()->header.pid = getpid ();
+#endif
+}
+
+std::string
+MetricsRegistry::GetFileName (void)
+{
+  return GetMetricsFileName ();
+}
+
+uint32_t
+MetricsRegistry::GetN (void)
+{
+  return GetMetricsTable ()->header.n;
+}
+
+MetricSlot *
+MetricsRegistry::Lookup (const std::string &name, enum Metric::Type type)
+{
+  MetricsTable *table = GetMetricsTable ();
+  std::string key = name.substr (0, sizeof (g_scratchSlot.name) - 1);
+  uint32_t n = table->header.n;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (key == table->slots[i].name)
+        {
+          return &table->slots[i];
+        }
+    }
+  if (n == CAPACITY)
+    {
+      NS_LOG_WARN ("No slot left for metric " << name);
+      return &g_scratchSlot;
+    }
+  NS_LOG_LOGIC ("Register metric " << key << " in slot " << n);
+  MetricSlot *slot = &table->slots[n];
+  std::memcpy (slot->name, key.c_str (), key.size () + 1);
+  slot->type = type;
+  slot->count = 0;
+  slot->value = 0;
+  // Publish the slot once it is written
+  __sync_synchronize ();
+  table->header.n = n + 1;
+  return slot;
+}
+
+} // namespace ns3
@@ -19,7 +19,12 @@
  */
 #include "object-factory.h"
 #include "log.h"
+#include "string.h"
+#include "ns3/core-config.h"
 #include <sstream>
+#ifdef HAVE_STDLIB_H
+#include <cstdlib>
+#endif
 
 /**
  * \file
@@ -46,18 +51,21 @@ void
 ObjectFactory::SetTypeId (TypeId tid)
 {
   NS_LOG_FUNCTION (this << tid.GetName ());
+  m_plan = 0;
   m_tid = tid;
 }
 void
 ObjectFactory::SetTypeId (std::string tid)
 {
   NS_LOG_FUNCTION (this << tid);
+  m_plan = 0;
   m_tid = TypeId::LookupByName (tid);
 }
 void
 ObjectFactory::SetTypeId (const char *tid)
 {
   NS_LOG_FUNCTION (this << tid);
+  m_plan = 0;
   m_tid = TypeId::LookupByName (tid);
 }
 void
@@ -82,6 +90,7 @@ ObjectFactory::Set (std::string name, const AttributeValue &value)
       return;
     }
   m_parameters.Add (name, info.checker, value.Copy ());
+  m_plan = 0;
 }
 
 TypeId 
@@ -100,11 +109,122 @@ ObjectFactory::Create (void) const
   Object *derived = dynamic_cast<Object *> (base);
   NS_ASSERT (derived != 0);
   derived->SetTypeId (m_tid);
-  derived->Construct (m_parameters);
+  if (m_plan == 0 || m_plan->generation != TypeId::GetAttributeGeneration ())
+    {
+      m_plan = BuildPlan ();
+    }
+  ApplyPlan (derived, m_plan);
   Ptr<Object> object = Ptr<Object> (derived, false);
   return object;
 }
 
+Ptr<ObjectFactory::AttributePlan>
+ObjectFactory::BuildPlan (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<AttributePlan> plan = ns3::Create<AttributePlan> ();
+  plan->generation = TypeId::GetAttributeGeneration ();
+
+  std::string env;
+#ifdef HAVE_GETENV
+  char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  if (envVar != 0)
+    {
+      env = std::string (envVar);
+    }
+#endif /* HAVE_GETENV */
+
+  // Same traversal as ObjectBase::ConstructSelf
+  TypeId tid = m_tid;
+  do {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          Ptr<AttributeValue> value = m_parameters.Find (info.checker);
+          if (!(info.flags & TypeId::ATTR_CONSTRUCT))
+            {
+              if (value != 0)
+                {
+                  NS_FATAL_ERROR ("Attribute name="<<info.name<<" tid="<<tid.GetName () << ": initial value cannot be set using attributes");
+                }
+              continue;
+            }
+          struct AttributePlan::Step step;
+          step.accessor = info.accessor;
+          step.checker = info.checker;
+          struct AttributePlan::Candidate candidate;
+          if (value != 0)
+            {
+              candidate.value = value;
+              candidate.checked = info.checker->Check (*value);
+              step.candidates.push_back (candidate);
+            }
+          std::string::size_type cur = 0;
+          std::string::size_type next = 0;
+          while (!env.empty () && next != std::string::npos)
+            {
+              next = env.find (";", cur);
+              std::string tmp = std::string (env, cur, next-cur);
+              std::string::size_type equal = tmp.find ("=");
+              if (equal != std::string::npos
+                  && tmp.substr (0, equal) == tid.GetAttributeFullName (i))
+                {
+                  candidate.value = ns3::Create<StringValue> (tmp.substr (equal+1, tmp.size () - equal - 1));
+                  candidate.checked = false;
+                  step.candidates.push_back (candidate);
+                }
+              cur = next + 1;
+            }
+          candidate.value = info.initialValue;
+          candidate.checked = info.checker->Check (*info.initialValue);
+          step.candidates.push_back (candidate);
+          plan->steps.push_back (step);
+        }
+      tid = tid.GetParent ();
+    } while (tid != ObjectBase::GetTypeId ());
+  return plan;
+}
+
+void
+ObjectFactory::ApplyPlan (Object *object, Ptr<const AttributePlan> plan)
+{
+  NS_LOG_FUNCTION (object << plan);
+  std::vector<struct AttributePlan::Step>::const_iterator step;
+  for (step = plan->steps.begin (); step != plan->steps.end (); ++step)
+    {
+      // Like ObjectBase::ConstructSelf, take the first candidate which
+      // can be set; the initial value is always the last candidate.
+      std::vector<struct AttributePlan::Candidate>::const_iterator candidate;
+      for (candidate = step->candidates.begin ();
+           candidate != step->candidates.end ();
+           ++candidate)
+        {
+          if (ApplyCandidate (object, *step, *candidate))
+            {
+              break;
+            }
+        }
+    }
+  object->NotifyConstructionCompleted ();
+}
+
+bool
+ObjectFactory::ApplyCandidate (Object *object,
+                               const struct AttributePlan::Step &step,
+                               const struct AttributePlan::Candidate &candidate)
+{
+  if (candidate.checked)
+    {
+      return step.accessor->Set (object, *candidate.value);
+    }
+  Ptr<AttributeValue> v = step.checker->CreateValidValue (*candidate.value);
+  if (v == 0)
+    {
+      return false;
+    }
+  return step.accessor->Set (object, *v);
+}
+
 std::ostream & operator << (std::ostream &os, const ObjectFactory &factory)
 {
   os << factory.m_tid.GetName () << "[";
@@ -184,6 +304,7 @@ std::istream & operator >> (std::istream &is, ObjectFactory &factory)
               else
                 {
                   factory.m_parameters.Add (name, info.checker, val);
+                  factory.m_plan = 0;
                 }
             }
         }
@@ -22,7 +22,9 @@
 
 #include "attribute-construction-list.h"
 #include "object.h"
+#include "simple-ref-count.h"
 #include "type-id.h"
+#include <vector>
 
 /**
  * \file
@@ -129,6 +131,75 @@ private:
    */
   friend std::istream & operator >> (std::istream &is, ObjectFactory &factory);
 
+  /**
+   * The resolved attribute values for constructing objects of m_tid.
+   *
+   * ObjectBase::ConstructSelf looks up the value of every attribute
+   * of every TypeId in the hierarchy each time an object is constructed.
+   * The result depends only on the TypeId, the factory parameters,
+   * the attribute initial values and the \c NS_ATTRIBUTE_DEFAULT
+   * environment variable, so the factory resolves it once into a plan,
+   * and applies the plan to each new object.
+   */
+  struct AttributePlan : public SimpleRefCount<AttributePlan>
+  {
+    /** A value which may be used for an attribute. */
+    struct Candidate
+    {
+      /** The value. */
+      Ptr<const AttributeValue> value;
+      /**
+       * Whether the checker accepts the value as is.  If not (the value
+       * is a StringValue) it is converted again for each object,
+       * so every object gets, for example, its own random variable.
+       */
+      bool checked;
+    };
+    /** How to set one attribute. */
+    struct Step
+    {
+      /** The attribute accessor. */
+      Ptr<const AttributeAccessor> accessor;
+      /** The attribute checker. */
+      Ptr<const AttributeChecker> checker;
+      /**
+       * The values to try, in order: the factory parameter, 
+       * the environment variable, the initial value.
+       */
+      std::vector<struct Candidate> candidates;
+    };
+    /** The attributes to set, in ObjectBase::ConstructSelf order. */
+    std::vector<struct Step> steps;
+    /** The TypeId::GetAttributeGeneration this plan was resolved at. */
+    uint32_t generation;
+  };
+
+  /**
+   * Resolve the attribute plan for m_tid and m_parameters.
+   *
+   * \returns The attribute plan.
+   */
+  Ptr<AttributePlan> BuildPlan (void) const;
+  /**
+   * Set the attributes of a new object, according to the plan,
+   * and notify it that construction is complete.
+   *
+   * \param [in] object The new object.
+   * \param [in] plan The attribute plan.
+   */
+  static void ApplyPlan (Object *object, Ptr<const AttributePlan> plan);
+  /**
+   * Attempt to set an attribute from a single candidate value.
+   *
+   * \param [in] object The object.
+   * \param [in] step The attribute to set.
+   * \param [in] candidate The candidate value.
+   * \returns \c true if the value was valid and could be set.
+   */
+  static bool ApplyCandidate (Object *object,
+                              const struct AttributePlan::Step &step,
+                              const struct AttributePlan::Candidate &candidate);
+
   /** The TypeId this factory will create. */
   TypeId m_tid;
   /**
@@ -136,6 +207,11 @@ private:
    * objects by this factory.
    */
   AttributeConstructionList m_parameters;  
+  /**
+   * The cached attribute plan, built by the first Create ().
+   * It is reset whenever the TypeId or the parameters change.
+   */
+  mutable Ptr<AttributePlan> m_plan;
 };
 
 std::ostream & operator << (std::ostream &os, const ObjectFactory &factory);
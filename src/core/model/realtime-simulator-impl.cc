@@ -33,6 +33,7 @@
 #include "enum.h"
 
 
+#include <algorithm>
 #include <cmath>
 
 
@@ -90,6 +91,7 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
+  m_inbox = 0;
 
   m_main = SystemThread::Self();
 
@@ -113,6 +115,14 @@ RealtimeSimulatorImpl::DoDispose (void)
       next.impl->Unref ();
     }
   m_events = 0;
+  InboxEvent *inbox = __sync_lock_test_and_set (&m_inbox, (InboxEvent *)0);
+  while (inbox != 0)
+    {
+      InboxEvent *next = inbox->next;
+      inbox->impl->Unref ();
+      delete inbox;
+      inbox = next;
+    }
   m_synchronizer = 0;
   SimulatorImpl::DoDispose ();
 }
@@ -208,6 +218,17 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
 
       { 
         CriticalSection cs (m_mutex);
+        //
+        // We're going to sleep, but need to work with the synchronizer to make
+        // sure we're awakened if something external happens (like a packet is
+        // received).  This next line resets the synchronizer so that any future
+        // event will cause it to interrupt.  Events injected by other threads
+        // before this point are in the inbox, which we drain right after, so
+        // that none is missed.
+        //
+        m_synchronizer->SetCondition (false);
+        DrainInbox ();
+
         //
         // Since we are in realtime mode, the time to delay has got to be the 
         // difference between the current realtime and the timestamp of the next 
@@ -248,15 +269,6 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
           {
             tsDelay = tsNext - tsNow;
           }
-
-        //
-        // We've figured out how long we need to delay in order to pace the 
-        // simulation time with the real time.  We're going to sleep, but need
-        // to work with the synchronizer to make sure we're awakened if something 
-        // external happens (like a packet is received).  This next line resets
-        // the synchronizer so that any future event will cause it to interrupt.
-        //
-        m_synchronizer->SetCondition (false);
       }
 
       //
@@ -399,7 +411,7 @@ RealtimeSimulatorImpl::IsFinished (void) const
   bool rc;
   {
     CriticalSection cs (m_mutex);
-    rc = m_events->IsEmpty () || m_stop;
+    rc = (m_events->IsEmpty () && m_inbox == 0) || m_stop;
   }
 
   return rc;
@@ -442,6 +454,8 @@ RealtimeSimulatorImpl::Run (void)
       {
         CriticalSection cs (m_mutex);
 
+        m_synchronizer->SetCondition (false);
+        DrainInbox ();
         if (!m_events->IsEmpty ())
           {
             process = true;
@@ -543,23 +557,20 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time,
 {
   NS_LOG_FUNCTION (this << context << time << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      //
+      // If the simulator is running, we're pacing and have a meaningful 
+      // realtime clock.  If we're not, then m_currentTs is where we stopped.
+      // 
+      uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
+      PushInbox (ts + time.GetTimeStep (), context, impl);
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
-    uint64_t ts;
-
-    if (SystemThread::Equals (m_main))
-      {
-        ts = m_currentTs + time.GetTimeStep ();
-      }
-    else
-      {
-        //
-        // If the simulator is running, we're pacing and have a meaningful 
-        // realtime clock.  If we're not, then m_currentTs is where we stopped.
-        // 
-        ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-        ts += time.GetTimeStep ();
-      }
+    uint64_t ts = m_currentTs + time.GetTimeStep ();
 
     NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
     Scheduler::Event ev;
@@ -609,6 +620,12 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext (uint32_t context, Time const
 {
   NS_LOG_FUNCTION (this << context << time << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      PushInbox (m_synchronizer->GetCurrentRealtime () + time.GetTimeStep (), context, impl);
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
 
@@ -617,6 +634,7 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext (uint32_t context, Time const
     Scheduler::Event ev;
     ev.impl = impl;
     ev.key.m_ts = ts;
+    ev.key.m_context = context;
     ev.key.m_uid = m_uid;
     m_uid++;
     m_unscheduledEvents++;
@@ -636,13 +654,20 @@ void
 RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext (uint32_t context, EventImpl *impl)
 {
   NS_LOG_FUNCTION (this << context << impl);
+
+  //
+  // If the simulator is running, we're pacing and have a meaningful 
+  // realtime clock.  If we're not, then m_currentTs is were we stopped.
+  // 
+  if (!SystemThread::Equals (m_main))
+    {
+      PushInbox (m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs, context, impl);
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
 
-    //
-    // If the simulator is running, we're pacing and have a meaningful 
-    // realtime clock.  If we're not, then m_currentTs is were we stopped.
-    // 
     uint64_t ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
     NS_ASSERT_MSG (ts >= m_currentTs, 
                    "RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext(): schedule for time < m_currentTs");
@@ -665,6 +690,73 @@ RealtimeSimulatorImpl::ScheduleRealtimeNow (EventImpl *impl)
   ScheduleRealtimeNowWithContext (GetContext (), impl);
 }
 
+void
+RealtimeSimulatorImpl::PushInbox (uint64_t ts, uint32_t context, EventImpl *impl)
+{
+  InboxEvent *ev = new InboxEvent;
+  ev->impl = impl;
+  ev->ts = ts;
+  ev->context = context;
+  InboxEvent *head;
+  do
+    {
+      head = m_inbox;
+      ev->next = head;
+    }
+  while (!__sync_bool_compare_and_swap (&m_inbox, head, ev));
+
+  //
+  // Only the event which makes the inbox non empty needs to wake up the
+  // main thread: it resets the synchronizer condition before it drains the
+  // inbox, so any later event is either drained with this one, or finds the
+  // inbox empty again and signals in turn.
+  //
+  if (head == 0)
+    {
+      m_synchronizer->Signal ();
+    }
+}
+
+void
+RealtimeSimulatorImpl::DrainInbox (void)
+{
+  if (m_inbox == 0)
+    {
+      return;
+    }
+  InboxEvent *head = __sync_lock_test_and_set (&m_inbox, (InboxEvent *)0);
+
+  // The inbox is most recent first: reverse it to keep the arrival order
+  InboxEvent *ordered = 0;
+  while (head != 0)
+    {
+      InboxEvent *next = head->next;
+      head->next = ordered;
+      ordered = head;
+      head = next;
+    }
+
+  while (ordered != 0)
+    {
+      //
+      // The timestamp was computed outside the critical section, so it may
+      // be just behind the event we executed last: run such events now.
+      //
+      Scheduler::Event ev;
+      ev.impl = ordered->impl;
+      ev.key.m_ts = std::max (ordered->ts, m_currentTs);
+      ev.key.m_context = ordered->context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+
+      InboxEvent *next = ordered->next;
+      delete ordered;
+      ordered = next;
+    }
+}
+
 Time
 RealtimeSimulatorImpl::RealtimeNow (void) const
 {
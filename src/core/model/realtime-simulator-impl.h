@@ -172,6 +172,19 @@ private:
   uint64_t NextTs (void) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
+  /**
+   * Add an event to the inbox.  This can be called from any thread.
+   *
+   * \param [in] ts The event timestamp.
+   * \param [in] context The event context.
+   * \param [in] impl The event.
+   */
+  void PushInbox (uint64_t ts, uint32_t context, EventImpl *impl);
+  /**
+   * Move all the events in the inbox to the event list.
+   * This is called by the main thread with #m_mutex held.
+   */
+  void DrainInbox (void);
   /** Destructor implementation. */
   virtual void DoDispose (void);
 
@@ -207,6 +220,23 @@ private:
   /** Mutex to control access to key state. */  
   mutable SystemMutex m_mutex;  
 
+  /** An event scheduled by another thread, waiting in the inbox. */
+  struct InboxEvent
+  {
+    EventImpl *impl;     //!< The event.
+    uint64_t ts;         //!< The event timestamp.
+    uint32_t context;    //!< The event context.
+    InboxEvent *next;    //!< The event pushed before this one.
+  };
+  /**
+   * Events scheduled by other threads, most recent first.
+   *
+   * This is a lock free stack: other threads push with a compare and swap,
+   * and the main thread takes all the events at once, so that threads
+   * injecting events at packet rate never contend for #m_mutex.
+   */
+  InboxEvent * volatile m_inbox;
+
   /** The synchronizer in use to track real time. */
   Ptr<Synchronizer> m_synchronizer;
 
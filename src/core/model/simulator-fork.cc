@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "simulator-fork.h"
+#include "simulator.h"
+#include "simulator-impl.h"
+#include "abort.h"
+#include "log.h"
+#include "metrics-registry.h"
+#include "ns3/core-config.h"
+
+#include <cstdio>
+#include <iostream>
+#include <map>
+
+#if defined (HAVE_SYS_WAIT_H) && defined (HAVE_UNISTD_H)
+#include <cerrno>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define SIMULATOR_FORK_SUPPORTED 1
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorFork implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SimulatorFork");
+
+bool SimulatorFork::m_isChild = false;
+uint32_t SimulatorFork::m_index = 0;
+std::vector<int> SimulatorFork::m_exitStatus;
+
+bool
+SimulatorFork::IsSupported (void)
+{
+#ifdef SIMULATOR_FORK_SUPPORTED
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool
+SimulatorFork::IsParent (void)
+{
+  return !m_isChild;
+}
+
+uint32_t
+SimulatorFork::GetIndex (void)
+{
+  return m_index;
+}
+
+int
+SimulatorFork::GetExitStatus (uint32_t i)
+{
+  NS_ASSERT_MSG (i < m_exitStatus.size (), "No child " << i);
+  return m_exitStatus[i];
+}
+
+uint32_t
+SimulatorFork::Fork (uint32_t n, uint32_t maxParallel)
+{
+  NS_LOG_FUNCTION (n << maxParallel);
+#ifdef SIMULATOR_FORK_SUPPORTED
+  std::string impl = Simulator::GetImplementation ()->GetInstanceTypeId ().GetName ();
+  NS_ABORT_MSG_UNLESS (impl == "ns3::DefaultSimulatorImpl",
+                       "SimulatorFork::Fork (): cannot fork " << impl);
+  if (maxParallel == 0 || maxParallel > n)
+    {
+      maxParallel = n;
+    }
+
+  // Don't let every child write what the parent has buffered
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+  std::fflush (0);
+
+  m_exitStatus.assign (n, -1);
+  std::map<pid_t, uint32_t> running;
+  uint32_t next = 0;
+  while (next < n || !running.empty ())
+    {
+      if (next < n && running.size () < maxParallel)
+        {
+          pid_t pid = fork ();
+          NS_ABORT_MSG_IF (pid < 0, "SimulatorFork::Fork (): fork failed: "
+                           << std::strerror (errno));
+          if (pid == 0)
+            {
+              m_isChild = true;
+              m_index = next;
+              m_exitStatus.clear ();
+              MetricsRegistry::ReopenInChild ();
+              NS_LOG_LOGIC ("child " << next << " pid " << getpid ());
+              return next;
+            }
+          NS_LOG_LOGIC ("forked child " << next << " pid " << pid);
+          running[pid] = next++;
+          continue;
+        }
+
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          NS_ABORT_MSG_UNLESS (errno == EINTR, "SimulatorFork::Fork (): waitpid failed: "
+                               << std::strerror (errno));
+          continue;
+        }
+      std::map<pid_t, uint32_t>::iterator child = running.find (pid);
+      if (child == running.end ())
+        {
+          continue;
+        }
+      m_exitStatus[child->second] = WIFEXITED (status) ? WEXITSTATUS (status) : -1;
+      NS_LOG_LOGIC ("child " << child->second << " exited with " << m_exitStatus[child->second]);
+      running.erase (child);
+    }
+  m_index = n;
+  return n;
+#else
+  NS_FATAL_ERROR ("SimulatorFork::Fork (): fork () is not supported on this system");
+  return n;
+#endif
+}
+
+} // namespace ns3
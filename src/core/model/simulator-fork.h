@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SIMULATOR_FORK_H
+#define SIMULATOR_FORK_H
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorFork declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Snapshot a simulation by forking the process, and continue
+ * from the snapshot several times.
+ *
+ * Parameter sweeps often share a long warm-up phase (ARP, routing
+ * convergence, TCP slow start) before the measurement period.
+ * Rather than serializing the event queue and object graph,
+ * SimulatorFork relies on the copy-on-write semantics of \c fork():
+ * each child process starts with an exact copy of the simulation state
+ * at the time of the fork, including pending events, and continues
+ * from there independently.
+ *
+ * A typical script runs the warm-up, forks one child per sweep point,
+ * and configures each child according to its index:
+ *
+ * \code
+ *   Simulator::Stop (warmup);
+ *   Simulator::Run ();
+ *   uint32_t point = SimulatorFork::Fork (rates.size ());
+ *   if (SimulatorFork::IsParent ())
+ *     {
+ *       Simulator::Destroy ();
+ *       return 0;
+ *     }
+ *   app->SetAttribute ("DataRate", DataRateValue (rates[point]));
+ *   Simulator::Stop (measurement);
+ *   Simulator::Run ();
+ * \endcode
+ *
+ * Fork() can also be called from within an event, in which case
+ * each child resumes the event loop where the parent left it.
+ *
+ * Some state is shared or duplicated rather than copied:
+ *
+ *   - Streams buffered but not yet written at the time of the fork
+ *     would be written by every child.  Fork() flushes the standard
+ *     streams; trace files should be opened after the fork,
+ *     one per child.
+ *   - Random variable streams continue from the same state in every
+ *     child.  Children which must see different random numbers
+ *     should create or reseed (SetStream) their streams after the fork.
+ *   - A metrics file would be updated by every child.  Fork() moves
+ *     the metrics of each child to a file of its own, see
+ *     MetricsRegistry::ReopenInChild().
+ *
+ * Only the single threaded ns3::DefaultSimulatorImpl can be forked,
+ * on systems which provide \c fork() and \c waitpid().
+ */
+class SimulatorFork
+{
+public:
+  /**
+   * Fork the simulation into \p n children.
+   *
+   * In each child this returns the index of the child,
+   * in the range [0, \p n).  In the parent, it returns \p n after all
+   * the children have exited.  At most \p maxParallel children run at
+   * the same time; zero means no limit.
+   *
+   * \param [in] n The number of children.
+   * \param [in] maxParallel The maximum number of concurrent children.
+   * \returns The child index, or \p n in the parent.
+   */
+  static uint32_t Fork (uint32_t n, uint32_t maxParallel = 0);
+  /**
+   * \returns \c true if this process is not a child
+   *          created by Fork().
+   */
+  static bool IsParent (void);
+  /**
+   * \returns The index of this child, or the number of children
+   *          in the parent.
+   */
+  static uint32_t GetIndex (void);
+  /**
+   * Get the exit status of a child of the last Fork().
+   *
+   * \param [in] i The child index.
+   * \returns The exit code of child \p i, or -1 if it did not
+   *          exit normally.
+   */
+  static int GetExitStatus (uint32_t i);
+  /**
+   * \returns \c true if Fork() is supported on this system.
+   */
+  static bool IsSupported (void);
+
+private:
+  /** Whether this process is a child created by Fork(). */
+  static bool m_isChild;
+  /** The child index, or the number of children in the parent. */
+  static uint32_t m_index;
+  /** The exit status of each child of the last Fork(). */
+  static std::vector<int> m_exitStatus;
+};
+
+} // namespace ns3
+
+#endif /* SIMULATOR_FORK_H */
@@ -105,6 +105,7 @@ public:
   void SetAttributeInitialValue(uint16_t uid,
                                 uint32_t i,
                                 Ptr<const AttributeValue> initialValue);
+  uint32_t GetAttributeGeneration (void) const;
   uint32_t GetAttributeN (uint16_t uid) const;
   struct TypeId::AttributeInformation GetAttribute(uint16_t uid, uint32_t i) const;
   void AddTraceSource (uint16_t uid,
@@ -145,6 +146,9 @@ private:
   typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
   hashmap_t m_hashmap;
 
+  /** Count of attribute additions and initial value changes. */
+  uint32_t m_attributeGeneration;
+
   
   // To handle the first collision, we reserve the high bit as a
   // chain flag:
@@ -152,6 +156,7 @@ private:
 };
 
 IidManager::IidManager ()
+  : m_attributeGeneration (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -435,6 +440,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.accessor = accessor;
   info.checker = checker;
   information->attributes.push_back (info);
+  ++m_attributeGeneration;
 }
 void 
 IidManager::SetAttributeInitialValue(uint16_t uid,
@@ -445,6 +451,14 @@ IidManager::SetAttributeInitialValue(uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  ++m_attributeGeneration;
+}
+
+uint32_t
+IidManager::GetAttributeGeneration (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_attributeGeneration;
 }
 
 
@@ -759,6 +773,13 @@ TypeId::SetAttributeInitialValue(uint32_t i,
   return true;
 }
 
+uint32_t
+TypeId::GetAttributeGeneration (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return Singleton<IidManager>::Get ()->GetAttributeGeneration ();
+}
+
 
 Callback<ObjectBase *> 
 TypeId::GetConstructor (void) const
@@ -303,6 +303,18 @@ public:
   bool SetAttributeInitialValue(uint32_t i, 
                                 Ptr<const AttributeValue> initialValue);
 
+  /**
+   * Get the attribute generation counter.
+   *
+   * The counter is incremented whenever an attribute is added to
+   * any TypeId, or any attribute initial value is changed, for example
+   * by Config::SetDefault.  Code which caches resolved attribute values,
+   * such as ObjectFactory, uses it to detect stale caches.
+   *
+   * \returns The current attribute generation.
+   */
+  static uint32_t GetAttributeGeneration (void);
+
   /**
    * \param name the name of the new attribute
    * \param help some help text which describes the purpose of this
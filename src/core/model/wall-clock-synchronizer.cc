@@ -17,11 +17,13 @@
  */
 
 
+#include <algorithm>   // min
 #include <ctime>       // clock_t
 #include <sys/time.h>  // gettimeofday
                        // clock_getres: glibc < 2.17, link with librt
 
 #include "log.h"
+#include "enum.h"
 #include "system-condition.h"
 
 #include "wall-clock-synchronizer.h"
@@ -44,6 +46,19 @@ WallClockSynchronizer::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::WallClockSynchronizer")
     .SetParent<Synchronizer> ()
     .SetGroupName ("Core")
+    .AddAttribute ("WaitMode",
+                   "How to wait for the next event: sleep, busy-poll, "
+                   "or busy-poll for SpinTime and then sleep.",
+                   EnumValue (WAIT_SLEEP),
+                   MakeEnumAccessor (&WallClockSynchronizer::m_waitMode),
+                   MakeEnumChecker (WAIT_SLEEP, "Sleep",
+                                    WAIT_BUSY_POLL, "BusyPoll",
+                                    WAIT_HYBRID, "Hybrid"))
+    .AddAttribute ("SpinTime",
+                   "The time to busy-poll before sleeping, in Hybrid WaitMode.",
+                   TimeValue (MicroSeconds (100)),
+                   MakeTimeAccessor (&WallClockSynchronizer::m_spinTime),
+                   MakeTimeChecker (Time (0)))
   ;
   return tid;
 }
@@ -189,9 +204,28 @@ WallClockSynchronizer::DoSynchronize (uint64_t nsCurrent, uint64_t nsDelay)
 // hand, print warning messages, or just ignore the situation and hope it will
 // go away.
 //
+  if (m_waitMode == WAIT_BUSY_POLL)
+    {
+      return SpinWait (nsCurrent + nsDelay);
+    }
+
   uint64_t ns = DriftCorrect (nsCurrent, nsDelay);
   NS_LOG_INFO ("Synchronize ns = " << ns);
 //
+// In hybrid mode we first poll for a while, since an external event is
+// likely to come soon after the last one, and only then go to sleep.
+//
+  if (m_waitMode == WAIT_HYBRID)
+    {
+      uint64_t spin = std::min (ns, (uint64_t)m_spinTime.GetNanoSeconds ());
+      if (SpinWait (GetNormalizedRealtime () + spin) == false)
+        {
+          NS_LOG_INFO ("SpinWait interrupted");
+          return false;
+        }
+      ns -= spin;
+    }
+//
 // Once we've decided on how long we need to delay, we need to split this
 // time into sleep waits and busy waits.  The reason for this is described
 // in the comments for the constructor where jiffies and jiffy resolution is
@@ -287,7 +321,11 @@ WallClockSynchronizer::DoSignal (void)
   NS_LOG_FUNCTION (this);
 
   m_condition.SetCondition (true);
-  m_condition.Signal ();
+  // Nobody sleeps on the condition in busy-poll mode
+  if (m_waitMode != WAIT_BUSY_POLL)
+    {
+      m_condition.Signal ();
+    }
 }
 
 void
@@ -21,6 +21,7 @@
 
 #include "system-condition.h"
 #include "synchronizer.h"
+#include "nstime.h"
 
 /**
  * \file
@@ -59,6 +60,14 @@ namespace ns3 {
  *
  * \todo Add more on jiffies, sleep, processes, etc.
  *
+ * The WaitMode attribute trades CPU time for wakeup latency.
+ * In the default Sleep mode we sleep for all but the last few jiffies
+ * of each wait.  In BusyPoll mode we never sleep, and notice events
+ * scheduled by other threads as soon as they are inserted, at the cost
+ * of a fully loaded core.  Hybrid mode polls for up to SpinTime before
+ * falling back to the Sleep behavior, which catches the bursts of
+ * packets typical of emulation without spinning while idle.
+ *
  * \internal
  * Nanosleep takes a <tt>struct timeval</tt> as an input so we have to
  * deal with conversion between Time and \c timeval here.
@@ -73,6 +82,16 @@ public:
    */
   static TypeId GetTypeId (void);
 
+  /** How to wait for the next event. */
+  enum WaitMode {
+    /** Sleep, then busy-wait the last few jiffies. */
+    WAIT_SLEEP,
+    /** Busy-wait, never sleep. */
+    WAIT_BUSY_POLL,
+    /** Busy-wait up to the SpinTime, then as WAIT_SLEEP. */
+    WAIT_HYBRID
+  };
+
   /** Constructor. */
   WallClockSynchronizer ();
   /** Destructor. */
@@ -193,6 +212,11 @@ protected:
 
   /** Thread synchronizer. */
   SystemCondition m_condition;
+
+  /** How to wait for the next event. */
+  WaitMode m_waitMode;
+  /** In WAIT_HYBRID mode, the time to busy-wait before sleeping. */
+  Time m_spinTime;
 };
 
 } // namespace ns3
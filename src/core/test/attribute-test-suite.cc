@@ -1372,6 +1372,77 @@ CallbackValueTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_gotCbValue, 2, "Callback Attribute set to null callback unexpectedly fired");
 }
 
+// ===========================================================================
+// Test that ObjectFactory constructs each object with the same attribute
+// values as CreateObject, including after the initial values change.
+// ===========================================================================
+class ObjectFactoryAttributeTestCase : public TestCase
+{
+public:
+  ObjectFactoryAttributeTestCase (std::string description);
+  virtual ~ObjectFactoryAttributeTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+ObjectFactoryAttributeTestCase::ObjectFactoryAttributeTestCase (std::string description)
+  : TestCase (description)
+{
+}
+
+void
+ObjectFactoryAttributeTestCase::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::AttributeObjectTest");
+  factory.Set ("TestUint8", UintegerValue (5));
+
+  Ptr<AttributeObjectTest> a = factory.Create<AttributeObjectTest> ();
+  Ptr<AttributeObjectTest> b = factory.Create<AttributeObjectTest> ();
+  NS_TEST_ASSERT_MSG_NE (a, 0, "Unable to factory.Create() an AttributeObjectTest");
+  NS_TEST_ASSERT_MSG_NE (b, 0, "Unable to factory.Create() an AttributeObjectTest");
+
+  UintegerValue uv;
+  b->GetAttribute ("TestUint8", uv);
+  NS_TEST_ASSERT_MSG_EQ (uv.Get (), 5, "Factory parameter not applied to second object");
+
+  IntegerValue iv;
+  b->GetAttribute ("TestInt16SetGet", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 6, "Initial value not applied through a setter");
+
+  //
+  // Initial values given as strings must still be converted for each
+  // object, so each object gets its own Derived instance.
+  //
+  PointerValue pa, pb;
+  a->GetAttribute ("PointerInitialized", pa);
+  b->GetAttribute ("PointerInitialized", pb);
+  NS_TEST_ASSERT_MSG_NE (pa.Get<Derived> (), 0, "PointerInitialized not created");
+  NS_TEST_ASSERT_MSG_NE (pa.Get<Derived> (), pb.Get<Derived> (),
+                         "Objects from one factory share a PointerInitialized instance");
+
+  //
+  // Changing an initial value after the first Create () must be
+  // seen by the next object.
+  //
+  Config::SetDefault ("ns3::AttributeObjectTest::TestInt16", IntegerValue (4));
+  Ptr<AttributeObjectTest> c = factory.Create<AttributeObjectTest> ();
+  c->GetAttribute ("TestInt16", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), 4, "Changed initial value not seen by ObjectFactory");
+  Config::SetDefault ("ns3::AttributeObjectTest::TestInt16", IntegerValue (-2));
+
+  //
+  // So must changes to the factory parameters.
+  //
+  factory.Set ("TestUint8", UintegerValue (7));
+  c = factory.Create<AttributeObjectTest> ();
+  c->GetAttribute ("TestUint8", uv);
+  NS_TEST_ASSERT_MSG_EQ (uv.Get (), 7, "Changed factory parameter not applied");
+  c->GetAttribute ("TestInt16", iv);
+  NS_TEST_ASSERT_MSG_EQ (iv.Get (), -2, "Restored initial value not seen by ObjectFactory");
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -1395,6 +1466,7 @@ AttributesTestSuite::AttributesTestSuite ()
   AddTestCase (new ObjectMapAttributeTestCase ("Check Attributes of type ObjectMapValue"), TestCase::QUICK);
   AddTestCase (new PointerAttributeTestCase ("Check Attributes of type PointerValue"), TestCase::QUICK);
   AddTestCase (new CallbackValueTestCase ("Check Attributes of type CallbackValue"), TestCase::QUICK);
+  AddTestCase (new ObjectFactoryAttributeTestCase ("Check Attributes set through ObjectFactory"), TestCase::QUICK);
   AddTestCase (new IntegerTraceSourceAttributeTestCase ("Ensure TracedValue<uint8_t> can be set like IntegerValue"), TestCase::QUICK);
   AddTestCase (new IntegerTraceSourceTestCase ("Ensure TracedValue<uint8_t> also works as trace source"), TestCase::QUICK);
   AddTestCase (new TracedCallbackTestCase ("Ensure TracedCallback<double, int, float> works as trace source"), TestCase::QUICK);
@@ -483,6 +483,23 @@ Int64x64ArithmeticTestCase::DoRun (void)
   // Check special values
   Check (51,  int64x64_t (0, 0x159fa87f8aeaad21ULL) * 10,
 	           int64x64_t (0, 0xd83c94fb6d2ac34aULL));
+
+  // Operands on either side of the inline integer fast paths
+  const int64x64_t half (0, 0x8000000000000000ULL);
+  const int64x64_t big  (1LL << 40, 0x1234);
+  const int64x64_t wide (1LL << 31, 0);
+  
+  Check (52,   (thre + half) * 7,  int64x64_t (24, 0x8000000000000000ULL));
+  Check (53,   7 * (-thre - half), int64x64_t (-25, 0x8000000000000000ULL));
+  Check (54,   big * 3,            int64x64_t (3LL << 40, 0x369c));
+  Check (55,   3 * big,            int64x64_t (3LL << 40, 0x369c));
+  Check (56,   wide * 3,           int64x64_t (3LL << 31, 0));
+  Check (57,   wide * wide,        int64x64_t (1LL << 62, 0));
+  Check (58,   one / thre,         int64x64_t (0, 0x5555555555555555ULL), tol1);
+  Check (59,   -one / thre,       -int64x64_t (0, 0x5555555555555555ULL), tol1);
+  Check (60,   int64x64_t (-7) / 2,        -thre - half);
+  Check (61,   (thre + half) / (-one),    -thre - half);
+  Check (62,   int64x64_t (12) / int64x64_t (-4),  -thre);
   
 }
 
@@ -0,0 +1,359 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "ns3/test.h"
+#include "ns3/core-config.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined (HAVE_SYS_WAIT_H) && defined (HAVE_UNISTD_H)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define LOG_TEST_FORK_SUPPORTED 1
+#endif
+
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include <vector>
+#endif
+
+/**
+ * \file
+ * \ingroup logging-tests
+ * Log sink and rate limit test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup logging-tests Logging tests
+ */
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LogTestSuiteComponent");
+
+namespace {
+
+/**
+ * Read a whole file.
+ *
+ * \param [in] fileName The file name.
+ * \returns The content of the file.
+ */
+std::string
+ReadFile (const std::string &fileName)
+{
+  std::ifstream file (fileName.c_str ());
+  std::ostringstream content;
+  content << file.rdbuf ();
+  return content.str ();
+}
+
+/**
+ * Count the lines of a string.
+ *
+ * \param [in] s The string.
+ * \returns The number of new line characters.
+ */
+uint32_t
+CountLines (const std::string &s)
+{
+  uint32_t lines = 0;
+  for (std::string::size_type i = 0; i < s.size (); i++)
+    {
+      if (s[i] == '\n')
+        {
+          lines++;
+        }
+    }
+  return lines;
+}
+
+} // anonymous namespace
+
+
+/**
+ * \ingroup logging-tests
+ * Check that the asynchronous log sink writes all the messages, in
+ * order, including those wrapping around its ring buffer.
+ */
+class LogAsyncSinkTestCase : public TestCase
+{
+public:
+  LogAsyncSinkTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+LogAsyncSinkTestCase::LogAsyncSinkTestCase ()
+  : TestCase ("Check the asynchronous log sink")
+{
+}
+
+void
+LogAsyncSinkTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("log-sink.txt");
+  LogComponentEnable ("LogTestSuiteComponent", LOG_LEVEL_INFO);
+  // A small ring buffer, so that the messages wrap around
+  LogEnableAsyncSink (fileName, 64);
+
+  std::ostringstream expected;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      NS_LOG_INFO ("message " << i);
+      expected << "message " << i << std::endl;
+    }
+  LogFlushAsyncSink ();
+  NS_TEST_EXPECT_MSG_EQ (ReadFile (fileName), expected.str (),
+                         "The flushed messages differ");
+
+  NS_LOG_INFO ("last message");
+  expected << "last message" << std::endl;
+  LogDisableAsyncSink ();
+  LogComponentDisable ("LogTestSuiteComponent", LOG_LEVEL_INFO);
+  NS_TEST_EXPECT_MSG_EQ (ReadFile (fileName), expected.str (),
+                         "The messages written at the end differ");
+}
+
+
+/**
+ * \ingroup logging-tests
+ * Check that the messages of the asynchronous log sink logged just
+ * before a fatal error are written, whether the sink was enabled by
+ * the crashing process or by its parent before the fork.
+ */
+class LogAsyncSinkFatalTestCase : public TestCase
+{
+public:
+  LogAsyncSinkFatalTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Log some messages, then stop on a fatal error, in a child process.
+   * \param [in] fileName The log file, or "" if the sink is already enabled.
+   */
+  void CrashChild (const std::string &fileName);
+};
+
+LogAsyncSinkFatalTestCase::LogAsyncSinkFatalTestCase ()
+  : TestCase ("Check the asynchronous log sink on a fatal error")
+{
+}
+
+void
+LogAsyncSinkFatalTestCase::CrashChild (const std::string &fileName)
+{
+#ifdef LOG_TEST_FORK_SUPPORTED
+  pid_t pid = fork ();
+  if (pid == 0)
+    {
+      // Keep the fatal error message out of the test output
+      if (std::freopen ("/dev/null", "w", stderr) == 0)
+        {
+          _exit (1);
+        }
+      if (!fileName.empty ())
+        {
+          LogEnableAsyncSink (fileName);
+        }
+      for (uint32_t i = 0; i < 100; i++)
+        {
+          NS_LOG_INFO ("message " << i);
+        }
+      NS_LOG_INFO ("last message");
+      NS_FATAL_ERROR ("fatal error after the last message");
+      _exit (0);
+    }
+  NS_TEST_ASSERT_MSG_GT (pid, 0, "fork failed");
+  int status;
+  NS_TEST_ASSERT_MSG_EQ (waitpid (pid, &status, 0), pid, "waitpid failed");
+  NS_TEST_EXPECT_MSG_EQ (WIFSIGNALED (status), true, "The child did not abort");
+#endif
+}
+
+void
+LogAsyncSinkFatalTestCase::DoRun (void)
+{
+#ifdef LOG_TEST_FORK_SUPPORTED
+  std::ostringstream expected;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      expected << "message " << i << std::endl;
+    }
+  expected << "last message" << std::endl;
+  LogComponentEnable ("LogTestSuiteComponent", LOG_LEVEL_INFO);
+
+  // The child enables the sink, whose thread may not run before the crash
+  std::string fileName = CreateTempDirFilename ("log-fatal.txt");
+  CrashChild (fileName);
+  NS_TEST_EXPECT_MSG_EQ (ReadFile (fileName), expected.str (),
+                         "The messages before the fatal error were lost");
+
+  // The child inherits the sink, without its thread
+  std::string forkFileName = CreateTempDirFilename ("log-fatal-fork.txt");
+  LogEnableAsyncSink (forkFileName);
+  NS_LOG_INFO ("parent message");
+  LogFlushAsyncSink ();
+  CrashChild ("");
+  LogDisableAsyncSink ();
+  LogComponentDisable ("LogTestSuiteComponent", LOG_LEVEL_INFO);
+  NS_TEST_EXPECT_MSG_EQ (ReadFile (forkFileName), "parent message\n" + expected.str (),
+                         "The messages of the forked child were lost");
+#endif
+}
+
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * \ingroup logging-tests
+ * Check that the messages of threads which exit are written.
+ */
+class LogAsyncSinkThreadsTestCase : public TestCase
+{
+public:
+  LogAsyncSinkThreadsTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Log some messages from a thread.
+   * \param [in] index The index of the thread.
+   */
+  static void LogMessages (uint32_t index);
+};
+
+LogAsyncSinkThreadsTestCase::LogAsyncSinkThreadsTestCase ()
+  : TestCase ("Check the asynchronous log sink with threads which exit")
+{
+}
+
+void
+LogAsyncSinkThreadsTestCase::LogMessages (uint32_t index)
+{
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      NS_LOG_INFO ("thread " << index << " message " << i);
+    }
+}
+
+void
+LogAsyncSinkThreadsTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("log-threads.txt");
+  LogComponentEnable ("LogTestSuiteComponent", LOG_LEVEL_INFO);
+  LogEnableAsyncSink (fileName, 256);
+
+  // Two rounds, so that the rings of the first threads are freed while
+  // the second ones log
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      std::vector<Ptr<SystemThread> > threads;
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          threads.push_back (Create<SystemThread> (MakeBoundCallback (&LogMessages, round * 4 + i)));
+          threads.back ()->Start ();
+        }
+      for (uint32_t i = 0; i < threads.size (); i++)
+        {
+          threads[i]->Join ();
+        }
+    }
+  LogFlushAsyncSink ();
+  std::string content = ReadFile (fileName);
+  LogDisableAsyncSink ();
+  LogComponentDisable ("LogTestSuiteComponent", LOG_LEVEL_INFO);
+
+  NS_TEST_EXPECT_MSG_EQ (CountLines (content), 800u, "Messages of the threads were lost");
+  NS_TEST_EXPECT_MSG_NE (content.find ("thread 7 message 99\n"), std::string::npos,
+                         "The last message of the last thread was lost");
+}
+#endif /* HAVE_PTHREAD_H */
+
+
+/**
+ * \ingroup logging-tests
+ * Check that the messages beyond the rate limit of a component are
+ * dropped.
+ */
+class LogRateLimitTestCase : public TestCase
+{
+public:
+  LogRateLimitTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+LogRateLimitTestCase::LogRateLimitTestCase ()
+  : TestCase ("Check the log rate limit")
+{
+}
+
+void
+LogRateLimitTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("log-rate.txt");
+  LogComponentEnable ("LogTestSuiteComponent", LOG_LEVEL_INFO);
+  LogComponentSetRateLimit ("LogTestSuiteComponent", 5);
+  LogEnableAsyncSink (fileName);
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      NS_LOG_INFO ("message " << i);
+    }
+  LogDisableAsyncSink ();
+  LogComponentSetRateLimit ("LogTestSuiteComponent", 0);
+  LogComponentDisable ("LogTestSuiteComponent", LOG_LEVEL_INFO);
+
+  // The messages of a second are expected, unless the loop ran across
+  // the end of the window
+  std::string content = ReadFile (fileName);
+  NS_TEST_EXPECT_MSG_EQ (content.compare (0, 20, "message 0\nmessage 1\n"), 0,
+                         "The first messages are missing");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (CountLines (content), 11u,
+                               "Too many messages within the rate limit");
+}
+
+
+/**
+ * \ingroup logging-tests
+ * Log test suite.
+ */
+class LogTestSuite : public TestSuite
+{
+public:
+  LogTestSuite ();
+};
+
+LogTestSuite::LogTestSuite ()
+  : TestSuite ("log", UNIT)
+{
+#ifdef NS3_LOG_ENABLE
+  AddTestCase (new LogAsyncSinkTestCase, TestCase::QUICK);
+  AddTestCase (new LogAsyncSinkFatalTestCase, TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new LogAsyncSinkThreadsTestCase, TestCase::QUICK);
+#endif
+  AddTestCase (new LogRateLimitTestCase, TestCase::QUICK);
+#endif
+}
+
+static LogTestSuite g_logTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/metrics-registry.h"
+#include "ns3/simulator.h"
+#include "ns3/traced-value.h"
+#include "ns3/callback.h"
+#include "ns3/test.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup metrics-tests
+ * Live metrics test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup metrics-tests Live metrics tests
+ */
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * Read a metric from a metrics file, as an external tool would.
+ *
+ * \param [in] fileName The metrics file.
+ * \param [in] name The name of the metric.
+ * \param [out] slot The slot of the metric.
+ * \returns \c true if the metric was found.
+ */
+bool
+ReadMetric (const std::string &fileName, const std::string &name, MetricSlot &slot)
+{
+  std::ifstream file (fileName.c_str (), std::ios::binary);
+  uint32_t header[4];
+  if (!file.read (reinterpret_cast<char *> (header), sizeof (header))
+      || header[0] != 0x6e736d72)
+    {
+      return false;
+    }
+  uint32_t n = header[3];
+  file.seekg (64);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (!file.read (reinterpret_cast<char *> (&slot), sizeof (slot)))
+        {
+          return false;
+        }
+      if (name == slot.name)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+} // anonymous namespace
+
+
+/**
+ * \ingroup metrics-tests
+ * Check the registration and the updates of the metrics, and their
+ * file.
+ */
+class MetricsRegistryTestCase : public TestCase
+{
+public:
+  MetricsRegistryTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+MetricsRegistryTestCase::MetricsRegistryTestCase ()
+  : TestCase ("Check the metrics and their file")
+{
+}
+
+void
+MetricsRegistryTestCase::DoRun (void)
+{
+  Metric counter ("test/counter");
+  Metric gauge ("test/gauge", Metric::GAUGE);
+  Metric same ("test/counter");
+  counter.Increment ();
+  counter.Add (10);
+  same.Increment ();
+  gauge.Set (2.5);
+  NS_TEST_EXPECT_MSG_EQ (counter.GetCount (), 12, "The handles do not share the counter");
+  NS_TEST_EXPECT_MSG_EQ (counter.GetName (), "test/counter", "Wrong name");
+  NS_TEST_EXPECT_MSG_EQ (gauge.GetValue (), 2.5, "Wrong gauge");
+
+  TracedValue<uint32_t> depth;
+  depth.ConnectWithoutContext (MakeCallback (&Metric::TraceValue<uint32_t>, &gauge));
+  depth = 7;
+  NS_TEST_EXPECT_MSG_EQ (gauge.GetValue (), 7, "The gauge does not follow the traced value");
+
+  std::string fileName = CreateTempDirFilename ("metrics");
+  MetricsRegistry::Enable (fileName);
+  NS_TEST_EXPECT_MSG_EQ (MetricsRegistry::GetFileName (), fileName, "Wrong file name");
+  MetricSlot slot;
+  NS_TEST_ASSERT_MSG_EQ (ReadMetric (fileName, "test/counter", slot), true,
+                         "The counter is not in the file");
+  NS_TEST_EXPECT_MSG_EQ (slot.type, Metric::COUNTER, "Wrong type");
+  NS_TEST_EXPECT_MSG_EQ (slot.count, 12, "Wrong counter in the file");
+
+  // The updates after the mapping go to the file, for the old handles
+  // and the new metrics alike
+  counter.Add (30);
+  Metric late ("test/late", Metric::GAUGE);
+  late.Set (-1);
+  NS_TEST_ASSERT_MSG_EQ (ReadMetric (fileName, "test/counter", slot), true,
+                         "The counter is not in the file");
+  NS_TEST_EXPECT_MSG_EQ (slot.count, 42, "The counter is not updated in the file");
+  NS_TEST_ASSERT_MSG_EQ (ReadMetric (fileName, "test/late", slot), true,
+                         "The new gauge is not in the file");
+  NS_TEST_EXPECT_MSG_EQ (slot.value, -1, "The gauge is not updated in the file");
+}
+
+
+/**
+ * \ingroup metrics-tests
+ * Check the metrics of the simulator.
+ */
+class MetricsSimulatorTestCase : public TestCase
+{
+public:
+  MetricsSimulatorTestCase ();
+private:
+  virtual void DoRun (void);
+  /** An event doing nothing. */
+  void Event (void);
+};
+
+MetricsSimulatorTestCase::MetricsSimulatorTestCase ()
+  : TestCase ("Check the metrics of the simulator")
+{
+}
+
+void
+MetricsSimulatorTestCase::Event (void)
+{
+}
+
+void
+MetricsSimulatorTestCase::DoRun (void)
+{
+  Simulator::Schedule (Seconds (1), &MetricsSimulatorTestCase::Event, this);
+  Simulator::Schedule (Seconds (2), &MetricsSimulatorTestCase::Event, this);
+  Simulator::Schedule (Seconds (3), &MetricsSimulatorTestCase::Event, this);
+  Metric events ("simulator/events");
+  Metric pending ("simulator/pending-events", Metric::GAUGE);
+  Metric time ("simulator/time-steps");
+  int64_t start = events.GetCount ();
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (events.GetCount () - start, 3, "Wrong event count");
+  NS_TEST_EXPECT_MSG_EQ (pending.GetValue (), 0, "Wrong pending event count");
+  NS_TEST_EXPECT_MSG_EQ (time.GetCount (), Seconds (3).GetTimeStep (), "Wrong simulation time");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup metrics-tests
+ * Live metrics test suite.
+ */
+class MetricsRegistryTestSuite : public TestSuite
+{
+public:
+  MetricsRegistryTestSuite ();
+};
+
+MetricsRegistryTestSuite::MetricsRegistryTestSuite ()
+  : TestSuite ("metrics-registry", UNIT)
+{
+  AddTestCase (new MetricsRegistryTestCase, TestCase::QUICK);
+  AddTestCase (new MetricsSimulatorTestCase, TestCase::QUICK);
+}
+
+static MetricsRegistryTestSuite g_metricsRegistryTestSuite; //!< Static variable for test initialization
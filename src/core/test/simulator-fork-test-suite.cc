@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/simulator-fork.h"
+#include "ns3/simulator.h"
+#include "ns3/metrics-registry.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+#include "ns3/core-config.h"
+
+#include <sstream>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+using namespace ns3;
+
+class SimulatorForkTestCase : public TestCase
+{
+public:
+  SimulatorForkTestCase ();
+  virtual void DoRun (void);
+  void Tick (void);
+  uint32_t m_ticks;
+};
+
+SimulatorForkTestCase::SimulatorForkTestCase ()
+  : TestCase ("Check that forked children continue from the parent state")
+{
+}
+
+void
+SimulatorForkTestCase::Tick (void)
+{
+  ++m_ticks;
+  Simulator::Schedule (Seconds (1), &SimulatorForkTestCase::Tick, this);
+}
+
+void
+SimulatorForkTestCase::DoRun (void)
+{
+#ifdef HAVE_UNISTD_H
+  if (!SimulatorFork::IsSupported ())
+    {
+      return;
+    }
+  const uint32_t n = 3;
+  m_ticks = 0;
+  Simulator::Schedule (Seconds (1), &SimulatorForkTestCase::Tick, this);
+  Simulator::Stop (Seconds (5.5));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_ticks, 5, "Warm-up did not run to completion");
+
+  // Child i runs i + 1 more ticks and reports the total as its exit code
+  uint32_t index = SimulatorFork::Fork (n, 2);
+  if (!SimulatorFork::IsParent ())
+    {
+      Simulator::Stop (Seconds (index + 1));
+      Simulator::Run ();
+      _exit (m_ticks);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (index, n, "Parent did not get the number of children");
+  NS_TEST_ASSERT_MSG_EQ (SimulatorFork::GetIndex (), n, "Parent index is not the number of children");
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (SimulatorFork::GetExitStatus (i), (int)(5 + i + 1),
+                             "Child " << i << " did not continue from the snapshot");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_ticks, 5, "Children changed the parent state");
+  Simulator::Destroy ();
+#endif /* HAVE_UNISTD_H */
+}
+
+class SimulatorForkMetricsTestCase : public TestCase
+{
+public:
+  SimulatorForkMetricsTestCase ();
+  virtual void DoRun (void);
+  void Tick (void);
+};
+
+SimulatorForkMetricsTestCase::SimulatorForkMetricsTestCase ()
+  : TestCase ("Check that forked children do not update the metrics of the parent")
+{
+}
+
+void
+SimulatorForkMetricsTestCase::Tick (void)
+{
+  Simulator::Schedule (Seconds (1), &SimulatorForkMetricsTestCase::Tick, this);
+}
+
+void
+SimulatorForkMetricsTestCase::DoRun (void)
+{
+#ifdef HAVE_UNISTD_H
+  if (!SimulatorFork::IsSupported ())
+    {
+      return;
+    }
+  std::string fileName = CreateTempDirFilename ("metrics");
+  MetricsRegistry::Enable (fileName);
+  Metric events ("simulator/events");
+  Simulator::Schedule (Seconds (1), &SimulatorForkMetricsTestCase::Tick, this);
+  Simulator::Stop (Seconds (5.5));
+  Simulator::Run ();
+  int64_t count = events.GetCount ();
+
+  // Each child checks that it counts its events in a file of its own
+  const uint32_t n = 2;
+  SimulatorFork::Fork (n);
+  if (!SimulatorFork::IsParent ())
+    {
+      std::ostringstream oss;
+      oss << fileName << "." << getpid ();
+      bool ok = MetricsRegistry::GetFileName () == oss.str ()
+        && events.GetCount () == count;
+      Simulator::Stop (Seconds (10));
+      Simulator::Run ();
+      ok = ok && events.GetCount () > count;
+      unlink (oss.str ().c_str ());
+      _exit (ok ? 0 : 1);
+    }
+
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (SimulatorFork::GetExitStatus (i), 0,
+                             "Child " << i << " did not move its metrics to its own file");
+    }
+  NS_TEST_ASSERT_MSG_EQ (MetricsRegistry::GetFileName (), fileName, "The parent file changed");
+  NS_TEST_ASSERT_MSG_EQ (events.GetCount (), count, "Children changed the parent metrics");
+  Simulator::Destroy ();
+#endif /* HAVE_UNISTD_H */
+}
+
+static class SimulatorForkTestSuite : public TestSuite
+{
+public:
+  SimulatorForkTestSuite ()
+    : TestSuite ("simulator-fork", UNIT)
+  {
+    AddTestCase (new SimulatorForkTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorForkMetricsTestCase (), TestCase::QUICK);
+  }
+} g_simulatorForkTestSuite;
@@ -23,6 +23,13 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/event-profiler.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/string.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -459,6 +466,144 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorProfileTestCase : public TestCase
+{
+public:
+  SimulatorProfileTestCase ();
+  virtual void DoRun (void);
+  void Member (void);
+  static void Function (int i);
+  /** Make one heap allocation. */
+  void Allocate (void);
+  /**
+   * Find the count of a line of a profile report section.
+   * \param [in] file The report file name.
+   * \param [in] section The section title.
+   * \param [in] name The line name.
+   * \param [in] column The column of the count.
+   * \returns The count, or 0 if the line is not found.
+   */
+  static uint64_t GetCount (std::string file, std::string section, std::string name,
+                            uint32_t column = 0);
+
+  std::vector<char *> m_buffers; //!< The buffers allocated by Allocate()
+};
+
+SimulatorProfileTestCase::SimulatorProfileTestCase ()
+  : TestCase ("Check the event profiler accounting")
+{
+}
+
+void
+SimulatorProfileTestCase::Allocate (void)
+{
+  m_buffers.push_back (new char[16]);
+}
+
+void
+SimulatorProfileTestCase::Member (void)
+{
+}
+
+void
+SimulatorProfileTestCase::Function (int i)
+{
+}
+
+uint64_t
+SimulatorProfileTestCase::GetCount (std::string file, std::string section, std::string name,
+                                    uint32_t column)
+{
+  std::ifstream is (file.c_str ());
+  std::string line;
+  bool inSection = false;
+  while (std::getline (is, line))
+    {
+      if (line.size () > 0 && line[0] == '#')
+        {
+          inSection = (line == "# " + section);
+          continue;
+        }
+      std::string::size_type pos = line.find ("%  ");
+      if (inSection && pos != std::string::npos && line.substr (pos + 3) == name)
+        {
+          std::istringstream iss (line);
+          std::string skip;
+          for (uint32_t i = 0; i < column; ++i)
+            {
+              iss >> skip;
+            }
+          uint64_t count = 0;
+          iss >> count;
+          return count;
+        }
+    }
+  return 0;
+}
+
+void
+SimulatorProfileTestCase::DoRun (void)
+{
+  EventImpl *ev = MakeEvent (&SimulatorProfileTestCase::Member, this);
+  NS_TEST_EXPECT_MSG_EQ (EventProfiler::GetTargetName (ev), "void (SimulatorProfileTestCase::*)()",
+                         "Wrong member function target name");
+  ev->Unref ();
+  ev = MakeEvent (&SimulatorProfileTestCase::Function, 1);
+  NS_TEST_EXPECT_MSG_EQ (EventProfiler::GetTargetName (ev), "void (*)(int)",
+                         "Wrong function target name");
+  ev->Unref ();
+
+  std::string file = CreateTempDirFilename ("profile.txt");
+  Simulator::GetImplementation ()->SetAttribute ("ProfileFile", StringValue (file));
+  for (int i = 0; i < 3; ++i)
+    {
+      Simulator::Schedule (Seconds (i), &SimulatorProfileTestCase::Member, this);
+    }
+  Simulator::ScheduleWithContext (1, Seconds (1), &SimulatorProfileTestCase::Function, 1);
+  Simulator::ScheduleWithContext (1, Seconds (2), &SimulatorProfileTestCase::Function, 2);
+  m_buffers.reserve (2);
+  for (int i = 0; i < 2; ++i)
+    {
+      Simulator::ScheduleWithContext (2, Seconds (i), &SimulatorProfileTestCase::Allocate, this);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  for (std::vector<char *>::iterator i = m_buffers.begin (); i != m_buffers.end (); ++i)
+    {
+      delete [] *i;
+    }
+  m_buffers.clear ();
+
+  NS_TEST_EXPECT_MSG_EQ (GetCount (file, "callback target", "void (SimulatorProfileTestCase::*)()"), 5,
+                         "Wrong member function event count");
+  NS_TEST_EXPECT_MSG_EQ (GetCount (file, "callback target", "void (*)(int)"), 2,
+                         "Wrong function event count");
+  NS_TEST_EXPECT_MSG_EQ (GetCount (file, "context", "no context"), 3,
+                         "Wrong event count without context");
+  NS_TEST_EXPECT_MSG_EQ (GetCount (file, "context", "node 1"), 2,
+                         "Wrong event count in context 1");
+  if (EventProfiler::IsCountingAllocations ())
+    {
+      // The columns are count, total, mean, allocs, allocs/ev, share
+      NS_TEST_EXPECT_MSG_EQ (GetCount (file, "context", "node 2", 3), 2,
+                             "Wrong heap allocation count in context 2");
+      NS_TEST_EXPECT_MSG_EQ (GetCount (file, "context", "no context", 3), 0,
+                             "Wrong heap allocation count without context");
+    }
+
+  std::ifstream folded ((file + ".folded").c_str ());
+  std::string line;
+  uint32_t stacks = 0;
+  while (std::getline (folded, line))
+    {
+      NS_TEST_EXPECT_MSG_EQ ((line.find ("no context;") == 0 || line.find ("node 1;") == 0
+                              || line.find ("node 2;") == 0), true,
+                             "Unexpected folded stack " << line);
+      ++stacks;
+    }
+  NS_TEST_EXPECT_MSG_EQ (stacks, 3, "Wrong number of folded stacks");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +620,6 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorProfileTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -38,7 +38,8 @@ using namespace ns3;
 class ThreadedSimulatorEventsTestCase : public TestCase
 {
 public:
-  ThreadedSimulatorEventsTestCase (ObjectFactory schedulerFactory, const std::string &simulatorType, unsigned int threads);
+  ThreadedSimulatorEventsTestCase (ObjectFactory schedulerFactory, const std::string &simulatorType, unsigned int threads,
+                                   const std::string &waitMode = "");
   void EventA (int a);
   void EventB (int b);
   void EventC (int c);
@@ -55,6 +56,7 @@ public:
   bool m_stop;
   ObjectFactory m_schedulerFactory;
   std::string m_simulatorType;
+  std::string m_waitMode;
   std::string m_error;
   std::list<Ptr<SystemThread> > m_threadlist;
 
@@ -64,12 +66,15 @@ private:
   virtual void DoTeardown (void);
 };
 
-ThreadedSimulatorEventsTestCase::ThreadedSimulatorEventsTestCase (ObjectFactory schedulerFactory, const std::string &simulatorType, unsigned int threads)
+ThreadedSimulatorEventsTestCase::ThreadedSimulatorEventsTestCase (ObjectFactory schedulerFactory, const std::string &simulatorType, unsigned int threads,
+                                                                  const std::string &waitMode)
   : TestCase ("Check that threaded event handling is working with " + 
-              schedulerFactory.GetTypeId ().GetName () + " in " + simulatorType),
+              schedulerFactory.GetTypeId ().GetName () + " in " + simulatorType +
+              (waitMode.empty () ? "" : " (" + waitMode + ")")),
     m_threads (threads),
     m_schedulerFactory (schedulerFactory),
-    m_simulatorType (simulatorType)
+    m_simulatorType (simulatorType),
+    m_waitMode (waitMode)
 {
 }
 
@@ -178,6 +183,10 @@ ThreadedSimulatorEventsTestCase::DoSetup (void)
     {
       Config::SetGlobal ("SimulatorImplementationType", StringValue (m_simulatorType));
     }
+  if (!m_waitMode.empty ())
+    {
+      Config::SetDefault ("ns3::WallClockSynchronizer::WaitMode", StringValue (m_waitMode));
+    }
   
   m_error = "";
   
@@ -200,6 +209,10 @@ ThreadedSimulatorEventsTestCase::DoTeardown (void)
   m_threadlist.clear();
  
   Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  if (!m_waitMode.empty ())
+    {
+      Config::SetDefault ("ns3::WallClockSynchronizer::WaitMode", StringValue ("Sleep"));
+    }
 }
 void 
 ThreadedSimulatorEventsTestCase::DoRun (void)
@@ -262,5 +275,19 @@ public:
               }
           }
       }
+#ifdef HAVE_RT
+    std::string waitModes[] = {
+      "BusyPoll",
+      "Hybrid"
+    };
+    factory.SetTypeId ("ns3::HeapScheduler");
+    for (unsigned int i=0; i < (sizeof(waitModes) / sizeof(waitModes[0])); ++i)
+      {
+        for (unsigned int j=1; j < (sizeof(threadcounts) / sizeof(threadcounts[0])); ++j)
+          {
+            AddTestCase (new ThreadedSimulatorEventsTestCase (factory, "ns3::RealtimeSimulatorImpl", threadcounts[j], waitModes[i]), TestCase::QUICK);
+          }
+      }
+#endif
   }
 } g_threadedSimulatorTestSuite;
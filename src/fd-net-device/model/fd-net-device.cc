@@ -36,16 +36,34 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <errno.h>
+#include <poll.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <net/ethernet.h>
+#include <sys/socket.h>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FdNetDevice");
 
+/**
+ * \ingroup fd-net-device
+ * \brief Align a burst offset on the frame length type.
+ * \param offset The offset.
+ * \returns The aligned offset.
+ */
+static inline ssize_t
+AlignFrameOffset (ssize_t offset)
+{
+  return (offset + sizeof (uint32_t) - 1) & ~(ssize_t)(sizeof (uint32_t) - 1);
+}
+
 FdNetDeviceFdReader::FdNetDeviceFdReader ()
-  : m_bufferSize (65536) // Defaults to maximum TCP window size
+  : m_bufferSize (65536), // Defaults to maximum TCP window size
+    m_batchSize (1),
+    m_useRecvmmsg (true)
 {
 }
 
@@ -56,15 +74,51 @@ FdNetDeviceFdReader::SetBufferSize (uint32_t bufferSize)
   m_bufferSize = bufferSize;
 }
 
+void
+FdNetDeviceFdReader::SetBatchSize (uint32_t batchSize)
+{
+  NS_LOG_FUNCTION (this << batchSize);
+  m_batchSize = std::max (batchSize, (uint32_t)1);
+}
+
+uint8_t *
+FdNetDeviceFdReader::GetNextFrame (ssize_t &offset, uint8_t *buf, ssize_t len, ssize_t &frameLen)
+{
+  if (offset + (ssize_t)sizeof (uint32_t) > len)
+    {
+      return 0;
+    }
+  uint32_t frameLength;
+  memcpy (&frameLength, buf + offset, sizeof (uint32_t));
+  uint8_t *frame = buf + offset + sizeof (uint32_t);
+  frameLen = frameLength;
+  offset = AlignFrameOffset (offset + sizeof (uint32_t) + frameLength);
+  return frame;
+}
+
 FdReader::Data FdNetDeviceFdReader::DoRead (void)
 {
   NS_LOG_FUNCTION (this);
 
-  uint8_t *buf = (uint8_t *)malloc (m_bufferSize);
+  // Each frame takes at most its length and a padded buffer
+  ssize_t slotSize = sizeof (uint32_t) + AlignFrameOffset (m_bufferSize);
+  uint8_t *buf = (uint8_t *)malloc (slotSize * m_batchSize);
   NS_ABORT_MSG_IF (buf == 0, "malloc() failed");
 
-  NS_LOG_LOGIC ("Calling read on fd " << m_fd);
-  ssize_t len = read (m_fd, buf, m_bufferSize);
+  ssize_t len = -1;
+  if (m_useRecvmmsg)
+    {
+      len = ReceiveBurst (buf);
+      if (len < 0)
+        {
+          NS_LOG_LOGIC ("recvmmsg not supported on fd " << m_fd << ", using read");
+          m_useRecvmmsg = false;
+        }
+    }
+  if (!m_useRecvmmsg)
+    {
+      len = ReadBurst (buf);
+    }
   if (len <= 0)
     {
       free (buf);
@@ -75,6 +129,86 @@ FdReader::Data FdNetDeviceFdReader::DoRead (void)
   return FdReader::Data (buf, len);
 }
 
+ssize_t
+FdNetDeviceFdReader::ReadBurst (uint8_t *buf)
+{
+  NS_LOG_FUNCTION (this << buf);
+  ssize_t offset = 0;
+  for (uint32_t i = 0; i < m_batchSize; ++i)
+    {
+      if (i > 0)
+        {
+          // Only read the frames which are already available
+          struct pollfd fds;
+          fds.fd = m_fd;
+          fds.events = POLLIN;
+          if (poll (&fds, 1, 0) <= 0 || !(fds.revents & POLLIN))
+            {
+              break;
+            }
+        }
+      NS_LOG_LOGIC ("Calling read on fd " << m_fd);
+      ssize_t len = read (m_fd, buf + offset + sizeof (uint32_t), m_bufferSize);
+      if (len <= 0)
+        {
+          // Stop reading on failure, unless frames were read already
+          return i == 0 ? 0 : offset;
+        }
+      uint32_t frameLength = len;
+      memcpy (buf + offset, &frameLength, sizeof (uint32_t));
+      offset = AlignFrameOffset (offset + sizeof (uint32_t) + len);
+    }
+  return offset;
+}
+
+ssize_t
+FdNetDeviceFdReader::ReceiveBurst (uint8_t *buf)
+{
+  NS_LOG_FUNCTION (this << buf);
+#ifdef MSG_WAITFORONE
+  // recvmmsg () and MSG_WAITFORONE are Linux extensions
+  ssize_t slotSize = sizeof (uint32_t) + AlignFrameOffset (m_bufferSize);
+  std::vector<struct mmsghdr> msgs (m_batchSize);
+  std::vector<struct iovec> iovs (m_batchSize);
+  memset (&msgs[0], 0, m_batchSize * sizeof (struct mmsghdr));
+  for (uint32_t i = 0; i < m_batchSize; ++i)
+    {
+      iovs[i].iov_base = buf + i * slotSize + sizeof (uint32_t);
+      iovs[i].iov_len = m_bufferSize;
+      msgs[i].msg_hdr.msg_iov = &iovs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+  NS_LOG_LOGIC ("Calling recvmmsg on fd " << m_fd);
+  int n = recvmmsg (m_fd, &msgs[0], m_batchSize, MSG_WAITFORONE, 0);
+  if (n < 0 && (errno == ENOTSOCK || errno == ENOSYS))
+    {
+      return -1;
+    }
+  if (n <= 0)
+    {
+      return 0;
+    }
+
+  // Pack the frames after each other
+  ssize_t offset = 0;
+  for (int i = 0; i < n; ++i)
+    {
+      uint32_t frameLength = msgs[i].msg_len;
+      memcpy (buf + offset, &frameLength, sizeof (uint32_t));
+      if (offset != i * slotSize)
+        {
+          memmove (buf + offset + sizeof (uint32_t),
+                   buf + i * slotSize + sizeof (uint32_t), frameLength);
+        }
+      offset = AlignFrameOffset (offset + sizeof (uint32_t) + frameLength);
+    }
+  return offset;
+#else
+  return -1;
+#endif
+}
+
 NS_OBJECT_ENSURE_REGISTERED (FdNetDevice);
 
 TypeId
@@ -115,6 +249,20 @@ FdNetDevice::GetTypeId (void)
                    UintegerValue (1000),
                    MakeUintegerAccessor (&FdNetDevice::m_maxPendingReads),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RxBatchSize",
+                   "Maximum number of frames read from the file descriptor "
+                   "at once, and forwarded up by a single simulator event.",
+                   UintegerValue (32),
+                   MakeUintegerAccessor (&FdNetDevice::m_rxBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("TxBatchSize",
+                   "Maximum number of frames written to the file descriptor "
+                   "at once.  Frames are written as soon as they are sent "
+                   "when the value is 1, and at the end of the simulator "
+                   "event which sent them otherwise.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FdNetDevice::m_txBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     //
     // Trace sources at the "top" of the net device, where packets transition
     // to/from higher layers.  These points do not really correspond to the
@@ -174,6 +322,7 @@ FdNetDevice::FdNetDevice ()
     m_isBroadcast (true),
     m_isMulticast (false),
     m_pendingReadCount (0),
+    m_useSendmmsg (true),
     m_startEvent (),
     m_stopEvent ()
 {
@@ -250,6 +399,7 @@ FdNetDevice::StartDevice (void)
   m_fdReader = Create<FdNetDeviceFdReader> ();
   // 22 bytes covers 14 bytes Ethernet header with possible 8 bytes LLC/SNAP
   m_fdReader->SetBufferSize(m_mtu + 22);  
+  m_fdReader->SetBatchSize (m_rxBatchSize);
   m_fdReader->Start (m_fd, MakeCallback (&FdNetDevice::ReceiveCallback, this));
 
   NotifyLinkUp ();
@@ -268,6 +418,7 @@ FdNetDevice::StopDevice (void)
 
   if (m_fd != -1)
     {
+      FlushTx ();
       close (m_fd);
       m_fd = -1;
     }
@@ -279,48 +430,49 @@ FdNetDevice::ReceiveCallback (uint8_t *buf, ssize_t len)
   NS_LOG_FUNCTION (this << buf << len);
   bool skip = false;
 
+  uint32_t count = 0;
+  ssize_t offset = 0;
+  ssize_t frameLen;
+  while (FdNetDeviceFdReader::GetNextFrame (offset, buf, len, frameLen) != 0)
+    {
+      ++count;
+    }
+
   {
     CriticalSection cs (m_pendingReadMutex);
-    if (m_pendingReadCount >= m_maxPendingReads)
+    if (m_pendingReadCount + count > m_maxPendingReads)
       {
-        NS_LOG_WARN ("Packet dropped");
+        NS_LOG_WARN (count << " packets dropped");
         skip = true;
       }
     else
       {
-        ++m_pendingReadCount;
+        m_pendingReadCount += count;
       }
   }
 
   if (skip)
     {
+      free (buf);
       struct timespec time = { 0, 100000000L }; // 100 ms
       nanosleep (&time, NULL);
     }
   else
     {
-      Simulator::ScheduleWithContext (m_nodeId, Time (0), MakeEvent (&FdNetDevice::ForwardUp, this, buf, len));
+      Simulator::ScheduleWithContext (m_nodeId, Time (0), MakeEvent (&FdNetDevice::ForwardUp, this, buf, len, count));
    }
 }
 
 /**
  * \ingroup fd-net-device
  * \brief Synthesize PI header for the kernel
- * \param buf the buffer to add the header to
- * \param len the buffer length
- *
- * \todo Consider having a instance member m_packetBuffer and using memmove
- * instead of memcpy to add the PI header. It might be faster in this case
- * to use memmove and avoid the extra mallocs.
+ * \param pi the 4 bytes of the header
+ * \param buf the frame
+ * \param len the frame length
  */
 static void
-AddPIHeader (uint8_t *&buf, ssize_t &len)
+WritePIHeader (uint8_t *pi, const uint8_t *buf, ssize_t len)
 {
-  // Synthesize PI header for our friend the kernel
-  uint8_t *buf2 = (uint8_t*)malloc (len + 4);
-  memcpy (buf2 + 4, buf, len);
-  len += 4;
-
   // PI = 16 bits flags (0) + 16 bits proto
   // NOTE: be careful to interpret buffer data explicitly as
   //  little-endian to be insensible to native byte ordering.
@@ -339,59 +491,51 @@ AddPIHeader (uint8_t *&buf, ssize_t &len)
           proto = buf[12] | (buf[13] << 8);
         }
     }
-  buf2[0] = (uint8_t)flags;
-  buf2[1] = (uint8_t)(flags >> 8);
-  buf2[2] = (uint8_t)proto;
-  buf2[3] = (uint8_t)(proto >> 8);
-
-  // swap buffer
-  free (buf);
-  buf = buf2;
-}
-
-/**
- * \ingroup fd-net-device
- * \brief Removes PI header
- * \param buf the buffer to add the header to
- * \param len the buffer length
- */
-static void
-RemovePIHeader (uint8_t *&buf, ssize_t &len)
-{
-  // strip PI header if present, shrink buffer
-  if (len >= 4)
-    {
-      len -= 4;
-      memmove (buf, buf + 4, len);
-      buf = (uint8_t*)realloc (buf, len);
-    }
+  pi[0] = (uint8_t)flags;
+  pi[1] = (uint8_t)(flags >> 8);
+  pi[2] = (uint8_t)proto;
+  pi[3] = (uint8_t)(proto >> 8);
 }
 
 void
-FdNetDevice::ForwardUp (uint8_t *buf, ssize_t len)
+FdNetDevice::ForwardUp (uint8_t *buf, ssize_t len, uint32_t count)
 {
-  NS_LOG_FUNCTION (this << buf << len);
+  NS_LOG_FUNCTION (this << buf << len << count);
 
   if (m_pendingReadCount > 0)
     {
       {
         CriticalSection cs (m_pendingReadMutex);
-        --m_pendingReadCount;
+        m_pendingReadCount -= std::min (count, m_pendingReadCount);
       }
     }
 
+  ssize_t offset = 0;
+  ssize_t frameLen;
+  uint8_t *frame;
+  while ((frame = FdNetDeviceFdReader::GetNextFrame (offset, buf, len, frameLen)) != 0)
+    {
+      ForwardFrame (frame, frameLen);
+    }
+  free (buf);
+}
+
+void
+FdNetDevice::ForwardFrame (uint8_t *buf, ssize_t len)
+{
+  NS_LOG_FUNCTION (this << buf << len);
+
   // We need to remove the PI header and ignore it
-  if (m_encapMode == DIXPI)
+  if (m_encapMode == DIXPI && len >= 4)
     {
-      RemovePIHeader (buf, len);
+      buf += 4;
+      len -= 4;
     }
 
   //
-  // Create a packet out of the buffer we received and free that buffer.
+  // Create a packet out of the buffer we received.
   //
   Ptr<Packet> packet = Create<Packet> (reinterpret_cast<const uint8_t *> (buf), len);
-  free (buf);
-  buf = 0;
 
   //
   // Trace sinks will expect complete packets, not packets without some of the
@@ -555,23 +699,48 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
   m_promiscSnifferTrace (packet);
   m_snifferTrace (packet);
 
-  NS_LOG_LOGIC ("calling write");
+  ssize_t len =  (ssize_t) packet->GetSize ();
+  // We need to add the PI header
+  ssize_t piLen = m_encapMode == DIXPI ? 4 : 0;
 
+  if (m_txBatchSize > 1)
+    {
+      // Queue the frame, and write the queued frames at the end of the event
+      uint32_t offset = m_txBuffer.size ();
+      m_txBuffer.resize (offset + piLen + len);
+      uint8_t *frame = &m_txBuffer[offset];
+      packet->CopyData (frame + piLen, len);
+      if (piLen != 0)
+        {
+          WritePIHeader (frame, frame + piLen, len);
+        }
+      m_txFrames.push_back (std::make_pair (offset, (uint32_t)(piLen + len)));
+      m_txPackets.push_back (packet);
 
-  ssize_t len =  (ssize_t) packet->GetSize ();
-  uint8_t *buffer = (uint8_t*)malloc (len);
-  packet->CopyData (buffer, len);
+      if (m_txFrames.size () >= m_txBatchSize)
+        {
+          FlushTx ();
+        }
+      else if (!m_txFlushEvent.IsRunning ())
+        {
+          m_txFlushEvent = Simulator::ScheduleNow (&FdNetDevice::FlushTx, this);
+        }
+      return true;
+    }
 
-  // We need to add the PI header
-  if (m_encapMode == DIXPI)
+  NS_LOG_LOGIC ("calling write");
+
+  uint8_t *buffer = (uint8_t*)malloc (piLen + len);
+  packet->CopyData (buffer + piLen, len);
+  if (piLen != 0)
     {
-      AddPIHeader (buffer, len);
+      WritePIHeader (buffer, buffer + piLen, len);
     }
 
-  ssize_t written = write (m_fd, buffer, len);
+  ssize_t written = write (m_fd, buffer, piLen + len);
   free (buffer);
 
-  if (written == -1 || written != len)
+  if (written == -1 || written != piLen + len)
     {
       m_macTxDropTrace (packet);
       return false;
@@ -580,6 +749,77 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
   return true;
 }
 
+void
+FdNetDevice::FlushTx (void)
+{
+  NS_LOG_FUNCTION (this << m_txFrames.size ());
+  Simulator::Cancel (m_txFlushEvent);
+  uint32_t n = m_txFrames.size ();
+  if (n == 0)
+    {
+      return;
+    }
+
+  // The frames [0, sent) have been written, and [sent, failed) have failed
+  uint32_t sent = 0;
+  std::vector<bool> failed (n, false);
+#ifdef MSG_WAITFORONE
+  // sendmmsg () is a Linux extension, like MSG_WAITFORONE
+  if (m_useSendmmsg)
+    {
+      std::vector<struct mmsghdr> msgs (n);
+      std::vector<struct iovec> iovs (n);
+      memset (&msgs[0], 0, n * sizeof (struct mmsghdr));
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          iovs[i].iov_base = &m_txBuffer[m_txFrames[i].first];
+          iovs[i].iov_len = m_txFrames[i].second;
+          msgs[i].msg_hdr.msg_iov = &iovs[i];
+          msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+      while (sent < n)
+        {
+          NS_LOG_LOGIC ("calling sendmmsg for " << n - sent << " frames");
+          int r = sendmmsg (m_fd, &msgs[sent], n - sent, 0);
+          if (r < 0 && sent == 0 && (errno == ENOTSOCK || errno == ENOSYS))
+            {
+              NS_LOG_LOGIC ("sendmmsg not supported on fd " << m_fd << ", using write");
+              m_useSendmmsg = false;
+              break;
+            }
+          if (r <= 0)
+            {
+              // The first remaining frame can't be written: drop it
+              failed[sent++] = true;
+              continue;
+            }
+          for (int i = 0; i < r; ++i, ++sent)
+            {
+              failed[sent] = msgs[sent].msg_len != m_txFrames[sent].second;
+            }
+        }
+    }
+#endif
+  for (; sent < n; ++sent)
+    {
+      NS_LOG_LOGIC ("calling write");
+      ssize_t written = write (m_fd, &m_txBuffer[m_txFrames[sent].first], m_txFrames[sent].second);
+      failed[sent] = written == -1 || written != (ssize_t)m_txFrames[sent].second;
+    }
+
+  std::vector<Ptr<Packet> > packets;
+  packets.swap (m_txPackets);
+  m_txFrames.clear ();
+  m_txBuffer.clear ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      if (failed[i])
+        {
+          m_macTxDropTrace (packets[i]);
+        }
+    }
+}
+
 void
 FdNetDevice::SetFileDescriptor (int fd)
 {
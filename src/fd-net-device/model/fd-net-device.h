@@ -37,6 +37,8 @@
 #include "ns3/system-mutex.h"
 
 #include <string.h>
+#include <utility>
+#include <vector>
 
 namespace ns3 {
 
@@ -50,6 +52,18 @@ namespace ns3 {
 /**
  * \ingroup fd-net-device
  * \brief This class performs the actual data reading from the sockets.
+ *
+ * Each read delivers a burst of up to BatchSize frames, which are read
+ * with a single recvmmsg () call when the file descriptor is a socket
+ * and the system supports it, or with successive read () calls
+ * otherwise.  The frames of a burst are stored in a single buffer, each
+ * one preceded by its length as a uint32_t in host byte order:
+ *
+ * \verbatim
+   | len 0 | frame 0 | len 1 | frame 1 | ... \endverbatim
+ *
+ * The lengths are aligned on 4 bytes.  Use GetNextFrame () to iterate
+ * over the frames of a burst.
  */
 class FdNetDeviceFdReader : public FdReader
 {
@@ -61,10 +75,43 @@ public:
    */
   void SetBufferSize (uint32_t bufferSize);
 
+  /**
+   * Set the maximum number of frames read at once.
+   * \param batchSize The maximum number of frames per burst.
+   */
+  void SetBatchSize (uint32_t batchSize);
+
+  /**
+   * Get the next frame of a burst.
+   *
+   * \param [in,out] offset The offset of the frame in the burst, which is
+   *        updated to the offset of the next frame.
+   * \param [in] buf The burst.
+   * \param [in] len The burst length.
+   * \param [out] frameLen The frame length.
+   * \returns The frame, or 0 at the end of the burst.
+   */
+  static uint8_t * GetNextFrame (ssize_t &offset, uint8_t *buf, ssize_t len, ssize_t &frameLen);
+
 private:
   FdReader::Data DoRead (void);
-  
+  /**
+   * Read a burst with successive read () calls.
+   * \param buf The burst buffer.
+   * \returns The number of bytes of the burst, or 0 on failure.
+   */
+  ssize_t ReadBurst (uint8_t *buf);
+  /**
+   * Read a burst with recvmmsg ().
+   * \param buf The burst buffer.
+   * \returns The number of bytes of the burst, 0 on failure, or -1 if
+   *          recvmmsg () is not supported on the file descriptor.
+   */
+  ssize_t ReceiveBurst (uint8_t *buf);
+
   uint32_t m_bufferSize; //!< size of the read buffer
+  uint32_t m_batchSize;  //!< maximum number of frames per burst
+  bool m_useRecvmmsg;    //!< whether recvmmsg () works on the file descriptor
 };
 
 class Node;
@@ -79,6 +126,15 @@ class Node;
  * or to a user space process, allowing the simulation to exchange traffic with the
  * "outside-world"
  *
+ * Frames are read in bursts of up to RxBatchSize frames, and each burst
+ * is forwarded up by a single simulator event.  Frames are written one
+ * at a time unless TxBatchSize is larger than one, in which case the
+ * frames sent during a simulator event are written together, with
+ * sendmmsg () when the file descriptor is a socket, at the end of the
+ * event or as soon as TxBatchSize frames are queued.  Transmission
+ * failures of queued frames are reported by the MacTxDrop trace, since
+ * Send () has already returned.
+ *
  */
 class FdNetDevice : public NetDevice
 {
@@ -209,14 +265,29 @@ private:
   void StopDevice (void);
 
   /**
-   * Callback to invoke when a new frame is received
+   * Callback to invoke when a new burst of frames is received
    */
   void ReceiveCallback (uint8_t *buf, ssize_t len);
 
   /**
-   * Forward the frame to the appropriate callback for processing
+   * Forward the frames of a burst, and free the burst buffer.
+   * \param buf The burst, in the format of FdNetDeviceFdReader.
+   * \param len The burst length.
+   * \param count The number of frames of the burst.
+   */
+  void ForwardUp (uint8_t *buf, ssize_t len, uint32_t count);
+
+  /**
+   * Forward a frame to the appropriate callback for processing
+   * \param buf The frame, which is not freed.
+   * \param len The frame length.
+   */
+  void ForwardFrame (uint8_t *buf, ssize_t len);
+
+  /**
+   * Write the frames queued for transmission.
    */
-  void ForwardUp (uint8_t *buf, ssize_t len);
+  void FlushTx (void);
 
   /**
    * Start Sending a Packet Down the Wire.
@@ -304,6 +375,41 @@ private:
    * Maximum number of packets that can be received and scheduled for read but not yeat read.
    */
   uint32_t m_maxPendingReads;
+
+  /**
+   * Maximum number of frames read from the file descriptor at once.
+   */
+  uint32_t m_rxBatchSize;
+
+  /**
+   * Maximum number of frames written to the file descriptor at once.
+   */
+  uint32_t m_txBatchSize;
+
+  /**
+   * The frames queued for transmission, one buffer for all of them.
+   */
+  std::vector<uint8_t> m_txBuffer;
+
+  /**
+   * The offset and length of each frame in m_txBuffer.
+   */
+  std::vector<std::pair<uint32_t, uint32_t> > m_txFrames;
+
+  /**
+   * The packets queued for transmission, for the drop trace.
+   */
+  std::vector<Ptr<Packet> > m_txPackets;
+
+  /**
+   * The event writing the frames queued for transmission.
+   */
+  EventId m_txFlushEvent;
+
+  /**
+   * Whether sendmmsg () works on the file descriptor.
+   */
+  bool m_useSendmmsg;
   
    
   /**
@@ -0,0 +1,291 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/fd-net-device.h"
+
+using namespace ns3;
+
+/**
+ * The frames exchanged per round.  Unix datagram sockets only queue
+ * net.unix.max_dgram_qlen frames, which defaults to 10.
+ */
+static const uint32_t FRAMES_PER_ROUND = 10;
+/** The number of rounds. */
+static const uint32_t ROUNDS = 5;
+
+/**
+ * Check the frames read by a FdNetDevice, using a socketpair to stand
+ * for the network.
+ */
+class FdNetDeviceRxTestCase : public TestCase
+{
+public:
+  /**
+   * \param batchSize The RxBatchSize of the device.
+   */
+  FdNetDeviceRxTestCase (uint32_t batchSize);
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * Write frames to the peer socket.
+   * \param round The round number.
+   */
+  void WriteFrames (uint32_t round);
+  /**
+   * The device receive callback.
+   * \param device The device.
+   * \param p The packet.
+   * \param protocol The protocol number.
+   * \param from The source address.
+   * \returns true.
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  uint32_t m_batchSize;                 //!< The device RxBatchSize
+  int m_peer;                           //!< The peer socket
+  std::vector<uint32_t> m_received;     //!< The received frame sequence numbers
+};
+
+FdNetDeviceRxTestCase::FdNetDeviceRxTestCase (uint32_t batchSize)
+  : TestCase ("Check frame reception with RxBatchSize " + std::string (batchSize == 1 ? "1" : "> 1")),
+    m_batchSize (batchSize),
+    m_peer (-1)
+{
+}
+
+void
+FdNetDeviceRxTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+}
+
+void
+FdNetDeviceRxTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+FdNetDeviceRxTestCase::WriteFrames (uint32_t round)
+{
+  for (uint32_t i = 0; i < FRAMES_PER_ROUND; ++i)
+    {
+      uint32_t seq = round * FRAMES_PER_ROUND + i;
+      // The payload size and contents depend on the sequence number
+      std::vector<uint8_t> payload (46 + seq, (uint8_t)seq);
+      Ptr<Packet> p = Create<Packet> (&payload[0], payload.size ());
+      EthernetHeader header (false);
+      header.SetSource (Mac48Address ("00:00:00:00:00:02"));
+      header.SetDestination (Mac48Address ("00:00:00:00:00:01"));
+      header.SetLengthType (0x0800);
+      p->AddHeader (header);
+      std::vector<uint8_t> frame (p->GetSize ());
+      p->CopyData (&frame[0], frame.size ());
+      ssize_t written = send (m_peer, &frame[0], frame.size (), 0);
+      NS_TEST_EXPECT_MSG_EQ (written, (ssize_t)frame.size (), "Could not write frame " << seq);
+    }
+}
+
+bool
+FdNetDeviceRxTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  NS_TEST_EXPECT_MSG_EQ (protocol, 0x0800, "Wrong protocol");
+  NS_TEST_EXPECT_MSG_EQ (Mac48Address::ConvertFrom (from), Mac48Address ("00:00:00:00:00:02"), "Wrong source");
+  std::vector<uint8_t> payload (p->GetSize ());
+  p->CopyData (&payload[0], payload.size ());
+  uint32_t seq = payload.size () - 46;
+  bool intact = true;
+  for (uint32_t i = 0; i < payload.size (); ++i)
+    {
+      intact = intact && payload[i] == (uint8_t)seq;
+    }
+  NS_TEST_EXPECT_MSG_EQ (intact, true, "Corrupted frame " << seq);
+  m_received.push_back (seq);
+  return true;
+}
+
+void
+FdNetDeviceRxTestCase::DoRun (void)
+{
+  int sv[2];
+  NS_TEST_ASSERT_MSG_EQ (socketpair (AF_UNIX, SOCK_DGRAM, 0, sv), 0, "socketpair failed");
+  m_peer = sv[1];
+
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<FdNetDevice> device = CreateObject<FdNetDevice> ();
+  device->SetAttribute ("RxBatchSize", UintegerValue (m_batchSize));
+  device->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  device->SetFileDescriptor (sv[0]);
+  node->AddDevice (device);
+  device->SetReceiveCallback (MakeCallback (&FdNetDeviceRxTestCase::Receive, this));
+
+  for (uint32_t round = 0; round < ROUNDS; ++round)
+    {
+      Simulator::Schedule (MilliSeconds (50 + 50 * round), &FdNetDeviceRxTestCase::WriteFrames, this, round);
+    }
+  Simulator::Stop (MilliSeconds (100 + 50 * ROUNDS));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  close (m_peer);
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), ROUNDS * FRAMES_PER_ROUND, "Wrong number of frames received");
+  for (uint32_t i = 0; i < m_received.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_received[i], i, "Frame received out of order");
+    }
+}
+
+/**
+ * Check the frames written by a FdNetDevice, using a socketpair to stand
+ * for the network.
+ */
+class FdNetDeviceTxTestCase : public TestCase
+{
+public:
+  /**
+   * \param batchSize The TxBatchSize of the device.
+   */
+  FdNetDeviceTxTestCase (uint32_t batchSize);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Send packets through the device.
+   * \param round The round number.
+   */
+  void SendPackets (uint32_t round);
+  /**
+   * Read and check the frames written to the peer socket.
+   * \param round The round number.
+   */
+  void ReadFrames (uint32_t round);
+
+  uint32_t m_batchSize;                 //!< The device TxBatchSize
+  int m_peer;                           //!< The peer socket
+  Ptr<FdNetDevice> m_device;            //!< The device
+  uint32_t m_received;                  //!< The number of frames read
+};
+
+FdNetDeviceTxTestCase::FdNetDeviceTxTestCase (uint32_t batchSize)
+  : TestCase ("Check frame transmission with TxBatchSize " + std::string (batchSize == 1 ? "1" : "> 1")),
+    m_batchSize (batchSize),
+    m_peer (-1),
+    m_received (0)
+{
+}
+
+void
+FdNetDeviceTxTestCase::SendPackets (uint32_t round)
+{
+  for (uint32_t i = 0; i < FRAMES_PER_ROUND; ++i)
+    {
+      uint32_t seq = round * FRAMES_PER_ROUND + i;
+      std::vector<uint8_t> payload (46 + seq, (uint8_t)seq);
+      Ptr<Packet> p = Create<Packet> (&payload[0], payload.size ());
+      NS_TEST_EXPECT_MSG_EQ (m_device->Send (p, Mac48Address ("00:00:00:00:00:02"), 0x0800), true,
+                             "Could not send packet " << seq);
+    }
+}
+
+void
+FdNetDeviceTxTestCase::ReadFrames (uint32_t round)
+{
+  uint8_t frame[2000];
+  ssize_t len;
+  while ((len = recv (m_peer, frame, sizeof (frame), MSG_DONTWAIT)) > 0)
+    {
+      Ptr<Packet> p = Create<Packet> (frame, len);
+      EthernetHeader header (false);
+      p->RemoveHeader (header);
+      NS_TEST_EXPECT_MSG_EQ (header.GetLengthType (), 0x0800, "Wrong protocol");
+      NS_TEST_EXPECT_MSG_EQ (header.GetDestination (), Mac48Address ("00:00:00:00:00:02"), "Wrong destination");
+      NS_TEST_EXPECT_MSG_EQ (header.GetSource (), Mac48Address ("00:00:00:00:00:01"), "Wrong source");
+      NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 46 + m_received, "Frame written out of order");
+      std::vector<uint8_t> payload (p->GetSize ());
+      p->CopyData (&payload[0], payload.size ());
+      bool intact = true;
+      for (uint32_t i = 0; i < payload.size (); ++i)
+        {
+          intact = intact && payload[i] == (uint8_t)m_received;
+        }
+      NS_TEST_EXPECT_MSG_EQ (intact, true, "Corrupted frame " << m_received);
+      ++m_received;
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_received, (round + 1) * FRAMES_PER_ROUND, "Frames not written in round " << round);
+}
+
+void
+FdNetDeviceTxTestCase::DoRun (void)
+{
+  int sv[2];
+  NS_TEST_ASSERT_MSG_EQ (socketpair (AF_UNIX, SOCK_DGRAM, 0, sv), 0, "socketpair failed");
+  m_peer = sv[1];
+
+  Ptr<Node> node = CreateObject<Node> ();
+  m_device = CreateObject<FdNetDevice> ();
+  // Not a divisor of the frames per round, to check the flush at the end of the events
+  m_device->SetAttribute ("TxBatchSize", UintegerValue (m_batchSize));
+  m_device->SetAddress (Mac48Address ("00:00:00:00:00:01"));
+  m_device->SetFileDescriptor (sv[0]);
+  node->AddDevice (m_device);
+
+  for (uint32_t round = 0; round < ROUNDS; ++round)
+    {
+      Simulator::Schedule (Seconds (1 + round), &FdNetDeviceTxTestCase::SendPackets, this, round);
+      Simulator::Schedule (Seconds (1.5 + round), &FdNetDeviceTxTestCase::ReadFrames, this, round);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_device = 0;
+  close (m_peer);
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, ROUNDS * FRAMES_PER_ROUND, "Wrong number of frames written");
+}
+
+/**
+ * FdNetDevice test suite.
+ */
+class FdNetDeviceTestSuite : public TestSuite
+{
+public:
+  FdNetDeviceTestSuite ();
+};
+
+FdNetDeviceTestSuite::FdNetDeviceTestSuite ()
+  : TestSuite ("fd-net-device", UNIT)
+{
+  AddTestCase (new FdNetDeviceRxTestCase (1), TestCase::QUICK);
+  AddTestCase (new FdNetDeviceRxTestCase (32), TestCase::QUICK);
+  AddTestCase (new FdNetDeviceTxTestCase (1), TestCase::QUICK);
+  AddTestCase (new FdNetDeviceTxTestCase (4), TestCase::QUICK);
+}
+
+static FdNetDeviceTestSuite g_fdNetDeviceTestSuite;
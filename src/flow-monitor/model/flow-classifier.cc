@@ -32,6 +32,11 @@ FlowClassifier::~FlowClassifier ()
 {
 }
 
+void
+FlowClassifier::RemoveFlow (FlowId flowId)
+{
+}
+
 FlowId
 FlowClassifier::GetNewFlowId ()
 {
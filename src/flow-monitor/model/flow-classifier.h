@@ -71,6 +71,13 @@ public:
   /// \param indent number of spaces to use as base indentation level
   virtual void SerializeToXmlStream (std::ostream &os, int indent) const = 0;
 
+  /// Forget a flow which is no longer monitored, so that the memory
+  /// of the classifier does not grow with the flows which ended.  If
+  /// packets of this flow are seen again, they get a new FlowId.
+  /// The default implementation keeps the flow.
+  /// \param flowId the flow Identifier
+  virtual void RemoveFlow (FlowId flowId);
+
 protected:
   /// Returns a new, unique Flow Identifier
   /// \returns a new FlowId
@@ -22,6 +22,8 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/abort.h"
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -72,6 +74,13 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("FlowIdleTimeout",
+                   "With the incremental export, the time after which the flows "
+                   "which have been exported and have not been updated are removed "
+                   "from the flow statistics.  Zero means that flows are never removed.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&FlowMonitor::m_flowIdleTimeout),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -82,8 +91,16 @@ FlowMonitor::GetInstanceTypeId (void) const
   return GetTypeId ();
 }
 
+FlowMonitor::FlowState::FlowState ()
+  : stats (0),
+    trackedPackets (0),
+    exportPending (false)
+{
+}
+
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_enabled (false),
+    m_exportStream (0)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
@@ -102,15 +119,23 @@ FlowMonitor::DoDispose (void)
       m_flowProbes[i]->Dispose ();
       m_flowProbes[i] = 0;
     }
+  Simulator::Cancel (m_exportEvent);
+  if (m_exportStream != 0)
+    {
+      // the destroy event can't export once the stream is gone
+      ExportUpdatedFlows ();
+      m_exportStream->close ();
+      delete m_exportStream;
+      m_exportStream = 0;
+    }
   Object::DoDispose ();
 }
 
-inline FlowMonitor::FlowStats&
-FlowMonitor::GetStatsForFlow (FlowId flowId)
+FlowMonitor::FlowState&
+FlowMonitor::UpdateFlow (FlowId flowId)
 {
-  FlowStatsContainerI iter;
-  iter = m_flowStats.find (flowId);
-  if (iter == m_flowStats.end ())
+  FlowState &state = m_flowStates[flowId];
+  if (state.stats == 0)
     {
       FlowMonitor::FlowStats &ref = m_flowStats[flowId];
       ref.delaySum = Seconds (0);
@@ -126,12 +151,30 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
       ref.jitterHistogram.SetDefaultBinWidth (m_jitterBinWidth);
       ref.packetSizeHistogram.SetDefaultBinWidth (m_packetSizeBinWidth);
       ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
-      return ref;
+      state.stats = &ref;
     }
-  else
+  state.lastUpdate = Simulator::Now ();
+  if (m_exportStream != 0 && !state.exportPending)
     {
-      return iter->second;
+      state.exportPending = true;
+      m_exportPending.push_back (flowId);
     }
+  return state;
+}
+
+inline FlowMonitor::FlowStats&
+FlowMonitor::GetStatsForFlow (FlowId flowId)
+{
+  return *UpdateFlow (flowId).stats;
+}
+
+void
+FlowMonitor::EraseTrackedPacket (TrackedPacketMap::iterator tracked)
+{
+  FlowStateMap::iterator state = m_flowStates.find (tracked->first.first);
+  NS_ASSERT (state != m_flowStates.end () && state->second.trackedPackets > 0);
+  state->second.trackedPackets--;
+  m_trackedPackets.erase (tracked);
 }
 
 
@@ -143,7 +186,14 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  FlowState &state = UpdateFlow (flowId);
+  std::pair<TrackedPacketMap::iterator, bool> insert
+    = m_trackedPackets.insert (std::make_pair (std::make_pair (flowId, packetId), TrackedPacket ()));
+  if (insert.second)
+    {
+      state.trackedPackets++;
+    }
+  TrackedPacket &tracked = insert.first->second;
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
@@ -152,7 +202,7 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
 
   probe->AddPacketStats (flowId, packetSize, Seconds (0));
 
-  FlowStats &stats = GetStatsForFlow (flowId);
+  FlowStats &stats = *state.stats;
   stats.txBytes += packetSize;
   stats.txPackets++;
   if (stats.txPackets == 1)
@@ -247,7 +297,7 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  EraseTrackedPacket (tracked); // we don't need to track this packet anymore
 }
 
 void
@@ -279,7 +329,7 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
       // FIXME: this will not necessarily be true with broadcast/multicast
       NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
-      m_trackedPackets.erase (tracked);
+      EraseTrackedPacket (tracked);
     }
 }
 
@@ -301,12 +351,11 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
       if (now - iter->second.lastSeenTime >= maxDelay)
         {
           // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
+          FlowState &state = UpdateFlow (iter->first.first);
+          state.stats->lostPackets++;
 
           // we won't track it anymore
-          m_trackedPackets.erase (iter++);
+          EraseTrackedPacket (iter++);
         }
       else
         {
@@ -328,6 +377,123 @@ FlowMonitor::PeriodicCheckForLostPackets ()
   Simulator::Schedule (PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
+void
+FlowMonitor::EnableIncrementalExport (std::string fileName, Time interval)
+{
+  NS_LOG_FUNCTION (this << fileName << interval);
+  NS_ABORT_MSG_UNLESS (interval.IsStrictlyPositive (), "The export interval must be positive");
+  if (m_exportStream != 0)
+    {
+      m_exportStream->close ();
+      delete m_exportStream;
+    }
+  m_exportStream = new std::ofstream (fileName.c_str (), std::ios::out);
+  NS_ABORT_MSG_UNLESS (m_exportStream->is_open (), "Could not open " << fileName);
+  *m_exportStream << "# time flowId timeFirstTxPacket timeFirstRxPacket timeLastTxPacket timeLastRxPacket"
+                  << " delaySum jitterSum lastDelay txBytes rxBytes txPackets rxPackets lostPackets timesForwarded\n";
+
+  // the flows seen so far have not been exported yet
+  m_exportPending.clear ();
+  for (FlowStateMap::iterator state = m_flowStates.begin (); state != m_flowStates.end (); state++)
+    {
+      state->second.exportPending = state->second.stats != 0;
+      if (state->second.exportPending)
+        {
+          m_exportPending.push_back (state->first);
+        }
+    }
+
+  m_exportInterval = interval;
+  if (!m_exportEvent.IsRunning ())
+    {
+      // write the last updates before the monitor goes away
+      Simulator::ScheduleDestroy (&FlowMonitor::ExportUpdatedFlows, Ptr<FlowMonitor> (this));
+    }
+  Simulator::Cancel (m_exportEvent);
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
+void
+FlowMonitor::PeriodicExport ()
+{
+  ExportUpdatedFlows ();
+  m_exportEvent = Simulator::Schedule (m_exportInterval, &FlowMonitor::PeriodicExport, this);
+}
+
+void
+FlowMonitor::ExportUpdatedFlows ()
+{
+  NS_LOG_FUNCTION (this << m_exportPending.size ());
+  if (m_exportStream == 0)
+    {
+      return;
+    }
+  Time now = Simulator::Now ();
+  std::sort (m_exportPending.begin (), m_exportPending.end ());
+  for (std::vector<FlowId>::const_iterator flowId = m_exportPending.begin ();
+       flowId != m_exportPending.end (); flowId++)
+    {
+      FlowStateMap::iterator state = m_flowStates.find (*flowId);
+      if (state == m_flowStates.end ())
+        {
+          continue;
+        }
+      state->second.exportPending = false;
+      if (state->second.stats == 0)
+        {
+          continue;
+        }
+      const FlowStats &stats = *state->second.stats;
+      *m_exportStream << now.GetNanoSeconds ()
+                      << " " << *flowId
+                      << " " << stats.timeFirstTxPacket.GetNanoSeconds ()
+                      << " " << stats.timeFirstRxPacket.GetNanoSeconds ()
+                      << " " << stats.timeLastTxPacket.GetNanoSeconds ()
+                      << " " << stats.timeLastRxPacket.GetNanoSeconds ()
+                      << " " << stats.delaySum.GetNanoSeconds ()
+                      << " " << stats.jitterSum.GetNanoSeconds ()
+                      << " " << stats.lastDelay.GetNanoSeconds ()
+                      << " " << stats.txBytes
+                      << " " << stats.rxBytes
+                      << " " << stats.txPackets
+                      << " " << stats.rxPackets
+                      << " " << stats.lostPackets
+                      << " " << stats.timesForwarded
+                      << "\n";
+    }
+  m_exportPending.clear ();
+  m_exportStream->flush ();
+
+  if (m_flowIdleTimeout.IsZero ())
+    {
+      return;
+    }
+  for (FlowStateMap::iterator state = m_flowStates.begin (); state != m_flowStates.end (); )
+    {
+      if (state->second.trackedPackets == 0
+          && now - state->second.lastUpdate >= m_flowIdleTimeout)
+        {
+          FlowId flowId = state->first;
+          NS_LOG_DEBUG ("Removing idle flow " << flowId);
+          m_flowStats.erase (flowId);
+          m_flowStates.erase (state++);
+          for (uint32_t i = 0; i < m_flowProbes.size (); i++)
+            {
+              m_flowProbes[i]->RemoveFlowStats (flowId);
+            }
+          for (std::list<Ptr<FlowClassifier> >::iterator classifier = m_classifiers.begin ();
+               classifier != m_classifiers.end (); classifier++)
+            {
+              (*classifier)->RemoveFlow (flowId);
+            }
+        }
+      else
+        {
+          state++;
+        }
+    }
+}
+
 void
 FlowMonitor::NotifyConstructionCompleted ()
 {
@@ -23,6 +23,7 @@
 
 #include <vector>
 #include <map>
+#include <fstream>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
@@ -31,6 +32,7 @@
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
 
@@ -46,6 +48,18 @@ namespace ns3 {
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * The packets in transit and the flows are looked up in hash tables,
+ * so that the cost of each probe report does not depend on the number
+ * of flows.  Packets which are not seen for MaxPerHopDelay are
+ * periodically swept from the tracked packets and counted as lost.
+ *
+ * For very large numbers of flows, EnableIncrementalExport () streams
+ * the statistics of the flows updated during each interval to a file,
+ * and the FlowIdleTimeout attribute then releases the flows which have
+ * been exported and have been idle for that long, in the monitor, its
+ * probes and its classifiers, which bounds the memory used by the
+ * monitor.
+ *
  */
 class FlowMonitor : public Object
 {
@@ -236,6 +250,22 @@ public:
   /// \returns a list of all the probes
   const FlowProbeContainer& GetAllProbes () const;
 
+  /// Stream the statistics of the flows to a file as they are
+  /// collected.  Every interval, one line is written for each flow
+  /// updated during the interval, with the current time and the
+  /// values of its FlowStats, except the histograms and the drop
+  /// reasons.  All times are in nanoseconds.  The flows updated after
+  /// the last interval are written when the simulator is destroyed.
+  ///
+  /// When the FlowIdleTimeout attribute is not zero, the flows which
+  /// have been exported and have not been updated for that long are
+  /// removed from the flow statistics, from the statistics of the
+  /// probes, and from the flow classifiers.  If such a flow becomes
+  /// active again, it gets a new FlowId.
+  /// \param fileName name or path of the output file that will be created
+  /// \param interval time between two exports
+  void EnableIncrementalExport (std::string fileName, Time interval);
+
   /// Serializes the results to an std::ostream in XML format
   /// \param os the output stream
   /// \param indent number of spaces to use as base indentation level
@@ -272,16 +302,44 @@ private:
     uint32_t timesForwarded; //!< number of times the packet was reportedly forwarded
   };
 
+  /// Hash function of the tracked packets (FlowId,PacketId) key
+  class TrackedPacketKeyHash : public std::unary_function<std::pair<FlowId, FlowPacketId>, size_t>
+  {
+  public:
+    /**
+     * Returns the hash of the key
+     * \param key the (FlowId,PacketId) key
+     * \return the hash
+     */
+    size_t operator() (std::pair<FlowId, FlowPacketId> const &key) const
+    {
+      return (size_t)key.first * 0x9e3779b1 ^ key.second;
+    }
+  };
+
+  /// Structure to represent the bookkeeping of a flow
+  struct FlowState
+  {
+    FlowState ();
+    FlowStats *stats;           //!< the flow stats, in m_flowStats, or 0
+    uint32_t trackedPackets;    //!< number of tracked packets of the flow
+    Time lastUpdate;            //!< absolute time when the flow stats were last updated
+    bool exportPending;         //!< the flow has been updated since the last export
+  };
+
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
+  /// FlowId --> FlowState, to find the flow stats in constant time
+  typedef sgi::hash_map<FlowId, FlowState> FlowStateMap;
+  FlowStateMap m_flowStates; //!< Flow states
 
   /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  typedef sgi::hash_map< std::pair<FlowId, FlowPacketId>, TrackedPacket, TrackedPacketKeyHash> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
-  // note: this is needed only for serialization
+  // note: this is needed only for serialization, and to remove the idle flows
   std::list<Ptr<FlowClassifier> > m_classifiers; //!< the FlowClassifiers
 
   EventId m_startEvent;     //!< Start event
@@ -293,13 +351,36 @@ private:
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
 
-  /// Get the stats for a given flow
+  std::ofstream *m_exportStream;        //!< The incremental export file, or 0
+  Time m_exportInterval;                //!< Time between two exports
+  EventId m_exportEvent;                //!< Next export event
+  std::vector<FlowId> m_exportPending;  //!< Flows updated since the last export
+  Time m_flowIdleTimeout;               //!< Idle time after which exported flows are removed
+
+  /// Get the state of a given flow, creating its stats if needed, and
+  /// mark the flow updated.
+  /// \param flowId the Flow identification
+  /// \returns the state of the flow
+  FlowState& UpdateFlow (FlowId flowId);
+
+  /// Get the stats for a given flow, and mark the flow updated
   /// \param flowId the Flow identification
   /// \returns the stats of the flow
   FlowStats& GetStatsForFlow (FlowId flowId);
 
+  /// Stop tracking a packet
+  /// \param tracked the tracked packet
+  void EraseTrackedPacket (TrackedPacketMap::iterator tracked);
+
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// Write the flows updated since the last export, and remove the
+  /// flows which have been idle for FlowIdleTimeout
+  void ExportUpdatedFlows ();
+
+  /// Periodic function to export the updated flows
+  void PeriodicExport ();
 };
 
 
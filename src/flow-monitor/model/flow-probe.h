@@ -86,6 +86,11 @@ public:
   /// \param reasonCode reason code for the drop
   void AddPacketDropStats (FlowId flowId, uint32_t packetSize, uint32_t reasonCode);
 
+  /// Remove the statistics of a flow.  This is used by the FlowMonitor
+  /// to release the flows which are no longer active.
+  /// \param flowId the flow Identifier
+  void RemoveFlowStats (FlowId flowId);
+
   /// Get the partial flow statistics stored in this probe.  With this
   /// information you can, for example, find out what is the delay
   /// from the first probe to this one.
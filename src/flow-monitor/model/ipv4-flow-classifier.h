@@ -22,10 +22,11 @@
 #define IPV4_FLOW_CLASSIFIER_H
 
 #include <stdint.h>
-#include <map>
+#include <vector>
 
 #include "ns3/ipv4-header.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/sgi-hashmap.h"
 
 namespace ns3 {
 
@@ -49,6 +50,18 @@ public:
     uint16_t destinationPort;       //!< Destination port
   };
 
+  /// Hash function for the FiveTuple
+  class FiveTupleHash : public std::unary_function<FiveTuple, size_t>
+  {
+  public:
+    /**
+     * Returns the hash of the tuple
+     * \param t the tuple
+     * \return the hash
+     */
+    size_t operator() (FiveTuple const &t) const;
+  };
+
   Ipv4FlowClassifier ();
 
   /// \brief try to classify the packet into flow-id and packet-id
@@ -70,13 +83,26 @@ public:
   FiveTuple FindFlow (FlowId flowId) const;
 
   virtual void SerializeToXmlStream (std::ostream &os, int indent) const;
+  virtual void RemoveFlow (FlowId flowId);
 
 private:
 
+  /// The identifiers of a flow
+  struct FlowIds
+  {
+    FlowId flowId;                //!< The FlowId
+    FlowPacketId lastPacketId;    //!< The FlowPacketId of the last packet
+  };
+
+  /// Container: FiveTuple, FlowIds
+  typedef sgi::hash_map<FiveTuple, FlowIds, FiveTupleHash> FlowMap;
+  /// Container: FlowId, FiveTuple
+  typedef sgi::hash_map<FlowId, FiveTuple> FlowTupleMap;
+
   /// Map to Flows Identifiers to FlowIds
-  std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+  FlowMap m_flowMap;
+  /// The FiveTuple of each flow
+  FlowTupleMap m_flowTuples;
 
 };
 
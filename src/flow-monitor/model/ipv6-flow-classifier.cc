@@ -25,6 +25,8 @@
 #include "ns3/udp-header.h"
 #include "ns3/tcp-header.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 /* see http://www.iana.org/assignments/protocol-numbers */
@@ -95,6 +97,18 @@ bool operator == (const Ipv6FlowClassifier::FiveTuple &t1,
 }
 
 
+size_t
+Ipv6FlowClassifier::FiveTupleHash::operator() (FiveTuple const &t) const
+{
+  Ipv6AddressHash addressHash;
+  size_t hash = addressHash (t.sourceAddress);
+  // combine the fields as boost::hash_combine does
+  hash ^= addressHash (t.destinationAddress) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= t.protocol + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= t.sourcePort + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  hash ^= t.destinationPort + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  return hash;
+}
 
 Ipv6FlowClassifier::Ipv6FlowClassifier ()
 {
@@ -148,23 +162,24 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationPort = dstPort;
 
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
-    = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
+  FlowIds ids = { 0, 0 };
+  std::pair<FlowMap::iterator, bool> insert
+    = m_flowMap.insert (std::pair<FiveTuple, FlowIds> (tuple, ids));
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
   if (insert.second)
     {
       FlowId newFlowId = GetNewFlowId ();
-      insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
+      insert.first->second.flowId = newFlowId;
+      m_flowTuples[newFlowId] = tuple;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      insert.first->second.lastPacketId ++;
     }
 
-  *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_flowId = insert.first->second.flowId;
+  *out_packetId = insert.first->second.lastPacketId;
 
   return true;
 }
@@ -173,19 +188,27 @@ Ipv6FlowClassifier::Classify (const Ipv6Header &ipHeader, Ptr<const Packet> ipPa
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  FlowTupleMap::const_iterator iter = m_flowTuples.find (flowId);
+  if (iter != m_flowTuples.end ())
     {
-      if (iter->second == flowId)
-        {
-          return iter->first;
-        }
+      return iter->second;
     }
   NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
   FiveTuple retval = { Ipv6Address::GetZero (), Ipv6Address::GetZero (), 0, 0, 0 };
   return retval;
 }
 
+void
+Ipv6FlowClassifier::RemoveFlow (FlowId flowId)
+{
+  FlowTupleMap::iterator iter = m_flowTuples.find (flowId);
+  if (iter != m_flowTuples.end ())
+    {
+      m_flowMap.erase (iter->second);
+      m_flowTuples.erase (iter);
+    }
+}
+
 void
 Ipv6FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
 {
@@ -193,17 +216,27 @@ Ipv6FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
 
   INDENT (indent); os << "<Ipv6FlowClassifier>\n";
 
+  // list the flows by FlowId, the hash table order being arbitrary
+  std::vector<std::pair<FlowId, const FiveTuple *> > tuples;
+  tuples.reserve (m_flowTuples.size ());
+  for (FlowTupleMap::const_iterator
+       iter = m_flowTuples.begin (); iter != m_flowTuples.end (); iter++)
+    {
+      tuples.push_back (std::make_pair (iter->first, &iter->second));
+    }
+  std::sort (tuples.begin (), tuples.end ());
+
   indent += 2;
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  for (uint32_t i = 0; i < tuples.size (); i++)
     {
+      const FiveTuple *tuple = tuples[i].second;
       INDENT (indent);
-      os << "<Flow flowId=\"" << iter->second << "\""
-         << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-         << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-         << " protocol=\"" << int(iter->first.protocol) << "\""
-         << " sourcePort=\"" << iter->first.sourcePort << "\""
-         << " destinationPort=\"" << iter->first.destinationPort << "\""
+      os << "<Flow flowId=\"" << tuples[i].first << "\""
+         << " sourceAddress=\"" << tuple->sourceAddress << "\""
+         << " destinationAddress=\"" << tuple->destinationAddress << "\""
+         << " protocol=\"" << int(tuple->protocol) << "\""
+         << " sourcePort=\"" << tuple->sourcePort << "\""
+         << " destinationPort=\"" << tuple->destinationPort << "\""
          << " />\n";
     }
 
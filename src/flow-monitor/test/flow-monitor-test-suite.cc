@@ -0,0 +1,316 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <fstream>
+#include <sstream>
+#include <map>
+
+#include "ns3/flow-monitor.h"
+#include "ns3/flow-probe.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * A probe which only reports what the test tells it.
+ */
+class TestFlowProbe : public FlowProbe
+{
+public:
+  /**
+   * \param monitor the FlowMonitor
+   */
+  TestFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * Check the Ipv4FlowClassifier flow and packet identifiers.
+ */
+class Ipv4FlowClassifierTestCase : public TestCase
+{
+public:
+  Ipv4FlowClassifierTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4FlowClassifierTestCase::Ipv4FlowClassifierTestCase ()
+  : TestCase ("Ipv4FlowClassifier")
+{
+}
+
+void
+Ipv4FlowClassifierTestCase::DoRun (void)
+{
+  Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+  const uint32_t nFlows = 2000;
+  for (uint32_t round = 0; round < 3; round++)
+    {
+      for (uint32_t i = 0; i < nFlows; i++)
+        {
+          Ipv4Header ipHeader;
+          ipHeader.SetSource (Ipv4Address (0x0a000000 + i % 100));
+          ipHeader.SetDestination (Ipv4Address (0x0b000000 + i / 100));
+          ipHeader.SetProtocol (17);
+          uint8_t ports[4] = { 0, 9, (uint8_t)(i >> 8), (uint8_t)i };
+          Ptr<Packet> payload = Create<Packet> (ports, 4);
+
+          uint32_t flowId, packetId;
+          NS_TEST_ASSERT_MSG_EQ (classifier->Classify (ipHeader, payload, &flowId, &packetId), true,
+                                 "Packet not classified");
+          NS_TEST_ASSERT_MSG_EQ (flowId, i + 1, "Wrong flow id");
+          NS_TEST_ASSERT_MSG_EQ (packetId, round, "Wrong packet id");
+        }
+    }
+
+  Ipv4FlowClassifier::FiveTuple tuple = classifier->FindFlow (1234);
+  NS_TEST_ASSERT_MSG_EQ (tuple.sourceAddress, Ipv4Address (0x0a000000 + 1233 % 100), "Wrong source address");
+  NS_TEST_ASSERT_MSG_EQ (tuple.destinationAddress, Ipv4Address (0x0b000000 + 1233 / 100), "Wrong destination address");
+  NS_TEST_ASSERT_MSG_EQ (tuple.destinationPort, 1233, "Wrong destination port");
+
+  // The flows are serialized in FlowId order
+  std::ostringstream os;
+  classifier->SerializeToXmlStream (os, 0);
+  std::string xml = os.str ();
+  NS_TEST_ASSERT_MSG_LT (xml.find ("flowId=\"1\""), xml.find ("flowId=\"2\""), "Flows not sorted");
+  NS_TEST_ASSERT_MSG_LT (xml.find ("flowId=\"1999\""), xml.find ("flowId=\"2000\""), "Flows not sorted");
+
+  // A removed flow gets a new FlowId, and its packets start over
+  classifier->RemoveFlow (1234);
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (tuple.sourceAddress);
+  ipHeader.SetDestination (tuple.destinationAddress);
+  ipHeader.SetProtocol (17);
+  uint8_t ports[4] = { 0, 9, (uint8_t)(1233 >> 8), (uint8_t)1233 };
+  uint32_t flowId, packetId;
+  NS_TEST_ASSERT_MSG_EQ (classifier->Classify (ipHeader, Create<Packet> (ports, 4), &flowId, &packetId), true,
+                         "Packet not classified");
+  NS_TEST_ASSERT_MSG_EQ (flowId, nFlows + 1, "Wrong flow id after the removal");
+  NS_TEST_ASSERT_MSG_EQ (packetId, 0, "Wrong packet id after the removal");
+}
+
+/**
+ * Check the incremental export and the removal of the idle flows.
+ */
+class FlowMonitorIncrementalExportTestCase : public TestCase
+{
+public:
+  FlowMonitorIncrementalExportTestCase ();
+private:
+  virtual void DoRun (void);
+  /// Report the transmission of the packets of all the flows
+  void SendPackets (void);
+  /// Report the reception of the first two packets of all the flows,
+  /// and the drop of the third one for the even flows
+  void ReceivePackets (void);
+
+  Ptr<FlowMonitor> m_monitor;   //!< The monitor
+  Ptr<FlowProbe> m_probe;       //!< The probe
+  Ptr<Ipv4FlowClassifier> m_classifier;  //!< The classifier
+};
+
+/// The number of flows
+static const uint32_t N_FLOWS = 1000;
+
+FlowMonitorIncrementalExportTestCase::FlowMonitorIncrementalExportTestCase ()
+  : TestCase ("FlowMonitor incremental export")
+{
+}
+
+void
+FlowMonitorIncrementalExportTestCase::SendPackets (void)
+{
+  for (FlowId flowId = 1; flowId <= N_FLOWS; flowId++)
+    {
+      for (FlowPacketId packetId = 0; packetId < 3; packetId++)
+        {
+          m_monitor->ReportFirstTx (m_probe, flowId, packetId, 100);
+        }
+    }
+}
+
+void
+FlowMonitorIncrementalExportTestCase::ReceivePackets (void)
+{
+  for (FlowId flowId = 1; flowId <= N_FLOWS; flowId++)
+    {
+      m_monitor->ReportLastRx (m_probe, flowId, 0, 100);
+      m_monitor->ReportLastRx (m_probe, flowId, 1, 100);
+      if (flowId % 2 == 0)
+        {
+          m_monitor->ReportDrop (m_probe, flowId, 2, 100, 0);
+        }
+    }
+}
+
+void
+FlowMonitorIncrementalExportTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("flow-monitor-export.txt");
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (1.5)));
+  m_monitor->SetAttribute ("FlowIdleTimeout", TimeValue (Seconds (2)));
+  m_probe = CreateObject<TestFlowProbe> (m_monitor);
+  m_monitor->EnableIncrementalExport (fileName, Seconds (0.75));
+
+  // The classifier knows the flows reported to the monitor
+  m_classifier = Create<Ipv4FlowClassifier> ();
+  m_monitor->AddFlowClassifier (m_classifier);
+  for (uint32_t i = 0; i < N_FLOWS; i++)
+    {
+      Ipv4Header ipHeader;
+      ipHeader.SetSource (Ipv4Address (0x0a000001));
+      ipHeader.SetDestination (Ipv4Address (0x0b000001));
+      ipHeader.SetProtocol (17);
+      uint8_t ports[4] = { 0, 9, (uint8_t)(i >> 8), (uint8_t)i };
+      uint32_t flowId, packetId;
+      m_classifier->Classify (ipHeader, Create<Packet> (ports, 4), &flowId, &packetId);
+    }
+
+  Simulator::Schedule (Seconds (0.1), &FlowMonitorIncrementalExportTestCase::SendPackets, this);
+  Simulator::Schedule (Seconds (0.2), &FlowMonitorIncrementalExportTestCase::ReceivePackets, this);
+  Simulator::Stop (Seconds (6));
+  Simulator::Run ();
+
+  // All the flows have been removed after being exported
+  NS_TEST_EXPECT_MSG_EQ (m_monitor->GetFlowStats ().size (), 0, "Idle flows not removed");
+  NS_TEST_EXPECT_MSG_EQ (m_probe->GetStats ().size (), 0, "Idle flows not removed from the probe");
+  std::ostringstream xml;
+  m_classifier->SerializeToXmlStream (xml, 0);
+  NS_TEST_EXPECT_MSG_EQ (xml.str ().find ("<Flow "), std::string::npos,
+                         "Idle flows not removed from the classifier");
+
+  Simulator::Destroy ();
+  m_probe = 0;
+  m_classifier = 0;
+  m_monitor->Dispose ();
+  m_monitor = 0;
+
+  std::ifstream file (fileName.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (file.is_open (), true, "Could not open " << fileName);
+  std::string line;
+  std::getline (file, line);
+  NS_TEST_ASSERT_MSG_EQ (line[0], '#', "No header line");
+  // The number of lines exported at each time, and the lost packets by flow
+  std::map<int64_t, uint32_t> lines;
+  std::map<FlowId, uint32_t> lost;
+  while (std::getline (file, line))
+    {
+      std::istringstream is (line);
+      int64_t time, timeFirstTx, timeFirstRx, timeLastTx, timeLastRx, delaySum, jitterSum, lastDelay;
+      uint64_t txBytes, rxBytes;
+      uint32_t flowId, txPackets, rxPackets, lostPackets, timesForwarded;
+      is >> time >> flowId >> timeFirstTx >> timeFirstRx >> timeLastTx >> timeLastRx
+         >> delaySum >> jitterSum >> lastDelay >> txBytes >> rxBytes
+         >> txPackets >> rxPackets >> lostPackets >> timesForwarded;
+      NS_TEST_ASSERT_MSG_EQ (is.fail (), false, "Malformed line " << line);
+      lines[time]++;
+      NS_TEST_EXPECT_MSG_EQ (txPackets, 3, "Wrong txPackets for flow " << flowId);
+      NS_TEST_EXPECT_MSG_EQ (rxPackets, 2, "Wrong rxPackets for flow " << flowId);
+      NS_TEST_EXPECT_MSG_EQ (txBytes, 300, "Wrong txBytes for flow " << flowId);
+      NS_TEST_EXPECT_MSG_EQ (delaySum, 2 * 100000000, "Wrong delaySum for flow " << flowId);
+      lost[flowId] = lostPackets;
+    }
+
+  // Every flow is exported after the first interval, and the odd flows
+  // again once their last packet is found lost, at 2 s.
+  NS_TEST_ASSERT_MSG_EQ (lines.size (), 2, "Wrong number of exports");
+  NS_TEST_EXPECT_MSG_EQ (lines[750000000], N_FLOWS, "Wrong number of flows exported at 0.75 s");
+  NS_TEST_EXPECT_MSG_EQ (lines[2250000000LL], N_FLOWS / 2, "Wrong number of flows exported at 2.25 s");
+  NS_TEST_ASSERT_MSG_EQ (lost.size (), N_FLOWS, "Wrong number of flows");
+  for (std::map<FlowId, uint32_t>::const_iterator i = lost.begin (); i != lost.end (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (i->second, 1, "Wrong lostPackets for flow " << i->first);
+    }
+}
+
+/**
+ * Check that the updates pending when the monitor is disposed are
+ * exported.
+ */
+class FlowMonitorDisposeExportTestCase : public TestCase
+{
+public:
+  FlowMonitorDisposeExportTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+FlowMonitorDisposeExportTestCase::FlowMonitorDisposeExportTestCase ()
+  : TestCase ("FlowMonitor export on dispose")
+{
+}
+
+void
+FlowMonitorDisposeExportTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("flow-monitor-dispose.txt");
+  Ptr<FlowMonitor> monitor = CreateObject<FlowMonitor> ();
+  Ptr<FlowProbe> probe = CreateObject<TestFlowProbe> (monitor);
+  monitor->EnableIncrementalExport (fileName, Seconds (1));
+  const uint32_t nFlows = 10;
+  for (uint32_t flowId = 1; flowId <= nFlows; flowId++)
+    {
+      Simulator::Schedule (Seconds (0.1), &FlowMonitor::ReportFirstTx, monitor, probe, flowId, 0, 100);
+    }
+
+  // Dispose of the monitor before the first periodic export, and
+  // before the simulator is destroyed
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  probe = 0;
+  monitor->Dispose ();
+  monitor = 0;
+  Simulator::Destroy ();
+
+  std::ifstream file (fileName.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (file.is_open (), true, "Could not open " << fileName);
+  std::string line;
+  std::getline (file, line);
+  NS_TEST_ASSERT_MSG_EQ (line[0], '#', "No header line");
+  uint32_t lines = 0;
+  while (std::getline (file, line))
+    {
+      lines++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (lines, nFlows, "Pending updates not exported on dispose");
+}
+
+/**
+ * FlowMonitor test suite.
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTestSuite ();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite ()
+  : TestSuite ("flow-monitor", UNIT)
+{
+  AddTestCase (new Ipv4FlowClassifierTestCase, TestCase::QUICK);
+  AddTestCase (new FlowMonitorIncrementalExportTestCase, TestCase::QUICK);
+  AddTestCase (new FlowMonitorDisposeExportTestCase, TestCase::QUICK);
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite;
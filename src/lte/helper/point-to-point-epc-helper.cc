@@ -32,6 +32,7 @@
 #include <ns3/packet-socket-address.h>
 #include <ns3/epc-enb-application.h>
 #include <ns3/epc-sgw-pgw-application.h>
+#include <ns3/boolean.h>
 
 #include <ns3/lte-enb-rrc.h>
 #include <ns3/epc-x2.h>
@@ -48,7 +49,8 @@ NS_OBJECT_ENSURE_REGISTERED (PointToPointEpcHelper);
 
 
 PointToPointEpcHelper::PointToPointEpcHelper () 
-  : m_gtpuUdpPort (2152)  // fixed by the standard
+  : m_gtpuUdpPort (2152),  // fixed by the standard
+    m_gtpuFastPath (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -144,6 +146,11 @@ PointToPointEpcHelper::GetTypeId (void)
                    UintegerValue (3000),
                    MakeUintegerAccessor (&PointToPointEpcHelper::m_x2LinkMtu),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("GtpuFastPath",
+                   "If true, the SGW/PGW classifies the downlink packets from the bytes of their headers with a flow table per UE, and the eNBs find the bearer of the GTP-U packets in a table indexed by the TEID. It must be set before the eNBs are added.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PointToPointEpcHelper::m_gtpuFastPath),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -218,6 +225,7 @@ PointToPointEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, ui
 
   NS_LOG_INFO ("create EpcEnbApplication");
   Ptr<EpcEnbApplication> enbApp = CreateObject<EpcEnbApplication> (enbLteSocket, enbS1uSocket, enbAddress, sgwAddress, cellId);
+  enbApp->SetAttribute ("FastPath", BooleanValue (m_gtpuFastPath));
   enb->AddApplication (enbApp);
   NS_ASSERT (enb->GetNApplications () == 1);
   NS_ASSERT_MSG (enb->GetApplication (0)->GetObject<EpcEnbApplication> () != 0, "cannot retrieve EpcEnbApplication");
@@ -230,6 +238,7 @@ PointToPointEpcHelper::AddEnb (Ptr<Node> enb, Ptr<NetDevice> lteEnbNetDevice, ui
 
   NS_LOG_INFO ("connect S1-AP interface");
   m_mme->AddEnb (cellId, enbAddress, enbApp->GetS1apSapEnb ());
+  m_sgwPgwApp->SetAttribute ("FastPath", BooleanValue (m_gtpuFastPath));
   m_sgwPgwApp->AddEnb (cellId, enbAddress, sgwAddress);
   enbApp->SetS1apSapMme (m_mme->GetS1apSapMme ());
 }
@@ -166,6 +166,13 @@ private:
    */
   uint16_t m_x2LinkMtu;
 
+  /**
+   * The `GtpuFastPath` attribute, passed to the `FastPath` attribute
+   * of the EpcSgwPgwApplication and of the EpcEnbApplication of the
+   * next eNBs to be added
+   */
+  bool m_gtpuFastPath;
+
 };
 
 
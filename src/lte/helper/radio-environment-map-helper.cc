@@ -37,9 +37,22 @@
 #include <ns3/node.h>
 #include <ns3/buildings-helper.h>
 #include <ns3/lte-spectrum-value-helper.h>
+#include <ns3/lte-spectrum-signal-parameters.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/angles.h>
+#include <ns3/core-config.h>
+
+#ifdef HAVE_PTHREAD_H
+#include <ns3/system-thread.h>
+#include <ns3/system-mutex.h>
+#endif
 
 #include <fstream>
 #include <limits>
+#include <cmath>
 
 namespace ns3 {
 
@@ -47,7 +60,23 @@ NS_LOG_COMPONENT_DEFINE ("RadioEnvironmentMapHelper");
 
 NS_OBJECT_ENSURE_REGISTERED (RadioEnvironmentMapHelper);
 
+#ifdef HAVE_PTHREAD_H
+/**
+ * \ingroup lte
+ * \returns The mutex serializing BuildingsHelper::MakeConsistent (), which
+ * takes references to the shared Building objects, in the threads of the
+ * offline map.
+ */
+static SystemMutex &
+GetBuildingsMutex (void)
+{
+  static SystemMutex mutex;
+  return mutex;
+}
+#endif
+
 RadioEnvironmentMapHelper::RadioEnvironmentMapHelper ()
+  : m_maxLossDb (1.0e9)
 {
 }
 
@@ -62,6 +91,10 @@ void
 RadioEnvironmentMapHelper::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_channel = 0;
+  m_offlineSignals.clear ();
+  m_propagationLoss = 0;
+  m_spectrumPropagationLoss = 0;
 }
 
 TypeId
@@ -144,6 +177,24 @@ RadioEnvironmentMapHelper::GetTypeId (void)
                    IntegerValue (-1),
                    MakeIntegerAccessor (&RadioEnvironmentMapHelper::m_rbId),
                    MakeIntegerChecker<int32_t> ())
+    .AddAttribute ("Offline",
+                   "If true, the DL signals of one subframe are recorded "
+                   "on the channel, and the map is computed from them with "
+                   "the loss models of the channel, without simulating a "
+                   "listener per point",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RadioEnvironmentMapHelper::m_offline),
+                   MakeBooleanChecker ())
+    .AddAttribute ("NumThreads",
+                   "Number of threads computing the map when Offline is "
+                   "true. With more than one thread the PropagationLossModel "
+                   "of the channel is evaluated concurrently, hence it must "
+                   "not keep a state, as the shadowing of the buildings "
+                   "models does. A SpectrumPropagationLossModel on the "
+                   "channel restricts the computation to one thread.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&RadioEnvironmentMapHelper::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1, 256))
   ;
   return tid;
 }
@@ -225,6 +276,18 @@ RadioEnvironmentMapHelper::DelayedInstall ()
     {
       m_maxPointsPerIteration = m_xRes * m_yRes;
     }
+
+  if (m_offline)
+    {
+      // record the signals received by the listeners of the first
+      // iteration of the online computation
+      m_rxSpectrumModel = LteSpectrumValueHelper::GetSpectrumModel (m_earfcn, m_bandwidth);
+      m_captureStart = Simulator::Now () + Seconds (0.0001);
+      m_channel->TraceConnectWithoutContext ("TxSigParams",
+                                             MakeCallback (&RadioEnvironmentMapHelper::CaptureSignal, this));
+      Simulator::Schedule (Seconds (0.0006), &RadioEnvironmentMapHelper::RunOffline, this);
+      return;
+    }
   
   for (uint32_t i = 0; i < m_maxPointsPerIteration; ++i)
     {
@@ -352,4 +415,246 @@ RadioEnvironmentMapHelper::Finalize ()
 }
 
 
+
+void
+RadioEnvironmentMapHelper::CaptureSignal (Ptr<SpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+  if (Simulator::Now () < m_captureStart)
+    {
+      return;
+    }
+  if (m_useDataChannel)
+    {
+      if (DynamicCast<LteSpectrumSignalParametersDataFrame> (params) == 0)
+        {
+          return;
+        }
+    }
+  else if (DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (params) == 0)
+    {
+      return;
+    }
+
+  OfflineSignal signal;
+  if (params->psd->GetSpectrumModelUid () == m_rxSpectrumModel->GetUid ())
+    {
+      signal.psd = Copy<SpectrumValue> (params->psd);
+    }
+  else
+    {
+      SpectrumConverter converter (params->psd->GetSpectrumModel (), m_rxSpectrumModel);
+      signal.psd = converter.Convert (params->psd);
+    }
+  signal.txAntenna = params->txAntenna;
+  signal.txMobility = params->txPhy->GetMobility ();
+  m_offlineSignals.push_back (signal);
+}
+
+void
+RadioEnvironmentMapHelper::RunOffline ()
+{
+  NS_LOG_FUNCTION (this);
+  m_channel->TraceDisconnectWithoutContext ("TxSigParams",
+                                            MakeCallback (&RadioEnvironmentMapHelper::CaptureSignal, this));
+  NS_LOG_INFO ("computing the map from " << m_offlineSignals.size () << " signals");
+
+  m_propagationLoss = m_channel->GetPropagationLossModel ();
+  m_spectrumPropagationLoss = m_channel->GetSpectrumPropagationLossModel ();
+  DoubleValue maxLossDb;
+  if (m_channel->GetAttributeFailSafe ("MaxLossDb", maxLossDb))
+    {
+      m_maxLossDb = maxLossDb.Get ();
+    }
+  m_bandWidths.clear ();
+  for (Bands::const_iterator it = m_rxSpectrumModel->Begin (); it != m_rxSpectrumModel->End (); ++it)
+    {
+      m_bandWidths.push_back (it->fh - it->fl);
+    }
+
+  uint32_t numThreads = m_numThreads;
+#ifndef HAVE_PTHREAD_H
+  numThreads = 1;
+#endif
+  if (numThreads > 1 && m_spectrumPropagationLoss != 0)
+    {
+      NS_LOG_WARN ("the channel has a SpectrumPropagationLossModel, computing the map with one thread");
+      numThreads = 1;
+    }
+
+  // The first worker uses the mobility models of the transmitters, the
+  // others their own copies, so that the threads do not share the
+  // reference counts of any object
+  std::vector<OfflineWorker> workers (numThreads);
+  for (uint32_t i = 0; i < numThreads; ++i)
+    {
+      workers[i].helper = this;
+      workers[i].rxMobility = CreateObject<ConstantPositionMobilityModel> ();
+      workers[i].rxMobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+      // also creates the BuildingList in the main thread
+      BuildingsHelper::MakeConsistent (workers[i].rxMobility);
+      for (std::vector<OfflineSignal>::const_iterator it = m_offlineSignals.begin ();
+           it != m_offlineSignals.end ();
+           ++it)
+        {
+          Ptr<MobilityModel> txMobility = it->txMobility;
+          if (i > 0 && txMobility != 0)
+            {
+              txMobility = CreateObject<ConstantPositionMobilityModel> ();
+              txMobility->SetPosition (it->txMobility->GetPosition ());
+              if (it->txMobility->GetObject<MobilityBuildingInfo> () != 0)
+                {
+                  txMobility->AggregateObject (CreateObject<MobilityBuildingInfo> ());
+                  BuildingsHelper::MakeConsistent (txMobility);
+                }
+            }
+          workers[i].txMobility.push_back (txMobility);
+        }
+    }
+
+  m_offlinePoints.clear ();
+  m_offlinePoints.reserve (m_maxPointsPerIteration);
+  for (double x = m_xMin; x < m_xMax + 0.5*m_xStep; x += m_xStep)
+    {
+      for (double y = m_yMin; y < m_yMax + 0.5*m_yStep ; y += m_yStep)
+        {
+          m_offlinePoints.push_back (Vector (x, y, m_z));
+          if (m_offlinePoints.size () == m_maxPointsPerIteration)
+            {
+              ComputeOfflineBlock (workers);
+            }
+        }
+    }
+  if (!m_offlinePoints.empty ())
+    {
+      ComputeOfflineBlock (workers);
+    }
+
+  m_offlineSignals.clear ();
+  Finalize ();
+}
+
+void
+RadioEnvironmentMapHelper::ComputeOfflineBlock (std::vector<OfflineWorker> &workers)
+{
+  NS_LOG_FUNCTION (this << m_offlinePoints.size ());
+  uint32_t n = m_offlinePoints.size ();
+  m_offlineSinr.resize (n);
+  for (uint32_t i = 0; i < workers.size (); ++i)
+    {
+      workers[i].first = (uint64_t) n * i / workers.size ();
+      workers[i].last = (uint64_t) n * (i + 1) / workers.size ();
+    }
+
+#ifdef HAVE_PTHREAD_H
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 1; i < workers.size (); ++i)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&OfflineWorker::Run, &workers[i])));
+      threads.back ()->Start ();
+    }
+#endif
+  workers[0].Run ();
+#ifdef HAVE_PTHREAD_H
+  for (uint32_t i = 0; i < threads.size (); ++i)
+    {
+      threads[i]->Join ();
+    }
+#endif
+
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      const Vector &pos = m_offlinePoints[i];
+      m_outFile << pos.x << "\t"
+                << pos.y << "\t"
+                << pos.z << "\t"
+                << m_offlineSinr[i]
+                << "\n";
+    }
+  m_outFile.flush ();
+  m_offlinePoints.clear ();
+}
+
+void
+RadioEnvironmentMapHelper::OfflineWorker::Run (void)
+{
+  for (uint32_t i = first; i < last; ++i)
+    {
+      helper->m_offlineSinr[i] = helper->CalcOfflineSinr (*this, helper->m_offlinePoints[i]);
+    }
+}
+
+double
+RadioEnvironmentMapHelper::CalcOfflineSinr (OfflineWorker &worker, const Vector &point)
+{
+  Ptr<MobilityModel> rxMobility = worker.rxMobility;
+  rxMobility->SetPosition (point);
+  {
+#ifdef HAVE_PTHREAD_H
+    CriticalSection cs (GetBuildingsMutex ());
+#endif
+    BuildingsHelper::MakeConsistent (rxMobility);
+  }
+
+  // as RemSpectrumPhy, with the gains of the channels
+  double referenceSignalPower = 0;
+  double sumPower = 0;
+  for (uint32_t s = 0; s < m_offlineSignals.size (); ++s)
+    {
+      const OfflineSignal &signal = m_offlineSignals[s];
+      Ptr<MobilityModel> txMobility = worker.txMobility[s];
+      double pathGainLinear = 1.0;
+      if (txMobility != 0)
+        {
+          double pathLossDb = 0;
+          if (signal.txAntenna != 0)
+            {
+              Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+              pathLossDb -= signal.txAntenna->GetGainDb (txAngles);
+            }
+          if (m_propagationLoss != 0)
+            {
+              pathLossDb -= m_propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+            }
+          if (pathLossDb > m_maxLossDb)
+            {
+              continue;
+            }
+          pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+        }
+
+      double power = 0;
+      if (m_spectrumPropagationLoss != 0 && txMobility != 0)
+        {
+          Ptr<SpectrumValue> psd = Copy<SpectrumValue> (signal.psd);
+          *psd *= pathGainLinear;
+          psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (psd, txMobility, rxMobility);
+          power = (m_rbId >= 0) ? (*psd)[m_rbId] * 180000 : Integral (*psd);
+        }
+      else
+        {
+          // the same operations on the values, without sharing the
+          // SpectrumModel among the threads
+          Values::const_iterator vit = signal.psd->ConstValuesBegin ();
+          if (m_rbId >= 0)
+            {
+              power = (vit[m_rbId] * pathGainLinear) * 180000;
+            }
+          else
+            {
+              for (uint32_t i = 0; i < m_bandWidths.size (); ++i, ++vit)
+                {
+                  power += (*vit * pathGainLinear) * m_bandWidths[i];
+                }
+            }
+        }
+      sumPower += power;
+      if (power > referenceSignalPower)
+        {
+          referenceSignalPower = power;
+        }
+    }
+  return referenceSignalPower / (sumPower - referenceSignalPower + m_noisePower);
+}
+
 } // namespace ns3
@@ -24,7 +24,10 @@
 
 
 #include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/vector.h>
 #include <fstream>
+#include <vector>
 
 
 namespace ns3 {
@@ -35,6 +38,12 @@ class NetDevice;
 class SpectrumChannel;
 //class BuildingsMobilityModel;
 class MobilityModel;
+class SpectrumValue;
+class SpectrumModel;
+class SpectrumSignalParameters;
+class AntennaModel;
+class PropagationLossModel;
+class SpectrumPropagationLossModel;
 
 /** 
  * \ingroup lte
@@ -108,6 +117,69 @@ private:
   /// Called when the map generation procedure has been completed.
   void Finalize ();
 
+  /**
+   * Trace sink of the signals transmitted on the channel, recording the
+   * DL signals of the subframe used by the offline computation.
+   *
+   * \param params The parameters of the signal.
+   */
+  void CaptureSignal (Ptr<SpectrumSignalParameters> params);
+
+  /**
+   * Scheduled by DelayedInstall() when the `Offline` attribute is set, to
+   * compute the whole map from the signals recorded by CaptureSignal().
+   *
+   * The points are computed and written by blocks of
+   * `MaxPointsPerIteration` points, each block being shared among
+   * `NumThreads` threads.
+   */
+  void RunOffline ();
+
+  /// A DL signal recorded for the offline computation.
+  struct OfflineSignal
+  {
+    /// The PSD, converted to the spectrum model of the map.
+    Ptr<SpectrumValue> psd;
+    /// The TX antenna, or null.
+    Ptr<AntennaModel> txAntenna;
+    /// The mobility model of the transmitter, or null.
+    Ptr<MobilityModel> txMobility;
+  };
+
+  /// A thread computing a part of a block of points of the offline map.
+  struct OfflineWorker
+  {
+    /// The helper.
+    RadioEnvironmentMapHelper *helper;
+    /// The first point of the block to compute.
+    uint32_t first;
+    /// The point after the last one to compute.
+    uint32_t last;
+    /// The position of the listener, moved from point to point.
+    Ptr<MobilityModel> rxMobility;
+    /// The mobility models of the transmitters, one per signal.
+    std::vector<Ptr<MobilityModel> > txMobility;
+    /// Compute the points of the worker.
+    void Run (void);
+  };
+
+  /**
+   * Compute the SINR of a point of the offline map.
+   *
+   * \param worker The thread computing the point.
+   * \param point The position of the point.
+   * \return The SINR.
+   */
+  double CalcOfflineSinr (OfflineWorker &worker, const Vector &point);
+
+  /**
+   * Compute the SINR of the points of a block of the offline map, then
+   * write them to the output file.
+   *
+   * \param workers The threads computing the block.
+   */
+  void ComputeOfflineBlock (std::vector<OfflineWorker> &workers);
+
   /// A complete Radio Environment Map is composed of many of this structure.
   struct RemPoint 
   {
@@ -152,6 +224,28 @@ private:
   bool m_useDataChannel;  ///< The `UseDataChannel` attribute.
   int32_t m_rbId;         ///< The `RbId` attribute.
 
+  bool m_offline;         ///< The `Offline` attribute.
+  uint32_t m_numThreads;  ///< The `NumThreads` attribute.
+
+  /// The spectrum model of the map.
+  Ptr<const SpectrumModel> m_rxSpectrumModel;
+  /// The start of the recording of the signals of the offline map.
+  Time m_captureStart;
+  /// The DL signals recorded for the offline map.
+  std::vector<OfflineSignal> m_offlineSignals;
+  /// The widths of the bands of the spectrum model of the map, in Hz.
+  std::vector<double> m_bandWidths;
+  /// The propagation loss model of the channel, or null.
+  Ptr<PropagationLossModel> m_propagationLoss;
+  /// The spectrum propagation loss model of the channel, or null.
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+  /// The `MaxLossDb` attribute of the channel.
+  double m_maxLossDb;
+  /// The points of the offline map block being computed.
+  std::vector<Vector> m_offlinePoints;
+  /// The SINR of the points of the offline map block being computed.
+  std::vector<double> m_offlineSinr;
+
 }; // end of `class RadioEnvironmentMapHelper`
 
 
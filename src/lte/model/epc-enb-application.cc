@@ -26,6 +26,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 
 #include "epc-gtpu-header.h"
 #include "eps-bearer-tag.h"
@@ -63,7 +64,14 @@ EpcEnbApplication::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::EpcEnbApplication")
     .SetParent<Object> ()
-    .SetGroupName("Lte");
+    .SetGroupName("Lte")
+    .AddAttribute ("FastPath",
+                   "If true, the bearer of the GTP-U packets received from "
+                   "the SGW is found in a table indexed by the TEID.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&EpcEnbApplication::m_fastPath),
+                   MakeBooleanChecker ())
+  ;
   return tid;
 }
 
@@ -83,6 +91,7 @@ EpcEnbApplication::EpcEnbApplication (Ptr<Socket> lteSocket, Ptr<Socket> s1uSock
     m_s1uSocket (s1uSocket),    
     m_enbS1uAddress (enbS1uAddress),
     m_sgwS1uAddress (sgwS1uAddress),
+    m_fastPath (false),
     m_gtpuUdpPort (2152), // fixed by the standard
     m_s1SapUser (0),
     m_s1apSapMme (0),
@@ -162,6 +171,7 @@ EpcEnbApplication::DoPathSwitchRequest (EpcEnbS1SapProvider::PathSwitchRequestPa
       // side effect: create entries if not exist
       m_rbidTeidMap[params.rnti][bit->epsBearerId] = teid;
       m_teidRbidMap[teid] = rbid;
+      SetTeidRbidTableEntry (teid, rbid);
 
       EpcS1apSapMme::ErabSwitchedInDownlinkItem erab;
       erab.erabId = bit->epsBearerId;
@@ -186,6 +196,7 @@ EpcEnbApplication::DoUeContextRelease (uint16_t rnti)
         {
           uint32_t teid = bidIt->second;
           m_teidRbidMap.erase (teid);
+          SetTeidRbidTableEntry (teid, EpsFlowId_t (0, 0));
         }
       m_rbidTeidMap.erase (rntiIt);
     }
@@ -218,6 +229,7 @@ EpcEnbApplication::DoInitialContextSetupRequest (uint64_t mmeUeS1Id, uint16_t en
       // side effect: create entries if not exist
       m_rbidTeidMap[rnti][erabIt->erabId] = params.gtpTeid;
       m_teidRbidMap[params.gtpTeid] = rbid;
+      SetTeidRbidTableEntry (params.gtpTeid, rbid);
 
     }
 }
@@ -277,17 +289,39 @@ EpcEnbApplication::RecvFromS1uSocket (Ptr<Socket> socket)
   GtpuHeader gtpu;
   packet->RemoveHeader (gtpu);
   uint32_t teid = gtpu.GetTeid ();
-  std::map<uint32_t, EpsFlowId_t>::iterator it = m_teidRbidMap.find (teid);
-  NS_ASSERT (it != m_teidRbidMap.end ());
 
   /// \internal
   /// Workaround for \bugid{231}
   SocketAddressTag tag;
   packet->RemovePacketTag (tag);
+
+  if (m_fastPath)
+    {
+      NS_ASSERT (teid < m_teidRbidTable.size () && m_teidRbidTable[teid].m_rnti != 0);
+      SendToLteSocket (packet, m_teidRbidTable[teid].m_rnti, m_teidRbidTable[teid].m_bid);
+      return;
+    }
+  std::map<uint32_t, EpsFlowId_t>::iterator it = m_teidRbidMap.find (teid);
+  NS_ASSERT (it != m_teidRbidMap.end ());
   
   SendToLteSocket (packet, it->second.m_rnti, it->second.m_bid);
 }
 
+void
+EpcEnbApplication::SetTeidRbidTableEntry (uint32_t teid, EpsFlowId_t rbid)
+{
+  NS_LOG_FUNCTION (this << teid << rbid.m_rnti << (uint16_t) rbid.m_bid);
+  if (!m_fastPath)
+    {
+      return;
+    }
+  if (teid >= m_teidRbidTable.size ())
+    {
+      m_teidRbidTable.resize (teid + 1, EpsFlowId_t (0, 0));
+    }
+  m_teidRbidTable[teid] = rbid;
+}
+
 void 
 EpcEnbApplication::SendToLteSocket (Ptr<Packet> packet, uint16_t rnti, uint8_t bid)
 {
@@ -35,6 +35,7 @@
 #include <ns3/epc-enb-s1-sap.h>
 #include <ns3/epc-s1ap-sap.h>
 #include <map>
+#include <vector>
 
 namespace ns3 {
 class EpcEnbS1SapUser;
@@ -217,6 +218,28 @@ private:
    * 
    */
   std::map<uint32_t, EpsFlowId_t> m_teidRbidMap;
+
+  /**
+   * The `FastPath` attribute: look the S1-U TEIDs up in
+   * m_teidRbidTable rather than in m_teidRbidMap
+   */
+  bool m_fastPath;
+
+  /**
+   * table telling for each S1-U TEID the corresponding RNTI,BID, an
+   * RNTI 0 meaning no bearer; it is filled with the fast path only,
+   * and indexed directly by the TEID, which the SGW allocates
+   * sequentially
+   */
+  std::vector<EpsFlowId_t> m_teidRbidTable;
+
+  /**
+   * Set an entry of m_teidRbidTable, growing the table if needed.
+   *
+   * \param teid the S1-U TEID
+   * \param rbid the RNTI and BID of the bearer, or RNTI 0 to clear the entry
+   */
+  void SetTeidRbidTableEntry (uint32_t teid, EpsFlowId_t rbid);
  
   /**
    * UDP port to be used for GTP
@@ -27,6 +27,7 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/epc-gtpu-header.h"
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 
 namespace ns3 {
 
@@ -67,6 +68,13 @@ EpcSgwPgwApplication::UeInfo::Classify (Ptr<Packet> p)
   return m_tftClassifier.Classify (p, EpcTft::DOWNLINK);
 }
 
+uint32_t
+EpcSgwPgwApplication::UeInfo::Classify (const uint8_t *headers, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  return m_tftClassifier.Classify (headers, size, EpcTft::DOWNLINK);
+}
+
 Ipv4Address 
 EpcSgwPgwApplication::UeInfo::GetEnbAddr ()
 {
@@ -101,7 +109,16 @@ EpcSgwPgwApplication::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::EpcSgwPgwApplication")
     .SetParent<Object> ()
-    .SetGroupName("Lte");
+    .SetGroupName("Lte")
+    .AddAttribute ("FastPath",
+                   "If true, the downlink packets are classified from the "
+                   "bytes of their IPv4 and UDP or TCP headers, without "
+                   "copying the packets, and the result is kept in a flow "
+                   "table per UE.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&EpcSgwPgwApplication::m_fastPath),
+                   MakeBooleanChecker ())
+  ;
   return tid;
 }
 
@@ -121,6 +138,7 @@ EpcSgwPgwApplication::EpcSgwPgwApplication (const Ptr<VirtualNetDevice> tunDevic
     m_tunDevice (tunDevice),
     m_gtpuUdpPort (2152), // fixed by the standard
     m_teidCount (0),
+    m_fastPath (false),
     m_s11SapMme (0)
 {
   NS_LOG_FUNCTION (this << tunDevice << s1uSocket);
@@ -140,6 +158,36 @@ EpcSgwPgwApplication::RecvFromTunDevice (Ptr<Packet> packet, const Address& sour
 {
   NS_LOG_FUNCTION (this << source << dest << packet << packet->GetSize ());
 
+  if (m_fastPath)
+    {
+      // the largest IPv4 header and the ports of the UDP or TCP header
+      uint8_t headers[64];
+      uint32_t size = packet->CopyData (headers, sizeof (headers));
+      if (size < 20)
+        {
+          NS_LOG_WARN ("truncated IPv4 header");
+          return true;
+        }
+      Ipv4Address ueAddr = Ipv4Address::Deserialize (headers + 16);
+      NS_LOG_LOGIC ("packet addressed to UE " << ueAddr);
+      std::map<Ipv4Address, Ptr<UeInfo> >::iterator it = m_ueInfoByAddrMap.find (ueAddr);
+      if (it == m_ueInfoByAddrMap.end ())
+        {
+          NS_LOG_WARN ("unknown UE address " << ueAddr);
+          return true;
+        }
+      uint32_t teid = it->second->Classify (headers, size);
+      if (teid == 0)
+        {
+          NS_LOG_WARN ("no matching bearer for this packet");
+        }
+      else
+        {
+          SendToS1uSocket (packet, it->second->GetEnbAddr (), teid);
+        }
+      return true;
+    }
+
   // get IP address of UE
   Ptr<Packet> pCopy = packet->Copy ();
   Ipv4Header ipv4Header;
@@ -193,6 +193,19 @@ public:
      */
     uint32_t Classify (Ptr<Packet> p);
 
+    /**
+     * Classify an IP packet from the bytes of its headers, as with
+     * EpcTftClassifier::Classify (const uint8_t *, uint32_t, EpcTft::Direction).
+     *
+     * \param headers the first bytes of the IP packet from the internet
+     * \param size the number of bytes in headers
+     *
+     * \return the corresponding bearer ID > 0 identifying the bearer
+     * among all the bearers of this UE;  returns 0 if no bearers
+     * matches with the previously declared TFTs
+     */
+    uint32_t Classify (const uint8_t *headers, uint32_t size);
+
     /** 
      * \return the address of the eNB to which the UE is connected
      */
@@ -254,6 +267,12 @@ public:
 
   uint32_t m_teidCount;
 
+  /**
+   * The `FastPath` attribute: classify the downlink packets from the
+   * bytes of their headers, with a flow table per UE
+   */
+  bool m_fastPath;
+
   /**
    * MME side of the S11 SAP
    * 
@@ -35,11 +35,17 @@
 #include "ns3/tcp-header.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/tcp-l4-protocol.h"
+#include "ns3/hash.h"
+
+#include <cstring>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EpcTftClassifier");
 
+/// number of entries of the flow table of a classifier, a power of 2
+static const uint32_t FLOW_TABLE_SIZE = 16;
+
 EpcTftClassifier::EpcTftClassifier ()
 {
   NS_LOG_FUNCTION (this);
@@ -51,6 +57,8 @@ EpcTftClassifier::Add (Ptr<EpcTft> tft, uint32_t id)
   NS_LOG_FUNCTION (this << tft);
   
   m_tftMap[id] = tft;  
+  m_flowTable.clear ();
+  m_flowMap.clear ();
   
   // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
   NS_ASSERT (m_tftMap.size () <= 16);
@@ -61,6 +69,8 @@ EpcTftClassifier::Delete (uint32_t id)
 {
   NS_LOG_FUNCTION (this << id);
   m_tftMap.erase (id);
+  m_flowTable.clear ();
+  m_flowMap.clear ();
 }
 
  
@@ -141,6 +151,117 @@ EpcTftClassifier::Classify (Ptr<Packet> p, EpcTft::Direction direction)
 	       << " remotePort=" << remotePort 
 	       << " tos=0x" << (uint16_t) tos );
 
+  return Match (direction, remoteAddress, localAddress, remotePort, localPort, tos);
+}
+
+uint32_t 
+EpcTftClassifier::Classify (const uint8_t *headers, uint32_t size, EpcTft::Direction direction)
+{
+  NS_LOG_FUNCTION (this << size << direction);
+
+  // the fields read by Classify (Ptr<Packet>, EpcTft::Direction) from
+  // the IPv4 header and the UDP or TCP header
+  if (size < 20)
+    {
+      NS_LOG_INFO ("Truncated IPv4 header");
+      return 0;
+    }
+  uint32_t ihl = (headers[0] & 0x0f) * 4;
+  uint8_t protocol = headers[9];
+  if (protocol != UdpL4Protocol::PROT_NUMBER && protocol != TcpL4Protocol::PROT_NUMBER)
+    {
+      NS_LOG_INFO ("Unknown protocol: " << protocol);
+      return 0;  // no match
+    }
+  if (ihl < 20 || size < ihl + 4)
+    {
+      NS_LOG_INFO ("Truncated transport header");
+      return 0;
+    }
+
+  // the key holds the remote address and port before the local ones
+  FlowKey flowKey;
+  uint8_t *key = flowKey.bytes;
+  key[0] = direction;
+  key[1] = headers[1];
+  if (direction == EpcTft::UPLINK)
+    {
+      std::memcpy (key + 2, headers + 16, 4);
+      std::memcpy (key + 6, headers + 12, 4);
+      std::memcpy (key + 10, headers + ihl + 2, 2);
+      std::memcpy (key + 12, headers + ihl, 2);
+    }
+  else
+    {
+      NS_ASSERT (direction == EpcTft::DOWNLINK);
+      std::memcpy (key + 2, headers + 12, 4);
+      std::memcpy (key + 6, headers + 16, 4);
+      std::memcpy (key + 10, headers + ihl, 2);
+      std::memcpy (key + 12, headers + ihl + 2, 2);
+    }
+
+  if (m_flowTable.empty ())
+    {
+      FlowEntry empty;
+      empty.valid = false;
+      m_flowTable.resize (FLOW_TABLE_SIZE, empty);
+    }
+  FlowEntry &entry = m_flowTable[FlowKeyHash () (flowKey) & (FLOW_TABLE_SIZE - 1)];
+  if (entry.valid && entry.key == flowKey)
+    {
+      NS_LOG_LOGIC ("cached flow, TFT ID = " << entry.id);
+      return entry.id;
+    }
+
+  // on a cache miss, look for the flow among all the flows classified,
+  // so that more flows than cache entries do not evaluate the TFTs
+  // again at each collision
+  uint32_t id;
+  sgi::hash_map<FlowKey, uint32_t, FlowKeyHash>::const_iterator it = m_flowMap.find (flowKey);
+  if (it != m_flowMap.end ())
+    {
+      NS_LOG_LOGIC ("known flow, TFT ID = " << it->second);
+      id = it->second;
+    }
+  else
+    {
+      Ipv4Address remoteAddress = Ipv4Address::Deserialize (key + 2);
+      Ipv4Address localAddress = Ipv4Address::Deserialize (key + 6);
+      uint16_t remotePort = (key[10] << 8) | key[11];
+      uint16_t localPort = (key[12] << 8) | key[13];
+      id = Match (direction, remoteAddress, localAddress, remotePort, localPort, key[1]);
+      if (m_flowMap.size () >= MAX_FLOWS)
+        {
+          // bound the memory of a UE with many short flows
+          NS_LOG_LOGIC ("flushing " << m_flowMap.size () << " flows");
+          m_flowMap.clear ();
+        }
+      m_flowMap[flowKey] = id;
+    }
+  entry.key = flowKey;
+  entry.valid = true;
+  entry.id = id;
+  return id;
+}
+
+bool
+EpcTftClassifier::FlowKey::operator == (const FlowKey &o) const
+{
+  return std::memcmp (bytes, o.bytes, sizeof (bytes)) == 0;
+}
+
+size_t
+EpcTftClassifier::FlowKeyHash::operator() (const FlowKey &key) const
+{
+  return Hash32 ((const char *) key.bytes, sizeof (key.bytes));
+}
+
+uint32_t 
+EpcTftClassifier::Match (EpcTft::Direction direction, Ipv4Address remoteAddress, Ipv4Address localAddress,
+                         uint16_t remotePort, uint16_t localPort, uint8_t tos)
+{
+  NS_LOG_FUNCTION (this << direction << remoteAddress << localAddress << remotePort << localPort << (uint16_t) tos);
+
   // now it is possible to classify the packet!
   // we use a reverse iterator since filter priority is not implemented properly.
   // This way, since the default bearer is expected to be added first, it will be evaluated last.
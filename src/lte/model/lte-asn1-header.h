@@ -25,6 +25,7 @@
 
 #include <bitset>
 #include <string>
+#include <vector>
 
 namespace ns3 {
 
@@ -69,15 +70,27 @@ protected:
   mutable uint8_t m_numSerializationPendingBits; //!< number of pending bits
   mutable bool m_isDataSerialized; //!< true if data is serialized
   mutable Buffer m_serializationResult; //!< serialization result
+  /// octets written so far, moved to m_serializationResult when finalized
+  mutable std::vector<uint8_t> m_serializationOctets;
 
   /**
-   * Function to write in m_serializationResult, after resizing its size
+   * Function to append an octet to the serialization in progress
    * \param octet bits to write
    */
   void WriteOctet (uint8_t octet) const;
 
   // Serialization functions
 
+  /**
+   * Serialize the least significant bits of a word, most significant
+   * bit first.  This is the primitive all the other serialization
+   * functions rely on: the bits are packed in whole octets, instead
+   * of one at a time.
+   * \param value the bits to serialize
+   * \param nBits the number of bits, at most 32
+   */
+  void SerializeBits (uint32_t value, uint8_t nBits) const;
+
   /**
    * Serialize a bool
    * \param value value to serialize
@@ -256,6 +269,18 @@ protected:
 
   // Deserialization functions
 
+  /**
+   * Deserialize bits into the least significant bits of a word, most
+   * significant bit first.  This is the primitive all the other
+   * deserialization functions rely on.
+   * \param value buffer to store the result
+   * \param nBits the number of bits, at most 32
+   * \param bIterator buffer iterator
+   * \returns the modified buffer iterator
+   */
+  Buffer::Iterator DeserializeBits (uint32_t *value, uint8_t nBits,
+                                    Buffer::Iterator bIterator);
+
   /**
    * Deserialize a bitset
    * \param data buffer to store the result
@@ -26,6 +26,7 @@
 #include <ns3/simulator.h>
 #include <ns3/attribute-accessor-helper.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 
 
 #include "lte-enb-phy.h"
@@ -145,7 +146,8 @@ LteEnbPhy::LteEnbPhy (Ptr<LteSpectrumPhy> dlPhy, Ptr<LteSpectrumPhy> ulPhy)
     m_srsPeriodicity (0),
     m_srsStartTime (Seconds (0)),
     m_currentSrsOffset (0),
-    m_interferenceSampleCounter (0)
+    m_interferenceSampleCounter (0),
+    m_idleSubframeSuppression (false)
 {
   m_enbPhySapProvider = new EnbMemberLteEnbPhySapProvider (this);
   m_enbCphySapProvider = new MemberLteEnbCphySapProvider<LteEnbPhy> (this);
@@ -209,6 +211,14 @@ LteEnbPhy::GetTypeId (void)
                    UintegerValue (1),  /// \todo In what unit is this?
                    MakeUintegerAccessor (&LteEnbPhy::m_interferenceSamplePeriod),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("IdleSubframeSuppression",
+                   "If true, skip the transmission of the DL control frame "
+                   "in the subframes without control messages nor data, "
+                   "except in the subframes carrying the PSS, so that the "
+                   "UE measurements are not affected.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LteEnbPhy::m_idleSubframeSuppression),
+                   MakeBooleanChecker ())
     .AddTraceSource ("DlPhyTransmission",
                      "DL transmission PHY layer statistics.",
                      MakeTraceSourceAccessor (&LteEnbPhy::m_dlPhyTransmission),
@@ -744,10 +754,20 @@ LteEnbPhy::StartSubFrame (void)
         }
     }
 
-  SendControlChannels (ctrlMsg);
+  Ptr<PacketBurst> pb = GetPacketBurst ();
+  if (m_idleSubframeSuppression && ctrlMsg.empty () && (pb == 0)
+      && (m_nrSubFrames != 1) && (m_nrSubFrames != 6))
+    {
+      // nothing to send and no PSS: skip the control frame, which would
+      // only be processed as interference by all the UEs around
+      NS_LOG_LOGIC (this << " eNB idle subframe, no TX CTRL");
+    }
+  else
+    {
+      SendControlChannels (ctrlMsg);
+    }
 
   // send data frame
-  Ptr<PacketBurst> pb = GetPacketBurst ();
   if (pb)
     {
       Simulator::Schedule (DL_CTRL_DELAY_FROM_SUBFRAME_START, // ctrl frame fixed to 3 symbols
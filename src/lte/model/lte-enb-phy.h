@@ -426,6 +426,13 @@ private:
   uint16_t m_interferenceSamplePeriod;
   uint16_t m_interferenceSampleCounter;
 
+  /**
+   * The `IdleSubframeSuppression` attribute. If true, the DL control frame
+   * is not transmitted in the subframes without control messages, data
+   * and PSS.
+   */
+  bool m_idleSubframeSuppression;
+
   /**
    * The `DlPhyTransmission` trace source. Contains trace information regarding
    * PHY stats from DL Tx perspective. Exporting a structure with type
@@ -0,0 +1,469 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-link-budget-spectrum-channel.h"
+#include "lte-spectrum-phy.h"
+#include "lte-spectrum-signal-parameters.h"
+
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/net-device.h>
+#include <ns3/node.h>
+#include <ns3/mobility-model.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/angles.h>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteLinkBudgetSpectrumChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (LteLinkBudgetSpectrumChannel);
+
+
+LteLinkBudgetSpectrumChannel::LinkBudget::LinkBudget ()
+  : valid (false),
+    lossDb (0.0),
+    gainLinear (1.0)
+{
+}
+
+
+LteLinkBudgetSpectrumChannel::LteLinkBudgetSpectrumChannel ()
+  : m_maxLossDb (1.0e9),
+    m_maxMove (0.0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LteLinkBudgetSpectrumChannel::~LteLinkBudgetSpectrumChannel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LteLinkBudgetSpectrumChannel::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+  m_propagationLoss = 0;
+  m_spectrumPropagationLoss = 0;
+  m_propagationDelay = 0;
+  m_receivers.clear ();
+  m_rxPhySet.clear ();
+  m_txIndex.clear ();
+  m_converters.clear ();
+  m_batch = 0;
+  SpectrumChannel::DoDispose ();
+}
+
+TypeId
+LteLinkBudgetSpectrumChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LteLinkBudgetSpectrumChannel")
+    .SetParent<SpectrumChannel> ()
+    .SetGroupName ("Lte")
+    .AddConstructor<LteLinkBudgetSpectrumChannel> ()
+    .AddAttribute ("MaxLossDb",
+                   "The maximum loss in dB of a link, including the "
+                   "antenna gains, for which the signals are delivered "
+                   "to the receiver, either individually or as "
+                   "interference.  The default value delivers all the "
+                   "signals.",
+                   DoubleValue (1.0e9),
+                   MakeDoubleAccessor (&LteLinkBudgetSpectrumChannel::m_maxLossDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxMove",
+                   "The distance in meters either end of a link may move "
+                   "before its link budget is evaluated again.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&LteLinkBudgetSpectrumChannel::m_maxMove),
+                   MakeDoubleChecker<double> (0.0))
+    .AddTraceSource ("PathLoss",
+                     "This trace is fired whenever the link budget of a "
+                     "pair of TX and RX SpectrumPhy instances is "
+                     "evaluated, with the TX and RX SpectrumPhy "
+                     "instances and the loss in dB due to the antennas "
+                     "and the PropagationLossModel.",
+                     MakeTraceSourceAccessor (&LteLinkBudgetSpectrumChannel::m_pathLossTrace),
+                     "ns3::SpectrumChannel::LossTracedCallback")
+    .AddTraceSource ("TxSigParams",
+                     "This trace is fired whenever a signal is transmitted "
+                     "on the channel, with the parameters of the signal.",
+                     MakeTraceSourceAccessor (&LteLinkBudgetSpectrumChannel::m_txSigParamsTrace),
+                     "ns3::SpectrumChannel::SignalParametersTracedCallback")
+  ;
+  return tid;
+}
+
+
+void
+LteLinkBudgetSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
+{
+  NS_LOG_FUNCTION (this << phy);
+  // the LteUePhy adds its PHY again whenever the DL bandwidth is
+  // configured; the SpectrumModel is looked up at every reception
+  if (m_rxPhySet.insert (phy).second)
+    {
+      Receiver receiver;
+      receiver.phy = phy;
+      receiver.ltePhy = DynamicCast<LteSpectrumPhy> (phy);
+      m_receivers.push_back (receiver);
+    }
+}
+
+
+void
+LteLinkBudgetSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams);
+
+  NS_ASSERT (txParams->txPhy);
+  NS_ASSERT (txParams->psd);
+
+  m_txSigParamsTrace (txParams);
+
+  Signal signal;
+  signal.params = txParams;
+  signal.txMobility = txParams->txPhy->GetMobility ();
+  if (signal.txMobility)
+    {
+      signal.txPosition = signal.txMobility->GetPosition ();
+    }
+  std::map<Ptr<const SpectrumPhy>, uint32_t>::iterator txIt = m_txIndex.find (txParams->txPhy);
+  if (txIt == m_txIndex.end ())
+    {
+      uint32_t txIndex = m_txIndex.size ();
+      txIt = m_txIndex.insert (std::make_pair (txParams->txPhy, txIndex)).first;
+    }
+  signal.txIndex = txIt->second;
+  signal.type = OTHER;
+  signal.cellId = 0;
+  signal.pss = false;
+
+  Ptr<LteSpectrumSignalParametersDataFrame> dataParams = DynamicCast<LteSpectrumSignalParametersDataFrame> (txParams);
+  Ptr<LteSpectrumSignalParametersDlCtrlFrame> dlCtrlParams = DynamicCast<LteSpectrumSignalParametersDlCtrlFrame> (txParams);
+  Ptr<LteSpectrumSignalParametersUlSrsFrame> ulSrsParams = DynamicCast<LteSpectrumSignalParametersUlSrsFrame> (txParams);
+  if (dataParams != 0)
+    {
+      signal.type = DATA;
+      signal.cellId = dataParams->cellId;
+    }
+  else if (dlCtrlParams != 0)
+    {
+      signal.type = DL_CTRL;
+      signal.cellId = dlCtrlParams->cellId;
+      signal.pss = dlCtrlParams->pss;
+    }
+  else if (ulSrsParams != 0)
+    {
+      signal.type = UL_SRS;
+      signal.cellId = ulSrsParams->cellId;
+    }
+
+  if (m_batch == 0 || m_batch->time != Simulator::Now ())
+    {
+      // first signal transmitted now: the other PHYs transmitting now
+      // have their events already scheduled, so that their signals
+      // join the batch before it is delivered
+      m_batch = Create<Batch> ();
+      m_batch->time = Simulator::Now ();
+      for (uint32_t i = 0; i < m_receivers.size (); ++i)
+        {
+          Ptr<NetDevice> netDev = m_receivers[i].phy->GetDevice ();
+          if (netDev)
+            {
+              Simulator::ScheduleWithContext (netDev->GetNode ()->GetId (), Seconds (0),
+                                              &LteLinkBudgetSpectrumChannel::Deliver, this,
+                                              m_batch, i);
+            }
+          else
+            {
+              Simulator::ScheduleNow (&LteLinkBudgetSpectrumChannel::Deliver, this,
+                                      m_batch, i);
+            }
+        }
+    }
+  m_batch->signals.push_back (signal);
+}
+
+
+void
+LteLinkBudgetSpectrumChannel::Deliver (Ptr<Batch> batch, uint32_t rxIndex)
+{
+  NS_LOG_FUNCTION (this << rxIndex);
+
+  if (batch == m_batch)
+    {
+      // any later signal is delivered in a new batch
+      m_batch = 0;
+    }
+
+  Receiver &receiver = m_receivers[rxIndex];
+  Ptr<SpectrumPhy> rxPhy = receiver.phy;
+  Ptr<const SpectrumModel> rxModel = rxPhy->GetRxSpectrumModel ();
+  NS_ASSERT (rxModel);
+  uint16_t cellId = receiver.ltePhy ? receiver.ltePhy->GetCellId () : 0;
+  Ptr<MobilityModel> rxMobility = rxPhy->GetMobility ();
+  Vector rxPosition;
+  if (rxMobility)
+    {
+      rxPosition = rxMobility->GetPosition ();
+    }
+
+  std::vector<Ptr<SpectrumSignalParameters> > rxParamsList;
+  std::vector<Aggregate> aggregates;
+  for (std::vector<Signal>::const_iterator it = batch->signals.begin ();
+       it != batch->signals.end (); ++it)
+    {
+      if (it->params->txPhy == rxPhy)
+        {
+          continue;
+        }
+      bool linked = it->txMobility && rxMobility;
+      double gainLinear = 1.0;
+      if (linked)
+        {
+          const LinkBudget &link = GetLinkBudget (*it, receiver, rxMobility, rxPosition);
+          if (link.lossDb > m_maxLossDb)
+            {
+              // beyond range
+              continue;
+            }
+          gainLinear = link.gainLinear;
+        }
+      Ptr<SpectrumValue> psd = ConvertPsd (it->params->psd, rxModel);
+
+      if (receiver.ltePhy && it->type != OTHER && it->cellId != cellId && !it->pss)
+        {
+          // interference only: add it to the sum of its type
+          std::vector<Aggregate>::iterator aggIt = aggregates.begin ();
+          while (aggIt != aggregates.end ()
+                 && (aggIt->type != it->type || aggIt->duration != it->params->duration))
+            {
+              ++aggIt;
+            }
+          if (aggIt == aggregates.end ())
+            {
+              Aggregate aggregate;
+              aggregate.type = it->type;
+              aggregate.duration = it->params->duration;
+              aggregate.params = CreateAggregate (*it, rxModel);
+              aggIt = aggregates.insert (aggregates.end (), aggregate);
+            }
+          Values::iterator sum = aggIt->params->psd->ValuesBegin ();
+          for (Values::const_iterator v = psd->ConstValuesBegin ();
+               v != psd->ConstValuesEnd (); ++v, ++sum)
+            {
+              *sum += gainLinear * (*v);
+            }
+        }
+      else
+        {
+          Ptr<SpectrumSignalParameters> rxParams = it->params->Copy ();
+          rxParams->psd = Copy<SpectrumValue> (psd);
+          if (linked)
+            {
+              *(rxParams->psd) *= gainLinear;
+              if (m_spectrumPropagationLoss)
+                {
+                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, it->txMobility, rxMobility);
+                }
+            }
+          rxParamsList.push_back (rxParams);
+        }
+    }
+
+  for (std::vector<Aggregate>::const_iterator aggIt = aggregates.begin ();
+       aggIt != aggregates.end (); ++aggIt)
+    {
+      rxParamsList.push_back (aggIt->params);
+    }
+  NS_LOG_LOGIC ("delivering " << rxParamsList.size () << " signals of "
+                << batch->signals.size () << " to " << rxPhy);
+  for (std::vector<Ptr<SpectrumSignalParameters> >::const_iterator it = rxParamsList.begin ();
+       it != rxParamsList.end (); ++it)
+    {
+      rxPhy->StartRx (*it);
+    }
+}
+
+
+const LteLinkBudgetSpectrumChannel::LinkBudget &
+LteLinkBudgetSpectrumChannel::GetLinkBudget (const Signal &signal,
+                                             Receiver &receiver,
+                                             Ptr<MobilityModel> rxMobility,
+                                             const Vector &rxPosition)
+{
+  if (receiver.links.size () <= signal.txIndex)
+    {
+      receiver.links.resize (m_txIndex.size ());
+    }
+  LinkBudget &link = receiver.links[signal.txIndex];
+  if (link.valid
+      && link.txAntenna == signal.params->txAntenna
+      && CalculateDistance (link.txPosition, signal.txPosition) <= m_maxMove
+      && CalculateDistance (link.rxPosition, rxPosition) <= m_maxMove)
+    {
+      return link;
+    }
+
+  NS_LOG_LOGIC ("evaluating the link budget from " << signal.params->txPhy << " to " << receiver.phy);
+  double lossDb = 0;
+  if (signal.params->txAntenna != 0)
+    {
+      Angles txAngles (rxPosition, signal.txPosition);
+      lossDb -= signal.params->txAntenna->GetGainDb (txAngles);
+    }
+  Ptr<AntennaModel> rxAntenna = receiver.phy->GetRxAntenna ();
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (signal.txPosition, rxPosition);
+      lossDb -= rxAntenna->GetGainDb (rxAngles);
+    }
+  if (m_propagationLoss)
+    {
+      lossDb -= m_propagationLoss->CalcRxPower (0, signal.txMobility, rxMobility);
+    }
+  m_pathLossTrace (signal.params->txPhy, receiver.phy, lossDb);
+
+  link.valid = true;
+  link.txPosition = signal.txPosition;
+  link.rxPosition = rxPosition;
+  link.txAntenna = signal.params->txAntenna;
+  link.lossDb = lossDb;
+  link.gainLinear = std::pow (10.0, -lossDb / 10.0);
+  return link;
+}
+
+
+Ptr<SpectrumValue>
+LteLinkBudgetSpectrumChannel::ConvertPsd (Ptr<SpectrumValue> txPsd,
+                                          Ptr<const SpectrumModel> rxModel)
+{
+  SpectrumModelUid_t txUid = txPsd->GetSpectrumModelUid ();
+  SpectrumModelUid_t rxUid = rxModel->GetUid ();
+  if (txUid == rxUid)
+    {
+      return txPsd;
+    }
+  std::pair<SpectrumModelUid_t, SpectrumModelUid_t> key (txUid, rxUid);
+  std::map<std::pair<SpectrumModelUid_t, SpectrumModelUid_t>, SpectrumConverter>::iterator it = m_converters.find (key);
+  if (it == m_converters.end ())
+    {
+      NS_LOG_LOGIC ("creating converter between SpectrumModelUids " << txUid << " and " << rxUid);
+      it = m_converters.insert (std::make_pair (key, SpectrumConverter (txPsd->GetSpectrumModel (), rxModel))).first;
+    }
+  return it->second.Convert (txPsd);
+}
+
+
+Ptr<SpectrumSignalParameters>
+LteLinkBudgetSpectrumChannel::CreateAggregate (const Signal &signal,
+                                               Ptr<const SpectrumModel> rxModel)
+{
+  // the sum carries the type and the cell of one of its signals, so that
+  // the LteSpectrumPhy adds it to the interference of that type and does
+  // not synchronize with it
+  Ptr<SpectrumSignalParameters> params;
+  switch (signal.type)
+    {
+    case DATA:
+      {
+        Ptr<LteSpectrumSignalParametersDataFrame> dataParams = Create<LteSpectrumSignalParametersDataFrame> ();
+        dataParams->cellId = signal.cellId;
+        params = dataParams;
+      }
+      break;
+    case DL_CTRL:
+      {
+        Ptr<LteSpectrumSignalParametersDlCtrlFrame> dlCtrlParams = Create<LteSpectrumSignalParametersDlCtrlFrame> ();
+        dlCtrlParams->cellId = signal.cellId;
+        dlCtrlParams->pss = false;
+        params = dlCtrlParams;
+      }
+      break;
+    case UL_SRS:
+      {
+        Ptr<LteSpectrumSignalParametersUlSrsFrame> ulSrsParams = Create<LteSpectrumSignalParametersUlSrsFrame> ();
+        ulSrsParams->cellId = signal.cellId;
+        params = ulSrsParams;
+      }
+      break;
+    default:
+      NS_FATAL_ERROR ("only LTE signals are summed");
+      break;
+    }
+  params->duration = signal.params->duration;
+  params->txPhy = signal.params->txPhy;
+  params->psd = Create<SpectrumValue> (rxModel);
+  return params;
+}
+
+
+uint32_t
+LteLinkBudgetSpectrumChannel::GetNDevices (void) const
+{
+  return m_receivers.size ();
+}
+
+Ptr<NetDevice>
+LteLinkBudgetSpectrumChannel::GetDevice (uint32_t i) const
+{
+  NS_ASSERT (i < m_receivers.size ());
+  return m_receivers[i].phy->GetDevice ();
+}
+
+void
+LteLinkBudgetSpectrumChannel::AddPropagationLossModel (Ptr<PropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  NS_ASSERT (m_propagationLoss == 0);
+  m_propagationLoss = loss;
+}
+
+void
+LteLinkBudgetSpectrumChannel::AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss)
+{
+  NS_LOG_FUNCTION (this << loss);
+  NS_ASSERT (m_spectrumPropagationLoss == 0);
+  m_spectrumPropagationLoss = loss;
+}
+
+void
+LteLinkBudgetSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel> delay)
+{
+  NS_LOG_FUNCTION (this << delay);
+  NS_ASSERT (m_propagationDelay == 0);
+  NS_LOG_WARN ("the propagation delay is neglected by LteLinkBudgetSpectrumChannel");
+  m_propagationDelay = delay;
+}
+
+Ptr<PropagationLossModel>
+LteLinkBudgetSpectrumChannel::GetPropagationLossModel (void)
+{
+  return m_propagationLoss;
+}
+
+Ptr<SpectrumPropagationLossModel>
+LteLinkBudgetSpectrumChannel::GetSpectrumPropagationLossModel (void)
+{
+  return m_spectrumPropagationLoss;
+}
+
+
+} // namespace ns3
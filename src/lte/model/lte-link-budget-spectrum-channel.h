@@ -0,0 +1,244 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_LINK_BUDGET_SPECTRUM_CHANNEL_H
+#define LTE_LINK_BUDGET_SPECTRUM_CHANNEL_H
+
+#include <ns3/spectrum-channel.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-converter.h>
+#include <ns3/spectrum-propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/simple-ref-count.h>
+#include <ns3/nstime.h>
+#include <ns3/vector.h>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+class LteSpectrumPhy;
+class MobilityModel;
+
+
+/**
+ * \ingroup lte
+ *
+ * An abstract (link-to-system) SpectrumChannel for large LTE
+ * scenarios, selected with
+ * LteHelper::SetSpectrumChannelType ("ns3::LteLinkBudgetSpectrumChannel").
+ *
+ * The channel keeps a link budget table, i.e., the antenna gains and
+ * the loss of the single-frequency PropagationLossModel of each pair
+ * of TX and RX SpectrumPhy instances.  An entry is evaluated at the
+ * first transmission, and again only when either end moves by more
+ * than MaxMove or the TX antenna changes.
+ *
+ * The signals transmitted at the same time are delivered together.
+ * An LteSpectrumPhy receives individually only the signals of its own
+ * cell and the PSS of all the cells, which carry information.  The
+ * signals of the other cells are only interference: they are summed,
+ * weighted by the link budget, into a single signal per type and
+ * duration, i.e., a single LteInterference update instead of one per
+ * cell.  The SINR and the RSRP, hence the CQI, the AMC and the
+ * LteMiErrorModel evaluation of every TB, are computed by the
+ * LteSpectrumPhy as with the MultiModelSpectrumChannel.
+ *
+ * The price of the abstraction is that:
+ *  - the SpectrumPropagationLossModel, e.g., the fading, is applied
+ *    only to the signals received individually, while the
+ *    interference of the other cells is frequency-flat. As a
+ *    consequence, the pathloss model must be a PropagationLossModel;
+ *  - the propagation delay is neglected;
+ *  - the PropagationLossModel is evaluated once per link budget entry,
+ *    so random losses, e.g., a random shadowing, are frozen;
+ *  - all the signals received together must be in the same
+ *    SpectrumModel as the receiver or convertible to it, as with the
+ *    MultiModelSpectrumChannel.
+ *
+ * Receivers that are not LteSpectrumPhy instances and signals that
+ * are not LTE signals are handled as in the MultiModelSpectrumChannel.
+ */
+class LteLinkBudgetSpectrumChannel : public SpectrumChannel
+{
+public:
+  LteLinkBudgetSpectrumChannel ();
+  virtual ~LteLinkBudgetSpectrumChannel ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  // inherited from SpectrumChannel
+  virtual void AddPropagationLossModel (Ptr<PropagationLossModel> loss);
+  virtual void AddSpectrumPropagationLossModel (Ptr<SpectrumPropagationLossModel> loss);
+  virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+  virtual void AddRx (Ptr<SpectrumPhy> phy);
+  virtual void StartTx (Ptr<SpectrumSignalParameters> params);
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
+  virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
+
+  // inherited from Channel
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+protected:
+  // inherited from Object
+  virtual void DoDispose ();
+
+private:
+  /// The type of a signal, which decides how it is aggregated
+  enum SignalType
+  {
+    DATA,     ///< LteSpectrumSignalParametersDataFrame
+    DL_CTRL,  ///< LteSpectrumSignalParametersDlCtrlFrame
+    UL_SRS,   ///< LteSpectrumSignalParametersUlSrsFrame
+    OTHER     ///< not an LTE signal
+  };
+
+  /// A signal being transmitted
+  struct Signal
+  {
+    Ptr<SpectrumSignalParameters> params; //!< the TX parameters
+    Ptr<MobilityModel> txMobility;        //!< the mobility of the transmitter
+    Vector txPosition;                    //!< the position of the transmitter
+    uint32_t txIndex;                     //!< the index of the transmitter in the link budget table
+    SignalType type;                      //!< the type of the signal
+    uint16_t cellId;                      //!< the cell of an LTE signal
+    bool pss;                             //!< true if a DL control frame carries the PSS
+  };
+
+  /// The signals transmitted at the same time, delivered together
+  struct Batch : public SimpleRefCount<Batch>
+  {
+    Time time;                   //!< the time of the transmissions
+    std::vector<Signal> signals; //!< the signals
+  };
+
+  /// An entry of the link budget table
+  struct LinkBudget
+  {
+    LinkBudget ();
+
+    bool valid;                        //!< false until the first evaluation
+    Vector txPosition;                 //!< the position of the transmitter
+    Vector rxPosition;                 //!< the position of the receiver
+    Ptr<const AntennaModel> txAntenna; //!< the antenna of the transmitter
+    double lossDb;                     //!< the loss in dB
+    double gainLinear;                 //!< the linear gain, i.e., the inverse of the loss
+  };
+
+  /// A receiver, with its row of the link budget table
+  struct Receiver
+  {
+    Ptr<SpectrumPhy> phy;            //!< the receiver
+    Ptr<LteSpectrumPhy> ltePhy;      //!< the receiver, if it is an LteSpectrumPhy
+    std::vector<LinkBudget> links;   //!< the link budget, indexed by transmitter
+  };
+
+  /// The signals of other cells summed for a receiver
+  struct Aggregate
+  {
+    SignalType type;                        //!< the type of the signals
+    Time duration;                          //!< the duration of the signals
+    Ptr<SpectrumSignalParameters> params;   //!< the RX parameters of the sum
+  };
+
+  /**
+   * Deliver the signals of a batch to a receiver.
+   *
+   * \param batch the signals
+   * \param rxIndex the index of the receiver in m_receivers
+   */
+  void Deliver (Ptr<Batch> batch, uint32_t rxIndex);
+
+  /**
+   * Get the link budget between a transmitter and a receiver,
+   * evaluating it again if either end moved or the TX antenna changed.
+   *
+   * \param signal the signal being transmitted
+   * \param receiver the receiver
+   * \param rxMobility the mobility model of the receiver
+   * \param rxPosition the position of the receiver
+   *
+   * \return the link budget
+   */
+  const LinkBudget & GetLinkBudget (const Signal &signal,
+                                    Receiver &receiver,
+                                    Ptr<MobilityModel> rxMobility,
+                                    const Vector &rxPosition);
+
+  /**
+   * Get the PSD of a signal in the SpectrumModel of a receiver.
+   *
+   * \param txPsd the PSD of the signal
+   * \param rxModel the SpectrumModel of the receiver
+   *
+   * \return the converted PSD, or txPsd if the models are the same
+   */
+  Ptr<SpectrumValue> ConvertPsd (Ptr<SpectrumValue> txPsd,
+                                 Ptr<const SpectrumModel> rxModel);
+
+  /**
+   * Create the parameters of the sum of the signals of other cells.
+   *
+   * \param signal the first signal of the sum
+   * \param rxModel the SpectrumModel of the receiver
+   *
+   * \return the parameters, with a null PSD
+   */
+  static Ptr<SpectrumSignalParameters> CreateAggregate (const Signal &signal,
+                                                        Ptr<const SpectrumModel> rxModel);
+
+  /// The single-frequency propagation loss model
+  Ptr<PropagationLossModel> m_propagationLoss;
+  /// The frequency-dependent propagation loss model
+  Ptr<SpectrumPropagationLossModel> m_spectrumPropagationLoss;
+  /// The propagation delay model, which is not used
+  Ptr<PropagationDelayModel> m_propagationDelay;
+
+  /// The receivers, with the link budget table
+  std::vector<Receiver> m_receivers;
+  /// The receivers, to add them only once
+  std::set<Ptr<const SpectrumPhy> > m_rxPhySet;
+  /// The column of each transmitter in the link budget table
+  std::map<Ptr<const SpectrumPhy>, uint32_t> m_txIndex;
+  /// The converters between SpectrumModel instances, indexed by TX and RX model
+  std::map<std::pair<SpectrumModelUid_t, SpectrumModelUid_t>, SpectrumConverter> m_converters;
+
+  /// The signals transmitted now, whose delivery is scheduled
+  Ptr<Batch> m_batch;
+
+  /// The maximum loss in dB of the links whose signals are delivered
+  double m_maxLossDb;
+  /// The distance either end of a link may move, in meters, before its
+  /// link budget is evaluated again
+  double m_maxMove;
+
+  /// The `PathLoss` trace source, fired when a link budget is evaluated
+  TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double> m_pathLossTrace;
+  /// The `TxSigParams` trace source, fired for each signal transmitted
+  TracedCallback<Ptr<SpectrumSignalParameters> > m_txSigParamsTrace;
+};
+
+
+} // namespace ns3
+
+#endif /* LTE_LINK_BUDGET_SPECTRUM_CHANNEL_H */
@@ -30,6 +30,7 @@
 */ 
 
 
+#include <algorithm>
 #include <list>
 #include <vector>
 #include <ns3/log.h>
@@ -323,86 +324,176 @@ static const double cEcrTable [9][38] = {
 };
 
 
+/**
+ * The largest absolute value of the normalized argument of the
+ * tabulated code block error rate; beyond, the error rate is 0 or 1
+ * within 1e-17.
+ */
+static const double BLER_TABLE_MAX_ARG = 6.0;
+
+/// The largest second derivative of 0.5 * (1 - erf (z)), at z = 1/sqrt(2).
+static const double BLER_MAX_SECOND_DERIVATIVE = 0.4839414490382867;
+
+/// The tolerance of the tabulated code block error rates, 0 if exact.
+static double g_blerTolerance = 1e-6;
+
+/**
+ * The code block error rate 0.5 * (1 - erf (z)) sampled from
+ * -BLER_TABLE_MAX_ARG to BLER_TABLE_MAX_ARG, rebuilt when the
+ * tolerance changes.
+ */
+static std::vector<double> g_blerTable;
+
+/// The tolerance of g_blerTable.
+static double g_blerTableTolerance = 0;
+
+/// The number of samples of g_blerTable per unit of z.
+static double g_blerTableScale = 0;
+
+/**
+ * The parameters of the BLER curves of each code block size and ECR,
+ * with the missing ones taken from the next larger code block size.
+ */
+struct BlerCurveParameters
+{
+  BlerCurveParameters ();
+  double b[9][38];          //!< The mean of the curves
+  double c[9][38];          //!< The standard deviation of the curves
+  double invC[9][38];       //!< 1 / (sqrt (2) * c)
+};
+
+BlerCurveParameters::BlerCurveParameters ()
+{
+  for (int cbIndex = 0; cbIndex < 9; cbIndex++)
+    {
+      for (int ecrId = 0; ecrId <= MI_64QAM_BLER_MAX_ID; ecrId++)
+        {
+          // take the lowest CB size including this CB for removing CB
+          // size quatization errors
+          double bValue = bEcrTable[cbIndex][ecrId];
+          int i = cbIndex;
+          while ((i < 9) && (bValue < 0))
+            {
+              bValue = bEcrTable[i++][ecrId];
+            }
+          double cValue = cEcrTable[cbIndex][ecrId];
+          i = cbIndex;
+          while ((i < 9) && (cValue < 0))
+            {
+              cValue = cEcrTable[i++][ecrId];
+            }
+          b[cbIndex][ecrId] = bValue;
+          c[cbIndex][ecrId] = cValue;
+          invC[cbIndex][ecrId] = 1.0 / (std::sqrt (2.0) * cValue);
+        }
+    }
+}
+
+/**
+ * \return the parameters of the BLER curves
+ */
+static const BlerCurveParameters &
+GetBlerCurveParameters (void)
+{
+  static BlerCurveParameters parameters;
+  return parameters;
+}
+
+/**
+ * Sample the code block error rate with a step such that the linear
+ * interpolation is within g_blerTolerance of the closed form.
+ */
+static void
+BuildBlerTable (void)
+{
+  // The error of the linear interpolation is below step^2 / 8 times
+  // the largest second derivative
+  double step = std::sqrt (8 * g_blerTolerance / BLER_MAX_SECOND_DERIVATIVE);
+  step = std::min (step, 0.25);
+  uint32_t n = std::ceil (2 * BLER_TABLE_MAX_ARG / step) + 1;
+  g_blerTableScale = (n - 1) / (2 * BLER_TABLE_MAX_ARG);
+  g_blerTable.resize (n + 1);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double z = i / g_blerTableScale - BLER_TABLE_MAX_ARG;
+      g_blerTable[i] = 0.5 * (1 - erf (z));
+    }
+  // So that the last sample can be interpolated
+  g_blerTable[n] = g_blerTable[n - 1];
+  g_blerTableTolerance = g_blerTolerance;
+}
+
+void
+LteMiErrorModel::SetBlerTolerance (double tolerance)
+{
+  NS_LOG_FUNCTION (tolerance);
+  NS_ASSERT_MSG (tolerance >= 0, "Negative BLER tolerance " << tolerance);
+  g_blerTolerance = tolerance;
+}
+
+double
+LteMiErrorModel::GetBlerTolerance (void)
+{
+  return g_blerTolerance;
+}
+
 double 
 LteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
-  
-  double MI;
+
+  // Select the MI map of the modulation once for all the RBs
+  const double *axis;
+  const double *miMap;
+  uint32_t size;
+  if (mcs <= MI_QPSK_MAX_ID) // QPSK
+    {
+      axis = MI_map_qpsk_axis;
+      miMap = MI_map_qpsk;
+      size = MI_MAP_QPSK_SIZE;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID) // 16-QAM
+    {
+      axis = MI_map_16qam_axis;
+      miMap = MI_map_16qam;
+      size = MI_MAP_16QAM_SIZE;
+    }
+  else // 64-QAM
+    {
+      axis = MI_map_64qam_axis;
+      miMap = MI_map_64qam;
+      size = MI_MAP_64QAM_SIZE;
+    }
+  // since the values of the axis are uniformly spaced, we have
+  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+  const double axisMin = axis[0];
+  const double axisMax = axis[size - 1];
+  const double scalingCoeff = (size - 1) / (axisMax - axisMin);
+
+  const double *sinrValues = &(*sinr.ConstValuesBegin ());
+  const int *rbs = &map[0];
+  const uint32_t nRbs = map.size ();
   double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
-  
-  for (uint32_t i = 0; i < map.size (); i++)
+  for (uint32_t i = 0; i < nRbs; i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
+      NS_ASSERT (rbs[i] >= 0 && rbs[i] < (int) sinr.GetSpectrumModel ()->GetNumBands ());
+      double sinrLin = sinrValues[rbs[i]];
+      double MI;
+      if (sinrLin > axisMax)
         {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1])
-            {
-              MI = 1;
-            }
-          else 
-            { 
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk = 
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE-1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
+          MI = 1;
         }
       else
         {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )	// 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else 
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam = 
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE-1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam = 
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE-1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max(0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
+          double sinrIndexDouble = (sinrLin - axisMin) * scalingCoeff + 1;
+          uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
+          NS_ASSERT_MSG (sinrIndex < size, "MI map out of data");
+          MI = miMap[sinrIndex];
         }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
+      NS_LOG_LOGIC (" RB " << rbs[i] << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
       MIsum += MI;
     }
-  MI = MIsum / map.size ();
+  double MI = MIsum / nRbs;
   NS_LOG_LOGIC (" MI = " << MI);
   return MI;
 }
@@ -412,8 +503,6 @@ double
 LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
 {
   NS_LOG_FUNCTION (mib << (uint32_t) ecrId << (uint32_t) cbSize);
-  double b = 0;
-  double c = 0;
 
   NS_ASSERT_MSG (ecrId <= MI_64QAM_BLER_MAX_ID, "ECR out of range [0..37]: " << (uint16_t) ecrId);
   int cbIndex = 1;
@@ -424,30 +513,38 @@ LteMiErrorModel::MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize)
   cbIndex--;
   NS_LOG_LOGIC (" ECRid " << (uint16_t)ecrId << " ECR " << BlerCurvesEcrMap[ecrId] << " CB size " << cbSize << " CB size curve " << cbMiSizeTable[cbIndex]);
 
-  b = bEcrTable[cbIndex][ecrId];
-  if (b<0.0)
+  const BlerCurveParameters &parameters = GetBlerCurveParameters ();
+  double b = parameters.b[cbIndex][ecrId];
+  double c = parameters.c[cbIndex][ecrId];
+  double bler;
+  if (g_blerTolerance == 0)
     {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(b<0))
-        {
-          b = bEcrTable[i++][ecrId];
-        }
+      // see IEEE802.16m EMD formula 55 of section 4.3.2.1
+      bler = 0.5*( 1 - erf((mib-b)/(sqrt(2)*c)) );
     }
-  c = cEcrTable[cbIndex][ecrId];
-  if (c<0.0)
+  else
     {
-      //take the lowest CB size including this CB for removing CB size
-      //quatization errors
-      int i = cbIndex;
-      while ((i<9)&&(c<0))
+      if (g_blerTableTolerance != g_blerTolerance)
+        {
+          BuildBlerTable ();
+        }
+      double z = (mib - b) * parameters.invC[cbIndex][ecrId];
+      double u = (z + BLER_TABLE_MAX_ARG) * g_blerTableScale;
+      if (u <= 0)
+        {
+          bler = g_blerTable[0];
+        }
+      else if (u >= g_blerTable.size () - 2)
+        {
+          bler = g_blerTable[g_blerTable.size () - 2];
+        }
+      else
         {
-          c = cEcrTable[i++][ecrId];
+          uint32_t i = static_cast<uint32_t> (u);
+          double fraction = u - i;
+          bler = g_blerTable[i] + fraction * (g_blerTable[i + 1] - g_blerTable[i]);
         }
     }
-  // see IEEE802.16m EMD formula 55 of section 4.3.2.1
-  double bler = 0.5*( 1 - erf((mib-b)/(sqrt(2)*c)) );
   NS_LOG_LOGIC ("MIB: " << mib << " BLER:" << bler << " b:" << b << " c:" << c);
   return bler;
 }
@@ -546,7 +643,7 @@ LteMiErrorModel::GetPcfichPdcchError (const SpectrumValue& sinr)
 
 
 TbStats_t
-LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory)
+LteMiErrorModel::GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory)
 {
   NS_LOG_FUNCTION (sinr << &map << (uint32_t) size << (uint32_t) mcs);
 
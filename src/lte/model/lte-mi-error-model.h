@@ -89,6 +89,22 @@ public:
    */
   static double MappingMiBler (double mib, uint8_t ecrId, uint16_t cbSize);
 
+  /**
+   * \brief set the tolerance of the code block error rates
+   *
+   * The code block error rates of MappingMiBler are interpolated in a
+   * table of the BLER curve, sampled so that they are within this
+   * tolerance of the closed form.  A null tolerance evaluates the
+   * closed form for each code block.  The default is 1e-6.
+   *
+   * \param tolerance the largest absolute error of the code block error rates
+   */
+  static void SetBlerTolerance (double tolerance);
+  /**
+   * \return the tolerance of the code block error rates
+   */
+  static double GetBlerTolerance (void);
+
   /**
    * \brief run the error-model algorithm for the specified TB
    * \param sinr the perceived sinrs in the whole bandwidth
@@ -98,7 +114,7 @@ public:
    * \param miHistory  MI of past transmissions (in case of retx)
    * \return the TB error rate and MI
    */
-  static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, HarqProcessInfoList_t miHistory);
+  static TbStats_t GetTbDecodificationStats (const SpectrumValue& sinr, const std::vector<int>& map, uint16_t size, uint8_t mcs, const HarqProcessInfoList_t& miHistory);
   
   /** 
   * \brief run the error-model algorithm for the specified PCFICH+PDCCH channels
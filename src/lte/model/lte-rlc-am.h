@@ -26,7 +26,8 @@
 #include <ns3/lte-rlc.h>
 
 #include <vector>
-#include <map>
+#include <deque>
+#include <list>
 
 namespace ns3 {
 
@@ -76,10 +77,20 @@ private:
 // 
   void ReassembleAndDeliver (Ptr<Packet> packet);
 
+  /**
+   * Take the next bytes of the SDU at the head of the transmission
+   * buffer, and remove the SDU once all its bytes have been taken.
+   *
+   * \param size the number of bytes, at most the bytes left in the SDU
+   * \return the SDU or segment, with its LteRlcSduStatusTag
+   */
+  Ptr<Packet> TakeTxonSegment (uint32_t size);
+
   void DoReportBufferStatus ();
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer;       // Transmission buffer
+    std::deque < Ptr<Packet> > m_txonBuffer;        // Transmission buffer
+    uint32_t m_txonOffset;                          ///< Bytes of the head SDU already segmented
 
     struct RetxPdu
     {
@@ -101,13 +112,18 @@ private:
 
     struct PduBuffer
     {
+      PduBuffer ()
+        : m_pduComplete (false)
+      {
+      }
       SequenceNumber10  m_seqNumber;
       std::list < Ptr<Packet> >  m_byteSegments;
 
       bool      m_pduComplete;
     };
 
-    std::map <uint16_t, PduBuffer > m_rxonBuffer; // Reception buffer
+  std::vector <PduBuffer> m_rxonBuffer; ///< Reception buffer, indexed by SN;
+                                        ///< a PDU is there if it has byte segments
 
     Ptr<Packet> m_controlPduBuffer;               // Control PDU buffer (just one PDU)
 
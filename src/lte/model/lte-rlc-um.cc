@@ -35,6 +35,7 @@ NS_OBJECT_ENSURE_REGISTERED (LteRlcUm);
 LteRlcUm::LteRlcUm ()
   : m_maxTxBufferSize (10 * 1024),
     m_txBufferSize (0),
+    m_txOffset (0),
     m_sequenceNumber (0),
     m_vrUr (0),
     m_vrUx (0),
@@ -44,6 +45,7 @@ LteRlcUm::LteRlcUm ()
 {
   NS_LOG_FUNCTION (this);
   m_reassemblingState = WAITING_S0_FULL;
+  m_rxBuffer.resize (1024);
 }
 
 LteRlcUm::~LteRlcUm ()
@@ -145,8 +147,9 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
   uint32_t dataFieldAddedSize = 0;
   std::vector < Ptr<Packet> > dataField;
 
-  // Remove the first packet from the transmission buffer.
-  // If only a segment of the packet is taken, then the remaining is given back later
+  // Take the SDUs from the head of the transmission buffer.
+  // If only a segment of an SDU is taken, then the SDU stays at the head
+  // of the buffer, and the next segment starts where this one ends
   if ( m_txBuffer.size () == 0 )
     {
       NS_LOG_LOGIC ("No data pending");
@@ -154,87 +157,34 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
     }
 
   NS_LOG_LOGIC ("SDUs in TxBuffer  = " << m_txBuffer.size ());
-  NS_LOG_LOGIC ("First SDU buffer  = " << *(m_txBuffer.begin()));
-  NS_LOG_LOGIC ("First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
+  NS_LOG_LOGIC ("First SDU buffer  = " << m_txBuffer.front ());
+  NS_LOG_LOGIC ("First SDU size    = " << m_txBuffer.front ()->GetSize () - m_txOffset);
   NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
-  NS_LOG_LOGIC ("Remove SDU from TxBuffer");
-  Ptr<Packet> firstSegment = (*(m_txBuffer.begin ()))->Copy ();
-  m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-  NS_LOG_LOGIC ("txBufferSize      = " << m_txBufferSize );
-  m_txBuffer.erase (m_txBuffer.begin ());
+  uint32_t firstSegmentSize = m_txBuffer.front ()->GetSize () - m_txOffset;
 
-  while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
+  while ( (firstSegmentSize > 0) && (nextSegmentSize > 0) )
     {
-      NS_LOG_LOGIC ("WHILE ( firstSegment && firstSegment->GetSize > 0 && nextSegmentSize > 0 )");
-      NS_LOG_LOGIC ("    firstSegment size = " << firstSegment->GetSize ());
+      NS_LOG_LOGIC ("WHILE ( firstSegment > 0 && nextSegmentSize > 0 )");
+      NS_LOG_LOGIC ("    firstSegment size = " << firstSegmentSize);
       NS_LOG_LOGIC ("    nextSegmentSize   = " << nextSegmentSize);
-      if ( (firstSegment->GetSize () > nextSegmentSize) ||
+      if ( (firstSegmentSize > nextSegmentSize) ||
            // Segment larger than 2047 octets can only be mapped to the end of the Data field
-           (firstSegment->GetSize () > 2047)
+           (firstSegmentSize > 2047)
          )
         {
           // Take the minimum size, due to the 2047-bytes 3GPP exception
           // This exception is due to the length of the LI field (just 11 bits)
-          uint32_t currSegmentSize = std::min (firstSegment->GetSize (), nextSegmentSize);
+          uint32_t currSegmentSize = std::min (firstSegmentSize, nextSegmentSize);
 
           NS_LOG_LOGIC ("    IF ( firstSegment > nextSegmentSize ||");
           NS_LOG_LOGIC ("         firstSegment > 2047 )");
 
-          // Segment txBuffer.FirstBuffer and
-          // Give back the remaining segment to the transmission buffer
-          Ptr<Packet> newSegment = firstSegment->CreateFragment (0, currSegmentSize);
+          // Segment txBuffer.FirstBuffer, the remaining segment
+          // stays in the transmission buffer
+          Ptr<Packet> newSegment = TakeTxSegment (currSegmentSize);
           NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
-
-          // Status tag of the new and remaining segments
-          // Note: This is the only place where a PDU is segmented and
-          // therefore its status can change
-          LteRlcSduStatusTag oldTag, newTag;
-          firstSegment->RemovePacketTag (oldTag);
-          newSegment->RemovePacketTag (newTag);
-          if (oldTag.GetStatus () == LteRlcSduStatusTag::FULL_SDU)
-            {
-              newTag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
-              oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-          else if (oldTag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT)
-            {
-              newTag.SetStatus (LteRlcSduStatusTag::MIDDLE_SEGMENT);
-              //oldTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-            }
-
-          // Give back the remaining segment to the transmission buffer
-          firstSegment->RemoveAtStart (currSegmentSize);
-          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << firstSegment->GetSize ());
-          if (firstSegment->GetSize () > 0)
-            {
-              firstSegment->AddPacketTag (oldTag);
-
-              m_txBuffer.insert (m_txBuffer.begin (), firstSegment);
-              m_txBufferSize += (*(m_txBuffer.begin()))->GetSize ();
-
-              NS_LOG_LOGIC ("    TX buffer: Give back the remaining segment");
-              NS_LOG_LOGIC ("    TX buffers = " << m_txBuffer.size ());
-              NS_LOG_LOGIC ("    Front buffer size = " << (*(m_txBuffer.begin()))->GetSize ());
-              NS_LOG_LOGIC ("    txBufferSize = " << m_txBufferSize );
-            }
-          else
-            {
-              // Whole segment was taken, so adjust tag
-              if (newTag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::FULL_SDU);
-                }
-              else if (newTag.GetStatus () == LteRlcSduStatusTag::MIDDLE_SEGMENT)
-                {
-                  newTag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
-                }
-            }
-          // Segment is completely taken or
-          // the remaining segment is given back to the transmission buffer
-          firstSegment = 0;
-
-          // Put status tag once it has been adjusted
-          newSegment->AddPacketTag (newTag);
+          NS_LOG_LOGIC ("    txBufferSize = " << m_txBufferSize );
+          firstSegmentSize = 0;
 
           // Add Segment to Data field
           dataFieldAddedSize = newSegment->GetSize ();
@@ -255,14 +205,16 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           // (NO more segments) → exit
           // break;
         }
-      else if ( (nextSegmentSize - firstSegment->GetSize () <= 2) || (m_txBuffer.size () == 0) )
+      else if ( (nextSegmentSize - firstSegmentSize <= 2) || (m_txBuffer.size () == 1) )
         {
           NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txBuffer.size == 0");
+
           // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
+          Ptr<Packet> newSegment = TakeTxSegment (firstSegmentSize);
+          dataFieldAddedSize = newSegment->GetSize ();
           dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
-          firstSegment = 0;
+          dataField.push_back (newSegment);
+          firstSegmentSize = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
           rlcHeader.PushExtensionBit (LteRlcHeader::DATA_FIELD_FOLLOWS);
@@ -275,8 +227,8 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
           NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txBuffer.size ());
           if (m_txBuffer.size () > 0)
             {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
+              NS_LOG_LOGIC ("        First SDU buffer  = " << m_txBuffer.front ());
+              NS_LOG_LOGIC ("        First SDU size    = " << m_txBuffer.front ()->GetSize ());
             }
           NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
 
@@ -289,33 +241,28 @@ LteRlcUm::DoNotifyTxOpportunity (uint32_t bytes, uint8_t layer, uint8_t harqId)
         {
           NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txBuffer.size > 0");
           // Add txBuffer.FirstBuffer to DataField
-          dataFieldAddedSize = firstSegment->GetSize ();
+          Ptr<Packet> newSegment = TakeTxSegment (firstSegmentSize);
+          dataFieldAddedSize = newSegment->GetSize ();
           dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
+          dataField.push_back (newSegment);
 
           // ExtensionBit (Next_Segment - 1) = 1
           rlcHeader.PushExtensionBit (LteRlcHeader::E_LI_FIELDS_FOLLOWS);
 
           // LengthIndicator (Next_Segment)  = txBuffer.FirstBuffer.length()
-          rlcHeader.PushLengthIndicator (firstSegment->GetSize ());
+          rlcHeader.PushLengthIndicator (dataFieldAddedSize);
 
           nextSegmentSize -= ((nextSegmentId % 2) ? (2) : (1)) + dataFieldAddedSize;
           nextSegmentId++;
 
           NS_LOG_LOGIC ("        SDUs in TxBuffer  = " << m_txBuffer.size ());
-          if (m_txBuffer.size () > 0)
-            {
-              NS_LOG_LOGIC ("        First SDU buffer  = " << *(m_txBuffer.begin()));
-              NS_LOG_LOGIC ("        First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
-            }
+          NS_LOG_LOGIC ("        First SDU buffer  = " << m_txBuffer.front ());
+          NS_LOG_LOGIC ("        First SDU size    = " << m_txBuffer.front ()->GetSize ());
           NS_LOG_LOGIC ("        Next segment size = " << nextSegmentSize);
-          NS_LOG_LOGIC ("        Remove SDU from TxBuffer");
+          NS_LOG_LOGIC ("        txBufferSize = " << m_txBufferSize );
 
           // (more segments)
-          firstSegment = (*(m_txBuffer.begin ()))->Copy ();
-          m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
-          m_txBuffer.erase (m_txBuffer.begin ());
-          NS_LOG_LOGIC ("        txBufferSize = " << m_txBufferSize );
+          firstSegmentSize = m_txBuffer.front ()->GetSize ();
         }
 
     }
@@ -448,7 +395,7 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
   m_vrUh.SetModulusBase (m_vrUh - m_windowSize);
   seqNumber.SetModulusBase (m_vrUh - m_windowSize);
 
-  if ( ( (m_vrUr < seqNumber) && (seqNumber < m_vrUh) && (m_rxBuffer.count (seqNumber.GetValue ()) > 0) ) ||
+  if ( ( (m_vrUr < seqNumber) && (seqNumber < m_vrUh) && (m_rxBuffer[seqNumber.GetValue ()] != 0) ) ||
        ( ((m_vrUh - m_windowSize) <= seqNumber) && (seqNumber < m_vrUr) )
      )
     {
@@ -478,10 +425,11 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
     {
       NS_LOG_LOGIC ("SN is outside the reordering window");
 
+      SequenceNumber10 lowSeqNumber = m_vrUh - m_windowSize;
       m_vrUh = seqNumber + 1;
       NS_LOG_LOGIC ("New VR(UH) = " << m_vrUh);
 
-      ReassembleOutsideWindow ();
+      ReassembleOutsideWindow (lowSeqNumber);
 
       if ( ! IsInsideReorderingWindow (m_vrUr) )
         {
@@ -497,17 +445,14 @@ LteRlcUm::DoReceivePdu (Ptr<Packet> p)
   //      so and deliver the reassembled RLC SDUs to upper layer in ascending order of the RLC SN if not delivered
   //      before;
 
-  if ( m_rxBuffer.count (m_vrUr.GetValue ()) > 0 )
+  if ( m_rxBuffer[m_vrUr.GetValue ()] != 0 )
     {
       NS_LOG_LOGIC ("Reception buffer contains SN = " << m_vrUr);
 
-      std::map <uint16_t, Ptr<Packet> >::iterator it;
-      uint16_t newVrUr;
+      SequenceNumber10 newVrUr = m_vrUr + 1;
       SequenceNumber10 oldVrUr = m_vrUr;
 
-      it = m_rxBuffer.find (m_vrUr.GetValue ());
-      newVrUr = (it->first) + 1;
-      while ( m_rxBuffer.count (newVrUr) > 0 )
+      while ( m_rxBuffer[newVrUr.GetValue ()] != 0 )
         {
           newVrUr++;
         }
@@ -1052,28 +997,24 @@ LteRlcUm::ReassembleAndDeliver (Ptr<Packet> packet)
 
 
 void
-LteRlcUm::ReassembleOutsideWindow (void)
+LteRlcUm::ReassembleOutsideWindow (SequenceNumber10 lowSeqNumber)
 {
   NS_LOG_LOGIC ("Reassemble Outside Window");
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
-  it = m_rxBuffer.begin ();
-
-  while ( (it != m_rxBuffer.end ()) && ! IsInsideReorderingWindow (SequenceNumber10 (it->first)) )
+  // The PDUs which left the reordering window are the ones
+  // between its former and its new lower edges
+  SequenceNumber10 highSeqNumber = m_vrUh - m_windowSize;
+  uint16_t n = (highSeqNumber.GetValue () + 1024 - lowSeqNumber.GetValue ()) % 1024;
+  for (uint16_t sn = lowSeqNumber.GetValue (); n > 0; sn = (sn + 1) % 1024, n--)
     {
-      NS_LOG_LOGIC ("SN = " << it->first);
-
-      // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
-      ReassembleAndDeliver (it->second);
-
-      std::map <uint16_t, Ptr<Packet> >::iterator it_tmp = it;
-      ++it;
-      m_rxBuffer.erase (it_tmp);
-    }
+      if (m_rxBuffer[sn] != 0)
+        {
+          NS_LOG_LOGIC ("SN = " << sn);
 
-  if (it != m_rxBuffer.end ())
-    {
-      NS_LOG_LOGIC ("(SN = " << it->first << ") is inside the reordering window");
+          // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
+          ReassembleAndDeliver (m_rxBuffer[sn]);
+          m_rxBuffer[sn] = 0;
+        }
     }
 }
 
@@ -1082,25 +1023,20 @@ LteRlcUm::ReassembleSnInterval (SequenceNumber10 lowSeqNumber, SequenceNumber10
 {
   NS_LOG_LOGIC ("Reassemble SN between " << lowSeqNumber << " and " << highSeqNumber);
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
-
   SequenceNumber10 reassembleSn = lowSeqNumber;
   NS_LOG_LOGIC ("reassembleSN = " << reassembleSn);
   NS_LOG_LOGIC ("highSeqNumber = " << highSeqNumber);
   while (reassembleSn < highSeqNumber)
     {
       NS_LOG_LOGIC ("reassembleSn < highSeqNumber");
-      it = m_rxBuffer.find (reassembleSn.GetValue ());
-      NS_LOG_LOGIC ("it->first  = " << it->first);
-      NS_LOG_LOGIC ("it->second = " << it->second);
-      if (it != m_rxBuffer.end () )
+      Ptr<Packet> &pdu = m_rxBuffer[reassembleSn.GetValue ()];
+      if (pdu != 0)
         {
-          NS_LOG_LOGIC ("SN = " << it->first);
+          NS_LOG_LOGIC ("SN = " << reassembleSn);
 
           // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
-          ReassembleAndDeliver (it->second);
-
-          m_rxBuffer.erase (it);
+          ReassembleAndDeliver (pdu);
+          pdu = 0;
         }
         
       reassembleSn++;
@@ -1108,6 +1044,59 @@ LteRlcUm::ReassembleSnInterval (SequenceNumber10 lowSeqNumber, SequenceNumber10
 }
 
 
+Ptr<Packet>
+LteRlcUm::TakeTxSegment (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+
+  Ptr<Packet> sdu = m_txBuffer.front ();
+  NS_ASSERT (m_txOffset + size <= sdu->GetSize ());
+  bool first = (m_txOffset == 0);
+  bool last = (m_txOffset + size == sdu->GetSize ());
+
+  Ptr<Packet> segment;
+  if (first && last)
+    {
+      segment = sdu->Copy ();
+    }
+  else
+    {
+      segment = sdu->CreateFragment (m_txOffset, size);
+
+      // Status tag of the segment
+      // Note: This is the only place where a PDU is segmented and
+      // therefore its status can change
+      LteRlcSduStatusTag tag;
+      segment->RemovePacketTag (tag);
+      if (first)
+        {
+          tag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
+        }
+      else if (last)
+        {
+          tag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
+        }
+      else
+        {
+          tag.SetStatus (LteRlcSduStatusTag::MIDDLE_SEGMENT);
+        }
+      segment->AddPacketTag (tag);
+    }
+
+  m_txBufferSize -= size;
+  if (last)
+    {
+      m_txBuffer.pop_front ();
+      m_txOffset = 0;
+    }
+  else
+    {
+      m_txOffset += size;
+    }
+  return segment;
+}
+
+
 void
 LteRlcUm::DoReportBufferStatus (void)
 {
@@ -1152,10 +1141,9 @@ LteRlcUm::ExpireReorderingTimer (void)
   //    - start t-Reordering;
   //    - set VR(UX) to VR(UH).
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
   SequenceNumber10 newVrUr = m_vrUx;
 
-  while ( (it = m_rxBuffer.find (newVrUr.GetValue ())) != m_rxBuffer.end () )
+  while ( m_rxBuffer[newVrUr.GetValue ()] != 0 )
     {
       newVrUr++;
     }
@@ -25,7 +25,9 @@
 #include "ns3/lte-rlc.h"
 
 #include <ns3/event-id.h>
-#include <map>
+#include <vector>
+#include <deque>
+#include <list>
 
 namespace ns3 {
 
@@ -58,18 +60,33 @@ private:
 
   bool IsInsideReorderingWindow (SequenceNumber10 seqNumber);
 
-  void ReassembleOutsideWindow (void);
+  /**
+   * Reassemble the PDUs which are now outside of the reordering window.
+   *
+   * \param lowSeqNumber the lower edge of the window before VR(UH) was updated
+   */
+  void ReassembleOutsideWindow (SequenceNumber10 lowSeqNumber);
   void ReassembleSnInterval (SequenceNumber10 lowSeqNumber, SequenceNumber10 highSeqNumber);
 
   void ReassembleAndDeliver (Ptr<Packet> packet);
 
+  /**
+   * Take the next bytes of the SDU at the head of the transmission
+   * buffer, and remove the SDU once all its bytes have been taken.
+   *
+   * \param size the number of bytes, at most the bytes left in the SDU
+   * \return the SDU or segment, with its LteRlcSduStatusTag
+   */
+  Ptr<Packet> TakeTxSegment (uint32_t size);
+
   void DoReportBufferStatus ();
 
 private:
   uint32_t m_maxTxBufferSize;
   uint32_t m_txBufferSize;
-  std::vector < Ptr<Packet> > m_txBuffer;       // Transmission buffer
-  std::map <uint16_t, Ptr<Packet> > m_rxBuffer; // Reception buffer
+  std::deque < Ptr<Packet> > m_txBuffer;        // Transmission buffer
+  uint32_t m_txOffset;                          ///< Bytes of the head SDU already segmented
+  std::vector < Ptr<Packet> > m_rxBuffer;       ///< Reception buffer, indexed by SN
   std::vector < Ptr<Packet> > m_reasBuffer;     // Reassembling buffer
 
   std::list < Ptr<Packet> > m_sdusBuffer;       // List of SDUs in a packet
@@ -68,13 +68,13 @@ RrcAsn1Header::GetMessageType ()
 }
 
 void
-RrcAsn1Header::SerializeDrbToAddModList (std::list<LteRrcSap::DrbToAddMod> drbToAddModList) const
+RrcAsn1Header::SerializeDrbToAddModList (const std::list<LteRrcSap::DrbToAddMod> &drbToAddModList) const
 {
   // Serialize DRB-ToAddModList sequence-of
   SerializeSequenceOf (drbToAddModList.size (),MAX_DRB,1);
 
   // Serialize the elements in the sequence-of list
-  std::list<LteRrcSap::DrbToAddMod>::iterator it = drbToAddModList.begin ();
+  std::list<LteRrcSap::DrbToAddMod>::const_iterator it = drbToAddModList.begin ();
   for (; it != drbToAddModList.end (); it++)
     {
       // Serialize DRB-ToAddMod sequence
@@ -156,13 +156,13 @@ RrcAsn1Header::SerializeDrbToAddModList (std::list<LteRrcSap::DrbToAddMod> drbTo
 }
 
 void
-RrcAsn1Header::SerializeSrbToAddModList (std::list<LteRrcSap::SrbToAddMod> srbToAddModList) const
+RrcAsn1Header::SerializeSrbToAddModList (const std::list<LteRrcSap::SrbToAddMod> &srbToAddModList) const
 {
   // Serialize SRB-ToAddModList ::= SEQUENCE (SIZE (1..2)) OF SRB-ToAddMod
   SerializeSequenceOf (srbToAddModList.size (),2,1);
 
   // Serialize the elements in the sequence-of list
-  std::list<LteRrcSap::SrbToAddMod>::iterator it = srbToAddModList.begin ();
+  std::list<LteRrcSap::SrbToAddMod>::const_iterator it = srbToAddModList.begin ();
   for (; it != srbToAddModList.end (); it++)
     {
       // Serialize SRB-ToAddMod sequence
@@ -185,7 +185,7 @@ RrcAsn1Header::SerializeSrbToAddModList (std::list<LteRrcSap::SrbToAddMod> srbTo
 }
 
 void
-RrcAsn1Header::SerializeLogicalChannelConfig (LteRrcSap::LogicalChannelConfig logicalChannelConfig) const
+RrcAsn1Header::SerializeLogicalChannelConfig (const LteRrcSap::LogicalChannelConfig &logicalChannelConfig) const
 {
   // Serialize LogicalChannelConfig sequence
   // 1 optional field (ul-SpecificParameters), which is present. Extension marker present.
@@ -260,7 +260,7 @@ RrcAsn1Header::SerializeLogicalChannelConfig (LteRrcSap::LogicalChannelConfig lo
 }
 
 void
-RrcAsn1Header::SerializePhysicalConfigDedicated (LteRrcSap::PhysicalConfigDedicated physicalConfigDedicated) const
+RrcAsn1Header::SerializePhysicalConfigDedicated (const LteRrcSap::PhysicalConfigDedicated &physicalConfigDedicated) const
 {
   // Serialize PhysicalConfigDedicated Sequence
   std::bitset<10> optionalFieldsPhysicalConfigDedicated;
@@ -357,7 +357,7 @@ RrcAsn1Header::SerializePhysicalConfigDedicated (LteRrcSap::PhysicalConfigDedica
 }
 
 void
-RrcAsn1Header::SerializeRadioResourceConfigDedicated (LteRrcSap::RadioResourceConfigDedicated radioResourceConfigDedicated) const
+RrcAsn1Header::SerializeRadioResourceConfigDedicated (const LteRrcSap::RadioResourceConfigDedicated &radioResourceConfigDedicated) const
 {
   bool isSrbToAddModListPresent = !radioResourceConfigDedicated.srbToAddModList.empty ();
   bool isDrbToAddModListPresent = !radioResourceConfigDedicated.drbToAddModList.empty ();
@@ -389,7 +389,7 @@ RrcAsn1Header::SerializeRadioResourceConfigDedicated (LteRrcSap::RadioResourceCo
   if (isDrbToReleaseListPresent)
     {
       SerializeSequenceOf (radioResourceConfigDedicated.drbToReleaseList.size (),MAX_DRB,1);
-      std::list<uint8_t>::iterator it = radioResourceConfigDedicated.drbToReleaseList.begin ();
+      std::list<uint8_t>::const_iterator it = radioResourceConfigDedicated.drbToReleaseList.begin ();
       for (; it != radioResourceConfigDedicated.drbToReleaseList.end (); it++)
         {
           // DRB-Identity ::= INTEGER (1..32)
@@ -404,7 +404,7 @@ RrcAsn1Header::SerializeRadioResourceConfigDedicated (LteRrcSap::RadioResourceCo
 }
 
 void
-RrcAsn1Header::SerializeSystemInformationBlockType1 (LteRrcSap::SystemInformationBlockType1 systemInformationBlockType1) const
+RrcAsn1Header::SerializeSystemInformationBlockType1 (const LteRrcSap::SystemInformationBlockType1 &systemInformationBlockType1) const
 {
   // 3 optional fields, no extension marker.
   std::bitset<3> sysInfoBlk1Opts;
@@ -463,7 +463,7 @@ RrcAsn1Header::SerializeSystemInformationBlockType1 (LteRrcSap::SystemInformatio
 }
 
 void
-RrcAsn1Header::SerializeRadioResourceConfigCommon (LteRrcSap::RadioResourceConfigCommon radioResourceConfigCommon) const
+RrcAsn1Header::SerializeRadioResourceConfigCommon (const LteRrcSap::RadioResourceConfigCommon &radioResourceConfigCommon) const
 {
   // 9 optional fields. Extension marker yes.
   std::bitset<9> rrCfgCmmOpts;
@@ -514,7 +514,7 @@ RrcAsn1Header::SerializeRadioResourceConfigCommon (LteRrcSap::RadioResourceConfi
 }
 
 void
-RrcAsn1Header::SerializeRadioResourceConfigCommonSib (LteRrcSap::RadioResourceConfigCommonSib radioResourceConfigCommonSib) const
+RrcAsn1Header::SerializeRadioResourceConfigCommonSib (const LteRrcSap::RadioResourceConfigCommonSib &radioResourceConfigCommonSib) const
 {
   SerializeSequence (std::bitset<0> (0),true);
 
@@ -573,7 +573,7 @@ RrcAsn1Header::SerializeRadioResourceConfigCommonSib (LteRrcSap::RadioResourceCo
 }
 
 void
-RrcAsn1Header::SerializeSystemInformationBlockType2 (LteRrcSap::SystemInformationBlockType2 systemInformationBlockType2) const
+RrcAsn1Header::SerializeSystemInformationBlockType2 (const LteRrcSap::SystemInformationBlockType2 &systemInformationBlockType2) const
 {
   SerializeSequence (std::bitset<2> (0),true);
 
@@ -622,16 +622,14 @@ RrcAsn1Header::SerializeSystemInformationBlockType2 (LteRrcSap::SystemInformatio
 }
 
 void
-RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
+RrcAsn1Header::SerializeMeasResults (const LteRrcSap::MeasResults &measResults) const
 {
   // Watchdog: if list has 0 elements, set boolean to false
-  if (measResults.measResultListEutra.empty ())
-    {
-      measResults.haveMeasResultNeighCells = false;
-    }
+  bool haveMeasResultNeighCells = measResults.haveMeasResultNeighCells
+    && !measResults.measResultListEutra.empty ();
 
   // Serialize MeasResults sequence, 1 optional value, extension marker present
-  SerializeSequence (std::bitset<1> (measResults.haveMeasResultNeighCells),true);
+  SerializeSequence (std::bitset<1> (haveMeasResultNeighCells),true);
 
   // Serialize measId
   SerializeInteger (measResults.measId,1,MAX_MEAS_ID);
@@ -645,7 +643,7 @@ RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
   // Serialize rsrqResult
   SerializeInteger (measResults.rsrqResult,0,34);
 
-  if (measResults.haveMeasResultNeighCells)
+  if (haveMeasResultNeighCells)
     {
       // Serialize Choice = 0 (MeasResultListEUTRA)
       SerializeChoice (4,0,false);
@@ -654,7 +652,7 @@ RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
       SerializeSequenceOf (measResults.measResultListEutra.size (),MAX_CELL_REPORT,1);
 
       // serialize MeasResultEutra elements in the list
-      std::list<LteRrcSap::MeasResultEutra>::iterator it;
+      std::list<LteRrcSap::MeasResultEutra>::const_iterator it;
       for (it = measResults.measResultListEutra.begin (); it != measResults.measResultListEutra.end (); it++)
         {
           SerializeSequence (std::bitset<1> (it->haveCgiInfo),false);
@@ -679,7 +677,7 @@ RrcAsn1Header::SerializeMeasResults (LteRrcSap::MeasResults measResults) const
               if (!it->cgiInfo.plmnIdentityList.empty ())
                 {
                   SerializeSequenceOf (it->cgiInfo.plmnIdentityList.size (),5,1);
-                  std::list<uint32_t>::iterator it2;
+                  std::list<uint32_t>::const_iterator it2;
                   for (it2 = it->cgiInfo.plmnIdentityList.begin (); it2 != it->cgiInfo.plmnIdentityList.end (); it2++)
                     {
                       SerializePlmnIdentity (*it2);
@@ -728,7 +726,7 @@ RrcAsn1Header::SerializePlmnIdentity (uint32_t plmnId) const
 }
 
 void 
-RrcAsn1Header::SerializeRachConfigCommon (LteRrcSap::RachConfigCommon rachConfigCommon) const
+RrcAsn1Header::SerializeRachConfigCommon (const LteRrcSap::RachConfigCommon &rachConfigCommon) const
 {
   // rach-ConfigCommon
   SerializeSequence (std::bitset<0> (0),true);
@@ -975,7 +973,7 @@ RrcAsn1Header::SerializeQoffsetRange (int8_t qOffsetRange) const
 }
 
 void
-RrcAsn1Header::SerializeThresholdEutra (LteRrcSap::ThresholdEutra thresholdEutra) const
+RrcAsn1Header::SerializeThresholdEutra (const LteRrcSap::ThresholdEutra &thresholdEutra) const
 {
   switch (thresholdEutra.choice)
     {
@@ -991,7 +989,7 @@ RrcAsn1Header::SerializeThresholdEutra (LteRrcSap::ThresholdEutra thresholdEutra
 }
 
 void
-RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
+RrcAsn1Header::SerializeMeasConfig (const LteRrcSap::MeasConfig &measConfig) const
 {
   // Serialize MeasConfig sequence
   // 11 optional fields, extension marker present
@@ -1012,7 +1010,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
   if (!measConfig.measObjectToRemoveList.empty ())
     {
       SerializeSequenceOf (measConfig.measObjectToRemoveList.size (),MAX_OBJECT_ID,1);
-      for (std::list<uint8_t>::iterator it = measConfig.measObjectToRemoveList.begin (); it != measConfig.measObjectToRemoveList.end (); it++)
+      for (std::list<uint8_t>::const_iterator it = measConfig.measObjectToRemoveList.begin (); it != measConfig.measObjectToRemoveList.end (); it++)
         {
           SerializeInteger (*it, 1, MAX_OBJECT_ID);
         }
@@ -1021,7 +1019,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
   if (!measConfig.measObjectToAddModList.empty ())
     {
       SerializeSequenceOf (measConfig.measObjectToAddModList.size (),MAX_OBJECT_ID,1);
-      for (std::list<LteRrcSap::MeasObjectToAddMod>::iterator it = measConfig.measObjectToAddModList.begin (); it != measConfig.measObjectToAddModList.end (); it++)
+      for (std::list<LteRrcSap::MeasObjectToAddMod>::const_iterator it = measConfig.measObjectToAddModList.begin (); it != measConfig.measObjectToAddModList.end (); it++)
         {
           SerializeSequence (std::bitset<0> (), false);
           SerializeInteger (it->measObjectId, 1, MAX_OBJECT_ID);
@@ -1071,7 +1069,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
           if (!it->measObjectEutra.cellsToRemoveList.empty ())
             {
               SerializeSequenceOf (it->measObjectEutra.cellsToRemoveList.size (),MAX_CELL_MEAS,1);
-              for (std::list<uint8_t>::iterator it2 = it->measObjectEutra.cellsToRemoveList.begin (); it2 != it->measObjectEutra.cellsToRemoveList.end (); it2++)
+              for (std::list<uint8_t>::const_iterator it2 = it->measObjectEutra.cellsToRemoveList.begin (); it2 != it->measObjectEutra.cellsToRemoveList.end (); it2++)
                 {
                   SerializeInteger (*it2, 1, MAX_CELL_MEAS);
                 }
@@ -1080,7 +1078,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
           if (!it->measObjectEutra.cellsToAddModList.empty ())
             {
               SerializeSequenceOf (it->measObjectEutra.cellsToAddModList.size (), MAX_CELL_MEAS, 1);
-              for (std::list<LteRrcSap::CellsToAddMod>::iterator it2 = it->measObjectEutra.cellsToAddModList.begin (); it2 != it->measObjectEutra.cellsToAddModList.end (); it2++)
+              for (std::list<LteRrcSap::CellsToAddMod>::const_iterator it2 = it->measObjectEutra.cellsToAddModList.begin (); it2 != it->measObjectEutra.cellsToAddModList.end (); it2++)
                 {
                   SerializeSequence (std::bitset<0> (), false);
 
@@ -1098,7 +1096,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
           if (!it->measObjectEutra.blackCellsToRemoveList.empty () )
             {
               SerializeSequenceOf (it->measObjectEutra.blackCellsToRemoveList.size (),MAX_CELL_MEAS,1);
-              for (std::list<uint8_t>::iterator it2 = it->measObjectEutra.blackCellsToRemoveList.begin (); it2 != it->measObjectEutra.blackCellsToRemoveList.end (); it2++)
+              for (std::list<uint8_t>::const_iterator it2 = it->measObjectEutra.blackCellsToRemoveList.begin (); it2 != it->measObjectEutra.blackCellsToRemoveList.end (); it2++)
                 {
                   SerializeInteger (*it2, 1, MAX_CELL_MEAS);
                 }
@@ -1107,7 +1105,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
           if (!it->measObjectEutra.blackCellsToAddModList.empty () )
             {
               SerializeSequenceOf (it->measObjectEutra.blackCellsToAddModList.size (), MAX_CELL_MEAS, 1);
-              for (std::list<LteRrcSap::BlackCellsToAddMod>::iterator it2 = it->measObjectEutra.blackCellsToAddModList.begin (); it2 != it->measObjectEutra.blackCellsToAddModList.end (); it2++)
+              for (std::list<LteRrcSap::BlackCellsToAddMod>::const_iterator it2 = it->measObjectEutra.blackCellsToAddModList.begin (); it2 != it->measObjectEutra.blackCellsToAddModList.end (); it2++)
                 {
                   SerializeSequence (std::bitset<0> (),false);
                   SerializeInteger (it2->cellIndex, 1, MAX_CELL_MEAS);
@@ -1182,7 +1180,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
   if (!measConfig.reportConfigToRemoveList.empty () )
     {
       SerializeSequenceOf (measConfig.reportConfigToRemoveList.size (),MAX_REPORT_CONFIG_ID,1);
-      for (std::list<uint8_t>::iterator it = measConfig.reportConfigToRemoveList.begin (); it != measConfig.reportConfigToRemoveList.end (); it++)
+      for (std::list<uint8_t>::const_iterator it = measConfig.reportConfigToRemoveList.begin (); it != measConfig.reportConfigToRemoveList.end (); it++)
         {
           SerializeInteger (*it, 1,MAX_REPORT_CONFIG_ID);
         }
@@ -1191,7 +1189,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
   if (!measConfig.reportConfigToAddModList.empty () )
     {
       SerializeSequenceOf (measConfig.reportConfigToAddModList.size (),MAX_REPORT_CONFIG_ID,1);
-      for (std::list<LteRrcSap::ReportConfigToAddMod>::iterator it = measConfig.reportConfigToAddModList.begin (); it != measConfig.reportConfigToAddModList.end (); it++)
+      for (std::list<LteRrcSap::ReportConfigToAddMod>::const_iterator it = measConfig.reportConfigToAddModList.begin (); it != measConfig.reportConfigToAddModList.end (); it++)
         {
           SerializeSequence (std::bitset<0> (), false);
           SerializeInteger (it->reportConfigId,1,MAX_REPORT_CONFIG_ID);
@@ -1413,7 +1411,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
   if (!measConfig.measIdToRemoveList.empty () )
     {
       SerializeSequenceOf (measConfig.measIdToRemoveList.size (), MAX_MEAS_ID, 1);
-      for (std::list<uint8_t>::iterator it = measConfig.measIdToRemoveList.begin (); it != measConfig.measIdToRemoveList.end (); it++)
+      for (std::list<uint8_t>::const_iterator it = measConfig.measIdToRemoveList.begin (); it != measConfig.measIdToRemoveList.end (); it++)
         {
           SerializeInteger (*it, 1, MAX_MEAS_ID);
         }
@@ -1422,7 +1420,7 @@ RrcAsn1Header::SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const
   if (!measConfig.measIdToAddModList.empty () )
     {
       SerializeSequenceOf ( measConfig.measIdToAddModList.size (), MAX_MEAS_ID, 1);
-      for (std::list<LteRrcSap::MeasIdToAddMod>::iterator it = measConfig.measIdToAddModList.begin (); it != measConfig.measIdToAddModList.end (); it++)
+      for (std::list<LteRrcSap::MeasIdToAddMod>::const_iterator it = measConfig.measIdToAddModList.begin (); it != measConfig.measIdToAddModList.end (); it++)
         {
           SerializeInteger (it->measId, 1, MAX_MEAS_ID);
           SerializeInteger (it->measObjectId, 1, MAX_OBJECT_ID);
@@ -49,21 +49,21 @@ protected:
   virtual void PreSerialize (void) const = 0;
 
   // Serialization functions
-  void SerializeSrbToAddModList (std::list<LteRrcSap::SrbToAddMod> srbToAddModList) const;
-  void SerializeDrbToAddModList (std::list<LteRrcSap::DrbToAddMod> drbToAddModList) const;
-  void SerializeLogicalChannelConfig (LteRrcSap::LogicalChannelConfig logicalChannelConfig) const;
-  void SerializeRadioResourceConfigDedicated (LteRrcSap::RadioResourceConfigDedicated radioResourceConfigDedicated) const;
-  void SerializePhysicalConfigDedicated (LteRrcSap::PhysicalConfigDedicated physicalConfigDedicated) const;
-  void SerializeSystemInformationBlockType1 (LteRrcSap::SystemInformationBlockType1 systemInformationBlockType1) const;
-  void SerializeSystemInformationBlockType2 (LteRrcSap::SystemInformationBlockType2 systemInformationBlockType2) const;
-  void SerializeRadioResourceConfigCommon (LteRrcSap::RadioResourceConfigCommon radioResourceConfigCommon) const;
-  void SerializeRadioResourceConfigCommonSib (LteRrcSap::RadioResourceConfigCommonSib radioResourceConfigCommonSib) const;
-  void SerializeMeasResults (LteRrcSap::MeasResults measResults) const;
+  void SerializeSrbToAddModList (const std::list<LteRrcSap::SrbToAddMod> &srbToAddModList) const;
+  void SerializeDrbToAddModList (const std::list<LteRrcSap::DrbToAddMod> &drbToAddModList) const;
+  void SerializeLogicalChannelConfig (const LteRrcSap::LogicalChannelConfig &logicalChannelConfig) const;
+  void SerializeRadioResourceConfigDedicated (const LteRrcSap::RadioResourceConfigDedicated &radioResourceConfigDedicated) const;
+  void SerializePhysicalConfigDedicated (const LteRrcSap::PhysicalConfigDedicated &physicalConfigDedicated) const;
+  void SerializeSystemInformationBlockType1 (const LteRrcSap::SystemInformationBlockType1 &systemInformationBlockType1) const;
+  void SerializeSystemInformationBlockType2 (const LteRrcSap::SystemInformationBlockType2 &systemInformationBlockType2) const;
+  void SerializeRadioResourceConfigCommon (const LteRrcSap::RadioResourceConfigCommon &radioResourceConfigCommon) const;
+  void SerializeRadioResourceConfigCommonSib (const LteRrcSap::RadioResourceConfigCommonSib &radioResourceConfigCommonSib) const;
+  void SerializeMeasResults (const LteRrcSap::MeasResults &measResults) const;
   void SerializePlmnIdentity (uint32_t plmnId) const;
-  void SerializeRachConfigCommon (LteRrcSap::RachConfigCommon rachConfigCommon) const;
-  void SerializeMeasConfig (LteRrcSap::MeasConfig measConfig) const;
+  void SerializeRachConfigCommon (const LteRrcSap::RachConfigCommon &rachConfigCommon) const;
+  void SerializeMeasConfig (const LteRrcSap::MeasConfig &measConfig) const;
   void SerializeQoffsetRange (int8_t qOffsetRange) const;
-  void SerializeThresholdEutra (LteRrcSap::ThresholdEutra thresholdEutra) const;
+  void SerializeThresholdEutra (const LteRrcSap::ThresholdEutra &thresholdEutra) const;
   
   // Deserialization functions
   Buffer::Iterator DeserializeDrbToAddModList (std::list<LteRrcSap::DrbToAddMod> *drbToAddModLis, Buffer::Iterator bIterator);
@@ -1189,6 +1189,12 @@ LteSpectrumPhy::SetCellId (uint16_t cellId)
   m_cellId = cellId;
 }
 
+uint16_t
+LteSpectrumPhy::GetCellId () const
+{
+  return m_cellId;
+}
+
 
 void
 LteSpectrumPhy::AddRsPowerChunkProcessor (Ptr<LteChunkProcessor> p)
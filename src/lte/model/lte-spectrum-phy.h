@@ -323,6 +323,11 @@ public:
    */
   void SetCellId (uint16_t cellId);
 
+  /**
+   * \return the Cell Identifier
+   */
+  uint16_t GetCellId () const;
+
 
   /**
   *
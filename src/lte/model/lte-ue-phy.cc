@@ -549,25 +549,27 @@ LteUePhy::GenerateCqiRsrpRsrq (const SpectrumValue& sinr)
       // measure instantaneous RSRQ now
       NS_ASSERT_MSG (m_rsInterferencePowerUpdated, " RS interference power info obsolete");
 
-      std::list <PssElement>::iterator itPss = m_pssList.begin ();
-      while (itPss != m_pssList.end ())
+      // the RSSI is the same for all the cells: evaluate it only once, so
+      // that the cost of a subframe grows linearly with the detected cells
+      uint16_t rbNum = 0;
+      double rssiSum = 0.0;
+
+      Values::const_iterator itIntN = m_rsInterferencePower.ConstValuesBegin ();
+      Values::const_iterator itPj = m_rsReceivedPower.ConstValuesBegin ();
+      for (itPj = m_rsReceivedPower.ConstValuesBegin ();
+           itPj != m_rsReceivedPower.ConstValuesEnd ();
+           itIntN++, itPj++)
         {
-          uint16_t rbNum = 0;
-          double rssiSum = 0.0;
-
-          Values::const_iterator itIntN = m_rsInterferencePower.ConstValuesBegin ();
-          Values::const_iterator itPj = m_rsReceivedPower.ConstValuesBegin ();
-          for (itPj = m_rsReceivedPower.ConstValuesBegin ();
-               itPj != m_rsReceivedPower.ConstValuesEnd ();
-               itIntN++, itPj++)
-            {
-              rbNum++;
-              // convert PSD [W/Hz] to linear power [W] for the single RE
-              double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
-              double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
-              rssiSum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
-            }
+          rbNum++;
+          // convert PSD [W/Hz] to linear power [W] for the single RE
+          double interfPlusNoisePowerTxW = ((*itIntN) * 180000.0) / 12.0;
+          double signalPowerTxW = ((*itPj) * 180000.0) / 12.0;
+          rssiSum += (2 * (interfPlusNoisePowerTxW + signalPowerTxW));
+        }
 
+      std::vector <PssElement>::iterator itPss = m_pssList.begin ();
+      while (itPss != m_pssList.end ())
+        {
           NS_ASSERT (rbNum == (*itPss).nRB);
           double rsrq_dB = 10 * log10 ((*itPss).pssPsdSum / rssiSum);
 
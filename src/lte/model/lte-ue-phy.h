@@ -406,7 +406,7 @@ private:
     double pssPsdSum;
     uint16_t nRB;
   };
-  std::list <PssElement> m_pssList;
+  std::vector <PssElement> m_pssList;
 
   /**
    * The `RsrqUeMeasThreshold` attribute. Receive threshold for PSS on RSRQ
@@ -1610,6 +1610,9 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
   bool eventLeavingCondApplicable = false;
   ConcernedCells_t concernedCellsEntry;
   ConcernedCells_t concernedCellsLeaving;
+  // cells to be removed from the pending triggers, all at once at the end
+  std::set<uint16_t> cancelledCellsEntry;
+  std::set<uint16_t> cancelledCellsLeaving;
 
   switch (reportConfigEutra.eventId)
     {
@@ -1862,7 +1865,7 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
               }
             else if (reportConfigEutra.timeToTrigger > 0)
               {
-                CancelEnteringTrigger (measId, cellId);
+                cancelledCellsEntry.insert (cellId);
               }
 
             // Inequality A3-2 (Leaving condition): Mn + Ofn + Ocn + Hys < Mp + Ofp + Ocp + Off
@@ -1878,7 +1881,7 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
               }
             else if (reportConfigEutra.timeToTrigger > 0)
               {
-                CancelLeavingTrigger (measId, cellId);
+                cancelledCellsLeaving.insert (cellId);
               }
 
             NS_LOG_LOGIC (this << " event A3: neighbor cell " << cellId
@@ -1963,7 +1966,7 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
               }
             else if (reportConfigEutra.timeToTrigger > 0)
               {
-                CancelEnteringTrigger (measId, cellId);
+                cancelledCellsEntry.insert (cellId);
               }
 
             // Inequality A4-2 (Leaving condition): Mn + Ofn + Ocn + Hys < Thresh
@@ -1979,7 +1982,7 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
               }
             else if (reportConfigEutra.timeToTrigger > 0)
               {
-                CancelLeavingTrigger (measId, cellId);
+                cancelledCellsLeaving.insert (cellId);
               }
 
             NS_LOG_LOGIC (this << " event A4: neighbor cell " << cellId
@@ -2081,7 +2084,7 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
                   }
                 else if (reportConfigEutra.timeToTrigger > 0)
                   {
-                    CancelEnteringTrigger (measId, cellId);
+                    cancelledCellsEntry.insert (cellId);
                   }
 
                 NS_LOG_LOGIC (this << " event A5: neighbor cell " << cellId
@@ -2170,7 +2173,7 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
 
                             if (!leavingCond)
                               {
-                                CancelLeavingTrigger (measId, cellId);
+                                cancelledCellsLeaving.insert (cellId);
                               }
 
                             /*
@@ -2268,6 +2271,16 @@ LteUeRrc::MeasurementReportTriggering (uint8_t measId)
 
     } // switch (event type)
 
+  if (!cancelledCellsEntry.empty ())
+    {
+      CancelEnteringTrigger (measId, cancelledCellsEntry);
+    }
+
+  if (!cancelledCellsLeaving.empty ())
+    {
+      CancelLeavingTrigger (measId, cancelledCellsLeaving);
+    }
+
   NS_LOG_LOGIC (this << " eventEntryCondApplicable=" << eventEntryCondApplicable
                      << " eventLeavingCondApplicable=" << eventLeavingCondApplicable);
 
@@ -2344,9 +2357,9 @@ LteUeRrc::CancelEnteringTrigger (uint8_t measId)
 }
 
 void
-LteUeRrc::CancelEnteringTrigger (uint8_t measId, uint16_t cellId)
+LteUeRrc::CancelEnteringTrigger (uint8_t measId, const std::set<uint16_t> &cellIds)
 {
-  NS_LOG_FUNCTION (this << (uint16_t) measId << cellId);
+  NS_LOG_FUNCTION (this << (uint16_t) measId << cellIds.size ());
 
   std::map<uint8_t, std::list<PendingTrigger_t> >::iterator
     it1 = m_enteringTriggerQueue.find (measId);
@@ -2357,14 +2370,17 @@ LteUeRrc::CancelEnteringTrigger (uint8_t measId, uint16_t cellId)
     {
       NS_ASSERT (it2->measId == measId);
 
-      ConcernedCells_t::iterator it3;
-      for (it3 = it2->concernedCells.begin ();
-           it3 != it2->concernedCells.end (); ++it3)
+      ConcernedCells_t::iterator it3 = it2->concernedCells.begin ();
+      while (it3 != it2->concernedCells.end ())
         {
-          if (*it3 == cellId)
+          if (cellIds.find (*it3) != cellIds.end ())
             {
               it3 = it2->concernedCells.erase (it3);
             }
+          else
+            {
+              it3++;
+            }
         }
 
       if (it2->concernedCells.empty ())
@@ -2406,9 +2422,9 @@ LteUeRrc::CancelLeavingTrigger (uint8_t measId)
 }
 
 void
-LteUeRrc::CancelLeavingTrigger (uint8_t measId, uint16_t cellId)
+LteUeRrc::CancelLeavingTrigger (uint8_t measId, const std::set<uint16_t> &cellIds)
 {
-  NS_LOG_FUNCTION (this << (uint16_t) measId << cellId);
+  NS_LOG_FUNCTION (this << (uint16_t) measId << cellIds.size ());
 
   std::map<uint8_t, std::list<PendingTrigger_t> >::iterator
     it1 = m_leavingTriggerQueue.find (measId);
@@ -2419,14 +2435,17 @@ LteUeRrc::CancelLeavingTrigger (uint8_t measId, uint16_t cellId)
     {
       NS_ASSERT (it2->measId == measId);
 
-      ConcernedCells_t::iterator it3;
-      for (it3 = it2->concernedCells.begin ();
-           it3 != it2->concernedCells.end (); ++it3)
+      ConcernedCells_t::iterator it3 = it2->concernedCells.begin ();
+      while (it3 != it2->concernedCells.end ())
         {
-          if (*it3 == cellId)
+          if (cellIds.find (*it3) != cellIds.end ())
             {
               it3 = it2->concernedCells.erase (it3);
             }
+          else
+            {
+              it3++;
+            }
         }
 
       if (it2->concernedCells.empty ())
@@ -2499,11 +2518,8 @@ LteUeRrc::VarMeasReportListAdd (uint8_t measId, ConcernedCells_t enteringCells)
            * we clean up the time-to-trigger queue. This case might occur when
            * time-to-trigger > 200 ms.
            */
-          for (ConcernedCells_t::const_iterator it = enteringCells.begin ();
-               it != enteringCells.end (); ++it)
-            {
-              CancelEnteringTrigger (measId, *it);
-            }
+          std::set<uint16_t> cellIds (enteringCells.begin (), enteringCells.end ());
+          CancelEnteringTrigger (measId, cellIds);
         }
 
     } // end of if (!enteringTriggerIt->second.empty ())
@@ -2560,11 +2576,8 @@ LteUeRrc::VarMeasReportListErase (uint8_t measId, ConcernedCells_t leavingCells,
            * we clean up the time-to-trigger queue. This case might occur when
            * time-to-trigger > 200 ms.
            */
-          for (ConcernedCells_t::const_iterator it = leavingCells.begin ();
-               it != leavingCells.end (); ++it)
-            {
-              CancelLeavingTrigger (measId, *it);
-            }
+          std::set<uint16_t> cellIds (leavingCells.begin (), leavingCells.end ());
+          CancelLeavingTrigger (measId, cellIds);
         }
 
     } // end of if (!leavingTriggerIt->second.empty ())
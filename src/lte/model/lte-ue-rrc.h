@@ -865,25 +865,26 @@ private:
   void CancelEnteringTrigger (uint8_t measId);
 
   /**
-   * \brief Remove a specific cell from the waiting triggers in
+   * \brief Remove some cells from the waiting triggers in
    *        #m_enteringTriggerQueue which belong to the given measurement
    *        identity.
    * \param measId the measurement identity to be processed, must already exists
    *               in #m_enteringTriggerQueue, otherwise an error would be
    *               raised
-   * \param cellId the cell ID to be removed from the waiting triggers
+   * \param cellIds the cell IDs to be removed from the waiting triggers
    *
    * \note The function may conclude that there is nothing to be removed. In
    *       this case, the function will simply ignore quietly.
    *
-   * This function is used when a specific neighbour cell no longer fulfills
-   * the entering condition of the measurement identity. Thus the cell must be
+   * This function is used when some neighbour cells no longer fulfill
+   * the entering condition of the measurement identity. Thus the cells must be
    * removed from all the waiting triggers for this measurement identity in
-   * #m_enteringTriggerQueue.
+   * #m_enteringTriggerQueue. The cells of a measurement are gathered and
+   * removed in a single pass over the waiting triggers.
    *
    * \sa LteUeRrc::m_enteringTriggerQueue
    */
-  void CancelEnteringTrigger (uint8_t measId, uint16_t cellId);
+  void CancelEnteringTrigger (uint8_t measId, const std::set<uint16_t> &cellIds);
 
   /**
    * \brief Clear all the waiting triggers in #m_leavingTriggerQueue which are
@@ -905,25 +906,26 @@ private:
   void CancelLeavingTrigger (uint8_t measId);
 
   /**
-   * \brief Remove a specific cell from the waiting triggers in
+   * \brief Remove some cells from the waiting triggers in
    *        #m_leavingTriggerQueue which belong to the given measurement
    *        identity.
    * \param measId the measurement identity to be processed, must already exists
    *               in #m_leavingTriggerQueue, otherwise an error would be
    *               raised
-   * \param cellId the cell ID to be removed from the waiting triggers
+   * \param cellIds the cell IDs to be removed from the waiting triggers
    *
    * \note The function may conclude that there is nothing to be removed. In
    *       this case, the function will simply ignore quietly.
    *
-   * This function is used when a specific neighbour cell no longer fulfills
-   * the leaving condition of the measurement identity. Thus the cell must be
+   * This function is used when some neighbour cells no longer fulfill
+   * the leaving condition of the measurement identity. Thus the cells must be
    * removed from all the waiting triggers for this measurement identity in
-   * #m_leavingTriggerQueue.
+   * #m_leavingTriggerQueue. The cells of a measurement are gathered and
+   * removed in a single pass over the waiting triggers.
    *
    * \sa LteUeRrc::m_leavingTriggerQueue
    */
-  void CancelLeavingTrigger (uint8_t measId, uint16_t cellId);
+  void CancelLeavingTrigger (uint8_t measId, const std::set<uint16_t> &cellIds);
 
   /**
    * The `T300` attribute. Timer for RRC connection establishment procedure
@@ -0,0 +1,682 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RNTI_MAP_H
+#define RNTI_MAP_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * A map from RNTI to the state of a UE, with the interface of a
+ * std::map <uint16_t, T>, used by the FF MAC schedulers.  It also maps
+ * the other dense 16 bit keys of the schedulers, such as the SFN/SF of
+ * the UL allocation maps.
+ *
+ * The RNTIs of a cell are small and dense, so the elements are found
+ * by indexing rather than by walking a tree: the 16 bit RNTI selects a
+ * page of 256 slots, then a slot.  The elements are stored in the
+ * slots, so that inserting an element allocates memory only for a new
+ * page.  A page is allocated when first used and released when its
+ * last element is erased, except for one spare page kept for the next
+ * allocation, so that the memory follows the number of UEs even when
+ * the RNTIs wrap around.
+ *
+ * The iteration is in increasing RNTI order, as with a std::map, so
+ * that the scheduling decisions do not depend on the container.  The
+ * iterators stay valid when other elements are inserted or erased.
+ */
+template <class T>
+class RntiMap
+{
+public:
+  typedef uint16_t key_type;                           //!< The RNTI
+  typedef T mapped_type;                               //!< The UE state
+  typedef std::pair<const uint16_t, T> value_type;     //!< An element
+  typedef std::size_t size_type;                       //!< A size
+
+private:
+  /** The number of RNTIs, and the end position of the iterators. */
+  static const uint32_t N_KEYS = 0x10000;
+  /** log2 of the number of slots of a page. */
+  static const uint32_t PAGE_BITS = 8;
+  /** The number of slots of a page. */
+  static const uint32_t PAGE_SIZE = 1 << PAGE_BITS;
+  /** The number of pages. */
+  static const uint32_t N_PAGES = N_KEYS >> PAGE_BITS;
+
+  /** The number of 64 bit words of the bitmap of a page. */
+  static const uint32_t PAGE_WORDS = PAGE_SIZE / 64;
+
+  /** A page of elements. */
+  struct Page
+  {
+    /** The storage of the elements, aligned for any type. */
+    union Storage
+    {
+      char bytes[PAGE_SIZE * sizeof (value_type)]; //!< The elements
+      long double ld;                              //!< Alignment
+      uint64_t u64;                                //!< Alignment
+      void *ptr;                                   //!< Alignment
+    } storage;                    //!< The elements
+    uint64_t used[PAGE_WORDS];    //!< The slots holding an element
+    uint32_t n;                   //!< The number of elements
+
+    /**
+     * \param [in] i The slot.
+     * \returns The element of the slot, or null.
+     */
+    value_type * Get (uint32_t i)
+    {
+      return (used[i >> 6] >> (i & 63)) & 1
+             ? reinterpret_cast<value_type *> (storage.bytes) + i : 0;
+    }
+  };
+
+public:
+  /**
+   * An iterator on the elements, in increasing RNTI order.
+   *
+   * \tparam V value_type or const value_type
+   */
+  template <class V>
+  class Iterator
+  {
+public:
+    Iterator ()
+      : m_map (0),
+        m_key (N_KEYS)
+    {
+    }
+    /**
+     * Build an iterator from an iterator on non-const elements.
+     * \param [in] o The iterator.
+     */
+    Iterator (const Iterator<value_type> &o)
+      : m_map (o.m_map),
+        m_key (o.m_key)
+    {
+    }
+    /** \returns The element. */
+    V & operator* () const
+    {
+      return *m_map->Slot (m_key);
+    }
+    /** \returns The element. */
+    V * operator-> () const
+    {
+      return m_map->Slot (m_key);
+    }
+    /** \returns The iterator on the next element. */
+    Iterator & operator++ ()
+    {
+      m_key = m_map->Next (m_key + 1);
+      return *this;
+    }
+    /** \returns The iterator before the increment. */
+    Iterator operator++ (int)
+    {
+      Iterator old = *this;
+      ++(*this);
+      return old;
+    }
+    /**
+     * \returns The iterator on the previous element, or the end
+     * iterator before the first element.
+     */
+    Iterator & operator-- ()
+    {
+      m_key = m_map->Previous (m_key);
+      return *this;
+    }
+    /** \returns The iterator before the decrement. */
+    Iterator operator-- (int)
+    {
+      Iterator old = *this;
+      --(*this);
+      return old;
+    }
+    /**
+     * \param [in] o The other iterator.
+     * \returns \c true if both iterators are on the same element.
+     */
+    bool operator== (const Iterator &o) const
+    {
+      return m_key == o.m_key && m_map == o.m_map;
+    }
+    /**
+     * \param [in] o The other iterator.
+     * \returns \c true if the iterators are on different elements.
+     */
+    bool operator!= (const Iterator &o) const
+    {
+      return !(*this == o);
+    }
+
+private:
+    friend class RntiMap;
+    template <class> friend class Iterator;
+    /**
+     * \param [in] map The map.
+     * \param [in] key The RNTI of the element, or N_KEYS for the end.
+     */
+    Iterator (const RntiMap *map, uint32_t key)
+      : m_map (map),
+        m_key (key)
+    {
+    }
+    const RntiMap *m_map;  //!< The map
+    uint32_t m_key;        //!< The RNTI of the element, or N_KEYS
+  };
+
+  typedef Iterator<value_type> iterator;             //!< An iterator
+  typedef Iterator<const value_type> const_iterator; //!< A const iterator
+
+  RntiMap ()
+    : m_spare (0),
+      m_size (0)
+  {
+    std::memset (m_pages, 0, sizeof (m_pages));
+  }
+  /**
+   * Copy a map.
+   * \param [in] o The map to copy.
+   */
+  RntiMap (const RntiMap &o)
+    : m_spare (0),
+      m_size (0)
+  {
+    std::memset (m_pages, 0, sizeof (m_pages));
+    Copy (o);
+  }
+  ~RntiMap ()
+  {
+    clear ();
+    delete m_spare;
+  }
+  /**
+   * Copy a map.
+   * \param [in] o The map to copy.
+   * \returns This map.
+   */
+  RntiMap & operator= (const RntiMap &o)
+  {
+    if (this != &o)
+      {
+        clear ();
+        Copy (o);
+      }
+    return *this;
+  }
+
+  /** \returns The iterator on the first element. */
+  iterator begin ()
+  {
+    return iterator (this, Next (0));
+  }
+  /** \returns The iterator on the first element. */
+  const_iterator begin () const
+  {
+    return const_iterator (this, Next (0));
+  }
+  /** \returns The end iterator. */
+  iterator end ()
+  {
+    return iterator (this, N_KEYS);
+  }
+  /** \returns The end iterator. */
+  const_iterator end () const
+  {
+    return const_iterator (this, N_KEYS);
+  }
+  /** \returns The number of elements. */
+  size_type size () const
+  {
+    return m_size;
+  }
+  /** \returns \c true if there is no element. */
+  bool empty () const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * \param [in] rnti The RNTI.
+   * \returns The iterator on the element of this RNTI, or end ().
+   */
+  iterator find (uint16_t rnti)
+  {
+    return iterator (this, Slot (rnti) != 0 ? rnti : N_KEYS);
+  }
+  /**
+   * \param [in] rnti The RNTI.
+   * \returns The iterator on the element of this RNTI, or end ().
+   */
+  const_iterator find (uint16_t rnti) const
+  {
+    return const_iterator (this, Slot (rnti) != 0 ? rnti : N_KEYS);
+  }
+  /**
+   * \param [in] rnti The RNTI.
+   * \returns The number of elements of this RNTI, 0 or 1.
+   */
+  size_type count (uint16_t rnti) const
+  {
+    return Slot (rnti) != 0 ? 1 : 0;
+  }
+  /**
+   * \param [in] rnti The RNTI.
+   * \returns The state of this RNTI, inserted if needed.
+   */
+  T & operator[] (uint16_t rnti)
+  {
+    value_type *slot = Slot (rnti);
+    if (slot == 0)
+      {
+        slot = Insert (rnti, T ());
+      }
+    return slot->second;
+  }
+  /**
+   * Insert an element if its RNTI is not in the map.
+   * \param [in] v The element, a std::pair of an RNTI and a state.
+   * \returns The iterator on the element of this RNTI, and \c true if
+   * the element was inserted.
+   */
+  template <class P>
+  std::pair<iterator, bool> insert (const P &v)
+  {
+    if (Slot (v.first) != 0)
+      {
+        return std::make_pair (iterator (this, v.first), false);
+      }
+    Insert (v.first, v.second);
+    return std::make_pair (iterator (this, v.first), true);
+  }
+  /**
+   * Erase an element.
+   * \param [in] it The iterator on the element.
+   */
+  void erase (iterator it)
+  {
+    erase ((uint16_t) it.m_key);
+  }
+  /**
+   * Erase the element of an RNTI, if any.
+   * \param [in] rnti The RNTI.
+   * \returns The number of elements erased.
+   */
+  size_type erase (uint16_t rnti)
+  {
+    Page *page = m_pages[rnti >> PAGE_BITS];
+    uint32_t i = rnti & (PAGE_SIZE - 1);
+    value_type *slot = page != 0 ? page->Get (i) : 0;
+    if (slot == 0)
+      {
+        return 0;
+      }
+    slot->~value_type ();
+    page->used[i >> 6] &= ~((uint64_t)1 << (i & 63));
+    m_size--;
+    if (--page->n == 0)
+      {
+        ReleasePage (page);
+        m_pages[rnti >> PAGE_BITS] = 0;
+      }
+    return 1;
+  }
+  /** Erase all the elements. */
+  void clear ()
+  {
+    for (uint32_t p = 0; m_size > 0 && p < N_PAGES; p++)
+      {
+        Page *page = m_pages[p];
+        if (page == 0)
+          {
+            continue;
+          }
+        for (uint32_t i = 0; i < PAGE_SIZE; i++)
+          {
+            value_type *slot = page->Get (i);
+            if (slot != 0)
+              {
+                slot->~value_type ();
+              }
+          }
+        m_size -= page->n;
+        page->n = 0;
+        std::memset (page->used, 0, sizeof (page->used));
+        ReleasePage (page);
+        m_pages[p] = 0;
+      }
+  }
+
+private:
+  /**
+   * \param [in] key The RNTI.
+   * \returns The element of this RNTI, or null.
+   */
+  value_type * Slot (uint32_t key) const
+  {
+    Page *page = m_pages[key >> PAGE_BITS];
+    return page != 0 ? page->Get (key & (PAGE_SIZE - 1)) : 0;
+  }
+  /**
+   * \param [in] key The first RNTI to check.
+   * \returns The first RNTI of an element from key, or N_KEYS.
+   */
+  uint32_t Next (uint32_t key) const
+  {
+    while (key < N_KEYS)
+      {
+        const Page *page = m_pages[key >> PAGE_BITS];
+        if (page == 0)
+          {
+            key = ((key >> PAGE_BITS) + 1) << PAGE_BITS;
+            continue;
+          }
+        // Skip the empty slots 64 at a time
+        uint32_t i = key & (PAGE_SIZE - 1);
+        uint64_t word = page->used[i >> 6] >> (i & 63);
+        if (word == 0)
+          {
+            key = (key | 63) + 1;
+            continue;
+          }
+        while ((word & 1) == 0)
+          {
+            word >>= 1;
+            key++;
+          }
+        return key;
+      }
+    return N_KEYS;
+  }
+  /**
+   * \param [in] key An RNTI, or N_KEYS.
+   * \returns The last RNTI of an element before key, or N_KEYS.
+   */
+  uint32_t Previous (uint32_t key) const
+  {
+    while (key > 0)
+      {
+        key--;
+        if (Slot (key) != 0)
+          {
+            return key;
+          }
+      }
+    return N_KEYS;
+  }
+  /**
+   * Insert an element, the RNTI not being in the map.
+   * \param [in] rnti The RNTI.
+   * \param [in] t The state.
+   * \returns The element.
+   */
+  value_type * Insert (uint16_t rnti, const T &t)
+  {
+    Page *&page = m_pages[rnti >> PAGE_BITS];
+    if (page == 0)
+      {
+        if (m_spare != 0)
+          {
+            page = m_spare;
+            m_spare = 0;
+          }
+        else
+          {
+            page = new Page;
+            std::memset (page->used, 0, sizeof (page->used));
+            page->n = 0;
+          }
+      }
+    uint32_t i = rnti & (PAGE_SIZE - 1);
+    value_type *slot = new (reinterpret_cast<value_type *> (page->storage.bytes) + i) value_type (rnti, t);
+    page->used[i >> 6] |= (uint64_t)1 << (i & 63);
+    page->n++;
+    m_size++;
+    return slot;
+  }
+  /**
+   * Release an empty page, keeping it as the spare page if there is none.
+   * \param [in] page The page.
+   */
+  void ReleasePage (Page *page)
+  {
+    if (m_spare == 0)
+      {
+        m_spare = page;
+      }
+    else
+      {
+        delete page;
+      }
+  }
+  /**
+   * Insert the elements of another map into this empty map.
+   * \param [in] o The other map.
+   */
+  void Copy (const RntiMap &o)
+  {
+    for (const_iterator it = o.begin (); it != o.end (); ++it)
+      {
+        Insert (it->first, it->second);
+      }
+  }
+
+  Page *m_pages[N_PAGES];  //!< The pages, or null
+  Page *m_spare;           //!< An empty page for the next allocation, or null
+  size_type m_size;        //!< The number of elements
+};
+
+/**
+ * \ingroup lte
+ *
+ * A set of RNTIs, with the interface of a std::set <uint16_t>, used by
+ * the FF MAC schedulers for the UEs already allocated in a TTI.
+ *
+ * The set is a bitmap of all the RNTIs, with the list of the RNTIs
+ * inserted, so that clear () only resets their bits.  A scheduler
+ * keeps one set as a scratch buffer cleared at each TTI, and neither
+ * insert () nor clear () allocate memory once the list has grown to
+ * the number of UEs.  The iteration is in increasing RNTI order.
+ */
+class RntiSet
+{
+  /** The number of RNTIs, and the end position of the iterators. */
+  static const uint32_t N_KEYS = 0x10000;
+
+public:
+  typedef uint16_t key_type;      //!< The RNTI
+  typedef uint16_t value_type;    //!< The RNTI
+  typedef std::size_t size_type;  //!< A size
+
+  /** An iterator on the RNTIs, in increasing order. */
+  class const_iterator
+  {
+public:
+    const_iterator ()
+      : m_set (0),
+        m_key (N_KEYS)
+    {
+    }
+    /** \returns The RNTI. */
+    uint16_t operator* () const
+    {
+      return m_key;
+    }
+    /** \returns The iterator on the next RNTI. */
+    const_iterator & operator++ ()
+    {
+      m_key = m_set->Next (m_key + 1);
+      return *this;
+    }
+    /** \returns The iterator before the increment. */
+    const_iterator operator++ (int)
+    {
+      const_iterator old = *this;
+      ++(*this);
+      return old;
+    }
+    /**
+     * \param [in] o The other iterator.
+     * \returns \c true if both iterators are on the same RNTI.
+     */
+    bool operator== (const const_iterator &o) const
+    {
+      return m_key == o.m_key && m_set == o.m_set;
+    }
+    /**
+     * \param [in] o The other iterator.
+     * \returns \c true if the iterators are on different RNTIs.
+     */
+    bool operator!= (const const_iterator &o) const
+    {
+      return !(*this == o);
+    }
+
+private:
+    friend class RntiSet;
+    /**
+     * \param [in] set The set.
+     * \param [in] key The RNTI, or N_KEYS for the end.
+     */
+    const_iterator (const RntiSet *set, uint32_t key)
+      : m_set (set),
+        m_key (key)
+    {
+    }
+    const RntiSet *m_set;  //!< The set
+    uint32_t m_key;        //!< The RNTI, or N_KEYS
+  };
+
+  typedef const_iterator iterator;  //!< An iterator
+
+  RntiSet ()
+    : m_bits (N_KEYS / 64, 0)
+  {
+  }
+
+  /** \returns The iterator on the first RNTI. */
+  const_iterator begin () const
+  {
+    return const_iterator (this, Next (0));
+  }
+  /** \returns The end iterator. */
+  const_iterator end () const
+  {
+    return const_iterator (this, N_KEYS);
+  }
+  /** \returns The number of RNTIs. */
+  size_type size () const
+  {
+    return m_keys.size ();
+  }
+  /** \returns \c true if there is no RNTI. */
+  bool empty () const
+  {
+    return m_keys.empty ();
+  }
+  /**
+   * \param [in] rnti The RNTI.
+   * \returns The iterator on this RNTI, or end ().
+   */
+  const_iterator find (uint16_t rnti) const
+  {
+    return const_iterator (this, Contains (rnti) ? rnti : N_KEYS);
+  }
+  /**
+   * \param [in] rnti The RNTI.
+   * \returns 1 if the RNTI is in the set, else 0.
+   */
+  size_type count (uint16_t rnti) const
+  {
+    return Contains (rnti) ? 1 : 0;
+  }
+  /**
+   * Insert an RNTI.
+   * \param [in] rnti The RNTI.
+   * \returns The iterator on the RNTI, and \c true if it was inserted.
+   */
+  std::pair<const_iterator, bool> insert (uint16_t rnti)
+  {
+    bool inserted = !Contains (rnti);
+    if (inserted)
+      {
+        m_bits[rnti >> 6] |= (uint64_t)1 << (rnti & 63);
+        m_keys.push_back (rnti);
+      }
+    return std::make_pair (const_iterator (this, rnti), inserted);
+  }
+  /** Erase all the RNTIs, keeping the memory for the next ones. */
+  void clear ()
+  {
+    for (std::vector<uint16_t>::const_iterator it = m_keys.begin (); it != m_keys.end (); ++it)
+      {
+        m_bits[*it >> 6] = 0;
+      }
+    m_keys.clear ();
+  }
+
+private:
+  /**
+   * \param [in] rnti The RNTI.
+   * \returns \c true if the RNTI is in the set.
+   */
+  bool Contains (uint16_t rnti) const
+  {
+    return (m_bits[rnti >> 6] >> (rnti & 63)) & 1;
+  }
+  /**
+   * \param [in] key The first RNTI to check.
+   * \returns The first RNTI of the set from key, or N_KEYS.
+   */
+  uint32_t Next (uint32_t key) const
+  {
+    while (key < N_KEYS)
+      {
+        uint64_t word = m_bits[key >> 6] >> (key & 63);
+        if (word == 0)
+          {
+            key = (key | 63) + 1;
+            continue;
+          }
+        while ((word & 1) == 0)
+          {
+            word >>= 1;
+            key++;
+          }
+        return key;
+      }
+    return N_KEYS;
+  }
+
+  std::vector<uint64_t> m_bits;   //!< The bitmap of the RNTIs
+  std::vector<uint16_t> m_keys;   //!< The RNTIs, in insertion order
+};
+
+} // namespace ns3
+
+#endif /* RNTI_MAP_H */
@@ -0,0 +1,223 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/simulator.h>
+#include <ns3/log.h>
+#include <ns3/callback.h>
+#include <ns3/config.h>
+#include <ns3/string.h>
+#include <ns3/boolean.h>
+#include <ns3/test.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-phy.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteIdleSubframeTest");
+
+/**
+ * \ingroup lte
+ *
+ * Check that the suppression of the idle DL control frames in LteEnbPhy
+ * leaves the UE measurements unchanged, while the UEs receive far fewer
+ * control frames.
+ *
+ * Two eNBs serve one UE each, without traffic, and the scenario is run
+ * with and without the suppression.
+ */
+class LteIdleSubframeTestCase : public TestCase
+{
+public:
+  LteIdleSubframeTestCase ();
+  virtual ~LteIdleSubframeTestCase ();
+
+  /**
+   * Trace sink of the DL control frames received by a UE.
+   *
+   * \param cellId the cell ID
+   * \param rnti the RNTI
+   * \param rsrp the RSRP of the control frame
+   * \param sinr the SINR of the control frame
+   */
+  void ReportCurrentCellRsrpSinr (uint16_t cellId, uint16_t rnti,
+                                  double rsrp, double sinr);
+  /**
+   * Trace sink of the UE measurements.
+   *
+   * \param path the path of the UE PHY
+   * \param rnti the RNTI
+   * \param cellId the measured cell ID
+   * \param rsrp the filtered RSRP
+   * \param rsrq the filtered RSRQ
+   * \param servingCell true if the measured cell is the serving cell
+   */
+  void ReportUeMeasurements (std::string path, uint16_t rnti, uint16_t cellId,
+                             double rsrp, double rsrq, bool servingCell);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario.
+   *
+   * \param suppression the value of the IdleSubframeSuppression attribute
+   */
+  void RunScenario (bool suppression);
+
+  uint32_t m_ctrlFrames; ///< DL control frames received after the warm-up
+  /// The last measurements, indexed by UE PHY path and measured cell ID
+  std::map<std::pair<std::string, uint16_t>, std::pair<double, double> > m_measurements;
+};
+
+static void
+ReportCurrentCellRsrpSinrCallback (LteIdleSubframeTestCase *testcase, std::string path,
+                                   uint16_t cellId, uint16_t rnti,
+                                   double rsrp, double sinr)
+{
+  testcase->ReportCurrentCellRsrpSinr (cellId, rnti, rsrp, sinr);
+}
+
+static void
+ReportUeMeasurementsCallback (LteIdleSubframeTestCase *testcase, std::string path,
+                              uint16_t rnti, uint16_t cellId,
+                              double rsrp, double rsrq, bool servingCell)
+{
+  testcase->ReportUeMeasurements (path, rnti, cellId, rsrp, rsrq, servingCell);
+}
+
+LteIdleSubframeTestCase::LteIdleSubframeTestCase ()
+  : TestCase ("Idle DL control frames suppression with two cells")
+{
+}
+
+LteIdleSubframeTestCase::~LteIdleSubframeTestCase ()
+{
+}
+
+void
+LteIdleSubframeTestCase::ReportCurrentCellRsrpSinr (uint16_t cellId, uint16_t rnti,
+                                                    double rsrp, double sinr)
+{
+  // after the RRC connection establishment
+  if (Simulator::Now () > MilliSeconds (200))
+    {
+      m_ctrlFrames++;
+    }
+}
+
+void
+LteIdleSubframeTestCase::ReportUeMeasurements (std::string path, uint16_t rnti,
+                                               uint16_t cellId, double rsrp,
+                                               double rsrq, bool servingCell)
+{
+  m_measurements[std::make_pair (path, cellId)] = std::make_pair (rsrp, rsrq);
+}
+
+void
+LteIdleSubframeTestCase::RunScenario (bool suppression)
+{
+  m_ctrlFrames = 0;
+  m_measurements.clear ();
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+  lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (true));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (2);
+  ueNodes.Create (2);
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));       // eNB1
+  positionAlloc->Add (Vector (1000.0, 0.0, 0.0));    // eNB2
+  positionAlloc->Add (Vector (100.0, 0.0, 0.0));     // UE1
+  positionAlloc->Add (Vector (800.0, 0.0, 0.0));     // UE2
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (NodeContainer (enbNodes, ueNodes));
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  for (uint32_t i = 0; i < enbDevs.GetN (); i++)
+    {
+      Ptr<LteEnbPhy> enbPhy = enbDevs.Get (i)->GetObject<LteEnbNetDevice> ()->GetPhy ();
+      enbPhy->SetAttribute ("IdleSubframeSuppression", BooleanValue (suppression));
+    }
+  lteHelper->Attach (ueDevs.Get (0), enbDevs.Get (0));
+  lteHelper->Attach (ueDevs.Get (1), enbDevs.Get (1));
+
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/ReportCurrentCellRsrpSinr",
+                   MakeBoundCallback (&ReportCurrentCellRsrpSinrCallback, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/ReportUeMeasurements",
+                   MakeBoundCallback (&ReportUeMeasurementsCallback, this));
+
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteIdleSubframeTestCase::DoRun (void)
+{
+  RunScenario (false);
+  uint32_t ctrlFrames = m_ctrlFrames;
+  std::map<std::pair<std::string, uint16_t>, std::pair<double, double> > measurements = m_measurements;
+
+  RunScenario (true);
+  NS_LOG_INFO ("control frames " << ctrlFrames << " without suppression, "
+               << m_ctrlFrames << " with suppression");
+  NS_TEST_ASSERT_MSG_GT (ctrlFrames, 0, "No control frame received");
+  NS_TEST_ASSERT_MSG_LT (m_ctrlFrames * 4, ctrlFrames, "Too many control frames with suppression");
+
+  // 2 UEs measuring 2 cells
+  NS_TEST_ASSERT_MSG_EQ (measurements.size (), 4, "Wrong number of measurements");
+  NS_TEST_ASSERT_MSG_EQ (m_measurements.size (), 4, "Wrong number of measurements with suppression");
+  std::map<std::pair<std::string, uint16_t>, std::pair<double, double> >::const_iterator it;
+  for (it = measurements.begin (); it != measurements.end (); ++it)
+    {
+      std::map<std::pair<std::string, uint16_t>, std::pair<double, double> >::const_iterator it2;
+      it2 = m_measurements.find (it->first);
+      NS_TEST_ASSERT_MSG_EQ ((it2 != m_measurements.end ()), true, "Missing measurement with suppression");
+      NS_TEST_EXPECT_MSG_EQ_TOL (it2->second.first, it->second.first, 1e-6, "Wrong RSRP with suppression");
+      NS_TEST_EXPECT_MSG_EQ_TOL (it2->second.second, it->second.second, 1e-6, "Wrong RSRQ with suppression");
+    }
+}
+
+
+/**
+ * \ingroup lte
+ *
+ * Test suite of the suppression of the idle DL control frames.
+ */
+class LteIdleSubframeTestSuite : public TestSuite
+{
+public:
+  LteIdleSubframeTestSuite ();
+};
+
+LteIdleSubframeTestSuite::LteIdleSubframeTestSuite ()
+  : TestSuite ("lte-idle-subframe", SYSTEM)
+{
+  AddTestCase (new LteIdleSubframeTestCase, TestCase::QUICK);
+}
+
+static LteIdleSubframeTestSuite g_lteIdleSubframeTestSuite;
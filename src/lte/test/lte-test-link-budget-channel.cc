@@ -0,0 +1,261 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/simulator.h>
+#include <ns3/log.h>
+#include <ns3/callback.h>
+#include <ns3/config.h>
+#include <ns3/string.h>
+#include <ns3/boolean.h>
+#include <ns3/test.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/lte-common.h>
+#include <ns3/eps-bearer.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <cmath>
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteLinkBudgetChannelTest");
+
+/**
+ * \ingroup lte
+ *
+ * Check that the LteLinkBudgetSpectrumChannel, which sums the signals of
+ * the other cells into a single interference signal, gives the same DL
+ * and UL SINR, the same RSRP and RSRQ, and the same TBs as the
+ * MultiModelSpectrumChannel, without fading.
+ *
+ * Three eNBs serve two UEs each, with full buffer DL and UL traffic.
+ */
+class LteLinkBudgetChannelTestCase : public TestCase
+{
+public:
+  LteLinkBudgetChannelTestCase ();
+  virtual ~LteLinkBudgetChannelTestCase ();
+
+  /// The results of a run
+  struct Results
+  {
+    /// The last RSRP and SINR of the DL control frames, by UE PHY path
+    std::map<std::string, std::pair<double, double> > dlRsrpSinr;
+    /// The last RSRP and RSRQ, by UE PHY path and measured cell ID
+    std::map<std::pair<std::string, uint16_t>, std::pair<double, double> > measurements;
+    /// The last UL SINR, by cell ID and RNTI
+    std::map<std::pair<uint16_t, uint16_t>, double> ulSinr;
+    uint32_t dlTbs;      ///< DL TBs received
+    uint32_t dlTbsOk;    ///< DL TBs received correctly
+    uint64_t dlBytesOk;  ///< bytes of the DL TBs received correctly
+  };
+
+  Results m_results; ///< the results of the current run
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario.
+   *
+   * \param channelType the TypeId of the spectrum channels
+   */
+  void RunScenario (std::string channelType);
+
+  /**
+   * Check that two values are equal within a relative tolerance.
+   *
+   * \param value the value
+   * \param reference the reference value
+   * \param msg the message of the failure
+   */
+  void CheckRelative (double value, double reference, std::string msg);
+};
+
+static void
+ReportCurrentCellRsrpSinrCallback (LteLinkBudgetChannelTestCase *testcase, std::string path,
+                                   uint16_t cellId, uint16_t rnti,
+                                   double rsrp, double sinr)
+{
+  testcase->m_results.dlRsrpSinr[path] = std::make_pair (rsrp, sinr);
+}
+
+static void
+ReportUeMeasurementsCallback (LteLinkBudgetChannelTestCase *testcase, std::string path,
+                              uint16_t rnti, uint16_t cellId,
+                              double rsrp, double rsrq, bool servingCell)
+{
+  testcase->m_results.measurements[std::make_pair (path, cellId)] = std::make_pair (rsrp, rsrq);
+}
+
+static void
+ReportUeSinrCallback (LteLinkBudgetChannelTestCase *testcase, std::string path,
+                      uint16_t cellId, uint16_t rnti, double sinrLinear)
+{
+  testcase->m_results.ulSinr[std::make_pair (cellId, rnti)] = sinrLinear;
+}
+
+static void
+DlPhyReceptionCallback (LteLinkBudgetChannelTestCase *testcase, std::string path,
+                        PhyReceptionStatParameters params)
+{
+  testcase->m_results.dlTbs++;
+  if (params.m_correctness)
+    {
+      testcase->m_results.dlTbsOk++;
+      testcase->m_results.dlBytesOk += params.m_size;
+    }
+}
+
+LteLinkBudgetChannelTestCase::LteLinkBudgetChannelTestCase ()
+  : TestCase ("Link budget channel against the MultiModelSpectrumChannel with three cells")
+{
+}
+
+LteLinkBudgetChannelTestCase::~LteLinkBudgetChannelTestCase ()
+{
+}
+
+void
+LteLinkBudgetChannelTestCase::CheckRelative (double value, double reference, std::string msg)
+{
+  NS_TEST_EXPECT_MSG_EQ_TOL (value, reference, std::fabs (reference) * 1e-9, msg);
+}
+
+void
+LteLinkBudgetChannelTestCase::RunScenario (std::string channelType)
+{
+  m_results = Results ();
+  m_results.dlTbs = 0;
+  m_results.dlTbsOk = 0;
+  m_results.dlBytesOk = 0;
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetSpectrumChannelType (channelType);
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisPropagationLossModel"));
+  lteHelper->SetAttribute ("UseIdealRrc", BooleanValue (true));
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (3);
+  ueNodes.Create (6);
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));       // eNB1
+  positionAlloc->Add (Vector (1000.0, 0.0, 0.0));    // eNB2
+  positionAlloc->Add (Vector (500.0, 800.0, 0.0));   // eNB3
+  positionAlloc->Add (Vector (100.0, 0.0, 0.0));     // UEs of eNB1
+  positionAlloc->Add (Vector (300.0, 200.0, 0.0));
+  positionAlloc->Add (Vector (800.0, 0.0, 0.0));     // UEs of eNB2
+  positionAlloc->Add (Vector (1000.0, 300.0, 0.0));
+  positionAlloc->Add (Vector (500.0, 500.0, 0.0));   // UEs of eNB3
+  positionAlloc->Add (Vector (400.0, 900.0, 0.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (NodeContainer (enbNodes, ueNodes));
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  // same random streams in both runs
+  int64_t stream = 1;
+  stream += lteHelper->AssignStreams (enbDevs, stream);
+  stream += lteHelper->AssignStreams (ueDevs, stream);
+  for (uint32_t i = 0; i < ueDevs.GetN (); i++)
+    {
+      lteHelper->Attach (ueDevs.Get (i), enbDevs.Get (i / 2));
+    }
+  // saturation traffic
+  lteHelper->ActivateDataRadioBearer (ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/ReportCurrentCellRsrpSinr",
+                   MakeBoundCallback (&ReportCurrentCellRsrpSinrCallback, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/ReportUeMeasurements",
+                   MakeBoundCallback (&ReportUeMeasurementsCallback, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteEnbPhy/ReportUeSinr",
+                   MakeBoundCallback (&ReportUeSinrCallback, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/LteUePhy/DlSpectrumPhy/DlPhyReception",
+                   MakeBoundCallback (&DlPhyReceptionCallback, this));
+
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+LteLinkBudgetChannelTestCase::DoRun (void)
+{
+  RunScenario ("ns3::MultiModelSpectrumChannel");
+  Results reference = m_results;
+  RunScenario ("ns3::LteLinkBudgetSpectrumChannel");
+  NS_LOG_INFO ("DL TBs " << reference.dlTbs << " (" << reference.dlTbsOk << " ok), "
+               << m_results.dlTbs << " (" << m_results.dlTbsOk << " ok) with the link budget");
+
+  NS_TEST_ASSERT_MSG_EQ (reference.dlRsrpSinr.size (), 6, "Wrong number of UEs");
+  NS_TEST_ASSERT_MSG_EQ (m_results.dlRsrpSinr.size (), 6, "Wrong number of UEs with the link budget");
+  std::map<std::string, std::pair<double, double> >::const_iterator dlIt;
+  for (dlIt = reference.dlRsrpSinr.begin (); dlIt != reference.dlRsrpSinr.end (); ++dlIt)
+    {
+      std::pair<double, double> value = m_results.dlRsrpSinr[dlIt->first];
+      CheckRelative (value.first, dlIt->second.first, "Wrong RSRP with the link budget");
+      CheckRelative (value.second, dlIt->second.second, "Wrong DL SINR with the link budget");
+    }
+
+  // 6 UEs measuring 3 cells
+  NS_TEST_ASSERT_MSG_EQ (reference.measurements.size (), 18, "Wrong number of measurements");
+  NS_TEST_ASSERT_MSG_EQ (m_results.measurements.size (), 18, "Wrong number of measurements with the link budget");
+  std::map<std::pair<std::string, uint16_t>, std::pair<double, double> >::const_iterator measIt;
+  for (measIt = reference.measurements.begin (); measIt != reference.measurements.end (); ++measIt)
+    {
+      std::pair<double, double> value = m_results.measurements[measIt->first];
+      CheckRelative (value.first, measIt->second.first, "Wrong measured RSRP with the link budget");
+      CheckRelative (value.second, measIt->second.second, "Wrong measured RSRQ with the link budget");
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (reference.ulSinr.size (), 6, "Wrong number of UL SINR");
+  NS_TEST_ASSERT_MSG_EQ (m_results.ulSinr.size (), 6, "Wrong number of UL SINR with the link budget");
+  std::map<std::pair<uint16_t, uint16_t>, double>::const_iterator ulIt;
+  for (ulIt = reference.ulSinr.begin (); ulIt != reference.ulSinr.end (); ++ulIt)
+    {
+      CheckRelative (m_results.ulSinr[ulIt->first], ulIt->second, "Wrong UL SINR with the link budget");
+    }
+
+  NS_TEST_ASSERT_MSG_GT (reference.dlTbsOk, 0, "No DL TB received");
+  NS_TEST_EXPECT_MSG_EQ (m_results.dlTbs, reference.dlTbs, "Wrong DL TBs with the link budget");
+  NS_TEST_EXPECT_MSG_EQ (m_results.dlTbsOk, reference.dlTbsOk, "Wrong correct DL TBs with the link budget");
+  NS_TEST_EXPECT_MSG_EQ (m_results.dlBytesOk, reference.dlBytesOk, "Wrong DL bytes with the link budget");
+}
+
+
+/**
+ * \ingroup lte
+ *
+ * Test suite of the LteLinkBudgetSpectrumChannel.
+ */
+class LteLinkBudgetChannelTestSuite : public TestSuite
+{
+public:
+  LteLinkBudgetChannelTestSuite ();
+};
+
+LteLinkBudgetChannelTestSuite::LteLinkBudgetChannelTestSuite ()
+  : TestSuite ("lte-link-budget-channel", SYSTEM)
+{
+  AddTestCase (new LteLinkBudgetChannelTestCase, TestCase::QUICK);
+}
+
+static LteLinkBudgetChannelTestSuite g_lteLinkBudgetChannelTestSuite;
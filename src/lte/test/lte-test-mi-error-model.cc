@@ -0,0 +1,168 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+
+#include "ns3/lte-mi-error-model.h"
+#include "ns3/lte-spectrum-value-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteTestMiErrorModel");
+
+/**
+ * Check that the tabulated code block error rates stay within the
+ * tolerance of the closed form, for all the BLER curves.
+ */
+class LteMiErrorModelBlerTestCase : public TestCase
+{
+public:
+  LteMiErrorModelBlerTestCase (double tolerance);
+
+private:
+  static std::string BuildNameString (double tolerance);
+  virtual void DoRun (void);
+  double m_tolerance;
+};
+
+std::string
+LteMiErrorModelBlerTestCase::BuildNameString (double tolerance)
+{
+  std::ostringstream name;
+  name << "Code block error rates with tolerance " << tolerance;
+  return name.str ();
+}
+
+LteMiErrorModelBlerTestCase::LteMiErrorModelBlerTestCase (double tolerance)
+  : TestCase (BuildNameString (tolerance)),
+    m_tolerance (tolerance)
+{
+}
+
+void
+LteMiErrorModelBlerTestCase::DoRun (void)
+{
+  static const uint16_t cbSizes[] = { 40, 64, 104, 160, 256, 512, 1000, 1024, 2560, 4032, 6144 };
+  double savedTolerance = LteMiErrorModel::GetBlerTolerance ();
+  double maxError = 0;
+  for (uint8_t ecrId = 0; ecrId <= MI_64QAM_BLER_MAX_ID; ecrId++)
+    {
+      for (uint32_t i = 0; i < sizeof (cbSizes) / sizeof (cbSizes[0]); i++)
+        {
+          for (double mib = 0; mib <= 1; mib += 0.0005)
+            {
+              LteMiErrorModel::SetBlerTolerance (0);
+              double exact = LteMiErrorModel::MappingMiBler (mib, ecrId, cbSizes[i]);
+              LteMiErrorModel::SetBlerTolerance (m_tolerance);
+              double tabulated = LteMiErrorModel::MappingMiBler (mib, ecrId, cbSizes[i]);
+              maxError = std::max (maxError, std::fabs (tabulated - exact));
+            }
+        }
+    }
+  LteMiErrorModel::SetBlerTolerance (savedTolerance);
+  NS_LOG_INFO ("Largest error " << maxError);
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (maxError, m_tolerance, "Code block error rate beyond the tolerance");
+}
+
+/**
+ * Check that the transport block error rates and MIs computed with the
+ * tabulated code block error rates stay close to the closed form, for
+ * all the MCSs, with and without HARQ history.
+ */
+class LteMiErrorModelTbTestCase : public TestCase
+{
+public:
+  LteMiErrorModelTbTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteMiErrorModelTbTestCase::LteMiErrorModelTbTestCase ()
+  : TestCase ("Transport block error rates with the default tolerance")
+{
+}
+
+void
+LteMiErrorModelTbTestCase::DoRun (void)
+{
+  Ptr<const SpectrumModel> model = LteSpectrumValueHelper::GetSpectrumModel (100, 25);
+  SpectrumValue sinr (model);
+  std::vector<int> map;
+  for (int rb = 0; rb < 25; rb += 2)
+    {
+      map.push_back (rb);
+    }
+  HarqProcessInfoElement_t element;
+  element.m_mi = 0.3;
+  element.m_infoBits = 4000;
+  element.m_codeBits = 8000;
+  HarqProcessInfoList_t history (1, element);
+  HarqProcessInfoList_t noHistory;
+
+  double tolerance = LteMiErrorModel::GetBlerTolerance ();
+  for (double sinrDb = -10; sinrDb <= 30; sinrDb += 0.25)
+    {
+      for (uint32_t rb = 0; rb < 25; rb++)
+        {
+          // a frequency selective channel
+          sinr[rb] = std::pow (10, (sinrDb + 3 * std::sin (rb)) / 10);
+        }
+      for (uint8_t mcs = 0; mcs <= MI_64QAM_MAX_ID; mcs++)
+        {
+          for (uint32_t h = 0; h < 2; h++)
+            {
+              HarqProcessInfoList_t &harq = h == 0 ? noHistory : history;
+              uint16_t size = 100 + 40 * mcs;
+              LteMiErrorModel::SetBlerTolerance (0);
+              TbStats_t exact = LteMiErrorModel::GetTbDecodificationStats (sinr, map, size, mcs, harq);
+              LteMiErrorModel::SetBlerTolerance (tolerance);
+              TbStats_t tabulated = LteMiErrorModel::GetTbDecodificationStats (sinr, map, size, mcs, harq);
+              NS_TEST_ASSERT_MSG_EQ (tabulated.mi, exact.mi, "MI differs");
+              // the error of each code block adds up in the TB error rate
+              uint32_t nCbs = size * 8 / 6120 + 1;
+              NS_TEST_ASSERT_MSG_EQ_TOL (tabulated.tbler, exact.tbler, nCbs * tolerance,
+                                         "TB error rate beyond the tolerance at "
+                                         << sinrDb << " dB, MCS " << (uint16_t) mcs);
+            }
+        }
+    }
+}
+
+/**
+ * Test suite of the tabulated MIESM error model.
+ */
+class LteMiErrorModelTestSuite : public TestSuite
+{
+public:
+  LteMiErrorModelTestSuite ();
+};
+
+LteMiErrorModelTestSuite::LteMiErrorModelTestSuite ()
+  : TestSuite ("lte-mi-error-model", UNIT)
+{
+  AddTestCase (new LteMiErrorModelBlerTestCase (LteMiErrorModel::GetBlerTolerance ()), TestCase::QUICK);
+  AddTestCase (new LteMiErrorModelBlerTestCase (1e-3), TestCase::QUICK);
+  AddTestCase (new LteMiErrorModelBlerTestCase (1e-9), TestCase::EXTENSIVE);
+  AddTestCase (new LteMiErrorModelTbTestCase, TestCase::QUICK);
+}
+
+static LteMiErrorModelTestSuite g_lteMiErrorModelTestSuite;
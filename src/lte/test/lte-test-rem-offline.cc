@@ -0,0 +1,176 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/simulator.h>
+#include <ns3/log.h>
+#include <ns3/string.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <ns3/test.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/radio-environment-map-helper.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+#include <fstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRemOfflineTest");
+
+/**
+ * \ingroup lte
+ *
+ * Check that the REM computed offline, with one or several threads, is
+ * the REM computed by simulating the listeners.
+ *
+ * Two sectorized eNBs transmit, and the map covers both cells.
+ */
+class LteRemOfflineTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param pathlossModel the type of the pathloss model of the LteHelper
+   * \param numThreads the NumThreads attribute of the offline REM
+   */
+  LteRemOfflineTestCase (std::string pathlossModel, uint32_t numThreads);
+  virtual ~LteRemOfflineTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario and read the REM.
+   *
+   * \param offline the Offline attribute of the REM
+   * \param rem the lines of the REM, each with x, y, z and the SINR
+   */
+  void RunScenario (bool offline, std::vector<std::vector<double> > &rem);
+
+  std::string m_pathlossModel; ///< the type of the pathloss model
+  uint32_t m_numThreads;       ///< the NumThreads attribute
+};
+
+LteRemOfflineTestCase::LteRemOfflineTestCase (std::string pathlossModel, uint32_t numThreads)
+  : TestCase ("Offline REM with " + pathlossModel + ", threads "
+              + (numThreads > 1 ? "> 1" : "= 1")),
+    m_pathlossModel (pathlossModel),
+    m_numThreads (numThreads)
+{
+}
+
+LteRemOfflineTestCase::~LteRemOfflineTestCase ()
+{
+}
+
+void
+LteRemOfflineTestCase::RunScenario (bool offline, std::vector<std::vector<double> > &rem)
+{
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  lteHelper->SetAttribute ("PathlossModel", StringValue (m_pathlossModel));
+  lteHelper->SetEnbAntennaModelType ("ns3::CosineAntennaModel");
+  lteHelper->SetEnbAntennaModelAttribute ("Beamwidth", DoubleValue (90.0));
+
+  NodeContainer enbNodes;
+  enbNodes.Create (2);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 10.0));
+  positionAlloc->Add (Vector (500.0, 0.0, 10.0));
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+
+  lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (0.0));
+  lteHelper->InstallEnbDevice (enbNodes.Get (0));
+  lteHelper->SetEnbAntennaModelAttribute ("Orientation", DoubleValue (180.0));
+  lteHelper->InstallEnbDevice (enbNodes.Get (1));
+
+  std::string fileName = CreateTempDirFilename ("rem.out");
+  Ptr<RadioEnvironmentMapHelper> remHelper = CreateObject<RadioEnvironmentMapHelper> ();
+  remHelper->SetAttribute ("ChannelPath", StringValue ("/ChannelList/0"));
+  remHelper->SetAttribute ("OutputFile", StringValue (fileName));
+  remHelper->SetAttribute ("XMin", DoubleValue (-100.0));
+  remHelper->SetAttribute ("XMax", DoubleValue (600.0));
+  remHelper->SetAttribute ("XRes", UintegerValue (15));
+  remHelper->SetAttribute ("YMin", DoubleValue (-200.0));
+  remHelper->SetAttribute ("YMax", DoubleValue (200.0));
+  remHelper->SetAttribute ("YRes", UintegerValue (9));
+  remHelper->SetAttribute ("MaxPointsPerIteration", UintegerValue (40));
+  remHelper->SetAttribute ("Offline", BooleanValue (offline));
+  remHelper->SetAttribute ("NumThreads", UintegerValue (m_numThreads));
+  remHelper->Install ();
+
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  rem.clear ();
+  std::ifstream file (fileName.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (file.is_open (), true, "Can't open " << fileName);
+  std::vector<double> line (4);
+  while (file >> line[0] >> line[1] >> line[2] >> line[3])
+    {
+      rem.push_back (line);
+    }
+}
+
+void
+LteRemOfflineTestCase::DoRun (void)
+{
+  std::vector<std::vector<double> > online;
+  std::vector<std::vector<double> > offline;
+  RunScenario (false, online);
+  RunScenario (true, offline);
+
+  NS_TEST_ASSERT_MSG_EQ (online.size (), 15 * 9, "Wrong number of points online");
+  NS_TEST_ASSERT_MSG_EQ (offline.size (), online.size (), "Wrong number of points offline");
+  for (uint32_t i = 0; i < online.size (); ++i)
+    {
+      for (uint32_t j = 0; j < 3; ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ_TOL (offline[i][j], online[i][j], 1e-6, "Wrong position of point " << i);
+        }
+      NS_TEST_ASSERT_MSG_GT (online[i][3], 0.0, "No signal at point " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (offline[i][3], online[i][3], online[i][3] * 1e-5, "Wrong SINR at point " << i);
+    }
+}
+
+
+/**
+ * \ingroup lte
+ *
+ * Test suite of the offline computation of the REM.
+ */
+class LteRemOfflineTestSuite : public TestSuite
+{
+public:
+  LteRemOfflineTestSuite ();
+};
+
+LteRemOfflineTestSuite::LteRemOfflineTestSuite ()
+  : TestSuite ("lte-rem-offline", SYSTEM)
+{
+  AddTestCase (new LteRemOfflineTestCase ("ns3::FriisPropagationLossModel", 1), TestCase::QUICK);
+  AddTestCase (new LteRemOfflineTestCase ("ns3::FriisPropagationLossModel", 3), TestCase::QUICK);
+  AddTestCase (new LteRemOfflineTestCase ("ns3::FriisSpectrumPropagationLossModel", 1), TestCase::QUICK);
+}
+
+static LteRemOfflineTestSuite g_lteRemOfflineTestSuite;
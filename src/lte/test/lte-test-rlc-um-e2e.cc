@@ -35,6 +35,8 @@
 #include "lte-test-entities.h"
 #include "lte-test-rlc-um-e2e.h"
 
+#include <vector>
+
 
 using namespace ns3;
 
@@ -74,6 +76,7 @@ LteRlcUmE2eTestSuite::LteRlcUmE2eTestSuite ()
           AddTestCase (new LteRlcUmE2eTestCase (name.str (), seeds[s], losses[l]), testDuration);
         }
     }
+  AddTestCase (new LteRlcUmE2eWrapAroundTestCase (), TestCase::QUICK);
 }
 
 static LteRlcUmE2eTestSuite lteRlcUmE2eTestSuite;
@@ -232,3 +235,121 @@ LteRlcUmE2eTestCase::DoRun (void)
 
   Simulator::Destroy ();
 }
+
+
+/**
+ * Wrap around TestCase
+ */
+
+namespace {
+
+/**
+ * MAC SAP provider keeping the PDUs transmitted by an RLC entity
+ */
+class WrapAroundMacSapProvider : public LteMacSapProvider
+{
+  public:
+    virtual void TransmitPdu (TransmitPduParameters params)
+    {
+      m_pdus.push_back (params.pdu);
+    }
+    virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+    {
+    }
+
+    std::vector<Ptr<Packet> > m_pdus;
+};
+
+/**
+ * RLC SAP user keeping the index carried by each SDU received
+ */
+class WrapAroundRlcSapUser : public LteRlcSapUser
+{
+  public:
+    virtual void ReceivePdcpPdu (Ptr<Packet> p)
+    {
+      uint8_t buf[4];
+      p->CopyData (buf, 4);
+      m_sdus.push_back ((buf[0] << 24) | (buf[1] << 16) | (buf[2] << 8) | buf[3]);
+    }
+
+    std::vector<uint32_t> m_sdus;
+};
+
+} // unnamed namespace
+
+LteRlcUmE2eWrapAroundTestCase::LteRlcUmE2eWrapAroundTestCase ()
+  : TestCase ("Sequence number wrap around with reordering")
+{
+}
+
+LteRlcUmE2eWrapAroundTestCase::~LteRlcUmE2eWrapAroundTestCase ()
+{
+}
+
+void
+LteRlcUmE2eWrapAroundTestCase::DoRun (void)
+{
+  // More than twice the sequence number space
+  const uint32_t nSdus = 3000;
+  // The first PDU of the pair (SN 1020, SN 1021) is lost.  The PDUs after
+  // it are held until the reordering window moves past SN 1021, and are
+  // then reassembled across the wrap around.
+  const uint32_t lost = 2045;
+
+  WrapAroundMacSapProvider macSapProvider;
+  WrapAroundRlcSapUser rlcSapUser;
+
+  Ptr<LteRlc> txRlc = CreateObject<LteRlcUm> ();
+  txRlc->SetRnti (1111);
+  txRlc->SetLcId (222);
+  txRlc->SetLteMacSapProvider (&macSapProvider);
+  Ptr<LteRlc> rxRlc = CreateObject<LteRlcUm> ();
+  rxRlc->SetRnti (1111);
+  rxRlc->SetLcId (222);
+  rxRlc->SetLteMacSapProvider (&macSapProvider);
+  rxRlc->SetLteRlcSapUser (&rlcSapUser);
+
+  // One SDU of 4 bytes, holding its index, per PDU of 2 + 4 bytes
+  for (uint32_t i = 0; i < nSdus; ++i)
+    {
+      uint8_t buf[4] = { (uint8_t)(i >> 24), (uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i };
+      LteRlcSapProvider::TransmitPdcpPduParameters params;
+      params.pdcpPdu = Create<Packet> (buf, 4);
+      params.rnti = 1111;
+      params.lcid = 222;
+      txRlc->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+      txRlc->GetLteMacSapUser ()->NotifyTxOpportunity (6, 0, 0);
+    }
+  NS_TEST_ASSERT_MSG_EQ (macSapProvider.m_pdus.size (), nSdus, "Wrong number of PDUs transmitted");
+
+  // Deliver each pair of PDUs in reverse order, without the lost PDU
+  for (uint32_t i = 0; i + 1 < nSdus; i += 2)
+    {
+      if (i + 1 != lost)
+        {
+          rxRlc->GetLteMacSapUser ()->ReceivePdu (macSapProvider.m_pdus[i + 1]);
+        }
+      if (i != lost)
+        {
+          rxRlc->GetLteMacSapUser ()->ReceivePdu (macSapProvider.m_pdus[i]);
+        }
+    }
+
+  // Once the reordering window has moved past the lost PDU, each SDU is
+  // delivered as soon as its pair is complete, without t-Reordering
+  NS_TEST_ASSERT_MSG_EQ (rlcSapUser.m_sdus.size (), nSdus - 1, "Wrong number of SDUs delivered");
+  uint32_t expected = 0;
+  for (uint32_t i = 0; i < rlcSapUser.m_sdus.size (); ++i, ++expected)
+    {
+      if (expected == lost)
+        {
+          ++expected;
+        }
+      NS_TEST_ASSERT_MSG_EQ (rlcSapUser.m_sdus[i], expected, "SDU " << i << " delivered out of sequence");
+    }
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
@@ -57,4 +57,19 @@ class LteRlcUmE2eTestCase : public TestCase
     double   m_losses;
 };
 
+
+/**
+ * Check the in-sequence delivery of the RLC UM receiver across the wrap
+ * around of the 10 bit sequence numbers, with reordered and lost PDUs.
+ */
+class LteRlcUmE2eWrapAroundTestCase : public TestCase
+{
+  public:
+    LteRlcUmE2eWrapAroundTestCase ();
+    virtual ~LteRlcUmE2eWrapAroundTestCase ();
+
+  private:
+    virtual void DoRun (void);
+};
+
 #endif // LTE_TEST_RLC_UM_E2E_H
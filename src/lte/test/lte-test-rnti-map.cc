@@ -0,0 +1,166 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/random-variable-stream.h>
+#include <ns3/rnti-map.h>
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteRntiMapTest");
+
+/**
+ * \ingroup lte
+ *
+ * Check that RntiMap behaves as a std::map <uint16_t, T> under random
+ * insertions, lookups and erasures, including the iteration order.
+ */
+class LteRntiMapTestCase : public TestCase
+{
+public:
+  LteRntiMapTestCase ();
+  virtual ~LteRntiMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check that a RntiMap holds the elements of a std::map, in the same
+   * order.
+   *
+   * \param map the RntiMap
+   * \param ref the std::map
+   */
+  void Compare (const RntiMap<uint32_t> &map, const std::map<uint16_t, uint32_t> &ref);
+};
+
+LteRntiMapTestCase::LteRntiMapTestCase ()
+  : TestCase ("RntiMap against std::map")
+{
+}
+
+LteRntiMapTestCase::~LteRntiMapTestCase ()
+{
+}
+
+void
+LteRntiMapTestCase::Compare (const RntiMap<uint32_t> &map, const std::map<uint16_t, uint32_t> &ref)
+{
+  NS_TEST_ASSERT_MSG_EQ (map.size (), ref.size (), "Wrong size");
+  RntiMap<uint32_t>::const_iterator it = map.begin ();
+  std::map<uint16_t, uint32_t>::const_iterator refIt;
+  for (refIt = ref.begin (); refIt != ref.end (); ++refIt, ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((it != map.end ()), true, "Missing element");
+      NS_TEST_ASSERT_MSG_EQ (it->first, refIt->first, "Wrong RNTI order");
+      NS_TEST_ASSERT_MSG_EQ (it->second, refIt->second, "Wrong value");
+    }
+  NS_TEST_ASSERT_MSG_EQ ((it == map.end ()), true, "Extra element");
+}
+
+void
+LteRntiMapTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  RntiMap<uint32_t> map;
+  std::map<uint16_t, uint32_t> ref;
+
+  // RNTIs spread over a few pages, and around the wrap around
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      uint16_t rnti = rng->GetInteger (0, 1000);
+      if (i % 4 == 0)
+        {
+          rnti = 0xFFFF - rnti;
+        }
+      switch (rng->GetInteger (0, 3))
+        {
+        case 0:
+          map[rnti] = i;
+          ref[rnti] = i;
+          break;
+        case 1:
+          {
+            bool inserted = map.insert (std::make_pair (rnti, i)).second;
+            bool refInserted = ref.insert (std::make_pair (rnti, i)).second;
+            NS_TEST_ASSERT_MSG_EQ (inserted, refInserted, "Wrong insertion");
+          }
+          break;
+        case 2:
+          NS_TEST_ASSERT_MSG_EQ (map.erase (rnti), ref.erase (rnti), "Wrong erasure");
+          break;
+        default:
+          NS_TEST_ASSERT_MSG_EQ (map.count (rnti), ref.count (rnti), "Wrong lookup");
+          NS_TEST_ASSERT_MSG_EQ ((map.find (rnti) == map.end ()), (ref.find (rnti) == ref.end ()), "Wrong find");
+          break;
+        }
+    }
+  Compare (map, ref);
+
+  // erasure through an iterator while iterating, as the schedulers do
+  RntiMap<uint32_t>::iterator it = map.begin ();
+  while (it != map.end ())
+    {
+      if (it->second % 2 == 0)
+        {
+          RntiMap<uint32_t>::iterator temp = it;
+          ++it;
+          ref.erase (temp->first);
+          map.erase (temp);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+  Compare (map, ref);
+
+  // backward iteration
+  if (!ref.empty ())
+    {
+      it = map.end ();
+      --it;
+      NS_TEST_ASSERT_MSG_EQ (it->first, ref.rbegin ()->first, "Wrong last element");
+    }
+
+  RntiMap<uint32_t> copy (map);
+  map.clear ();
+  NS_TEST_ASSERT_MSG_EQ (map.empty (), true, "Not cleared");
+  NS_TEST_ASSERT_MSG_EQ ((map.begin () == map.end ()), true, "Not cleared");
+  Compare (copy, ref);
+}
+
+
+/**
+ * \ingroup lte
+ *
+ * Test suite of the RNTI indexed container of the schedulers.
+ */
+class LteRntiMapTestSuite : public TestSuite
+{
+public:
+  LteRntiMapTestSuite ();
+};
+
+LteRntiMapTestSuite::LteRntiMapTestSuite ()
+  : TestSuite ("lte-rnti-map", UNIT)
+{
+  AddTestCase (new LteRntiMapTestCase, TestCase::QUICK);
+}
+
+static LteRntiMapTestSuite g_lteRntiMapTestSuite;
@@ -131,6 +131,14 @@ EpcTftClassifierTestCase::DoRun (void)
   NS_LOG_LOGIC (this << *udpPacket);
   uint32_t obtainedTftId = m_c ->Classify (udpPacket, m_d);
   NS_TEST_ASSERT_MSG_EQ (obtainedTftId, m_tftId, "bad classification of UDP packet");
+
+  // the same classification from the bytes of the headers, then from the flow table
+  uint8_t headers[64];
+  uint32_t size = udpPacket->CopyData (headers, sizeof (headers));
+  obtainedTftId = m_c->Classify (headers, size, m_d);
+  NS_TEST_ASSERT_MSG_EQ (obtainedTftId, m_tftId, "bad classification of UDP packet from its headers");
+  obtainedTftId = m_c->Classify (headers, size, m_d);
+  NS_TEST_ASSERT_MSG_EQ (obtainedTftId, m_tftId, "bad classification of UDP packet from the flow table");
 }
 
 
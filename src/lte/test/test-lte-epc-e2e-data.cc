@@ -85,18 +85,20 @@ struct EnbTestData
 class LteEpcE2eDataTestCase : public TestCase
 {
 public:
-  LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v);
+  LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v, bool gtpuFastPath = false);
   virtual ~LteEpcE2eDataTestCase ();
 
 private:
   virtual void DoRun (void);
   std::vector<EnbTestData> m_enbTestData;
+  bool m_gtpuFastPath;
 };
 
 
-LteEpcE2eDataTestCase::LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v)
+LteEpcE2eDataTestCase::LteEpcE2eDataTestCase (std::string name, std::vector<EnbTestData> v, bool gtpuFastPath)
   : TestCase (name),
-    m_enbTestData (v)
+    m_enbTestData (v),
+    m_gtpuFastPath (gtpuFastPath)
 {
   NS_LOG_FUNCTION (this << name);
 }
@@ -122,6 +124,7 @@ LteEpcE2eDataTestCase::DoRun ()
 
   // allow jumbo frames on the S1-U link
   epcHelper->SetAttribute ("S1uLinkMtu", UintegerValue (30000));
+  epcHelper->SetAttribute ("GtpuFastPath", BooleanValue (m_gtpuFastPath));
 
   Ptr<Node> pgw = epcHelper->GetPgwNode ();
   
@@ -397,6 +400,7 @@ LteEpcE2eDataTestSuite::LteEpcE2eDataTestSuite ()
   v4.push_back (e1);
   v4.push_back (e2);
   AddTestCase (new LteEpcE2eDataTestCase ("3 eNBs", v4), TestCase::EXTENSIVE);
+  AddTestCase (new LteEpcE2eDataTestCase ("3 eNBs, GTP-U fast path", v4, true), TestCase::EXTENSIVE);
 
   EnbTestData e5;
   UeTestData u5;
@@ -427,6 +431,7 @@ LteEpcE2eDataTestSuite::LteEpcE2eDataTestSuite ()
   std::vector<EnbTestData> v7;
   v7.push_back (e7);
   AddTestCase (new LteEpcE2eDataTestCase ("1 eNB, 1UE with 2 bearers", v7), TestCase::EXTENSIVE);
+  AddTestCase (new LteEpcE2eDataTestCase ("1 eNB, 1UE with 2 bearers, GTP-U fast path", v7, true), TestCase::QUICK);
 
   EnbTestData e8;
   UeTestData u8;
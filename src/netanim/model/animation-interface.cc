@@ -21,6 +21,7 @@
 
 
 #include <cstdio>
+#include <cstring>
 #include <unistd.h>
 #include <sstream>
 #include <fstream>
@@ -48,6 +49,12 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/energy-source-container.h"
+#include "ns3/async-block-writer.h"
+#include "ns3/abort.h"
+
+#ifdef NS3_ZLIB
+#include <zlib.h>
+#endif
 
 namespace ns3 {
 
@@ -57,6 +64,119 @@ NS_LOG_COMPONENT_DEFINE ("AnimationInterface");
 
 static bool initialized = false;
 
+// Size of the blocks in which the trace file is buffered
+static const uint32_t OUTPUT_BLOCK_SIZE = 64 * 1024;
+
+
+/**
+ * \ingroup netanim
+ *
+ * \brief Stream buffer writing the blocks of the trace file to a C file,
+ * optionally through a gzip compressor.
+ *
+ * With asynchronous output the blocks, and so the compression, are
+ * handled by the background thread of the AsyncBlockWriter.
+ */
+class AnimFileBuffer : public std::streambuf
+{
+public:
+  /**
+   * \param f The file to write to
+   * \param compress Whether to compress the data with gzip
+   */
+  AnimFileBuffer (FILE * f, bool compress);
+  /**
+   * Terminate the compressed stream
+   */
+  virtual ~AnimFileBuffer ();
+
+protected:
+  virtual std::streamsize xsputn (const char * s, std::streamsize n);
+  virtual int overflow (int c);
+
+private:
+  FILE * m_f;
+  bool m_compress;
+#ifdef NS3_ZLIB
+  void Deflate (const char * data, std::streamsize n, int flush);
+  z_stream m_zStream;
+  std::vector <char> m_zBuffer;
+#endif
+};
+
+AnimFileBuffer::AnimFileBuffer (FILE * f, bool compress)
+  : m_f (f),
+    m_compress (compress)
+{
+#ifdef NS3_ZLIB
+  if (m_compress)
+    {
+      std::memset (&m_zStream, 0, sizeof (m_zStream));
+      // 15 bits of window plus 16 selects the gzip format
+      if (deflateInit2 (&m_zStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+          NS_FATAL_ERROR ("Unable to initialize the trace file compression");
+        }
+      m_zBuffer.resize (OUTPUT_BLOCK_SIZE);
+    }
+#else
+  NS_ABORT_MSG_IF (m_compress, "Compressed trace files require zlib");
+#endif
+}
+
+AnimFileBuffer::~AnimFileBuffer ()
+{
+#ifdef NS3_ZLIB
+  if (m_compress)
+    {
+      Deflate (0, 0, Z_FINISH);
+      deflateEnd (&m_zStream);
+    }
+#endif
+  std::fflush (m_f);
+}
+
+std::streamsize
+AnimFileBuffer::xsputn (const char * s, std::streamsize n)
+{
+#ifdef NS3_ZLIB
+  if (m_compress)
+    {
+      Deflate (s, n, Z_NO_FLUSH);
+      return n;
+    }
+#endif
+  return std::fwrite (s, 1, n, m_f);
+}
+
+int
+AnimFileBuffer::overflow (int c)
+{
+  if (c == traits_type::eof ())
+    {
+      return traits_type::not_eof (c);
+    }
+  char ch = traits_type::to_char_type (c);
+  return xsputn (&ch, 1) == 1 ? c : traits_type::eof ();
+}
+
+#ifdef NS3_ZLIB
+void
+AnimFileBuffer::Deflate (const char * data, std::streamsize n, int flush)
+{
+  m_zStream.next_in = (Bytef *) data;
+  m_zStream.avail_in = n;
+  do
+    {
+      m_zStream.next_out = (Bytef *) &m_zBuffer[0];
+      m_zStream.avail_out = m_zBuffer.size ();
+      deflate (&m_zStream, flush);
+      std::fwrite (&m_zBuffer[0], 1, m_zBuffer.size () - m_zStream.avail_out, m_f);
+    }
+  while (m_zStream.avail_out == 0);
+}
+#endif
+
 
 // Public methods
 
@@ -76,7 +196,12 @@ AnimationInterface::AnimationInterface (const std::string fn)
     m_routingStopTime (Seconds (0)), 
     m_routingFileName (""),
     m_routingPollInterval (Seconds (5)), 
-    m_trackPackets (true)
+    m_trackPackets (true),
+    m_mobilityThreshold (0),
+    m_asyncOutput (false),
+    m_writer (0),
+    m_fileBuffer (0),
+    m_fileStream (0)
 {
   initialized = true;
   StartAnimation ();
@@ -281,6 +406,30 @@ AnimationInterface::SetMobilityPollInterval (Time t)
 }
 
 
+void
+AnimationInterface::SetMobilityThreshold (double distance)
+{
+  m_mobilityThreshold = distance;
+}
+
+void
+AnimationInterface::SetAsynchronousOutput (bool enable)
+{
+  m_asyncOutput = enable;
+  if (m_f)
+    {
+      OpenOutputWriter ();
+    }
+}
+
+void
+AnimationInterface::SetPacketSamplingRate (ProtocolType protocolType, uint32_t oneOutOf)
+{
+  NS_ABORT_MSG_IF (oneOutOf == 0, "The packet sampling rate must be at least 1");
+  m_packetSamplingRate[protocolType] = oneOutOf;
+  m_packetSamplingCount[protocolType] = 0;
+}
+
 void 
 AnimationInterface::SetConstantPosition (Ptr <Node> n, double x, double y, double z)
 {
@@ -409,6 +558,11 @@ AnimationInterface::MobilityCourseChangeTrace (Ptr <const MobilityModel> mobilit
     {
       v = mobility->GetPosition ();
     }
+  if (m_mobilityThreshold > 0 && !NodeHasMoved (n, v))
+    {
+      UpdatePosition (n, v);
+      return;
+    }
   UpdatePosition (n, v);
   WriteXmlUpdateNodePosition (n->GetId (), v.x, v.y);
 }
@@ -416,6 +570,12 @@ AnimationInterface::MobilityCourseChangeTrace (Ptr <const MobilityModel> mobilit
 bool 
 AnimationInterface::NodeHasMoved (Ptr <Node> n, Vector newLocation)
 {
+  if (m_mobilityThreshold > 0)
+    {
+      std::map <uint32_t, Vector>::const_iterator it = m_writtenNodeLocation.find (n->GetId ());
+      return (it == m_writtenNodeLocation.end ()) ||
+             (CalculateDistance (it->second, Vector (newLocation.x, newLocation.y, 0)) >= m_mobilityThreshold);
+    }
   Vector oldLocation = GetPosition (n);
   if ((ceil (oldLocation.x) == ceil (newLocation.x)) &&
     (ceil (oldLocation.y) == ceil (newLocation.y)))
@@ -499,6 +659,11 @@ AnimationInterface::WriteN (const char* data, uint32_t count, FILE * f)
 { 
   if (!f)
     return 0;
+  if (f == m_f && m_writer)
+    {
+      std::memcpy (m_writer->Append (count), data, count);
+      return count;
+    }
   // Write count bytes to h from data
   uint32_t    nLeft   = count;
   const char* p       = data;
@@ -743,6 +908,8 @@ AnimationInterface::DevTxTrace (std::string context,
     return;
   NS_ASSERT (tx);
   NS_ASSERT (rx);
+  if (!IsPacketSampled (AnimationInterface::P2P))
+    return;
   Time now = Simulator::Now ();
   double fbTx = now.GetSeconds ();
   double lbTx = (now + txTime).GetSeconds ();
@@ -768,6 +935,11 @@ AnimationInterface::UanPhyGenTxTrace (std::string context, Ptr<const Packet> p)
   NS_ASSERT (ndev);
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
+  if (!IsPacketSampled (AnimationInterface::UAN))
+    {
+      AddByteTag (0, p);
+      return;
+    }
   ++gAnimUid;
   NS_LOG_INFO ("Uan TxBeginTrace for packet:" << gAnimUid);
   AddByteTag (gAnimUid, p);
@@ -787,6 +959,8 @@ AnimationInterface::UanPhyGenRxTrace (std::string context, Ptr<const Packet> p)
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (animUid == 0)
+    return; // Not sampled
   NS_LOG_INFO ("UanPhyGenRxTrace for packet:" << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::UAN))
     {
@@ -809,6 +983,11 @@ AnimationInterface::WifiPhyTxBeginTrace (std::string context,
   NS_ASSERT (ndev);
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
+  if (!IsPacketSampled (AnimationInterface::WIFI))
+    {
+      AddByteTag (0, p);
+      return;
+    }
   ++gAnimUid;
   NS_LOG_INFO ("Wifi TxBeginTrace for packet:" << gAnimUid);
   AddByteTag (gAnimUid, p);
@@ -836,6 +1015,8 @@ AnimationInterface::WifiPhyRxBeginTrace (std::string context,
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (animUid == 0)
+    return; // Not sampled
   NS_LOG_INFO ("Wifi RxBeginTrace for packet:" << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::WIFI))
     {
@@ -875,6 +1056,11 @@ AnimationInterface::WimaxTxTrace (std::string context, Ptr<const Packet> p, cons
   NS_ASSERT (ndev);
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
+  if (!IsPacketSampled (AnimationInterface::WIMAX))
+    {
+      AddByteTag (0, p);
+      return;
+    }
   ++gAnimUid;
   NS_LOG_INFO ("WimaxTxTrace for packet:" << gAnimUid);
   UpdatePosition (n);
@@ -895,6 +1081,8 @@ AnimationInterface::WimaxRxTrace (std::string context, Ptr<const Packet> p, cons
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (animUid == 0)
+    return; // Not sampled
   NS_LOG_INFO ("WimaxRxTrace for packet:" << animUid);
   NS_ASSERT (IsPacketPending (animUid, AnimationInterface::WIMAX) == true);
   AnimPacketInfo& pktInfo = m_pendingWimaxPackets[animUid];
@@ -912,6 +1100,11 @@ AnimationInterface::LteTxTrace (std::string context, Ptr<const Packet> p, const
   NS_ASSERT (ndev);
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
+  if (!IsPacketSampled (AnimationInterface::LTE))
+    {
+      AddByteTag (0, p);
+      return;
+    }
   ++gAnimUid;
   NS_LOG_INFO ("LteTxTrace for packet:" << gAnimUid);
   UpdatePosition (n);
@@ -932,6 +1125,8 @@ AnimationInterface::LteRxTrace (std::string context, Ptr<const Packet> p, const
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (animUid == 0)
+    return; // Not sampled
   NS_LOG_INFO ("LteRxTrace for packet:" << gAnimUid);
   if (!IsPacketPending (animUid, AnimationInterface::LTE))
     {
@@ -966,6 +1161,11 @@ AnimationInterface::LteSpectrumPhyTxStart (std::string context, Ptr<const Packet
        ++i)
     {
       Ptr <Packet> p = *i;
+      if (!IsPacketSampled (AnimationInterface::LTE))
+        {
+          AddByteTag (0, p);
+          continue;
+        }
       ++gAnimUid;
       NS_LOG_INFO ("LteSpectrumPhyTxTrace for packet:" << gAnimUid);
       UpdatePosition (n);
@@ -999,6 +1199,8 @@ AnimationInterface::LteSpectrumPhyRxStart (std::string context, Ptr<const Packet
     {
       Ptr <Packet> p = *i;
       uint64_t animUid = GetAnimUidFromPacket (p);
+      if (animUid == 0)
+        continue; // Not sampled
       NS_LOG_INFO ("LteSpectrumPhyRxTrace for packet:" << gAnimUid);
       if (!IsPacketPending (animUid, AnimationInterface::LTE))
         {
@@ -1021,6 +1223,11 @@ AnimationInterface::CsmaPhyTxBeginTrace (std::string context, Ptr<const Packet>
   NS_ASSERT (ndev);
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
+  if (!IsPacketSampled (AnimationInterface::CSMA))
+    {
+      AddByteTag (0, p);
+      return;
+    }
   ++gAnimUid;
   NS_LOG_INFO ("CsmaPhyTxBeginTrace for packet:" << gAnimUid);
   AddByteTag (gAnimUid, p);
@@ -1040,6 +1247,8 @@ AnimationInterface::CsmaPhyTxEndTrace (std::string context, Ptr<const Packet> p)
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (animUid == 0)
+    return; // Not sampled
   NS_LOG_INFO ("CsmaPhyTxEndTrace for packet:" << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::CSMA))
     {
@@ -1065,6 +1274,8 @@ AnimationInterface::CsmaPhyRxEndTrace (std::string context, Ptr<const Packet> p)
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (animUid == 0)
+    return; // Not sampled
   if (!IsPacketPending (animUid, AnimationInterface::CSMA))
     {
       NS_LOG_WARN ("CsmaPhyRxEndTrace: unknown Uid"); 
@@ -1091,6 +1302,8 @@ AnimationInterface::CsmaMacRxTrace (std::string context,
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
   uint64_t animUid = GetAnimUidFromPacket (p);
+  if (animUid == 0)
+    return; // Not sampled
   if (!IsPacketPending (animUid, AnimationInterface::CSMA))
     {
       NS_LOG_WARN ("CsmaMacRxTrace: unknown Uid"); 
@@ -1149,6 +1362,17 @@ AnimationInterface::AddPendingPacket (ProtocolType protocolType, uint64_t animUi
   pendingPackets->insert (AnimUidPacketInfoMap::value_type (animUid, pktInfo));
 }
 
+bool
+AnimationInterface::IsPacketSampled (AnimationInterface::ProtocolType protocolType)
+{
+  std::map <ProtocolType, uint32_t>::const_iterator it = m_packetSamplingRate.find (protocolType);
+  if (it == m_packetSamplingRate.end ())
+    {
+      return true;
+    }
+  return (m_packetSamplingCount[protocolType]++ % it->second) == 0;
+}
+
 bool 
 AnimationInterface::IsPacketPending (uint64_t animUid, AnimationInterface::ProtocolType protocolType)
 {
@@ -1216,6 +1440,11 @@ AnimationInterface::ProtocolTypeToPendingPackets (AnimationInterface::ProtocolTy
           pendingPackets = &m_pendingLtePackets;
           break;
         }
+      case AnimationInterface::P2P:
+        {
+          // Point-to-point packets are written on transmission
+          break;
+        }
     }
   return pendingPackets;
 
@@ -1269,6 +1498,7 @@ AnimationInterface::StopAnimation (bool onlyAnimation)
     {
       // Terminate the anim element
       WriteXmlClose ("anim");
+      CloseOutputWriter ();
       std::fclose (m_f);
       m_f = 0;
     }
@@ -1695,10 +1925,47 @@ AnimationInterface::SetOutputFile (const std::string& fn, bool routing)
     {
       m_f = f;
       m_outputFileName = fn;
+      OpenOutputWriter ();
     }
   return;
 }
 
+void
+AnimationInterface::OpenOutputWriter ()
+{
+  if (m_writer)
+    {
+      // Write the blocks buffered so far
+      delete m_writer;
+      m_writer = 0;
+    }
+  bool compress = (m_outputFileName.size () > 3) &&
+                  (m_outputFileName.compare (m_outputFileName.size () - 3, 3, ".gz") == 0);
+  if (!compress && !m_asyncOutput)
+    {
+      CloseOutputWriter ();
+      return;
+    }
+  if (!m_fileStream)
+    {
+      m_fileBuffer = new AnimFileBuffer (m_f, compress);
+      m_fileStream = new std::ostream (m_fileBuffer);
+    }
+  m_writer = new AsyncBlockWriter (m_fileStream, OUTPUT_BLOCK_SIZE, m_asyncOutput);
+}
+
+void
+AnimationInterface::CloseOutputWriter ()
+{
+  // The writer writes its last blocks, then the buffer terminates the compressed stream
+  delete m_writer;
+  m_writer = 0;
+  delete m_fileStream;
+  m_fileStream = 0;
+  delete m_fileBuffer;
+  m_fileBuffer = 0;
+}
+
 void 
 AnimationInterface::CheckMaxPktsPerTraceFile ()
 {
@@ -2077,6 +2344,7 @@ AnimationInterface::WriteXmlNode (uint32_t id, uint32_t sysId, double locX, doub
   element.AddAttribute ("locY", locY);
   element.Close ();
   WriteN (element.GetElementString (), m_f);
+  m_writtenNodeLocation[id] = Vector (locX, locY, 0);
 }
 
 void 
@@ -2260,6 +2528,7 @@ AnimationInterface::WriteXmlUpdateNodePosition (uint32_t nodeId, double x, doubl
   element.AddAttribute ("y", y);
   element.Close ();
   WriteN (element.GetElementString (), m_f);
+  m_writtenNodeLocation[nodeId] = Vector (x, y, 0);
 }
 
 void 
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <cstdio>
+#include <iosfwd>
 #include <map>
 
 #include "ns3/ptr.h"
@@ -51,6 +52,7 @@ namespace ns3 {
 
 
 struct NodeSize;
+class AsyncBlockWriter;
 
 /**
  * \defgroup netanim Network Animation
@@ -72,7 +74,9 @@ public:
 
   /**
    * \brief Constructor
-   * \param filename The Filename for the trace file used by the Animator
+   * \param filename The Filename for the trace file used by the Animator.
+   *        If the filename ends with ".gz" the trace file is compressed
+   *        with gzip, which requires zlib
    *
    */
   AnimationInterface (const std::string filename);
@@ -86,6 +90,19 @@ public:
       DOUBLE_COUNTER
     } CounterType;
 
+  /**
+   * Protocol Types of the traced packets
+   */
+  typedef enum
+    {
+      UAN,
+      LTE,
+      WIFI,
+      WIMAX,
+      CSMA,
+      P2P
+    } ProtocolType;
+
   /**
    * \brief typedef for WriteCallBack used for listening to AnimationInterface
    * write messages
@@ -218,6 +235,42 @@ public:
    */
   void SetMobilityPollInterval (Time t);
 
+  /**
+   * \brief Set the distance a node must move before its new position is
+   * written to the trace file. This helps reduce the trace file size for
+   * large mobile scenarios
+   *
+   * \param distance Distance in meters from the last position written for the node.
+   * Default: 0, where a position is written whenever a coordinate of the node
+   * crosses an integer boundary, and on every course change
+   *
+   * \returns none
+   */
+  void SetMobilityThreshold (double distance);
+
+  /**
+   * \brief Buffer the trace file in large blocks, compressed and written by a
+   * background thread so that the simulation does not wait for the disk
+   *
+   * \param enable if true the blocks are written by a background thread
+   *        if false the blocks are written by the simulation thread
+   *
+   * \returns none
+   */
+  void SetAsynchronousOutput (bool enable = true);
+
+  /**
+   * \brief Trace only a sample of the packets of a protocol. This helps reduce
+   * the trace file size for dense traffic
+   *
+   * \param protocolType The protocol of the packets
+   * \param oneOutOf Trace one out of oneOutOf packets transmitted with the protocol.
+   * Default: 1, where every packet is traced
+   *
+   * \returns none
+   */
+  void SetPacketSamplingRate (ProtocolType protocolType, uint32_t oneOutOf);
+
   /**
    * \brief Set a callback function to listen to AnimationInterface write events
    *
@@ -488,15 +541,6 @@ private:
       std::string nextHop;
     } Ipv4RoutePathElement;
 
-  typedef enum
-    {
-      UAN,
-      LTE,
-      WIFI,
-      WIMAX,
-      CSMA
-    } ProtocolType;
-
   typedef struct
     {
       double width;
@@ -560,6 +604,13 @@ private:
   Time m_wifiPhyCountersPollInterval;
   static Rectangle * userBoundary;
   bool m_trackPackets;
+  double m_mobilityThreshold;
+  bool m_asyncOutput;
+  AsyncBlockWriter * m_writer; // Block writer for output (0 if none)
+  std::streambuf * m_fileBuffer; // Stream buffer writing the blocks to m_f (0 if none)
+  std::ostream * m_fileStream; // Stream over m_fileBuffer (0 if none)
+  std::map <ProtocolType, uint32_t> m_packetSamplingRate;
+  std::map <ProtocolType, uint64_t> m_packetSamplingCount;
 
   // Counter ID
   uint32_t m_remainingEnergyCounterId;
@@ -586,6 +637,7 @@ private:
   AnimUidPacketInfoMap m_pendingCsmaPackets;
   AnimUidPacketInfoMap m_pendingUanPackets;
   std::map <uint32_t, Vector> m_nodeLocation;
+  std::map <uint32_t, Vector> m_writtenNodeLocation;
   std::map <std::string, uint32_t> m_macToNodeIdMap;
   std::map <std::string, uint32_t> m_ipv4ToNodeIdMap;
   NodeColorsMap m_nodeColors;
@@ -620,6 +672,8 @@ private:
   void StartAnimation (bool restart = false);
   void SetOutputFile (const std::string& fn, bool routing = false);
   void StopAnimation (bool onlyAnimation = false);
+  void OpenOutputWriter ();
+  void CloseOutputWriter ();
   std::string CounterTypeToString (CounterType counterType);
   std::string GetPacketMetadata (Ptr<const Packet> p);
   void AddByteTag (uint64_t animUid, Ptr<const Packet> p);
@@ -630,6 +684,7 @@ private:
   std::string GetNetAnimVersion ();
   void MobilityAutoCheck ();
   bool IsPacketPending (uint64_t animUid, ProtocolType protocolType);
+  bool IsPacketSampled (ProtocolType protocolType);
   void PurgePendingPackets (ProtocolType protocolType);
   AnimUidPacketInfoMap * ProtocolTypeToPendingPackets (ProtocolType protocolType);
   void AddPendingPacket (ProtocolType protocolType, uint64_t animUid, AnimPacketInfo pktInfo);
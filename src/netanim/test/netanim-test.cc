@@ -18,6 +18,7 @@
  */
 
 #include <iostream>
+#include <cstring>
 #include "unistd.h"
 
 #include "ns3/core-module.h"
@@ -29,6 +30,11 @@
 #include "ns3/point-to-point-layout-module.h"
 #include "ns3/basic-energy-source.h"
 #include "ns3/simple-device-energy-model.h"
+#include "ns3/mobility-module.h"
+
+#ifdef NS3_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace ns3;
 
@@ -228,6 +234,214 @@ AnimationRemainingEnergyTestCase::CheckLogic (void)
                             "Wrong remaining energy value was traced");
 }
 
+class AnimationPacketSamplingTestCase : public AbstractAnimationInterfaceTestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  AnimationPacketSamplingTestCase ();
+
+private:
+
+  virtual void
+  PrepareNetwork ();
+
+  virtual void
+  CheckLogic ();
+
+  void
+  EnableSampling ();
+};
+
+AnimationPacketSamplingTestCase::AnimationPacketSamplingTestCase () :
+  AbstractAnimationInterfaceTestCase ("Verify packet sampling")
+{
+}
+
+void
+AnimationPacketSamplingTestCase::EnableSampling ()
+{
+  m_anim->SetPacketSamplingRate (AnimationInterface::P2P, 2);
+}
+
+void
+AnimationPacketSamplingTestCase::PrepareNetwork (void)
+{
+  m_nodes.Create (2);
+  AnimationInterface::SetConstantPosition (m_nodes.Get (0), 0 , 10);
+  AnimationInterface::SetConstantPosition (m_nodes.Get (1), 1 , 10);
+
+  PointToPointHelper pointToPoint;
+  NetDeviceContainer devices = pointToPoint.Install (m_nodes);
+
+  InternetStackHelper stack;
+  stack.Install (m_nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  UdpEchoServerHelper echoServer (9);
+  ApplicationContainer serverApps = echoServer.Install (m_nodes.Get (1));
+  serverApps.Start (Seconds (1.0));
+  serverApps.Stop (Seconds (10.0));
+
+  UdpEchoClientHelper echoClient (interfaces.GetAddress (1), 9);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (100));
+  echoClient.SetAttribute ("Interval", TimeValue (Seconds (1.0)));
+  echoClient.SetAttribute ("PacketSize", UintegerValue (1024));
+  ApplicationContainer clientApps = echoClient.Install (m_nodes.Get (0));
+  clientApps.Start (Seconds (2.0));
+  clientApps.Stop (Seconds (10.0));
+
+  // The AnimationInterface is created once the network is ready
+  Simulator::Schedule (Seconds (0), &AnimationPacketSamplingTestCase::EnableSampling, this);
+}
+
+void
+AnimationPacketSamplingTestCase::CheckLogic (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_anim->GetTracePktCount (), 8, "Expected 8 out of 16 packets traced");
+}
+
+/// Number of node position updates written by the AnimationInterface
+static uint32_t g_nodePositionUpdates = 0;
+
+/// Count the node position updates written by the AnimationInterface
+static void
+CountNodePositionUpdates (const char * str)
+{
+  if (std::strncmp (str, "<nu p=\"p\"", 9) == 0)
+    {
+      ++g_nodePositionUpdates;
+    }
+}
+
+class AnimationMobilityThresholdTestCase : public AbstractAnimationInterfaceTestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  AnimationMobilityThresholdTestCase ();
+
+private:
+
+  virtual void
+  PrepareNetwork ();
+
+  virtual void
+  CheckLogic ();
+
+  void
+  EnableThreshold ();
+};
+
+AnimationMobilityThresholdTestCase::AnimationMobilityThresholdTestCase () :
+  AbstractAnimationInterfaceTestCase ("Verify mobility threshold")
+{
+}
+
+void
+AnimationMobilityThresholdTestCase::EnableThreshold ()
+{
+  g_nodePositionUpdates = 0;
+  m_anim->SetAnimWriteCallback (&CountNodePositionUpdates);
+  m_anim->SetMobilityThreshold (4);
+}
+
+void
+AnimationMobilityThresholdTestCase::PrepareNetwork (void)
+{
+  m_nodes.Create (1);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (m_nodes);
+  m_nodes.Get (0)->GetObject<ConstantVelocityMobilityModel> ()->SetVelocity (Vector (1, 0, 0));
+
+  Simulator::Schedule (Seconds (0), &AnimationMobilityThresholdTestCase::EnableThreshold, this);
+  Simulator::Stop (Seconds (10));
+}
+
+void
+AnimationMobilityThresholdTestCase::CheckLogic (void)
+{
+  // The node is polled every 0.25 m, its position is written at 4 m and 8 m
+  NS_TEST_ASSERT_MSG_EQ (g_nodePositionUpdates, 2, "Expected 2 node position updates");
+}
+
+class AnimationOutputTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  AnimationOutputTestCase ();
+
+private:
+  virtual void
+  DoRun (void);
+};
+
+AnimationOutputTestCase::AnimationOutputTestCase () :
+  TestCase ("Verify asynchronous and compressed output")
+{
+}
+
+void
+AnimationOutputTestCase::DoRun (void)
+{
+#ifdef NS3_ZLIB
+  std::string fileName = CreateTempDirFilename ("netanim-test.xml.gz");
+#else
+  std::string fileName = CreateTempDirFilename ("netanim-test.xml");
+#endif
+  NodeContainer nodes;
+  nodes.Create (100);
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      AnimationInterface::SetConstantPosition (nodes.Get (i), i, 10);
+    }
+  AnimationInterface * anim = new AnimationInterface (fileName);
+  anim->SetAsynchronousOutput ();
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      anim->UpdateNodeDescription (nodes.Get (i), "node");
+    }
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  delete anim;
+
+  std::string content;
+  char buffer[4096];
+#ifdef NS3_ZLIB
+  gzFile f = gzopen (fileName.c_str (), "rb");
+  NS_TEST_ASSERT_MSG_NE (f, 0, "Trace file was not created");
+  int n;
+  while ((n = gzread (f, buffer, sizeof (buffer))) > 0)
+    {
+      content.append (buffer, n);
+    }
+  gzclose (f);
+#else
+  FILE * f = fopen (fileName.c_str (), "r");
+  NS_TEST_ASSERT_MSG_NE (f, 0, "Trace file was not created");
+  size_t n;
+  while ((n = fread (buffer, 1, sizeof (buffer), f)) > 0)
+    {
+      content.append (buffer, n);
+    }
+  fclose (f);
+#endif
+  unlink (fileName.c_str ());
+
+  NS_TEST_ASSERT_MSG_EQ (content.compare (0, 5, "<anim"), 0, "Trace file does not start with the anim element");
+  NS_TEST_ASSERT_MSG_NE (content.find ("<node id=\"99\""), std::string::npos, "Node missing from the trace file");
+  NS_TEST_ASSERT_MSG_EQ (content.compare (content.size () - 8, 8, "</anim>\n"), 0, "Trace file not terminated");
+}
+
 static class AnimationInterfaceTestSuite : public TestSuite
 {
 public:
@@ -236,5 +450,8 @@ public:
   {
     AddTestCase (new AnimationInterfaceTestCase (), TestCase::QUICK);
     AddTestCase (new AnimationRemainingEnergyTestCase (), TestCase::QUICK);
+    AddTestCase (new AnimationPacketSamplingTestCase (), TestCase::QUICK);
+    AddTestCase (new AnimationMobilityThresholdTestCase (), TestCase::QUICK);
+    AddTestCase (new AnimationOutputTestCase (), TestCase::QUICK);
   }
 } g_animationInterfaceTestSuite;
@@ -35,6 +35,37 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+namespace {
+
+/** The pcapng file shared by the pcap traces, if multiplexing is enabled. */
+Ptr<PcapNgFile> g_multiplexedFile;
+
+/**
+ * Write an event of a default ascii trace sink as a binary record,
+ * if the stream was created by AsciiTraceHelper::CreateBinaryFileStream().
+ *
+ * \param [in] stream The trace stream.
+ * \param [in] event The event character: '+', '-', 'd' or 'r'.
+ * \param [in] context The trace context, or 0 if none.
+ * \param [in] p The packet.
+ * \returns \c true if the event was written as a binary record,
+ *          \c false if it must be written as text.
+ */
+bool
+WriteBinaryRecord (Ptr<OutputStreamWrapper> stream, char event,
+                   const std::string *context, Ptr<const Packet> p)
+{
+  Ptr<BinaryTraceWriter> binary = stream->GetBinaryTraceWriter ();
+  if (binary == 0)
+    {
+      return false;
+    }
+  binary->Write (event, Simulator::Now ().GetNanoSeconds (), context, p);
+  return true;
+}
+
+} // unnamed namespace
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -56,6 +87,13 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  if (g_multiplexedFile != 0)
+    {
+      file->Open (g_multiplexedFile, filename);
+      file->Init (dataLinkType, snapLen, tzCorrection);
+      NS_ABORT_MSG_IF (file->Fail (), "Unable to add " << filename << " to the multiplexed file");
+      return file;
+    }
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +114,30 @@ PcapHelper::CreateFile (
   return file;
 }
 
+void
+PcapHelper::EnableMultiplexing (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  if (g_multiplexedFile == 0)
+    {
+      Simulator::ScheduleDestroy (&PcapHelper::DisableMultiplexing);
+    }
+  g_multiplexedFile = Create<PcapNgFile> ();
+  g_multiplexedFile->Open (filename);
+  NS_ABORT_MSG_IF (g_multiplexedFile->Fail (), "Unable to Open " << filename);
+}
+
+void
+PcapHelper::DisableMultiplexing (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (g_multiplexedFile != 0)
+    {
+      g_multiplexedFile->Flush ();
+      g_multiplexedFile = 0;
+    }
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -201,6 +263,17 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   return StreamWrapper;
 }
 
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream (std::string filename, bool compress)
+{
+  NS_LOG_FUNCTION (filename << compress);
+
+  Ptr<OutputStreamWrapper> StreamWrapper =
+    Create<OutputStreamWrapper> (filename, std::ios::out | std::ios::binary);
+  StreamWrapper->EnableBinaryTrace (compress);
+  return StreamWrapper;
+}
+
 std::string
 AsciiTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -303,6 +376,10 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (WriteBinaryRecord (stream, '+', 0, p))
+    {
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -310,6 +387,10 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (WriteBinaryRecord (stream, '+', &context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -329,6 +410,10 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (WriteBinaryRecord (stream, 'd', 0, p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -336,6 +421,10 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (WriteBinaryRecord (stream, 'd', &context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -356,6 +445,10 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (WriteBinaryRecord (stream, '-', 0, p))
+    {
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -363,6 +456,10 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (WriteBinaryRecord (stream, '-', &context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -380,6 +477,10 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (WriteBinaryRecord (stream, 'r', 0, p))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -387,6 +488,10 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  if (WriteBinaryRecord (stream, 'r', &context, p))
+    {
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
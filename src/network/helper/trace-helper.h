@@ -110,6 +110,25 @@ public:
    */
   template <typename T> void HookDefaultSink (Ptr<T> object, std::string traceName, Ptr<PcapFileWrapper> file);
 
+  /**
+   * @brief Write the packets of all the pcap files created afterwards to a
+   * single pcapng file.
+   *
+   * Each file created by CreateFile () becomes an interface of the pcapng
+   * file, named after the pcap file name it replaces, instead of a
+   * separate file.  This avoids opening thousands of files in simulations
+   * with many traced devices.  The pcapng file is flushed and released by
+   * Simulator::Destroy (), or by DisableMultiplexing ().
+   *
+   * @param filename name of the pcapng file
+   */
+  static void EnableMultiplexing (std::string filename);
+  /**
+   * @brief Create separate pcap files again.  The pcapng file is closed
+   * once all the trace sinks writing to it are released.
+   */
+  static void DisableMultiplexing (void);
+
 private:
   /**
    * The basic default trace sink.
@@ -202,6 +221,23 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create an output stream to which the default trace sinks write
+   * compact binary records instead of text.
+   *
+   * Formatting every packet with Packet::Print is the main cost of ascii
+   * tracing.  The binary records store the raw headers instead, and the
+   * binary-trace-to-ascii program (or BinaryTraceReader) converts them
+   * to the ascii trace text on demand.  The stream can be given to the
+   * EnableAscii methods of the device helpers which use the default
+   * sinks; sinks writing text must not be connected to it.
+   *
+   * @param filename file name
+   * @param compress compress the records with zlib, if available
+   * @returns a smart pointer to the output stream
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename, bool compress = true);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
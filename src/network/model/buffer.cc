@@ -20,6 +20,7 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/metrics-registry.h"
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -43,6 +44,28 @@ static struct Zeroes
   const uint32_t size;  //!< buffer size
 } g_zeroes; //!< Zero-filled buffer
 
+/**
+ * \ingroup packet
+ * \returns The network/buffer-allocations metric.
+ */
+ns3::Metric &
+GetAllocationsMetric (void)
+{
+  static ns3::Metric metric ("network/buffer-allocations");
+  return metric;
+}
+
+/**
+ * \ingroup packet
+ * \returns The network/buffer-deallocations metric.
+ */
+ns3::Metric &
+GetDeallocationsMetric (void)
+{
+  static ns3::Metric metric ("network/buffer-deallocations");
+  return metric;
+}
+
 }
 
 namespace ns3 {
@@ -173,6 +196,7 @@ Buffer::Allocate (uint32_t reqSize)
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
+  GetAllocationsMetric ().Increment ();
   return data;
 }
 
@@ -183,6 +207,7 @@ Buffer::Deallocate (struct Buffer::Data *data)
   NS_ASSERT (data->m_count == 0);
   uint8_t *buf = reinterpret_cast<uint8_t *> (data);
   delete [] buf;
+  GetDeallocationsMetric ().Increment ();
 }
 
 Buffer::Buffer ()
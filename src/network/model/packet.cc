@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/metrics-registry.h"
 #include <string>
 #include <cstdarg>
 
@@ -30,6 +31,22 @@ NS_LOG_COMPONENT_DEFINE ("Packet");
 
 uint32_t Packet::m_globalUid = 0;
 
+namespace {
+
+/**
+ * \ingroup packet
+ * \returns The network/packets metric, the number of packets created
+ * with a new uid.
+ */
+Metric &
+GetPacketsMetric (void)
+{
+  static Metric metric ("network/packets");
+  return metric;
+}
+
+} // anonymous namespace
+
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
 {
@@ -141,6 +158,7 @@ Packet::Packet ()
     m_nixVector (0)
 {
   m_globalUid++;
+  GetPacketsMetric ().Increment ();
 }
 
 Packet::Packet (const Packet &o)
@@ -183,6 +201,7 @@ Packet::Packet (uint32_t size)
     m_nixVector (0)
 {
   m_globalUid++;
+  GetPacketsMetric ().Increment ();
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -209,6 +228,7 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
     m_nixVector (0)
 {
   m_globalUid++;
+  GetPacketsMetric ().Increment ();
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
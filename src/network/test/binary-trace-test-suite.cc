@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sstream>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/ethernet-trailer.h"
+#include "ns3/trace-helper.h"
+#include "ns3/binary-trace-file.h"
+
+using namespace ns3;
+
+/**
+ * Check that the binary traces written by the default ascii trace sinks
+ * convert back to the text the sinks write to ascii streams.
+ */
+class BinaryTraceTestCase : public TestCase
+{
+public:
+  BinaryTraceTestCase (bool compress);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Trace a packet to the text and binary streams.
+   * \param p The packet.
+   * \param i The packet index, which selects the sink.
+   */
+  void Trace (Ptr<const Packet> p, uint32_t i);
+
+  bool m_compress;                      //!< Compress the binary trace
+  Ptr<OutputStreamWrapper> m_text;      //!< The text stream
+  Ptr<OutputStreamWrapper> m_binary;    //!< The binary stream
+};
+
+BinaryTraceTestCase::BinaryTraceTestCase (bool compress)
+  : TestCase (compress ? "Check compressed binary traces" : "Check uncompressed binary traces"),
+    m_compress (compress)
+{
+}
+
+void
+BinaryTraceTestCase::Trace (Ptr<const Packet> p, uint32_t i)
+{
+  std::ostringstream context;
+  context << "/NodeList/" << i % 3 << "/DeviceList/0/$ns3::PointToPointNetDevice/TxQueue/Enqueue";
+  Ptr<OutputStreamWrapper> streams[2] = { m_text, m_binary };
+  for (uint32_t j = 0; j < 2; ++j)
+    {
+      switch (i % 8)
+        {
+        case 0: AsciiTraceHelper::DefaultEnqueueSinkWithContext (streams[j], context.str (), p); break;
+        case 1: AsciiTraceHelper::DefaultDequeueSinkWithContext (streams[j], context.str (), p); break;
+        case 2: AsciiTraceHelper::DefaultDropSinkWithContext (streams[j], context.str (), p); break;
+        case 3: AsciiTraceHelper::DefaultReceiveSinkWithContext (streams[j], context.str (), p); break;
+        case 4: AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (streams[j], p); break;
+        case 5: AsciiTraceHelper::DefaultDequeueSinkWithoutContext (streams[j], p); break;
+        case 6: AsciiTraceHelper::DefaultDropSinkWithoutContext (streams[j], p); break;
+        case 7: AsciiTraceHelper::DefaultReceiveSinkWithoutContext (streams[j], p); break;
+        }
+    }
+}
+
+void
+BinaryTraceTestCase::DoRun (void)
+{
+  Packet::EnablePrinting ();
+  std::string filename = CreateTempDirFilename (m_compress ? "trace.btz" : "trace.bt");
+  std::ostringstream text;
+  m_text = Create<OutputStreamWrapper> (&text);
+  AsciiTraceHelper helper;
+  m_binary = helper.CreateBinaryFileStream (filename, m_compress);
+
+  const uint32_t nPackets = 5000;
+  for (uint32_t i = 0; i < nPackets; ++i)
+    {
+      Ptr<Packet> p = Create<Packet> (i % 1500);
+      if (i % 4 != 0)
+        {
+          EthernetHeader header (false);
+          header.SetSource (Mac48Address::Allocate ());
+          header.SetDestination (Mac48Address ("ff:ff:ff:ff:ff:ff"));
+          header.SetLengthType (i % 1500);
+          p->AddHeader (header);
+        }
+      if (i % 3 == 0)
+        {
+          EthernetTrailer trailer;
+          trailer.CalcFcs (p);
+          p->AddTrailer (trailer);
+        }
+      if (i % 5 == 0 && p->GetSize () > 20)
+        {
+          p = p->CreateFragment (7, p->GetSize () - 10);
+        }
+      Simulator::Schedule (MicroSeconds (i * 37), &BinaryTraceTestCase::Trace, this, p, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_text = 0;
+  // Release the binary stream to write the last block
+  m_binary = 0;
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Could not open " << filename);
+  std::ostringstream converted;
+  BinaryTraceReader::Record record;
+  uint32_t records = 0;
+  while (reader.Read (record))
+    {
+      BinaryTraceReader::PrintAscii (converted, record);
+      ++records;
+    }
+  NS_TEST_ASSERT_MSG_EQ (records, nPackets, "Wrong number of records in " << filename);
+  NS_TEST_ASSERT_MSG_EQ ((converted.str () == text.str ()), true,
+                         "Converted binary trace differs from the ascii trace");
+}
+
+/**
+ * Binary trace test suite.
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ();
+};
+
+BinaryTraceTestSuite::BinaryTraceTestSuite ()
+  : TestSuite ("binary-trace", UNIT)
+{
+  AddTestCase (new BinaryTraceTestCase (false), TestCase::QUICK);
+  AddTestCase (new BinaryTraceTestCase (true), TestCase::QUICK);
+}
+
+static BinaryTraceTestSuite g_binaryTraceTestSuite;
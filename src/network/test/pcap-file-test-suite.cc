@@ -21,10 +21,22 @@
 #include <cstdlib>
 #include <sstream>
 #include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
 
+#include "ns3/core-config.h"
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcap-ng-file.h"
+
+#if defined (HAVE_SYS_WAIT_H) && defined (HAVE_UNISTD_H)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define PCAP_TEST_FORK_SUPPORTED 1
+#endif
 
 using namespace ns3;
 
@@ -1121,6 +1133,286 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// Test case to make sure that records buffered in blocks, either written
+// synchronously or by the writer thread, read back as written directly.
+// ===========================================================================
+class BlockWriterTestCase : public TestCase
+{
+public:
+  BlockWriterTestCase (bool async);
+
+private:
+  virtual void DoRun (void);
+  bool m_async;
+};
+
+BlockWriterTestCase::BlockWriterTestCase (bool async)
+  : TestCase (async ? "Check asynchronous block writes" : "Check synchronous block writes"),
+    m_async (async)
+{
+}
+
+void
+BlockWriterTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("block.pcap");
+  const uint32_t snapLen = 100;
+  const uint32_t nPackets = 1000;
+  uint8_t data[200];
+
+  PcapFile f;
+  f.Open (filename, std::ios::out);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::out\") returns error");
+  f.Init (1, snapLen);
+  // A block size smaller than some records, to check oversized records
+  f.EnableBlockWriter (128, m_async);
+  for (uint32_t i = 0; i < nPackets; ++i)
+    {
+      uint32_t len = i % 200;
+      for (uint32_t j = 0; j < len; ++j)
+        {
+          data[j] = i + j;
+        }
+      f.Write (i / 1000, i % 1000, data, len);
+    }
+  f.Close ();
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Close () of " << filename << " returns error");
+
+  f.Open (filename, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ", \"std::ios::in\") returns error");
+  NS_TEST_ASSERT_MSG_EQ (f.GetSnapLen (), snapLen, "Wrong snap length in file header");
+  for (uint32_t i = 0; i < nPackets; ++i)
+    {
+      uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+      f.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Read () of record " << i << " returns error");
+      NS_TEST_ASSERT_MSG_EQ (tsSec, i / 1000, "Wrong seconds in record " << i);
+      NS_TEST_ASSERT_MSG_EQ (tsUsec, i % 1000, "Wrong microseconds in record " << i);
+      NS_TEST_ASSERT_MSG_EQ (origLen, i % 200, "Wrong original length in record " << i);
+      NS_TEST_ASSERT_MSG_EQ (inclLen, std::min (i % 200, snapLen), "Wrong included length in record " << i);
+      for (uint32_t j = 0; j < inclLen; ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t)data[j], (uint8_t)(i + j), "Wrong data in record " << i);
+        }
+    }
+  uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+  f.Read (data, 1, tsSec, tsUsec, inclLen, origLen, readLen);
+  NS_TEST_ASSERT_MSG_EQ (f.Eof (), true, "Extra records in " << filename);
+  f.Close ();
+}
+
+// ===========================================================================
+// Test case to make sure that the packets of several interfaces are
+// multiplexed in a well formed pcapng file.
+// ===========================================================================
+class PcapNgTestCase : public TestCase
+{
+public:
+  PcapNgTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapNgTestCase::PcapNgTestCase ()
+  : TestCase ("Check pcapng multiplexing")
+{
+}
+
+void
+PcapNgTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("multiplexed.pcapng");
+  uint8_t data[64];
+  for (uint32_t j = 0; j < sizeof (data); ++j)
+    {
+      data[j] = j;
+    }
+
+  PcapNgFile f;
+  f.Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") returns error");
+  f.EnableBlockWriter (256, true);
+  uint32_t a = f.AddInterface ("node-0-dev-0", 1, 65535);
+  uint32_t b = f.AddInterface ("n1", 9, 10);
+  NS_TEST_ASSERT_MSG_EQ (a, 0, "Wrong first interface id");
+  NS_TEST_ASSERT_MSG_EQ (b, 1, "Wrong second interface id");
+  NS_TEST_ASSERT_MSG_EQ (f.GetInterfaceCount (), 2, "Wrong interface count");
+  const uint32_t nPackets = 100;
+  for (uint32_t i = 0; i < nPackets; ++i)
+    {
+      f.Write (i % 2, i * 1000000007ULL, data, 1 + i % 63);
+    }
+  f.Close ();
+
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  std::vector<uint8_t> file ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+  uint32_t offset = 0;
+  uint32_t blocks = 0;
+  uint32_t packets = 0;
+  while (offset + 12 <= file.size ())
+    {
+      uint32_t type, total, trailer;
+      std::memcpy (&type, &file[offset], 4);
+      std::memcpy (&total, &file[offset + 4], 4);
+      NS_TEST_ASSERT_MSG_EQ (total % 4, 0, "Block " << blocks << " is not padded");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (offset + total, file.size (), "Block " << blocks << " is truncated");
+      std::memcpy (&trailer, &file[offset + total - 4], 4);
+      NS_TEST_ASSERT_MSG_EQ (trailer, total, "Bad trailer length in block " << blocks);
+      if (blocks == 0)
+        {
+          uint32_t magic;
+          std::memcpy (&magic, &file[offset + 8], 4);
+          NS_TEST_ASSERT_MSG_EQ (type, 0x0a0d0d0a, "First block is not a section header");
+          NS_TEST_ASSERT_MSG_EQ (magic, 0x1a2b3c4d, "Bad byte order magic");
+        }
+      else if (blocks <= 2)
+        {
+          uint16_t linkType;
+          uint32_t snapLen;
+          std::memcpy (&linkType, &file[offset + 8], 2);
+          std::memcpy (&snapLen, &file[offset + 12], 4);
+          NS_TEST_ASSERT_MSG_EQ (type, 1, "Missing interface description block");
+          NS_TEST_ASSERT_MSG_EQ (linkType, (blocks == 1 ? 1 : 9), "Bad link type");
+          NS_TEST_ASSERT_MSG_EQ (snapLen, (blocks == 1 ? 65535 : 10), "Bad snap length");
+          // if_tsresol follows if_name, its one byte value comes first
+          uint32_t tsresol = offset + 16 + 4 + (blocks == 1 ? 12 : 4);
+          uint16_t code, length;
+          std::memcpy (&code, &file[tsresol], 2);
+          std::memcpy (&length, &file[tsresol + 2], 2);
+          NS_TEST_ASSERT_MSG_EQ (code, 9, "Missing if_tsresol option");
+          NS_TEST_ASSERT_MSG_EQ (length, 1, "Bad if_tsresol length");
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t)file[tsresol + 4], 9, "Bad if_tsresol value");
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t)(file[tsresol + 5] | file[tsresol + 6] | file[tsresol + 7]), 0,
+                                 "Bad if_tsresol padding");
+        }
+      else
+        {
+          uint32_t interface, high, low, inclLen, origLen;
+          std::memcpy (&interface, &file[offset + 8], 4);
+          std::memcpy (&high, &file[offset + 12], 4);
+          std::memcpy (&low, &file[offset + 16], 4);
+          std::memcpy (&inclLen, &file[offset + 20], 4);
+          std::memcpy (&origLen, &file[offset + 24], 4);
+          uint32_t i = packets++;
+          NS_TEST_ASSERT_MSG_EQ (type, 6, "Expected an enhanced packet block");
+          NS_TEST_ASSERT_MSG_EQ (interface, i % 2, "Wrong interface in packet " << i);
+          uint64_t ts = ((uint64_t)high << 32) | low;
+          NS_TEST_ASSERT_MSG_EQ (ts, i * 1000000007ULL, "Wrong timestamp in packet " << i);
+          NS_TEST_ASSERT_MSG_EQ (origLen, 1 + i % 63, "Wrong original length in packet " << i);
+          NS_TEST_ASSERT_MSG_EQ (inclLen, (i % 2 ? std::min (origLen, 10U) : origLen), "Wrong included length in packet " << i);
+          NS_TEST_ASSERT_MSG_EQ (std::memcmp (&file[offset + 28], data, inclLen), 0, "Wrong data in packet " << i);
+        }
+      offset += total;
+      ++blocks;
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset, file.size (), "Trailing bytes in " << filename);
+  NS_TEST_ASSERT_MSG_EQ (packets, nPackets, "Wrong number of packets in " << filename);
+}
+
+// ===========================================================================
+// Test case to make sure that the records still buffered by the block
+// writers reach the files when a fatal error aborts the process.
+// ===========================================================================
+class BlockWriterFatalTestCase : public TestCase
+{
+public:
+  BlockWriterFatalTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BlockWriterFatalTestCase::BlockWriterFatalTestCase ()
+  : TestCase ("Check block writes on fatal errors")
+{
+}
+
+void
+BlockWriterFatalTestCase::DoRun (void)
+{
+#ifdef PCAP_TEST_FORK_SUPPORTED
+  std::string pcapName = CreateTempDirFilename ("fatal.pcap");
+  std::string pcapNgName = CreateTempDirFilename ("fatal.pcapng");
+  const uint32_t nPackets = 100;
+  uint8_t data[64];
+  for (uint32_t j = 0; j < sizeof (data); ++j)
+    {
+      data[j] = j;
+    }
+
+  pid_t pid = fork ();
+  if (pid == 0)
+    {
+      // Keep the fatal error message out of the test output
+      if (std::freopen ("/dev/null", "w", stderr) == 0)
+        {
+          _exit (1);
+        }
+      // Blocks large enough to hold every record until the fatal error
+      PcapFile f;
+      f.Open (pcapName, std::ios::out);
+      f.Init (1, sizeof (data));
+      f.EnableBlockWriter (1 << 20, true);
+      PcapNgFile g;
+      g.Open (pcapNgName);
+      g.EnableBlockWriter (1 << 20, true);
+      g.AddInterface ("n0", 1, sizeof (data));
+      for (uint32_t i = 0; i < nPackets; ++i)
+        {
+          f.Write (i, 0, data, sizeof (data));
+          g.Write (0, i, data, sizeof (data));
+        }
+      NS_FATAL_ERROR ("fatal error after the last record");
+      _exit (0);
+    }
+  NS_TEST_ASSERT_MSG_GT (pid, 0, "fork failed");
+  int status;
+  NS_TEST_ASSERT_MSG_EQ (waitpid (pid, &status, 0), pid, "waitpid failed");
+  NS_TEST_ASSERT_MSG_EQ (WIFSIGNALED (status), true, "The child did not abort");
+
+  PcapFile f;
+  f.Open (pcapName, std::ios::in);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << pcapName << ", \"std::ios::in\") returns error");
+  uint32_t records = 0;
+  while (true)
+    {
+      uint32_t tsSec, tsUsec, inclLen, origLen, readLen;
+      f.Read (data, sizeof (data), tsSec, tsUsec, inclLen, origLen, readLen);
+      if (f.Fail ())
+        {
+          break;
+        }
+      NS_TEST_ASSERT_MSG_EQ (tsSec, records, "Wrong seconds in record " << records);
+      ++records;
+    }
+  NS_TEST_ASSERT_MSG_EQ (f.Eof (), true, "Truncated record in " << pcapName);
+  NS_TEST_ASSERT_MSG_EQ (records, nPackets, "Wrong number of records in " << pcapName);
+  f.Close ();
+
+  std::ifstream in (pcapNgName.c_str (), std::ios::binary);
+  std::vector<uint8_t> file ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+  uint32_t offset = 0;
+  uint32_t packets = 0;
+  while (offset + 12 <= file.size ())
+    {
+      uint32_t type, total;
+      std::memcpy (&type, &file[offset], 4);
+      std::memcpy (&total, &file[offset + 4], 4);
+      NS_TEST_ASSERT_MSG_GT_OR_EQ (total, 12, "Bad block length in " << pcapNgName);
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (offset + total, file.size (), "Truncated block in " << pcapNgName);
+      if (type == 6)
+        {
+          ++packets;
+        }
+      offset += total;
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset, file.size (), "Trailing bytes in " << pcapNgName);
+  NS_TEST_ASSERT_MSG_EQ (packets, nPackets, "Wrong number of packets in " << pcapNgName);
+#endif
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1138,6 +1430,10 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BlockWriterTestCase (false), TestCase::QUICK);
+  AddTestCase (new BlockWriterTestCase (true), TestCase::QUICK);
+  AddTestCase (new PcapNgTestCase, TestCase::QUICK);
+  AddTestCase (new BlockWriterFatalTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
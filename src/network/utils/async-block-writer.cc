@@ -0,0 +1,369 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-block-writer.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/core-config.h"
+#include "ns3/fatal-impl.h"
+
+#include <algorithm>
+#include <list>
+#include <map>
+
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncBlockWriter");
+
+#ifdef HAVE_PTHREAD_H
+
+namespace {
+
+/**
+ * The thread writing the blocks of all the asynchronous block writers.
+ *
+ * The thread is started by the first asynchronous writer and stopped
+ * when the last one is destroyed.  Block writers are only created and
+ * destroyed by the simulation thread.
+ */
+class WriterThread
+{
+public:
+  /** Register a block writer, starting the thread if needed. */
+  static void Acquire (void);
+  /** Unregister a block writer, stopping the thread after the last one. */
+  static void Release (void);
+  /** \returns The writer thread, which must have been acquired. */
+  static WriterThread * Get (void);
+
+  /**
+   * Queue a block for writing.
+   * \param [in] owner The block writer.
+   * \param [in] os The stream to write to.
+   * \param [in] block The block, which is deleted once written.
+   * \param [in] size The number of bytes to write.
+   */
+  void Submit (const AsyncBlockWriter *owner, std::ostream *os,
+               std::vector<uint8_t> *block, uint32_t size);
+  /**
+   * Wait until all the blocks of a writer are written.
+   * \param [in] owner The block writer.
+   */
+  void Wait (const AsyncBlockWriter *owner);
+
+private:
+  WriterThread ();
+  /** Stop the thread, after writing all the queued blocks. */
+  void Stop (void);
+  /** The thread main loop. */
+  void Run (void);
+
+  /** A block to write. */
+  struct Job
+  {
+    const AsyncBlockWriter *owner;      //!< The block writer
+    std::ostream *os;                   //!< The stream
+    std::vector<uint8_t> *block;        //!< The block
+    uint32_t size;                      //!< The bytes to write
+  };
+
+  SystemMutex m_mutex;                  //!< Protects the queue and counters
+  SystemCondition m_work;               //!< Set when a job is queued
+  SystemCondition m_done;               //!< Set when a job is done
+  std::list<Job> m_queue;               //!< The blocks to write
+  /** The number of blocks queued or being written, by writer. */
+  std::map<const AsyncBlockWriter *, uint32_t> m_pending;
+  bool m_stop;                          //!< Stop when the queue is empty
+  Ptr<SystemThread> m_thread;           //!< The thread
+
+  static WriterThread *g_thread;        //!< The writer thread
+  static uint32_t g_users;              //!< The number of registered writers
+};
+
+WriterThread *WriterThread::g_thread = 0;
+uint32_t WriterThread::g_users = 0;
+
+void
+WriterThread::Acquire (void)
+{
+  if (g_users++ == 0)
+    {
+      g_thread = new WriterThread ();
+    }
+}
+
+WriterThread *
+WriterThread::Get (void)
+{
+  NS_ASSERT (g_thread != 0);
+  return g_thread;
+}
+
+void
+WriterThread::Release (void)
+{
+  NS_ASSERT (g_users > 0);
+  if (--g_users == 0)
+    {
+      g_thread->Stop ();
+      delete g_thread;
+      g_thread = 0;
+    }
+}
+
+WriterThread::WriterThread ()
+  : m_stop (false)
+{
+  m_thread = Create<SystemThread> (MakeCallback (&WriterThread::Run, this));
+  m_thread->Start ();
+}
+
+void
+WriterThread::Stop (void)
+{
+  {
+    CriticalSection cs (m_mutex);
+    m_stop = true;
+  }
+  m_work.SetCondition (true);
+  m_work.Signal ();
+  m_thread->Join ();
+}
+
+void
+WriterThread::Submit (const AsyncBlockWriter *owner, std::ostream *os,
+                      std::vector<uint8_t> *block, uint32_t size)
+{
+  Job job;
+  job.owner = owner;
+  job.os = os;
+  job.block = block;
+  job.size = size;
+  {
+    CriticalSection cs (m_mutex);
+    m_queue.push_back (job);
+    m_pending[owner]++;
+  }
+  m_work.SetCondition (true);
+  m_work.Signal ();
+}
+
+void
+WriterThread::Wait (const AsyncBlockWriter *owner)
+{
+  for (;;)
+    {
+      // Reset the condition before checking, so that no completion is missed
+      m_done.SetCondition (false);
+      {
+        CriticalSection cs (m_mutex);
+        std::map<const AsyncBlockWriter *, uint32_t>::iterator i = m_pending.find (owner);
+        if (i == m_pending.end () || i->second == 0)
+          {
+            if (i != m_pending.end ())
+              {
+                m_pending.erase (i);
+              }
+            return;
+          }
+      }
+      m_done.TimedWait (1000000000);
+    }
+}
+
+void
+WriterThread::Run (void)
+{
+  for (;;)
+    {
+      m_work.SetCondition (false);
+      Job job;
+      bool have = false;
+      bool stop;
+      {
+        CriticalSection cs (m_mutex);
+        if (!m_queue.empty ())
+          {
+            job = m_queue.front ();
+            m_queue.pop_front ();
+            have = true;
+          }
+        stop = m_stop;
+      }
+      if (!have)
+        {
+          if (stop)
+            {
+              return;
+            }
+          m_work.TimedWait (1000000000);
+          continue;
+        }
+
+      job.os->write (reinterpret_cast<const char *> (&(*job.block)[0]), job.size);
+      delete job.block;
+      {
+        CriticalSection cs (m_mutex);
+        m_pending[job.owner]--;
+      }
+      m_done.SetCondition (true);
+      m_done.Broadcast ();
+    }
+}
+
+} // unnamed namespace
+
+#endif /* HAVE_PTHREAD_H */
+
+namespace {
+
+/**
+ * The block writers which exist, to flush on fatal errors, or 0 if none.
+ * A plain pointer is safe to use from the writers destroyed at exit.
+ * Block writers are only created and destroyed by the simulation thread.
+ */
+std::list<AsyncBlockWriter *> *g_writers = 0;
+
+} // unnamed namespace
+
+AsyncBlockWriter::AsyncBlockWriter (std::ostream *os, uint32_t blockSize, bool async)
+  : m_os (os),
+    m_blockSize (std::max (blockSize, (uint32_t)1)),
+    m_async (false),
+    m_block (0),
+    m_used (0)
+{
+  NS_LOG_FUNCTION (this << os << blockSize << async);
+#ifdef HAVE_PTHREAD_H
+  if (async)
+    {
+      WriterThread::Acquire ();
+      m_async = true;
+    }
+#endif
+  if (g_writers == 0)
+    {
+      g_writers = new std::list<AsyncBlockWriter *> ();
+      FatalImpl::RegisterFlushHook (&AsyncBlockWriter::FlushAll);
+    }
+  g_writers->push_back (this);
+}
+
+AsyncBlockWriter::~AsyncBlockWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  delete m_block;
+  g_writers->remove (this);
+  if (g_writers->empty ())
+    {
+      FatalImpl::UnregisterFlushHook (&AsyncBlockWriter::FlushAll);
+      delete g_writers;
+      g_writers = 0;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      WriterThread::Release ();
+    }
+#endif
+}
+
+bool
+AsyncBlockWriter::IsAsync (void) const
+{
+  return m_async;
+}
+
+uint8_t *
+AsyncBlockWriter::Append (uint32_t size)
+{
+  if (m_block != 0 && m_used + size > m_block->size ())
+    {
+      Submit ();
+    }
+  if (m_block == 0)
+    {
+      m_block = new std::vector<uint8_t> (std::max (m_blockSize, size));
+      m_used = 0;
+    }
+  else if (m_used + size > m_block->size ())
+    {
+      // The block was written synchronously and is reused: grow it
+      m_block->resize (m_used + size);
+    }
+  uint8_t *record = &(*m_block)[m_used];
+  m_used += size;
+  return record;
+}
+
+void
+AsyncBlockWriter::Submit (void)
+{
+  NS_LOG_FUNCTION (this << m_used);
+  if (m_block == 0 || m_used == 0)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      WriterThread::Get ()->Submit (this, m_os, m_block, m_used);
+      m_block = 0;
+      m_used = 0;
+      return;
+    }
+#endif
+  m_os->write (reinterpret_cast<const char *> (&(*m_block)[0]), m_used);
+  m_used = 0;
+}
+
+void
+AsyncBlockWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  Submit ();
+#ifdef HAVE_PTHREAD_H
+  if (m_async)
+    {
+      WriterThread::Get ()->Wait (this);
+    }
+#endif
+  m_os->flush ();
+}
+
+void
+AsyncBlockWriter::FlushAll (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  if (g_writers == 0)
+    {
+      return;
+    }
+  for (std::list<AsyncBlockWriter *>::iterator i = g_writers->begin ();
+       i != g_writers->end (); ++i)
+    {
+      (*i)->Flush ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,520 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/type-id.h"
+#include "ns3/packet.h"
+#include "ns3/buffer.h"
+#include "ns3/chunk.h"
+#include "binary-trace-file.h"
+
+#ifdef NS3_ZLIB
+#include <zlib.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+namespace {
+
+/**
+ * The file starts with this magic string and a version number, followed
+ * by a flags byte.  The rest of the file is a sequence of blocks, each
+ * starting with its uncompressed and stored sizes as 32 bit little
+ * endian integers.  Once uncompressed, a block is a sequence of records
+ * which start with a record type byte:
+ *
+ *   - STRING_RECORD, id, length, bytes: define an entry of the string table.
+ *   - '+', '-', 'd' or 'r': a trace record, followed by the time
+ *     difference with the previous record in nanoseconds (zigzag
+ *     encoded), the context string id (0 for no context), the number
+ *     of packet items, and the items.  Each item starts with a byte
+ *     holding its type and the FRAGMENT_FLAG.  Headers and trailers are
+ *     followed by their name string id.  Fragments are followed by
+ *     their start and size, whole payloads by their size, and whole
+ *     headers and trailers by their size and serialized bytes.
+ *
+ * All the integers in the blocks are unsigned LEB128 varints.
+ */
+const char MAGIC[] = "NS3BTRC";
+const uint8_t VERSION = 1;                      /**< File format version */
+const uint8_t COMPRESSED_FLAG = 1;              /**< The blocks are compressed */
+const uint8_t STRING_RECORD = 'S';              /**< String table record */
+const uint8_t FRAGMENT_FLAG = 0x80;             /**< Item is a fragment */
+const uint32_t BLOCK_SIZE = 65536;              /**< Uncompressed block size */
+const uint32_t MAX_BLOCK_SIZE = 1 << 30;        /**< Sanity limit when reading */
+
+/**
+ * Write a 32 bit little endian integer.
+ * \param os The output stream.
+ * \param v The value.
+ */
+void
+Write32 (std::ostream *os, uint32_t v)
+{
+  char b[4] = { char (v), char (v >> 8), char (v >> 16), char (v >> 24) };
+  os->write (b, 4);
+}
+
+/**
+ * Read a 32 bit little endian integer.
+ * \param is The input stream.
+ * \param v [out] The value.
+ * \returns false at the end of the stream.
+ */
+bool
+Read32 (std::istream &is, uint32_t &v)
+{
+  uint8_t b[4];
+  if (!is.read (reinterpret_cast<char *> (b), 4))
+    {
+      return false;
+    }
+  v = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+  return true;
+}
+
+} // unnamed namespace
+
+BinaryTraceWriter::BinaryTraceWriter (std::ostream *os, bool compress)
+  : m_os (os),
+    m_compress (false),
+    m_lastNs (0)
+{
+  NS_LOG_FUNCTION (this << os << compress);
+#ifdef NS3_ZLIB
+  m_compress = compress;
+#endif
+  m_os->write (MAGIC, sizeof (MAGIC) - 1);
+  m_os->put (VERSION);
+  m_os->put (m_compress ? COMPRESSED_FLAG : 0);
+  m_block.reserve (BLOCK_SIZE + 1024);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+}
+
+bool
+BinaryTraceWriter::IsCompressed (void) const
+{
+  return m_compress;
+}
+
+void
+BinaryTraceWriter::PutVarint (uint64_t v)
+{
+  while (v >= 0x80)
+    {
+      m_block.push_back ((v & 0x7f) | 0x80);
+      v >>= 7;
+    }
+  m_block.push_back (v);
+}
+
+uint32_t
+BinaryTraceWriter::Intern (std::string const &s)
+{
+  std::map<std::string, uint32_t>::iterator i = m_strings.find (s);
+  if (i != m_strings.end ())
+    {
+      return i->second;
+    }
+  // Id 0 means no string
+  uint32_t id = m_strings.size () + 1;
+  m_strings.insert (std::make_pair (s, id));
+  m_block.push_back (STRING_RECORD);
+  PutVarint (id);
+  PutVarint (s.size ());
+  m_block.insert (m_block.end (), s.begin (), s.end ());
+  return id;
+}
+
+void
+BinaryTraceWriter::Write (char op, int64_t ns, std::string const *context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << op << ns << p);
+  uint32_t contextId = context != 0 ? Intern (*context) : 0;
+  // The string definitions must precede the record
+  uint32_t count = 0;
+  PacketMetadata::ItemIterator i = p->BeginItem ();
+  while (i.HasNext ())
+    {
+      PacketMetadata::Item item = i.Next ();
+      if (item.type != PacketMetadata::Item::PAYLOAD)
+        {
+          Intern (item.tid.GetName ());
+        }
+      ++count;
+    }
+
+  int64_t delta = ns - m_lastNs;
+  m_lastNs = ns;
+  m_block.push_back (op);
+  PutVarint ((delta << 1) ^ (delta >> 63));
+  PutVarint (contextId);
+  PutVarint (count);
+
+  i = p->BeginItem ();
+  while (i.HasNext ())
+    {
+      PacketMetadata::Item item = i.Next ();
+      uint32_t nameId = 0;
+      if (item.type != PacketMetadata::Item::PAYLOAD)
+        {
+          nameId = Intern (item.tid.GetName ());
+        }
+      m_block.push_back (item.type | (item.isFragment ? FRAGMENT_FLAG : 0));
+      if (item.type != PacketMetadata::Item::PAYLOAD)
+        {
+          PutVarint (nameId);
+        }
+      if (item.isFragment)
+        {
+          PutVarint (item.currentTrimedFromStart);
+          PutVarint (item.currentSize);
+        }
+      else if (item.type == PacketMetadata::Item::PAYLOAD)
+        {
+          PutVarint (item.currentSize);
+        }
+      else
+        {
+          PutVarint (item.currentSize);
+          Buffer::Iterator start = item.current;
+          if (item.type == PacketMetadata::Item::TRAILER)
+            {
+              start.Prev (item.currentSize);
+            }
+          uint32_t offset = m_block.size ();
+          m_block.resize (offset + item.currentSize);
+          start.Read (&m_block[offset], item.currentSize);
+        }
+    }
+
+  if (m_block.size () >= BLOCK_SIZE)
+    {
+      WriteBlock ();
+    }
+}
+
+void
+BinaryTraceWriter::WriteBlock (void)
+{
+  NS_LOG_FUNCTION (this << m_block.size ());
+  if (m_block.empty ())
+    {
+      return;
+    }
+  const uint8_t *data = &m_block[0];
+  uint32_t size = m_block.size ();
+#ifdef NS3_ZLIB
+  if (m_compress)
+    {
+      uLongf compressedSize = compressBound (m_block.size ());
+      m_compressed.resize (compressedSize);
+      int status = compress2 (&m_compressed[0], &compressedSize,
+                              &m_block[0], m_block.size (), Z_BEST_SPEED);
+      NS_ABORT_MSG_IF (status != Z_OK, "BinaryTraceWriter: compression failed (" << status << ")");
+      data = &m_compressed[0];
+      size = compressedSize;
+    }
+#endif
+  Write32 (m_os, m_block.size ());
+  Write32 (m_os, size);
+  m_os->write (reinterpret_cast<const char *> (data), size);
+  m_block.clear ();
+}
+
+void
+BinaryTraceWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  WriteBlock ();
+  m_os->flush ();
+}
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_compressed (false),
+    m_offset (0),
+    m_lastNs (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+BinaryTraceReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  char magic[sizeof (MAGIC) + 1];
+  if (!m_file.read (magic, sizeof (magic))
+      || std::memcmp (magic, MAGIC, sizeof (MAGIC) - 1) != 0
+      || magic[sizeof (MAGIC) - 1] != VERSION)
+    {
+      NS_LOG_WARN ("Not a binary trace file: " << filename);
+      return false;
+    }
+  m_compressed = (magic[sizeof (MAGIC)] & COMPRESSED_FLAG) != 0;
+#ifndef NS3_ZLIB
+  if (m_compressed)
+    {
+      NS_LOG_WARN ("Compressed binary trace, but zlib is not available: " << filename);
+      return false;
+    }
+#endif
+  m_block.clear ();
+  m_offset = 0;
+  m_strings.clear ();
+  m_lastNs = 0;
+  return true;
+}
+
+bool
+BinaryTraceReader::ReadBlock (void)
+{
+  uint32_t rawSize, storedSize;
+  if (!Read32 (m_file, rawSize) || !Read32 (m_file, storedSize)
+      || rawSize > MAX_BLOCK_SIZE || storedSize > MAX_BLOCK_SIZE)
+    {
+      return false;
+    }
+  std::vector<uint8_t> stored (storedSize);
+  if (storedSize > 0 && !m_file.read (reinterpret_cast<char *> (&stored[0]), storedSize))
+    {
+      return false;
+    }
+  m_offset = 0;
+  if (!m_compressed)
+    {
+      m_block.swap (stored);
+      return !m_block.empty ();
+    }
+#ifdef NS3_ZLIB
+  m_block.resize (rawSize);
+  uLongf size = rawSize;
+  if (rawSize == 0
+      || uncompress (&m_block[0], &size, &stored[0], storedSize) != Z_OK
+      || size != rawSize)
+    {
+      return false;
+    }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool
+BinaryTraceReader::GetVarint (uint64_t &v)
+{
+  v = 0;
+  for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+      if (m_offset >= m_block.size ())
+        {
+          return false;
+        }
+      uint8_t b = m_block[m_offset++];
+      v |= (uint64_t)(b & 0x7f) << shift;
+      if ((b & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+BinaryTraceReader::GetString (uint64_t id, std::string &s) const
+{
+  if (id == 0 || id > m_strings.size ())
+    {
+      return false;
+    }
+  s = m_strings[id - 1];
+  return true;
+}
+
+bool
+BinaryTraceReader::Read (Record &record)
+{
+  for (;;)
+    {
+      if (m_offset >= m_block.size () && !ReadBlock ())
+        {
+          return false;
+        }
+      uint8_t type = m_block[m_offset++];
+      if (type == STRING_RECORD)
+        {
+          uint64_t id, size;
+          if (!GetVarint (id) || !GetVarint (size) || id != m_strings.size () + 1
+              || size > m_block.size () - m_offset)
+            {
+              return false;
+            }
+          m_strings.push_back (std::string (m_block.begin () + m_offset,
+                                            m_block.begin () + m_offset + size));
+          m_offset += size;
+          continue;
+        }
+
+      uint64_t delta, contextId, count;
+      if (!GetVarint (delta) || !GetVarint (contextId) || !GetVarint (count))
+        {
+          return false;
+        }
+      m_lastNs += (int64_t)(delta >> 1) ^ -(int64_t)(delta & 1);
+      record.op = type;
+      record.ns = m_lastNs;
+      record.hasContext = contextId != 0;
+      record.context.clear ();
+      if (record.hasContext && !GetString (contextId, record.context))
+        {
+          return false;
+        }
+      record.items.clear ();
+      for (uint64_t j = 0; j < count; ++j)
+        {
+          if (m_offset >= m_block.size ())
+            {
+              return false;
+            }
+          uint8_t flags = m_block[m_offset++];
+          Item item;
+          item.isFragment = (flags & FRAGMENT_FLAG) != 0;
+          item.trimmedFromStart = 0;
+          switch (flags & ~FRAGMENT_FLAG)
+            {
+            case PacketMetadata::Item::PAYLOAD:
+              item.type = Item::PAYLOAD;
+              break;
+            case PacketMetadata::Item::HEADER:
+              item.type = Item::HEADER;
+              break;
+            case PacketMetadata::Item::TRAILER:
+              item.type = Item::TRAILER;
+              break;
+            default:
+              return false;
+            }
+          uint64_t v;
+          if (item.type != Item::PAYLOAD)
+            {
+              if (!GetVarint (v) || !GetString (v, item.name))
+                {
+                  return false;
+                }
+            }
+          if (item.isFragment)
+            {
+              if (!GetVarint (v))
+                {
+                  return false;
+                }
+              item.trimmedFromStart = v;
+            }
+          if (!GetVarint (v))
+            {
+              return false;
+            }
+          item.size = v;
+          if (!item.isFragment && item.type != Item::PAYLOAD)
+            {
+              if (item.size > m_block.size () - m_offset)
+                {
+                  return false;
+                }
+              item.data.assign (m_block.begin () + m_offset,
+                                m_block.begin () + m_offset + item.size);
+              m_offset += item.size;
+            }
+          record.items.push_back (item);
+        }
+      return true;
+    }
+}
+
+void
+BinaryTraceReader::PrintAscii (std::ostream &os, Record const &record)
+{
+  os << record.op << " " << NanoSeconds (record.ns).GetSeconds () << " ";
+  if (record.hasContext)
+    {
+      os << record.context << " ";
+    }
+  // Same format as Packet::Print
+  for (std::vector<Item>::const_iterator i = record.items.begin ();
+       i != record.items.end (); ++i)
+    {
+      if (i->isFragment)
+        {
+          os << (i->type == Item::PAYLOAD ? std::string ("Payload") : i->name)
+             << " Fragment [" << i->trimmedFromStart << ":"
+             << (i->trimmedFromStart + i->size) << "]";
+        }
+      else if (i->type == Item::PAYLOAD)
+        {
+          os << "Payload (size=" << i->size << ")";
+        }
+      else
+        {
+          os << i->name << " (";
+          TypeId tid;
+          Chunk *chunk = 0;
+          if (TypeId::LookupByNameFailSafe (i->name, &tid) && tid.HasConstructor ())
+            {
+              ObjectBase *instance = tid.GetConstructor () ();
+              chunk = dynamic_cast<Chunk *> (instance);
+              if (chunk == 0)
+                {
+                  delete instance;
+                }
+            }
+          if (chunk != 0)
+            {
+              Buffer buffer;
+              buffer.AddAtStart (i->size);
+              if (i->size > 0)
+                {
+                  buffer.Begin ().Write (&i->data[0], i->size);
+                }
+              chunk->Deserialize (i->type == Item::HEADER ? buffer.Begin () : buffer.End ());
+              chunk->Print (os);
+              delete chunk;
+            }
+          else
+            {
+              os << "?";
+            }
+          os << ")";
+        }
+      if (i + 1 != record.items.end ())
+        {
+          os << " ";
+        }
+    }
+  os << std::endl;
+}
+
+} // namespace ns3
@@ -49,6 +49,8 @@ OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
 OutputStreamWrapper::~OutputStreamWrapper ()
 {
   NS_LOG_FUNCTION (this);
+  // Write the last binary records before the stream is deleted
+  m_binary = 0;
   FatalImpl::UnregisterStream (m_ostream);
   if (m_destroyable) delete m_ostream;
   m_ostream = 0;
@@ -61,4 +63,18 @@ OutputStreamWrapper::GetStream (void)
   return m_ostream;
 }
 
+void
+OutputStreamWrapper::EnableBinaryTrace (bool compress)
+{
+  NS_LOG_FUNCTION (this << compress);
+  NS_ABORT_MSG_IF (m_binary != 0, "OutputStreamWrapper::EnableBinaryTrace(): already enabled");
+  m_binary = Create<BinaryTraceWriter> (m_ostream, compress);
+}
+
+Ptr<BinaryTraceWriter>
+OutputStreamWrapper::GetBinaryTraceWriter (void) const
+{
+  return m_binary;
+}
+
 } // namespace ns3
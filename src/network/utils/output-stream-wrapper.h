@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "binary-trace-file.h"
 
 namespace ns3 {
 
@@ -92,9 +93,25 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * Write the default ascii trace sink records in binary instead of text.
+   *
+   * The default sinks of AsciiTraceHelper then write to the returned
+   * BinaryTraceWriter.  Sinks writing text with GetStream () must not be
+   * connected to a binary stream.
+   *
+   * \param compress Whether to compress the records, if zlib is available.
+   */
+  void EnableBinaryTrace (bool compress);
+  /**
+   * \returns the binary trace writer, or 0 if the stream is a text stream.
+   */
+  Ptr<BinaryTraceWriter> GetBinaryTraceWriter (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  Ptr<BinaryTraceWriter> m_binary; //!< The binary trace writer, if enabled
 };
 
 } // namespace ns3
@@ -18,6 +18,7 @@
 
 #include "ns3/log.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
 #include "pcap-file-wrapper.h"
@@ -40,12 +41,25 @@ PcapFileWrapper::GetTypeId (void)
                    UintegerValue (PcapFile::SNAPLEN_DEFAULT),
                    MakeUintegerAccessor (&PcapFileWrapper::m_snapLen),
                    MakeUintegerChecker<uint32_t> (0, PcapFile::SNAPLEN_DEFAULT))
+    .AddAttribute ("Asynchronous",
+                   "Buffer the packet records in blocks written by a "
+                   "background thread, instead of writing each record "
+                   "to the file",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_async),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BlockSize",
+                   "Size of the blocks written in asynchronous mode, in bytes",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_blockSize),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_interface (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -61,6 +75,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->Fail ();
+    }
   return m_file.Fail ();
 }
 bool 
@@ -80,6 +98,8 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  // The shared pcapng file is closed by its last user
+  m_ngFile = 0;
   m_file.Close ();
 }
 
@@ -90,6 +110,14 @@ PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
   m_file.Open (filename, mode);
 }
 
+void
+PcapFileWrapper::Open (Ptr<PcapNgFile> file, std::string const &interfaceName)
+{
+  NS_LOG_FUNCTION (this << file << interfaceName);
+  m_ngFile = file;
+  m_interfaceName = interfaceName;
+}
+
 void
 PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrection)
 {
@@ -99,20 +127,35 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
-  if (snapLen != std::numeric_limits<uint32_t>::max ())
+  if (snapLen == std::numeric_limits<uint32_t>::max ())
     {
-      m_file.Init (dataLinkType, snapLen, tzCorrection);
-    } 
-  else
+      snapLen = m_snapLen;
+    }
+  if (m_ngFile != 0)
     {
-      m_file.Init (dataLinkType, m_snapLen, tzCorrection);
-    } 
+      if (m_async)
+        {
+          m_ngFile->EnableBlockWriter (m_blockSize, true);
+        }
+      m_interface = m_ngFile->AddInterface (m_interfaceName, dataLinkType, snapLen);
+      return;
+    }
+  m_file.Init (dataLinkType, snapLen, tzCorrection);
+  if (m_async)
+    {
+      m_file.EnableBlockWriter (m_blockSize, true);
+    }
 }
 
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_interface, t.GetNanoSeconds (), p);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -124,6 +167,11 @@ void
 PcapFileWrapper::Write (Time t, Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_interface, t.GetNanoSeconds (), header, p);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -135,6 +183,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_interface, t.GetNanoSeconds (), buffer, length);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcap-ng-file.h"
 
 namespace ns3 {
 
@@ -77,6 +78,17 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Write to an interface of a shared pcapng file instead of a pcap file.
+   * The interface is added to \p file by Init ().  Only the Write methods
+   * can be used with a multiplexed file; the pcap header accessors
+   * return unspecified values.
+   *
+   * \param file The pcapng file, which must be open.
+   * \param interfaceName The name of the interface in \p file.
+   */
+  void Open (Ptr<PcapNgFile> file, std::string const &interfaceName);
+
   /**
    * Close the underlying pcap file.
    */
@@ -215,6 +227,11 @@ public:
 private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
+  bool m_async; //!< write from a background thread
+  uint32_t m_blockSize; //!< size of the blocks written
+  Ptr<PcapNgFile> m_ngFile; //!< shared pcapng file, if multiplexed
+  std::string m_interfaceName; //!< interface name in the pcapng file
+  uint32_t m_interface; //!< interface id in the pcapng file
 };
 
 } // namespace ns3
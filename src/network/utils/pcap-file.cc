@@ -27,6 +27,7 @@
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "async-block-writer.h"
 #include "ns3/log.h"
 //
 // This file is used as part of the ns-3 test framework, so please refrain from 
@@ -48,7 +49,8 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 
 PcapFile::PcapFile ()
   : m_file (),
-    m_swapMode (false)
+    m_swapMode (false),
+    m_writer (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file);
@@ -58,6 +60,7 @@ PcapFile::~PcapFile ()
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::UnregisterStream (&m_file);
+  delete m_writer;
   Close ();
 }
 
@@ -66,6 +69,11 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      // Don't read the stream state while the writer thread may write
+      m_writer->Flush ();
+    }
   return m_file.fail ();
 }
 bool 
@@ -86,6 +94,8 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  delete m_writer;
+  m_writer = 0;
   m_file.close ();
 }
 
@@ -370,6 +380,16 @@ PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrect
   WriteFileHeader ();
 }
 
+void
+PcapFile::EnableBlockWriter (uint32_t blockSize, bool async)
+{
+  NS_LOG_FUNCTION (this << blockSize << async);
+  NS_ASSERT_MSG (m_writer == 0, "PcapFile::EnableBlockWriter(): block writer already enabled");
+  // Write the file header before the records go through the blocks
+  m_file.flush ();
+  m_writer = new AsyncBlockWriter (&m_file, blockSize, async);
+}
+
 uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
@@ -400,10 +420,51 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   return inclLen;
 }
 
+uint8_t *
+PcapFile::AppendPacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen,
+                              uint32_t &inclLen)
+{
+  NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
+  NS_ASSERT (m_writer != 0);
+
+  inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
+
+  PcapRecordHeader header;
+  header.m_tsSec = tsSec;
+  header.m_tsUsec = tsUsec;
+  header.m_inclLen = inclLen;
+  header.m_origLen = totalLen;
+
+  if (m_swapMode)
+    {
+      Swap (&header, &header);
+    }
+
+  uint8_t *record = m_writer->Append (sizeof (header.m_tsSec) + sizeof (header.m_tsUsec)
+                                      + sizeof (header.m_inclLen) + sizeof (header.m_origLen)
+                                      + inclLen);
+  std::memcpy (record, &header.m_tsSec, sizeof (header.m_tsSec));
+  record += sizeof (header.m_tsSec);
+  std::memcpy (record, &header.m_tsUsec, sizeof (header.m_tsUsec));
+  record += sizeof (header.m_tsUsec);
+  std::memcpy (record, &header.m_inclLen, sizeof (header.m_inclLen));
+  record += sizeof (header.m_inclLen);
+  std::memcpy (record, &header.m_origLen, sizeof (header.m_origLen));
+  record += sizeof (header.m_origLen);
+  return record;
+}
+
 void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
+  if (m_writer != 0)
+    {
+      uint32_t inclLen;
+      uint8_t *record = AppendPacketHeader (tsSec, tsUsec, totalLen, inclLen);
+      std::memcpy (record, data, inclLen);
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
   m_file.write ((const char *)data, inclLen);
 }
@@ -412,6 +473,13 @@ void
 PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
+  if (m_writer != 0)
+    {
+      uint32_t inclLen;
+      uint8_t *record = AppendPacketHeader (tsSec, tsUsec, p->GetSize (), inclLen);
+      p->CopyData (record, inclLen);
+      return;
+    }
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
   p->CopyData (&m_file, inclLen);
 }
@@ -422,11 +490,22 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Header &header, Ptr<const Pack
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &header << p);
   uint32_t headerSize = header.GetSerializedSize ();
   uint32_t totalSize = headerSize + p->GetSize ();
-  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
 
   Buffer headerBuffer;
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
+
+  if (m_writer != 0)
+    {
+      uint32_t inclLen;
+      uint8_t *record = AppendPacketHeader (tsSec, tsUsec, totalSize, inclLen);
+      uint32_t toCopy = std::min (headerSize, inclLen);
+      headerBuffer.CopyData (record, toCopy);
+      p->CopyData (record + toCopy, inclLen - toCopy);
+      return;
+    }
+
+  uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalSize);
   uint32_t toCopy = std::min (headerSize, inclLen);
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
@@ -30,6 +30,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class AsyncBlockWriter;
 
 
 /**
@@ -50,6 +51,9 @@ public:
   ~PcapFile ();
 
   /**
+   * The records buffered by the block writer, if enabled, are written
+   * first, so that write errors are reported.
+   *
    * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
    */
   bool Fail (void) const;
@@ -85,6 +89,18 @@ public:
    */
   void Close (void);
 
+  /**
+   * Buffer the packet records in large blocks instead of writing each
+   * record to the file directly.  Must be called after Init ().  The
+   * blocks are written when full and when the file is closed.
+   *
+   * \param blockSize The minimum size of the blocks, in bytes.
+   * \param async If true, the blocks are written by a background thread
+   * (when threads are available), so that file I/O does not slow down the
+   * simulation.
+   */
+  void EnableBlockWriter (uint32_t blockSize, bool async);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -343,6 +359,16 @@ private:
    * \returns the length of the packet to write in the Pcap file
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * \brief Append a Pcap packet header to the current block
+   * \param tsSec Time stamp (seconds part)
+   * \param tsUsec Time stamp (microseconds part)
+   * \param totalLen total packet length
+   * \param inclLen [out] the length of the packet to write in the Pcap file
+   * \returns the address where the packet data must be written
+   */
+  uint8_t * AppendPacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen,
+                                uint32_t &inclLen);
 
   /**
    * \brief Read and verify a Pcap file header
@@ -353,6 +379,7 @@ private:
   std::fstream   m_file;        //!< file stream
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
+  AsyncBlockWriter *m_writer;   //!< block writer, if enabled
 };
 
 } // namespace ns3
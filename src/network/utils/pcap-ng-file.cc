@@ -0,0 +1,266 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "ns3/fatal-impl.h"
+#include "pcap-ng-file.h"
+#include "async-block-writer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgFile");
+
+namespace {
+
+const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;     /**< Section header block type */
+const uint32_t INTERFACE_DESCRIPTION_BLOCK = 1;       /**< Interface description block type */
+const uint32_t ENHANCED_PACKET_BLOCK = 6;             /**< Enhanced packet block type */
+const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;         /**< Section header byte order magic */
+const uint16_t OPT_ENDOFOPT = 0;                      /**< End of options */
+const uint16_t OPT_IF_NAME = 2;                       /**< Interface name option */
+const uint16_t OPT_IF_TSRESOL = 9;                    /**< Timestamp resolution option */
+const uint32_t DEFAULT_BLOCK_SIZE = 65536;            /**< Block size before EnableBlockWriter () */
+
+/**
+ * \param len A length, in bytes.
+ * \returns \p len rounded up to a multiple of 4.
+ */
+inline uint32_t
+Pad (uint32_t len)
+{
+  return (len + 3) & ~3U;
+}
+
+/**
+ * Write a 32 bit value in host byte order.
+ * \param [in,out] p The write position, advanced past the value.
+ * \param [in] v The value.
+ */
+inline void
+Put32 (uint8_t *&p, uint32_t v)
+{
+  std::memcpy (p, &v, 4);
+  p += 4;
+}
+
+/**
+ * Write a 16 bit value in host byte order.
+ * \param [in,out] p The write position, advanced past the value.
+ * \param [in] v The value.
+ */
+inline void
+Put16 (uint8_t *&p, uint16_t v)
+{
+  std::memcpy (p, &v, 2);
+  p += 2;
+}
+
+} // unnamed namespace
+
+PcapNgFile::PcapNgFile ()
+  : m_writer (0),
+    m_blockWriterEnabled (false)
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::RegisterStream (&m_file);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+  FatalImpl::UnregisterStream (&m_file);
+  Close ();
+}
+
+void
+PcapNgFile::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT_MSG (!m_file.is_open (), "PcapNgFile::Open(): File already open");
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (m_file.fail ())
+    {
+      return;
+    }
+  m_writer = new AsyncBlockWriter (&m_file, DEFAULT_BLOCK_SIZE, false);
+  m_blockWriterEnabled = false;
+  m_snapLen.clear ();
+
+  uint8_t *p = m_writer->Append (28);
+  Put32 (p, SECTION_HEADER_BLOCK);
+  Put32 (p, 28);
+  Put32 (p, BYTE_ORDER_MAGIC);
+  Put16 (p, 1);
+  Put16 (p, 0);
+  // Unknown section length
+  Put32 (p, 0xffffffff);
+  Put32 (p, 0xffffffff);
+  Put32 (p, 28);
+}
+
+void
+PcapNgFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  delete m_writer;
+  m_writer = 0;
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  if (m_writer != 0)
+    {
+      // Don't read the stream state while the writer thread may write
+      m_writer->Flush ();
+    }
+  return m_file.fail ();
+}
+
+void
+PcapNgFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      m_writer->Flush ();
+    }
+}
+
+void
+PcapNgFile::EnableBlockWriter (uint32_t blockSize, bool async)
+{
+  NS_LOG_FUNCTION (this << blockSize << async);
+  NS_ASSERT_MSG (m_writer != 0, "PcapNgFile::EnableBlockWriter(): File not open");
+  if (m_blockWriterEnabled)
+    {
+      return;
+    }
+  m_blockWriterEnabled = true;
+  delete m_writer;
+  m_writer = new AsyncBlockWriter (&m_file, blockSize, async);
+}
+
+uint32_t
+PcapNgFile::AddInterface (std::string const &name, uint32_t dataLinkType, uint32_t snapLen)
+{
+  NS_LOG_FUNCTION (this << name << dataLinkType << snapLen);
+  NS_ASSERT_MSG (m_writer != 0, "PcapNgFile::AddInterface(): File not open");
+
+  uint32_t nameLen = name.size ();
+  // Header, link type and snap length, options, trailer
+  uint32_t total = 8 + 8 + (4 + Pad (nameLen)) + (4 + 4) + 4 + 4;
+  uint8_t *p = m_writer->Append (total);
+  Put32 (p, INTERFACE_DESCRIPTION_BLOCK);
+  Put32 (p, total);
+  Put16 (p, dataLinkType);
+  Put16 (p, 0);
+  Put32 (p, snapLen);
+  Put16 (p, OPT_IF_NAME);
+  Put16 (p, nameLen);
+  std::memset (p, 0, Pad (nameLen));
+  std::memcpy (p, name.data (), nameLen);
+  p += Pad (nameLen);
+  // Timestamps in nanoseconds: the option value is a single byte,
+  // padded to 32 bits, which doesn't depend on the section byte order
+  Put16 (p, OPT_IF_TSRESOL);
+  Put16 (p, 1);
+  std::memset (p, 0, 4);
+  p[0] = 9;
+  p += 4;
+  Put16 (p, OPT_ENDOFOPT);
+  Put16 (p, 0);
+  Put32 (p, total);
+
+  m_snapLen.push_back (snapLen);
+  return m_snapLen.size () - 1;
+}
+
+uint32_t
+PcapNgFile::GetInterfaceCount (void) const
+{
+  return m_snapLen.size ();
+}
+
+uint8_t *
+PcapNgFile::AppendPacketBlock (uint32_t interface, uint64_t ns, uint32_t totalLen,
+                               uint32_t &inclLen)
+{
+  NS_ASSERT_MSG (interface < m_snapLen.size (), "PcapNgFile::Write(): Unknown interface " << interface);
+  NS_ASSERT (m_writer != 0);
+  inclLen = std::min (totalLen, m_snapLen[interface]);
+
+  uint32_t total = 28 + Pad (inclLen) + 4;
+  uint8_t *p = m_writer->Append (total);
+  Put32 (p, ENHANCED_PACKET_BLOCK);
+  Put32 (p, total);
+  Put32 (p, interface);
+  Put32 (p, ns >> 32);
+  Put32 (p, ns & 0xffffffff);
+  Put32 (p, inclLen);
+  Put32 (p, totalLen);
+  // Padding and trailer
+  std::memset (p + inclLen, 0, Pad (inclLen) - inclLen);
+  uint8_t *trailer = p + Pad (inclLen);
+  Put32 (trailer, total);
+  return p;
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t ns, uint8_t const *data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interface << ns << &data << totalLen);
+  uint32_t inclLen;
+  uint8_t *p = AppendPacketBlock (interface, ns, totalLen, inclLen);
+  std::memcpy (p, data, inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t ns, Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << interface << ns << packet);
+  uint32_t inclLen;
+  uint8_t *p = AppendPacketBlock (interface, ns, packet->GetSize (), inclLen);
+  packet->CopyData (p, inclLen);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, uint64_t ns, Header &header, Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << interface << ns << &header << packet);
+  uint32_t headerSize = header.GetSerializedSize ();
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+
+  uint32_t inclLen;
+  uint8_t *p = AppendPacketBlock (interface, ns, headerSize + packet->GetSize (), inclLen);
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (p, toCopy);
+  packet->CopyData (p + toCopy, inclLen - toCopy);
+}
+
+} // namespace ns3
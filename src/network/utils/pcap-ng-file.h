@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_NG_FILE_H
+#define PCAP_NG_FILE_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+class AsyncBlockWriter;
+
+/**
+ * \brief A pcapng file, in which the packets of several interfaces are
+ * multiplexed.
+ *
+ * Each traced device is declared as an interface, with its own data link
+ * type and snap length, and its packets are stored as enhanced packet
+ * blocks with nanosecond timestamps.  A single pcapng file replaces the
+ * pcap file per device, which can be thousands of files in large
+ * simulations.  The records are always buffered by an AsyncBlockWriter.
+ *
+ * The file is written in the host byte order, as allowed by the format.
+ * See http://www.tcpdump.org/pcap/pcap.html for the file format.
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+public:
+  PcapNgFile ();
+  /** Close the file. */
+  ~PcapNgFile ();
+
+  /**
+   * Create a new pcapng file and write its section header.
+   *
+   * \param filename The name of the file.
+   */
+  void Open (std::string const &filename);
+  /**
+   * Write the records buffered so far and close the file.
+   */
+  void Close (void);
+  /**
+   * The records buffered so far are written first, so that write
+   * errors are reported.
+   *
+   * \return true if the 'fail' bit is set in the underlying iostream, false otherwise.
+   */
+  bool Fail (void) const;
+  /**
+   * Write the records buffered so far.
+   */
+  void Flush (void);
+
+  /**
+   * Set the block size, and whether the blocks are written by a
+   * background thread.  Records written before are flushed first.
+   * Only the first call after Open () has an effect, so that all the
+   * users of a shared file can request it.
+   *
+   * \param blockSize The minimum size of the blocks, in bytes.
+   * \param async Whether to write the blocks from a background thread.
+   */
+  void EnableBlockWriter (uint32_t blockSize, bool async);
+
+  /**
+   * Add an interface description to the file.
+   *
+   * \param name The interface name, such as the pcap file name of the device.
+   * \param dataLinkType A data link type as defined in the pcap library.
+   * \param snapLen The maximum length of the packets stored for this interface.
+   * \returns The interface id to use when writing packets.
+   */
+  uint32_t AddInterface (std::string const &name, uint32_t dataLinkType, uint32_t snapLen);
+  /** \returns The number of interfaces added so far. */
+  uint32_t GetInterfaceCount (void) const;
+
+  /**
+   * \brief Write the next packet to the file
+   *
+   * \param interface The interface id.
+   * \param ns The packet timestamp, in nanoseconds.
+   * \param data The data buffer.
+   * \param totalLen The total packet length.
+   */
+  void Write (uint32_t interface, uint64_t ns, uint8_t const *data, uint32_t totalLen);
+  /**
+   * \brief Write the next packet to the file
+   *
+   * \param interface The interface id.
+   * \param ns The packet timestamp, in nanoseconds.
+   * \param p The packet to write.
+   */
+  void Write (uint32_t interface, uint64_t ns, Ptr<const Packet> p);
+  /**
+   * \brief Write the next packet to the file
+   *
+   * \param interface The interface id.
+   * \param ns The packet timestamp, in nanoseconds.
+   * \param header The header to write, in front of the packet.
+   * \param p The packet to write.
+   */
+  void Write (uint32_t interface, uint64_t ns, Header &header, Ptr<const Packet> p);
+
+private:
+  /**
+   * Append an enhanced packet block header to the current block.
+   *
+   * \param interface The interface id.
+   * \param ns The packet timestamp, in nanoseconds.
+   * \param totalLen The total packet length.
+   * \param inclLen [out] The length of the packet data to write.
+   * \returns The address where the packet data must be written.
+   */
+  uint8_t * AppendPacketBlock (uint32_t interface, uint64_t ns, uint32_t totalLen,
+                               uint32_t &inclLen);
+
+  std::ofstream m_file;                 //!< The file stream
+  AsyncBlockWriter *m_writer;           //!< The block writer
+  bool m_blockWriterEnabled;            //!< EnableBlockWriter () was called
+  std::vector<uint32_t> m_snapLen;      //!< The snap length of each interface
+};
+
+} // namespace ns3
+
+#endif /* PCAP_NG_FILE_H */
@@ -26,6 +26,7 @@
 #include <ns3/net-device.h>
 #include <ns3/node.h>
 #include <ns3/double.h>
+#include <ns3/boolean.h>
 #include <ns3/mobility-model.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-converter.h>
@@ -76,6 +77,8 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_cacheCouplingLoss (false),
+    m_couplingLossMaxMove (0.0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -89,6 +92,7 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_couplingLossCache.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -113,6 +117,23 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("CacheCouplingLoss",
+                   "If true, the loss due to the antennas and the "
+                   "PropagationLossModel, and the propagation delay, are "
+                   "evaluated once for each pair of TX and RX SpectrumPhy "
+                   "instances, and evaluated again only when either end "
+                   "moves by more than CouplingLossMaxMove.  Only to be "
+                   "used with deterministic PropagationLossModel and "
+                   "PropagationDelayModel instances.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiModelSpectrumChannel::m_cacheCouplingLoss),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CouplingLossMaxMove",
+                   "The distance in meters either end of a link may move "
+                   "before its cached coupling loss is evaluated again.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_couplingLossMaxMove),
+                   MakeDoubleChecker<double> (0.0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -125,9 +146,16 @@ MultiModelSpectrumChannel::GetTypeId (void)
                      "PropagationLossModel. In particular, note that "
                      "SpectrumPropagationLossModel (even if present) "
                      "is never used to evaluate the loss value "
-                     "reported in this trace. ",
+                     "reported in this trace.  With CacheCouplingLoss, "
+                     "the trace is fired only when the loss is evaluated, "
+                     "not when a cached value is used. ",
                      MakeTraceSourceAccessor (&MultiModelSpectrumChannel::m_pathLossTrace),
                      "ns3::SpectrumChannel::LossTracedCallback")
+    .AddTraceSource ("TxSigParams",
+                     "This trace is fired whenever a signal is transmitted "
+                     "on the channel, with the parameters of the signal.",
+                     MakeTraceSourceAccessor (&MultiModelSpectrumChannel::m_txSigParamsTrace),
+                     "ns3::SpectrumChannel::SignalParametersTracedCallback")
   ;
   return tid;
 }
@@ -253,6 +281,7 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_ASSERT (txParams->txPhy);
   NS_ASSERT (txParams->psd);
 
+  m_txSigParamsTrace (txParams);
 
   Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
   SpectrumModelUid_t txSpectrumModelUid = txParams->psd->GetSpectrumModelUid ();
@@ -297,56 +326,49 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
               Time delay = MicroSeconds (0);
+              double pathGainLinear = 1.0;
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
               if (txMobility && receiverMobility)
                 {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
+                  double pathLossDb;
+                  if (m_cacheCouplingLoss)
                     {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
+                      const CouplingLoss &couplingLoss = GetCouplingLoss (txParams, txMobility, *rxPhyIterator, receiverMobility);
+                      pathLossDb = couplingLoss.lossDb;
+                      pathGainLinear = couplingLoss.gainLinear;
+                      delay = couplingLoss.delay;
                     }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
+                  else
                     {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
+                      pathLossDb = CalcPathLossDb (txParams, txMobility, *rxPhyIterator, receiverMobility);
+                      pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+                      if (m_propagationDelay)
+                        {
+                          delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+                        }
                     }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
                   if ( pathLossDb > m_maxLossDb)
                     {
                       // beyond range
                       continue;
                     }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
+                }
+
+              NS_LOG_LOGIC (" copying signal parameters " << txParams);
+              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+
+              if (txMobility && receiverMobility)
+                {
+                  *(rxParams->psd) *= pathGainLinear;
 
                   if (m_spectrumPropagationLoss)
                     {
                       rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
                     }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
                 }
 
               Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
@@ -370,6 +392,76 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
 }
 
+double
+MultiModelSpectrumChannel::CalcPathLossDb (Ptr<const SpectrumSignalParameters> txParams,
+                                           Ptr<MobilityModel> txMobility,
+                                           Ptr<SpectrumPhy> rxPhy,
+                                           Ptr<MobilityModel> rxMobility)
+{
+  double pathLossDb = 0;
+  if (txParams->txAntenna != 0)
+    {
+      Angles txAngles (rxMobility->GetPosition (), txMobility->GetPosition ());
+      double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+      pathLossDb -= txAntennaGain;
+    }
+  Ptr<AntennaModel> rxAntenna = rxPhy->GetRxAntenna ();
+  if (rxAntenna != 0)
+    {
+      Angles rxAngles (txMobility->GetPosition (), rxMobility->GetPosition ());
+      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+      pathLossDb -= rxAntennaGain;
+    }
+  if (m_propagationLoss)
+    {
+      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, rxMobility);
+      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+      pathLossDb -= propagationGainDb;
+    }
+  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+  m_pathLossTrace (txParams->txPhy, rxPhy, pathLossDb);
+  return pathLossDb;
+}
+
+const MultiModelSpectrumChannel::CouplingLoss &
+MultiModelSpectrumChannel::GetCouplingLoss (Ptr<const SpectrumSignalParameters> txParams,
+                                            Ptr<MobilityModel> txMobility,
+                                            Ptr<SpectrumPhy> rxPhy,
+                                            Ptr<MobilityModel> rxMobility)
+{
+  std::pair<Ptr<const SpectrumPhy>, Ptr<const SpectrumPhy> > key (txParams->txPhy, rxPhy);
+  std::map<std::pair<Ptr<const SpectrumPhy>, Ptr<const SpectrumPhy> >, CouplingLoss>::iterator it;
+  it = m_couplingLossCache.find (key);
+  Vector txPosition = txMobility->GetPosition ();
+  Vector rxPosition = rxMobility->GetPosition ();
+  if (it != m_couplingLossCache.end ()
+      && it->second.txAntenna == txParams->txAntenna
+      && CalculateDistance (it->second.txPosition, txPosition) <= m_couplingLossMaxMove
+      && CalculateDistance (it->second.rxPosition, rxPosition) <= m_couplingLossMaxMove)
+    {
+      return it->second;
+    }
+  if (it == m_couplingLossCache.end ())
+    {
+      it = m_couplingLossCache.insert (std::make_pair (key, CouplingLoss ())).first;
+    }
+  NS_LOG_LOGIC ("evaluating the coupling loss from " << txParams->txPhy << " to " << rxPhy);
+  CouplingLoss &couplingLoss = it->second;
+  couplingLoss.txPosition = txPosition;
+  couplingLoss.rxPosition = rxPosition;
+  couplingLoss.txAntenna = txParams->txAntenna;
+  couplingLoss.lossDb = CalcPathLossDb (txParams, txMobility, rxPhy, rxMobility);
+  couplingLoss.gainLinear = std::pow (10.0, (-couplingLoss.lossDb) / 10.0);
+  couplingLoss.delay = MicroSeconds (0);
+  if (m_propagationDelay)
+    {
+      couplingLoss.delay = m_propagationDelay->GetDelay (txMobility, rxMobility);
+    }
+  return couplingLoss;
+}
+
 void
 MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
@@ -443,6 +535,13 @@ MultiModelSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel>
   m_propagationDelay = delay;
 }
 
+Ptr<PropagationLossModel>
+MultiModelSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 Ptr<SpectrumPropagationLossModel>
 MultiModelSpectrumChannel::GetSpectrumPropagationLossModel (void)
 {
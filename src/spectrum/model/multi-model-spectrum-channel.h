@@ -27,6 +27,8 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/antenna-model.h>
+#include <ns3/vector.h>
 #include <map>
 #include <set>
 
@@ -82,6 +84,17 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * With the CacheCouplingLoss attribute, the coupling loss of each pair
+ * of TX and RX SpectrumPhy instances, i.e., the antenna gains and the
+ * loss of the single-frequency PropagationLossModel, and the
+ * propagation delay are evaluated at the first transmission, then
+ * reused as long as neither end moves by more than
+ * CouplingLossMaxMove.  This saves the evaluation of the propagation
+ * models for every receiver at every transmission, and is meant for
+ * static or slowly moving nodes with deterministic propagation models.
+ * The SpectrumPropagationLossModel, which may vary in time (e.g.,
+ * fading), is still evaluated at every transmission.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -103,6 +116,7 @@ public:
   virtual uint32_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
 
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
   virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
 
 
@@ -132,6 +146,53 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Evaluate the loss between a transmitter and a receiver, due to the
+   * antennas and the single-frequency propagation loss model, and fire
+   * the PathLoss trace.
+   *
+   * @param txParams the parameters of the signal being transmitted
+   * @param txMobility the mobility model of the transmitter
+   * @param rxPhy the receiver
+   * @param rxMobility the mobility model of the receiver
+   *
+   * @return the loss in dB
+   */
+  double CalcPathLossDb (Ptr<const SpectrumSignalParameters> txParams,
+                         Ptr<MobilityModel> txMobility,
+                         Ptr<SpectrumPhy> rxPhy,
+                         Ptr<MobilityModel> rxMobility);
+
+  /**
+   * The coupling loss between a transmitter and a receiver, cached
+   * when CacheCouplingLoss is enabled.
+   */
+  struct CouplingLoss
+  {
+    Vector txPosition;                //!< the position of the transmitter
+    Vector rxPosition;                //!< the position of the receiver
+    Ptr<const AntennaModel> txAntenna; //!< the antenna of the transmitter
+    double lossDb;                    //!< the loss in dB
+    double gainLinear;                //!< the linear gain, i.e., the inverse of the loss
+    Time delay;                       //!< the propagation delay
+  };
+
+  /**
+   * Get the cached coupling loss between a transmitter and a receiver,
+   * evaluating it again if either end moved or the TX antenna changed.
+   *
+   * @param txParams the parameters of the signal being transmitted
+   * @param txMobility the mobility model of the transmitter
+   * @param rxPhy the receiver
+   * @param rxMobility the mobility model of the receiver
+   *
+   * @return the coupling loss
+   */
+  const CouplingLoss & GetCouplingLoss (Ptr<const SpectrumSignalParameters> txParams,
+                                        Ptr<MobilityModel> txMobility,
+                                        Ptr<SpectrumPhy> rxPhy,
+                                        Ptr<MobilityModel> rxMobility);
+
 
 
   /**
@@ -173,7 +234,20 @@ private:
 
   double m_maxLossDb;
 
+  /// The coupling losses, indexed by TX and RX SpectrumPhy
+  std::map<std::pair<Ptr<const SpectrumPhy>, Ptr<const SpectrumPhy> >, CouplingLoss> m_couplingLossCache;
+
+  /// If true, the coupling losses are cached in m_couplingLossCache
+  bool m_cacheCouplingLoss;
+
+  /// The distance either end of a link may move, in meters, before its
+  /// cached coupling loss is evaluated again
+  double m_couplingLossMaxMove;
+
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
+
+  /// The `TxSigParams` trace source, fired for each signal transmitted
+  TracedCallback<Ptr<SpectrumSignalParameters> > m_txSigParamsTrace;
 };
 
 
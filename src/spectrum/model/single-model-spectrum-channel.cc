@@ -97,6 +97,11 @@ SingleModelSpectrumChannel::GetTypeId (void)
                      "loss value reported in this trace. ",
                      MakeTraceSourceAccessor (&SingleModelSpectrumChannel::m_pathLossTrace),
                      "ns3::SpectrumChannel::LossTracedCallback")
+    .AddTraceSource ("TxSigParams",
+                     "This trace is fired whenever a signal is transmitted "
+                     "on the channel, with the parameters of the signal.",
+                     MakeTraceSourceAccessor (&SingleModelSpectrumChannel::m_txSigParamsTrace),
+                     "ns3::SpectrumChannel::SignalParametersTracedCallback")
   ;
   return tid;
 }
@@ -117,6 +122,8 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_ASSERT_MSG (txParams->psd, "NULL txPsd");
   NS_ASSERT_MSG (txParams->txPhy, "NULL txPhy");
 
+  m_txSigParamsTrace (txParams);
+
   // just a sanity check routine. We might want to remove it to save some computational load -- one "if" statement  ;-)
   if (m_spectrumModel == 0)
     {
@@ -261,6 +268,13 @@ SingleModelSpectrumChannel::SetPropagationDelayModel (Ptr<PropagationDelayModel>
 }
 
 
+Ptr<PropagationLossModel>
+SingleModelSpectrumChannel::GetPropagationLossModel (void)
+{
+  NS_LOG_FUNCTION (this);
+  return m_propagationLoss;
+}
+
 Ptr<SpectrumPropagationLossModel>
 SingleModelSpectrumChannel::GetSpectrumPropagationLossModel (void)
 {
@@ -61,6 +61,7 @@ public:
 
   typedef std::vector<Ptr<SpectrumPhy> > PhyList;
 
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void);
   virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void);
 
 private:
@@ -110,6 +111,9 @@ private:
   double m_maxLossDb;
 
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
+
+  /// The `TxSigParams` trace source, fired for each signal transmitted
+  TracedCallback<Ptr<SpectrumSignalParameters> > m_txSigParamsTrace;
 };
 
 
@@ -70,6 +70,16 @@ public:
    */
   virtual void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay) = 0;
 
+  /**
+   * \return the single-frequency propagation loss model, or null
+   */
+  virtual Ptr<PropagationLossModel> GetPropagationLossModel (void) = 0;
+
+  /**
+   * \return the frequency-dependent propagation loss model, or null
+   */
+  virtual Ptr<SpectrumPropagationLossModel> GetSpectrumPropagationLossModel (void) = 0;
+
 
   /**
    * Used by attached PHY instances to transmit signals on the channel
@@ -105,6 +115,14 @@ public:
   typedef void (* LossTracedCallback)
     (const Ptr<const SpectrumPhy> txPhy, const Ptr<const SpectrumPhy> rxPhy,
      const double lossDb);
+
+  /**
+   * TracedCallback signature for the signals transmitted on the channel.
+   *
+   * \param [in] params The parameters of the signal.
+   */
+  typedef void (* SignalParametersTracedCallback)
+    (const Ptr<SpectrumSignalParameters> params);
   
 };
 
@@ -0,0 +1,220 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/net-device.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-model-ism2400MHz-res1MHz.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumCouplingLossTest");
+
+/**
+ * \ingroup spectrum
+ *
+ * A SpectrumPhy keeping the PSD of the last signal received.
+ */
+class CouplingLossTestPhy : public SpectrumPhy
+{
+public:
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice ()
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return SpectrumModelIsm2400MhzRes1Mhz;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    m_rxPsd = params->psd;
+  }
+
+  Ptr<MobilityModel> m_mobility; //!< the mobility model
+  Ptr<SpectrumValue> m_rxPsd;    //!< the PSD of the last signal received
+};
+
+
+/**
+ * \ingroup spectrum
+ *
+ * Check that the cached coupling loss of MultiModelSpectrumChannel gives
+ * the received PSD of the uncached evaluation, and is evaluated again
+ * when a node moves.
+ */
+class SpectrumCouplingLossTestCase : public TestCase
+{
+public:
+  SpectrumCouplingLossTestCase ();
+  virtual ~SpectrumCouplingLossTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Transmit a signal and run the simulation until it is received.
+   *
+   * \return the first value of the received PSD
+   */
+  double Transmit (void);
+
+  /**
+   * Trace sink of the path loss evaluations.
+   *
+   * \param txPhy the transmitter
+   * \param rxPhy the receiver
+   * \param lossDb the loss in dB
+   */
+  void PathLoss (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb);
+
+  Ptr<MultiModelSpectrumChannel> m_channel; //!< the channel
+  Ptr<CouplingLossTestPhy> m_txPhy;         //!< the transmitter
+  Ptr<CouplingLossTestPhy> m_rxPhy;         //!< the receiver
+  uint32_t m_pathLossEvaluations;           //!< the path loss evaluations
+};
+
+SpectrumCouplingLossTestCase::SpectrumCouplingLossTestCase ()
+  : TestCase ("Check the cached coupling loss of MultiModelSpectrumChannel"),
+    m_pathLossEvaluations (0)
+{
+}
+
+SpectrumCouplingLossTestCase::~SpectrumCouplingLossTestCase ()
+{
+}
+
+void
+SpectrumCouplingLossTestCase::PathLoss (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb)
+{
+  m_pathLossEvaluations++;
+}
+
+double
+SpectrumCouplingLossTestCase::Transmit (void)
+{
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = Create<SpectrumValue> (SpectrumModelIsm2400MhzRes1Mhz);
+  *(params->psd) = 1e-9;
+  params->txPhy = m_txPhy;
+  params->duration = MilliSeconds (1);
+  m_rxPhy->m_rxPsd = 0;
+  m_channel->StartTx (params);
+  Simulator::Run ();
+  NS_ASSERT (m_rxPhy->m_rxPsd);
+  return (*m_rxPhy->m_rxPsd)[0];
+}
+
+void
+SpectrumCouplingLossTestCase::DoRun (void)
+{
+  Ptr<FriisPropagationLossModel> loss = CreateObject<FriisPropagationLossModel> ();
+  m_channel = CreateObject<MultiModelSpectrumChannel> ();
+  m_channel->AddPropagationLossModel (loss);
+  m_channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  m_channel->SetAttribute ("CacheCouplingLoss", BooleanValue (true));
+  m_channel->SetAttribute ("CouplingLossMaxMove", DoubleValue (10.0));
+  m_channel->TraceConnectWithoutContext ("PathLoss", MakeCallback (&SpectrumCouplingLossTestCase::PathLoss, this));
+
+  Ptr<ConstantPositionMobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> rxMobility = CreateObject<ConstantPositionMobilityModel> ();
+  txMobility->SetPosition (Vector (0.0, 0.0, 0.0));
+  rxMobility->SetPosition (Vector (100.0, 0.0, 0.0));
+  m_txPhy = CreateObject<CouplingLossTestPhy> ();
+  m_txPhy->SetMobility (txMobility);
+  m_rxPhy = CreateObject<CouplingLossTestPhy> ();
+  m_rxPhy->SetMobility (rxMobility);
+  m_channel->AddRx (m_rxPhy);
+
+  // the test macros evaluate their arguments more than once
+  double rxPsd;
+  double gain = std::pow (10.0, loss->CalcRxPower (0, txMobility, rxMobility) / 10.0);
+  rxPsd = Transmit ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPsd, 1e-9 * gain, 1e-9 * gain * 1e-9, "Wrong RX PSD");
+  rxPsd = Transmit ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPsd, 1e-9 * gain, 1e-9 * gain * 1e-9, "Wrong RX PSD with the cached loss");
+  NS_TEST_EXPECT_MSG_EQ (m_pathLossEvaluations, 1, "The coupling loss is not cached");
+
+  // a move within CouplingLossMaxMove keeps the cached loss
+  rxMobility->SetPosition (Vector (105.0, 0.0, 0.0));
+  rxPsd = Transmit ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPsd, 1e-9 * gain, 1e-9 * gain * 1e-9, "Wrong RX PSD after a small move");
+  NS_TEST_EXPECT_MSG_EQ (m_pathLossEvaluations, 1, "The coupling loss is evaluated after a small move");
+
+  // a larger move does not
+  rxMobility->SetPosition (Vector (200.0, 0.0, 0.0));
+  gain = std::pow (10.0, loss->CalcRxPower (0, txMobility, rxMobility) / 10.0);
+  rxPsd = Transmit ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPsd, 1e-9 * gain, 1e-9 * gain * 1e-9, "Wrong RX PSD after a move");
+  NS_TEST_EXPECT_MSG_EQ (m_pathLossEvaluations, 2, "The coupling loss is not evaluated after a move");
+
+  // without the cache, the loss is evaluated at every transmission
+  m_channel->SetAttribute ("CacheCouplingLoss", BooleanValue (false));
+  rxPsd = Transmit ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (rxPsd, 1e-9 * gain, 1e-9 * gain * 1e-9, "Wrong RX PSD without the cache");
+  NS_TEST_EXPECT_MSG_EQ (m_pathLossEvaluations, 3, "The coupling loss is not evaluated without the cache");
+
+  m_channel->Dispose ();
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup spectrum
+ *
+ * Test suite of the cached coupling loss of MultiModelSpectrumChannel.
+ */
+class SpectrumCouplingLossTestSuite : public TestSuite
+{
+public:
+  SpectrumCouplingLossTestSuite ();
+};
+
+SpectrumCouplingLossTestSuite::SpectrumCouplingLossTestSuite ()
+  : TestSuite ("spectrum-coupling-loss", UNIT)
+{
+  AddTestCase (new SpectrumCouplingLossTestCase, TestCase::QUICK);
+}
+
+static SpectrumCouplingLossTestSuite g_spectrumCouplingLossTestSuite;
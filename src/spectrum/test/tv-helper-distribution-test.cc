@@ -18,6 +18,8 @@
  * Author: Benjamin Cizdziel <ben.cizdziel@gmail.com>
  */
 
+#include <sstream>
+#include <iostream>
 #define private public //to make private method testable
 
 #include <ns3/test.h>
@@ -86,6 +86,16 @@ FileHelper::ConfigureFile (const std::string &outputFileNameWithoutExtension,
   // constructed later when needed.
 }
 
+void
+FileHelper::ConfigureColumnarFile (const std::string &outputFileName,
+                                   enum ColumnarFileAggregator::FileType fileType)
+{
+  NS_LOG_FUNCTION (this << outputFileName << fileType);
+
+  m_columnarAggregator = CreateObject<ColumnarFileAggregator> (outputFileName, fileType);
+  m_columnarAggregator->Enable ();
+}
+
 void
 FileHelper::WriteProbe (const std::string &typeId,
                         const std::string &path,
@@ -302,6 +312,12 @@ FileHelper::GetProbe (std::string probeName) const
     }
 }
 
+Ptr<ColumnarFileAggregator>
+FileHelper::GetColumnarAggregator (void) const
+{
+  return m_columnarAggregator;
+}
+
 Ptr<FileAggregator>
 FileHelper::GetAggregatorSingle ()
 {
@@ -555,6 +571,17 @@ FileHelper::ConnectProbeToAggregator (const std::string &typeId,
       NS_FATAL_ERROR ("Unknown probe type " << m_probeMap[probeName].second << "; need to add support in the helper for this");
     }
 
+  if (m_columnarAggregator != 0)
+    {
+      // Write the samples of all the probes to the same file.
+      m_timeSeriesAdaptorMap[probeContext]->TraceConnect
+        ("Output",
+        path + "/" + probeTraceSource,
+        MakeCallback (&ColumnarFileAggregator::Write2d,
+                      m_columnarAggregator));
+      return;
+    }
+
   // Add the aggregator to the map of aggregators, which will keep the
   // aggregator in memory after this function ends.
   std::string outputFileName = outputFileNameWithoutExtension + ".txt";
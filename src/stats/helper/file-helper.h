@@ -27,6 +27,7 @@
 #include "ns3/ptr.h"
 #include "ns3/probe.h"
 #include "ns3/file-aggregator.h"
+#include "ns3/columnar-file-aggregator.h"
 #include "ns3/time-series-adaptor.h"
 
 namespace ns3 {
@@ -73,6 +74,19 @@ public:
   void ConfigureFile (const std::string &outputFileNameWithoutExtension,
                       enum FileAggregator::FileType fileType = FileAggregator::SPACE_SEPARATED);
 
+  /**
+   * \param outputFileName name of the file to write.
+   * \param fileType type of file to write.
+   *
+   * Configures this file helper so that the probes of the following
+   * calls to WriteProbe () are all written to a single file named
+   * outputFileName, by a ColumnarFileAggregator, instead of one file
+   * per probe.  The context of each probe is its matched config path
+   * followed by the probe trace source, separated by a slash.
+   */
+  void ConfigureColumnarFile (const std::string &outputFileName,
+                              enum ColumnarFileAggregator::FileType fileType = ColumnarFileAggregator::CSV);
+
   /**
    * \param typeId the type ID for the probe used when it is created.
    * \param path Config path for underlying trace source to be probed
@@ -154,6 +168,12 @@ public:
   Ptr<FileAggregator> GetAggregatorMultiple (const std::string &aggregatorName,
                                              const std::string &outputFileName);
 
+  /**
+   * \return Ptr to the ColumnarFileAggregator object, or 0 if
+   * ConfigureColumnarFile () has not been called.
+   */
+  Ptr<ColumnarFileAggregator> GetColumnarAggregator (void) const;
+
   /**
    * \param heading the heading string.
    *
@@ -285,6 +305,9 @@ private:
   /// The single aggregator that is always created in the constructor.
   Ptr<FileAggregator> m_aggregator;
 
+  /// The aggregator writing all the probes, if configured.
+  Ptr<ColumnarFileAggregator> m_columnarAggregator;
+
   /// Maps aggregator names to aggregators when multiple aggregators
   /// are needed.
   std::map<std::string, Ptr<FileAggregator> > m_aggregatorMap;
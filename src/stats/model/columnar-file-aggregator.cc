@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+
+#include "columnar-file-aggregator.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ColumnarFileAggregator");
+
+NS_OBJECT_ENSURE_REGISTERED (ColumnarFileAggregator);
+
+const uint32_t ColumnarFileAggregator::MAX_DIMENSION;
+
+/// The magic number of the binary files.
+static const uint32_t COLUMNAR_MAGIC = 0x6e73636c;
+/// The major version of the binary format.
+static const uint16_t COLUMNAR_VERSION_MAJOR = 1;
+/// The minor version of the binary format.
+static const uint16_t COLUMNAR_VERSION_MINOR = 0;
+/// The type of the probe records.
+static const uint32_t COLUMNAR_PROBE = 1;
+/// The type of the block records.
+static const uint32_t COLUMNAR_BLOCK = 2;
+
+TypeId
+ColumnarFileAggregator::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::ColumnarFileAggregator")
+    .SetParent<DataCollectionObject> ()
+    .SetGroupName ("Stats")
+  ;
+
+  return tid;
+}
+
+ColumnarFileAggregator::ColumnarFileAggregator (const std::string &outputFileName,
+                                                enum FileType fileType)
+  : m_fileType (fileType),
+    m_blockSize (65536),
+    m_lastProbeId (0)
+{
+  NS_LOG_FUNCTION (this << outputFileName << fileType);
+
+  // The blocks are written as they are, without another copy in the
+  // stream buffer
+  m_file.rdbuf ()->pubsetbuf (0, 0);
+  m_file.open (outputFileName.c_str (), std::ios::out | std::ios::binary);
+  if (!m_file.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open " << outputFileName);
+    }
+  m_buffer.reserve (m_blockSize + 1024);
+
+  if (m_fileType == BINARY)
+    {
+      Append (&COLUMNAR_MAGIC, sizeof (COLUMNAR_MAGIC));
+      Append (&COLUMNAR_VERSION_MAJOR, sizeof (COLUMNAR_VERSION_MAJOR));
+      Append (&COLUMNAR_VERSION_MINOR, sizeof (COLUMNAR_VERSION_MINOR));
+    }
+}
+
+ColumnarFileAggregator::~ColumnarFileAggregator ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  m_file.close ();
+}
+
+void
+ColumnarFileAggregator::SetBlockSize (uint32_t blockSize)
+{
+  NS_LOG_FUNCTION (this << blockSize);
+  NS_ABORT_MSG_IF (blockSize == 0, "The block size must not be null");
+  m_blockSize = blockSize;
+  m_buffer.reserve (m_blockSize + 1024);
+}
+
+int64_t
+ColumnarFileAggregator::GetProbeId (const std::string &context) const
+{
+  std::map<std::string, uint32_t>::const_iterator it = m_probeIds.find (context);
+  if (it == m_probeIds.end ())
+    {
+      return -1;
+    }
+  return it->second;
+}
+
+void
+ColumnarFileAggregator::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fileType == BINARY)
+    {
+      for (uint32_t dimension = 1; dimension <= MAX_DIMENSION; dimension++)
+        {
+          SerializeColumns (dimension);
+        }
+    }
+  m_file.write (m_buffer.data (), m_buffer.size ());
+  m_file.flush ();
+  m_buffer.clear ();
+}
+
+void
+ColumnarFileAggregator::Write1d (std::string context,
+                                 double v1)
+{
+  NS_LOG_FUNCTION (this << context << v1);
+  double values[1] = { v1 };
+  Write (context, values, 1);
+}
+
+void
+ColumnarFileAggregator::Write2d (std::string context,
+                                 double v1,
+                                 double v2)
+{
+  NS_LOG_FUNCTION (this << context << v1 << v2);
+  double values[2] = { v1, v2 };
+  Write (context, values, 2);
+}
+
+void
+ColumnarFileAggregator::Write3d (std::string context,
+                                 double v1,
+                                 double v2,
+                                 double v3)
+{
+  NS_LOG_FUNCTION (this << context << v1 << v2 << v3);
+  double values[3] = { v1, v2, v3 };
+  Write (context, values, 3);
+}
+
+void
+ColumnarFileAggregator::Write (const std::string &context, const double *values, uint32_t dimension)
+{
+  if (!m_enabled)
+    {
+      return;
+    }
+
+  uint32_t id = LookupProbeId (context);
+  if (m_fileType == CSV)
+    {
+      char line[160];
+      int length = snprintf (line, sizeof (line), "%u", id);
+      for (uint32_t i = 0; i < dimension; i++)
+        {
+          length += snprintf (line + length, sizeof (line) - length, ",%.15g", values[i]);
+        }
+      line[length++] = '\n';
+      Append (line, length);
+      WriteBlockIfFull ();
+    }
+  else
+    {
+      Columns &columns = m_columns[dimension - 1];
+      columns.ids.push_back (id);
+      for (uint32_t i = 0; i < dimension; i++)
+        {
+          columns.values[i].push_back (values[i]);
+        }
+      // Each sample takes the size of its id and values in the block
+      if (columns.ids.size () * (4 + 8 * dimension) >= m_blockSize)
+        {
+          SerializeColumns (dimension);
+          WriteBlockIfFull ();
+        }
+    }
+}
+
+uint32_t
+ColumnarFileAggregator::LookupProbeId (const std::string &context)
+{
+  // The samples of a probe often come in a row, at the same time
+  if (!m_probeIds.empty () && context == m_lastContext)
+    {
+      return m_lastProbeId;
+    }
+
+  std::map<std::string, uint32_t>::iterator it = m_probeIds.find (context);
+  if (it == m_probeIds.end ())
+    {
+      uint32_t id = m_probeIds.size ();
+      it = m_probeIds.insert (std::make_pair (context, id)).first;
+      NS_LOG_DEBUG ("Probe " << id << " is " << context);
+      if (m_fileType == CSV)
+        {
+          char prefix[32];
+          int length = snprintf (prefix, sizeof (prefix), "# probe %u ", id);
+          Append (prefix, length);
+          Append (context.data (), context.size ());
+          Append ("\n", 1);
+        }
+      else
+        {
+          AppendRecordHeader (COLUMNAR_PROBE, 4 + context.size ());
+          Append (&id, 4);
+          Append (context.data (), context.size ());
+        }
+    }
+  m_lastContext = context;
+  m_lastProbeId = it->second;
+  return m_lastProbeId;
+}
+
+void
+ColumnarFileAggregator::SerializeColumns (uint32_t dimension)
+{
+  Columns &columns = m_columns[dimension - 1];
+  uint32_t n = columns.ids.size ();
+  if (n == 0)
+    {
+      return;
+    }
+  AppendRecordHeader (COLUMNAR_BLOCK, 8 + n * (4 + 8 * dimension));
+  Append (&dimension, 4);
+  Append (&n, 4);
+  Append (&columns.ids[0], n * 4);
+  columns.ids.clear ();
+  for (uint32_t i = 0; i < dimension; i++)
+    {
+      Append (&columns.values[i][0], n * 8);
+      columns.values[i].clear ();
+    }
+}
+
+void
+ColumnarFileAggregator::AppendRecordHeader (uint32_t type, uint32_t size)
+{
+  Append (&type, 4);
+  Append (&size, 4);
+}
+
+void
+ColumnarFileAggregator::Append (const void *data, uint32_t size)
+{
+  m_buffer.append (static_cast<const char *> (data), size);
+}
+
+void
+ColumnarFileAggregator::WriteBlockIfFull (void)
+{
+  if (m_buffer.size () >= m_blockSize)
+    {
+      m_file.write (m_buffer.data (), m_buffer.size ());
+      m_buffer.clear ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COLUMNAR_FILE_AGGREGATOR_H
+#define COLUMNAR_FILE_AGGREGATOR_H
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/data-collection-object.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup aggregator
+ *
+ * This aggregator writes the values of many probes to a single file,
+ * in blocks, with a probe id column identifying the context of each
+ * sample.
+ *
+ * Each distinct context gets the next probe id, starting from 0,
+ * when its first sample arrives.  The samples are buffered, and
+ * written to the file in blocks of about BlockSize bytes, so that
+ * sampling thousands of probes costs a few large writes instead of a
+ * write per sample.  The file is complete once the aggregator has
+ * been destroyed, or after Flush ().
+ *
+ * Two formats are written:
+ *
+ * - CSV: one line per sample, "id,v1[,v2[,v3]]", in the order of the
+ *   samples.  The first sample of a probe is preceded by the comment
+ *   line "# probe <id> <context>".
+ *
+ * - BINARY: the samples of each dimension are gathered in columns.
+ *   The file starts with the 32 bit magic number 0x6e73636c and the
+ *   16 bit major and minor version numbers 1 and 0, and continues with
+ *   records, all in the byte order of the host.  Each record starts
+ *   with a 32 bit type and the 32 bit size of the data which follows:
+ *   - type 1, a probe: its 32 bit id, then its context, without any
+ *     terminating null character;
+ *   - type 2, a block of samples: the 32 bit dimension d and number of
+ *     samples n, then n 32 bit probe ids, then d columns of n doubles.
+ *   A probe record always precedes the first block using its id.  The
+ *   samples of a dimension keep their order, but the blocks of
+ *   different dimensions are interleaved as they fill up.
+ **/
+class ColumnarFileAggregator : public DataCollectionObject
+{
+public:
+  /// The type of file written by the aggregator.
+  enum FileType
+  {
+    CSV,
+    BINARY
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \param outputFileName name of the file to write.
+   * \param fileType type of file to write.
+   *
+   * Constructs an aggregator that will create a file named
+   * outputFileName with samples written as specified by fileType.  The
+   * default file type is CSV.
+   */
+  ColumnarFileAggregator (const std::string &outputFileName,
+                          enum FileType fileType = CSV);
+
+  virtual ~ColumnarFileAggregator ();
+
+  /**
+   * \param blockSize the size of the blocks, in bytes.
+   *
+   * \brief Sets the amount of data buffered before it is written to
+   * the file.  The default is 64 KiB.
+   */
+  void SetBlockSize (uint32_t blockSize);
+
+  /**
+   * \param context a context.
+   * \return the probe id of the context, or -1 if no sample of this
+   * context has been written yet.
+   */
+  int64_t GetProbeId (const std::string &context) const;
+
+  /**
+   * \brief Writes the buffered samples to the file.
+   */
+  void Flush (void);
+
+  // Below are hooked to connectors exporting data
+  // They are not overloaded since it confuses the compiler when made
+  // into callbacks
+
+  /**
+   * \param context specifies the probe this value came from.
+   * \param v1 value for the new sample.
+   *
+   * \brief Writes 1 value to the file.
+   */
+  void Write1d (std::string context,
+                double v1);
+
+  /**
+   * \param context specifies the probe these values came from.
+   * \param v1 first value for the new sample.
+   * \param v2 second value for the new sample.
+   *
+   * \brief Writes 2 values to the file.  This is the sink of the
+   * Output trace source of a TimeSeriesAdaptor.
+   */
+  void Write2d (std::string context,
+                double v1,
+                double v2);
+
+  /**
+   * \param context specifies the probe these values came from.
+   * \param v1 first value for the new sample.
+   * \param v2 second value for the new sample.
+   * \param v3 third value for the new sample.
+   *
+   * \brief Writes 3 values to the file.
+   */
+  void Write3d (std::string context,
+                double v1,
+                double v2,
+                double v3);
+
+  /// The largest dimension of the samples.
+  static const uint32_t MAX_DIMENSION = 3;
+
+private:
+  /**
+   * The samples of one dimension, buffered as columns for the binary
+   * file.
+   */
+  struct Columns
+  {
+    std::vector<uint32_t> ids;                      //!< The probe ids
+    std::vector<double> values[MAX_DIMENSION];      //!< The value columns
+  };
+
+  /**
+   * \param context the context of the sample.
+   * \param values the values of the sample.
+   * \param dimension the number of values.
+   *
+   * \brief Buffers a sample.
+   */
+  void Write (const std::string &context, const double *values, uint32_t dimension);
+
+  /**
+   * \param context a context.
+   * \return the probe id of the context, assigned and announced in the
+   * file the first time the context is seen.
+   */
+  uint32_t LookupProbeId (const std::string &context);
+
+  /**
+   * \param dimension the dimension of the columns.
+   *
+   * \brief Serializes the columns of a dimension as a block record.
+   */
+  void SerializeColumns (uint32_t dimension);
+
+  /**
+   * \param type the record type.
+   * \param size the size of the data following the record header.
+   *
+   * \brief Appends a binary record header to the buffer.
+   */
+  void AppendRecordHeader (uint32_t type, uint32_t size);
+
+  /**
+   * \param data the data.
+   * \param size the size of the data.
+   *
+   * \brief Appends raw bytes to the buffer.
+   */
+  void Append (const void *data, uint32_t size);
+
+  /// Writes the buffer to the file if it holds a block.
+  void WriteBlockIfFull (void);
+
+  std::ofstream m_file;                            //!< The output file
+  enum FileType m_fileType;                        //!< The file type
+  uint32_t m_blockSize;                            //!< The block size
+  std::string m_buffer;                            //!< The data waiting to be written
+  std::map<std::string, uint32_t> m_probeIds;      //!< The probe ids of the contexts
+  std::string m_lastContext;                       //!< The context of the last sample
+  uint32_t m_lastProbeId;                          //!< The probe id of the last sample
+  Columns m_columns[MAX_DIMENSION];                //!< The binary columns by dimension - 1
+};
+
+} // namespace ns3
+
+#endif // COLUMNAR_FILE_AGGREGATOR_H
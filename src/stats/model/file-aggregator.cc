@@ -102,7 +102,7 @@ FileAggregator::SetHeading (const std::string &heading)
       m_hasHeadingBeenSet = true;
 
       // Print the heading to the file.
-      m_file << m_heading << std::endl;
+      m_file << m_heading << "\n";
     }
 }
 
@@ -204,12 +204,12 @@ FileAggregator::Write1d (std::string context,
             }
 
           // Write the formatted value.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
           // Write the value.
-          m_file << v1 << std::endl;
+          m_file << v1 << "\n";
         }
     }
 }
@@ -244,13 +244,13 @@ FileAggregator::Write2d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
           // Write the values with the proper separator.
           m_file << v1 << m_separator
-                 << v2 << std::endl;
+                 << v2 << "\n";
         }
     }
 }
@@ -287,14 +287,14 @@ FileAggregator::Write3d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
           // Write the values with the proper separator.
           m_file << v1 << m_separator
                  << v2 << m_separator
-                 << v3 << std::endl;
+                 << v3 << "\n";
         }
     }
 }
@@ -333,7 +333,7 @@ FileAggregator::Write4d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
@@ -341,7 +341,7 @@ FileAggregator::Write4d (std::string context,
           m_file << v1 << m_separator
                  << v2 << m_separator
                  << v3 << m_separator
-                 << v4 << std::endl;
+                 << v4 << "\n";
         }
     }
 }
@@ -382,7 +382,7 @@ FileAggregator::Write5d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
@@ -391,7 +391,7 @@ FileAggregator::Write5d (std::string context,
                  << v2 << m_separator
                  << v3 << m_separator
                  << v4 << m_separator
-                 << v5 << std::endl;
+                 << v5 << "\n";
         }
     }
 }
@@ -434,7 +434,7 @@ FileAggregator::Write6d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
@@ -444,7 +444,7 @@ FileAggregator::Write6d (std::string context,
                  << v3 << m_separator
                  << v4 << m_separator
                  << v5 << m_separator
-                 << v6 << std::endl;
+                 << v6 << "\n";
         }
     }
 }
@@ -489,7 +489,7 @@ FileAggregator::Write7d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
@@ -500,7 +500,7 @@ FileAggregator::Write7d (std::string context,
                  << v4 << m_separator
                  << v5 << m_separator
                  << v6 << m_separator
-                 << v7 << std::endl;
+                 << v7 << "\n";
         }
     }
 }
@@ -547,7 +547,7 @@ FileAggregator::Write8d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
@@ -559,7 +559,7 @@ FileAggregator::Write8d (std::string context,
                  << v5 << m_separator
                  << v6 << m_separator
                  << v7 << m_separator
-                 << v8 << std::endl;
+                 << v8 << "\n";
         }
     }
 }
@@ -607,7 +607,7 @@ FileAggregator::Write9d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
@@ -620,7 +620,7 @@ FileAggregator::Write9d (std::string context,
                  << v6 << m_separator
                  << v7 << m_separator
                  << v8 << m_separator
-                 << v9 << std::endl;
+                 << v9 << "\n";
         }
     }
 }
@@ -670,7 +670,7 @@ FileAggregator::Write10d (std::string context,
             }
 
           // Write the formatted values.
-          m_file << buffer << std::endl;
+          m_file << buffer << "\n";
         }
       else
         {
@@ -684,7 +684,7 @@ FileAggregator::Write10d (std::string context,
                  << v7 << m_separator
                  << v8 << m_separator
                  << v9 << m_separator
-                 << v10 << std::endl;
+                 << v10 << "\n";
         }
     }
 }
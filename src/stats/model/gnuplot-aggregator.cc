@@ -106,7 +106,8 @@ GnuplotAggregator::Write2d (std::string context, double x, double y)
 {
   NS_LOG_FUNCTION (this << context << x << y);
 
-  if (m_2dDatasetMap.count (context) == 0)
+  std::map<std::string, Gnuplot2dDataset>::iterator dataset = m_2dDatasetMap.find (context);
+  if (dataset == m_2dDatasetMap.end ())
     {
       NS_ABORT_MSG ("Dataset " << context << " has not been added");
     }
@@ -114,7 +115,7 @@ GnuplotAggregator::Write2d (std::string context, double x, double y)
   if (m_enabled)
     {
       // Add this 2D data point to its dataset.
-      m_2dDatasetMap[context].Add (x, y);
+      dataset->second.Add (x, y);
     }
 }
 
@@ -126,7 +127,8 @@ GnuplotAggregator::Write2dWithXErrorDelta (std::string context,
 {
   NS_LOG_FUNCTION (this << context << x << y << errorDelta);
 
-  if (m_2dDatasetMap.count (context) == 0)
+  std::map<std::string, Gnuplot2dDataset>::iterator dataset = m_2dDatasetMap.find (context);
+  if (dataset == m_2dDatasetMap.end ())
     {
       NS_ABORT_MSG ("Dataset " << context << " has not been added");
     }
@@ -134,7 +136,7 @@ GnuplotAggregator::Write2dWithXErrorDelta (std::string context,
   if (m_enabled)
     {
       // Add this 2D data point with its error bar to its dataset.
-      m_2dDatasetMap[context].Add (x, y, errorDelta);
+      dataset->second.Add (x, y, errorDelta);
     }
 }
 
@@ -146,7 +148,8 @@ GnuplotAggregator::Write2dWithYErrorDelta (std::string context,
 {
   NS_LOG_FUNCTION (this << context << x << y << errorDelta);
 
-  if (m_2dDatasetMap.count (context) == 0)
+  std::map<std::string, Gnuplot2dDataset>::iterator dataset = m_2dDatasetMap.find (context);
+  if (dataset == m_2dDatasetMap.end ())
     {
       NS_ABORT_MSG ("Dataset " << context << " has not been added");
     }
@@ -154,7 +157,7 @@ GnuplotAggregator::Write2dWithYErrorDelta (std::string context,
   if (m_enabled)
     {
       // Add this 2D data point with its error bar to its dataset.
-      m_2dDatasetMap[context].Add (x, y, errorDelta);
+      dataset->second.Add (x, y, errorDelta);
     }
 }
 
@@ -167,7 +170,8 @@ GnuplotAggregator::Write2dWithXYErrorDelta (std::string context,
 {
   NS_LOG_FUNCTION (this << context << x << y << xErrorDelta << yErrorDelta);
 
-  if (m_2dDatasetMap.count (context) == 0)
+  std::map<std::string, Gnuplot2dDataset>::iterator dataset = m_2dDatasetMap.find (context);
+  if (dataset == m_2dDatasetMap.end ())
     {
       NS_ABORT_MSG ("Dataset " << context << " has not been added");
     }
@@ -175,7 +179,7 @@ GnuplotAggregator::Write2dWithXYErrorDelta (std::string context,
   if (m_enabled)
     {
       // Add this 2D data point with its error bar to its dataset.
-      m_2dDatasetMap[context].Add (x, y, xErrorDelta, yErrorDelta);
+      dataset->second.Add (x, y, xErrorDelta, yErrorDelta);
     }
 }
 
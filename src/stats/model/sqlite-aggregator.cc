@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sqlite3.h>
+
+#include "sqlite-aggregator.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SqliteAggregator");
+
+NS_OBJECT_ENSURE_REGISTERED (SqliteAggregator);
+
+TypeId
+SqliteAggregator::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::SqliteAggregator")
+    .SetParent<DataCollectionObject> ()
+    .SetGroupName ("Stats")
+  ;
+
+  return tid;
+}
+
+SqliteAggregator::SqliteAggregator (const std::string &databaseFileName,
+                                    const std::string &tableName)
+  : m_db (0),
+    m_insert (0),
+    m_commitInterval (10000),
+    m_uncommittedRows (0)
+{
+  NS_LOG_FUNCTION (this << databaseFileName << tableName);
+
+  if (sqlite3_open (databaseFileName.c_str (), &m_db) != SQLITE_OK)
+    {
+      NS_FATAL_ERROR ("Could not open sqlite3 database \"" << databaseFileName
+                      << "\": " << sqlite3_errmsg (m_db));
+    }
+
+  // Write-ahead logging lets the readers follow the time series while
+  // they are written
+  Exec ("PRAGMA journal_mode=WAL");
+  Exec ("create table if not exists \"" + tableName + "\" (context text, time real, value real)");
+
+  std::string insert = "insert into \"" + tableName + "\" (context,time,value) values (?,?,?)";
+  if (sqlite3_prepare_v2 (m_db, insert.c_str (), -1, &m_insert, 0) != SQLITE_OK)
+    {
+      NS_FATAL_ERROR ("sqlite3 error: " << sqlite3_errmsg (m_db));
+    }
+}
+
+SqliteAggregator::~SqliteAggregator ()
+{
+  NS_LOG_FUNCTION (this);
+  Commit ();
+  sqlite3_finalize (m_insert);
+  sqlite3_close (m_db);
+}
+
+void
+SqliteAggregator::Exec (const std::string &sql)
+{
+  NS_LOG_FUNCTION (this << sql);
+
+  char *errMsg = 0;
+  if (sqlite3_exec (m_db, sql.c_str (), 0, 0, &errMsg) != SQLITE_OK)
+    {
+      NS_LOG_ERROR ("sqlite3 error: \"" << errMsg << "\"");
+    }
+  sqlite3_free (errMsg);
+}
+
+void
+SqliteAggregator::SetCommitInterval (uint32_t rows)
+{
+  NS_LOG_FUNCTION (this << rows);
+  NS_ABORT_MSG_IF (rows == 0, "The commit interval must be at least one row");
+  m_commitInterval = rows;
+}
+
+void
+SqliteAggregator::Commit (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_uncommittedRows > 0)
+    {
+      Exec ("COMMIT");
+      m_uncommittedRows = 0;
+    }
+}
+
+void
+SqliteAggregator::Write1d (std::string context,
+                           double v1)
+{
+  NS_LOG_FUNCTION (this << context << v1);
+  Write2d (context, Simulator::Now ().GetSeconds (), v1);
+}
+
+void
+SqliteAggregator::Write2d (std::string context,
+                           double time,
+                           double value)
+{
+  NS_LOG_FUNCTION (this << context << time << value);
+
+  if (!m_enabled)
+    {
+      return;
+    }
+  if (m_uncommittedRows == 0)
+    {
+      Exec ("BEGIN");
+    }
+  sqlite3_bind_text (m_insert, 1, context.c_str (), context.size (), SQLITE_TRANSIENT);
+  sqlite3_bind_double (m_insert, 2, time);
+  sqlite3_bind_double (m_insert, 3, value);
+  if (sqlite3_step (m_insert) != SQLITE_DONE)
+    {
+      NS_LOG_ERROR ("sqlite3 error: \"" << sqlite3_errmsg (m_db) << "\"");
+    }
+  sqlite3_reset (m_insert);
+  if (++m_uncommittedRows >= m_commitInterval)
+    {
+      Commit ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLITE_AGGREGATOR_H
+#define SQLITE_AGGREGATOR_H
+
+#include <string>
+#include "ns3/data-collection-object.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace ns3 {
+
+/**
+ * \ingroup aggregator
+ *
+ * This aggregator streams the time series it receives to a table of
+ * a SQLite database while the simulation runs.
+ *
+ * Each row of the table holds the context of the series, a time and
+ * a value.  The rows are inserted with a prepared statement, in
+ * transactions committed every CommitInterval rows and when the
+ * aggregator is destroyed, so that other processes can follow the
+ * series in the database, which uses write-ahead logging.
+ *
+ * Connect the Output trace source of a TimeSeriesAdaptor, which
+ * converts the values of a probe to time series, to Write2d ().
+ **/
+class SqliteAggregator : public DataCollectionObject
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \param databaseFileName name of the SQLite database to write.
+   * \param tableName name of the table receiving the time series.
+   *
+   * Constructs an aggregator that opens, or creates, the database
+   * databaseFileName and the table tableName, with the columns
+   * context, time and value.
+   */
+  SqliteAggregator (const std::string &databaseFileName,
+                    const std::string &tableName = "TimeSeries");
+
+  virtual ~SqliteAggregator ();
+
+  /**
+   * \param rows the number of rows inserted in each transaction.
+   *
+   * \brief Sets the number of rows after which the inserted rows are
+   * committed, and become visible to the readers of the database.
+   * The default is 10000 rows.
+   */
+  void SetCommitInterval (uint32_t rows);
+
+  /**
+   * \brief Commits the rows inserted so far.
+   */
+  void Commit (void);
+
+  // Below are hooked to connectors exporting data
+  // They are not overloaded since it confuses the compiler when made
+  // into callbacks
+
+  /**
+   * \param context specifies the time series this value came from.
+   * \param v1 value of the time series at the current simulation time.
+   *
+   * \brief Inserts a value with the current simulation time, in seconds.
+   */
+  void Write1d (std::string context,
+                double v1);
+
+  /**
+   * \param context specifies the time series these values came from.
+   * \param time the time, as exported by a TimeSeriesAdaptor.
+   * \param value the value at this time.
+   *
+   * \brief Inserts a value with its time.
+   */
+  void Write2d (std::string context,
+                double time,
+                double value);
+
+private:
+  /**
+   * \brief Execute a SQL statement without parameters.
+   * \param sql the statement
+   */
+  void Exec (const std::string &sql);
+
+  sqlite3 *m_db;                    //!< The database
+  sqlite3_stmt *m_insert;           //!< The prepared insert statement
+  uint32_t m_commitInterval;        //!< Rows per transaction
+  uint32_t m_uncommittedRows;       //!< Rows inserted in the current transaction
+};
+
+} // namespace ns3
+
+#endif // SQLITE_AGGREGATOR_H
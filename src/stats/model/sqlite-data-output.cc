@@ -18,8 +18,6 @@
  * Author: Joe Kopena (tjkopena@cs.drexel.edu)
  */
 
-#include <sstream>
-
 #include <sqlite3.h>
 
 #include "ns3/log.h"
@@ -33,6 +31,20 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("SqliteDataOutput");
 
+/**
+ * \brief Bind a text parameter of a prepared statement
+ * \param stmt the prepared statement, or 0
+ * \param index the index of the parameter, starting at 1
+ * \param text the text
+ */
+static void
+BindText (sqlite3_stmt *stmt, int index, const std::string &text)
+{
+  if (stmt != 0) {
+      sqlite3_bind_text (stmt, index, text.c_str (), text.size (), SQLITE_TRANSIENT);
+    }
+}
+
 //--------------------------------------------------------------
 //----------------------------------------------
 SqliteDataOutput::SqliteDataOutput()
@@ -99,6 +111,41 @@ SqliteDataOutput::Exec (std::string exe) {
   // end SqliteDataOutput::Exec
 }
 
+sqlite3_stmt *
+SqliteDataOutput::Prepare (std::string sql)
+{
+  NS_LOG_FUNCTION (this << sql);
+
+  sqlite3_stmt *stmt = 0;
+  if (sqlite3_prepare_v2 (m_db, sql.c_str (), -1, &stmt, 0) != SQLITE_OK) {
+      NS_LOG_ERROR ("sqlite3 error: \"" << sqlite3_errmsg (m_db) << "\"");
+      sqlite3_finalize (stmt);
+      return 0;
+    }
+  return stmt;
+
+  // end SqliteDataOutput::Prepare
+}
+
+int
+SqliteDataOutput::Step (sqlite3_stmt *stmt)
+{
+  NS_LOG_FUNCTION (this << stmt);
+
+  if (stmt == 0) {
+      return SQLITE_MISUSE;
+    }
+  int res = sqlite3_step (stmt);
+  if (res != SQLITE_DONE) {
+      NS_LOG_ERROR ("sqlite3 error: \"" << sqlite3_errmsg (m_db) << "\"");
+    }
+  sqlite3_reset (stmt);
+  sqlite3_clear_bindings (stmt);
+  return res;
+
+  // end SqliteDataOutput::Step
+}
+
 //----------------------------------------------
 void
 SqliteDataOutput::Output (DataCollector &dc)
@@ -117,31 +164,42 @@ SqliteDataOutput::Output (DataCollector &dc)
 
   std::string run = dc.GetRunLabel ();
 
+  // Write-ahead logging lets other processes read the database while
+  // runs append to it, and only syncs the log on commit.
+  Exec ("PRAGMA journal_mode=WAL");
+  Exec ("BEGIN");
+
   Exec ("create table if not exists Experiments (run, experiment, strategy, input, description text)");
-  Exec ("insert into Experiments (run,experiment,strategy,input,description) values ('" +
-        run + "', '" +
-        dc.GetExperimentLabel () + "', '" +
-        dc.GetStrategyLabel () + "', '" +
-        dc.GetInputLabel () + "', '" +
-        dc.GetDescription () + "')");
+  sqlite3_stmt *stmt = Prepare ("insert into Experiments (run,experiment,strategy,input,description) values (?,?,?,?,?)");
+  BindText (stmt, 1, run);
+  BindText (stmt, 2, dc.GetExperimentLabel ());
+  BindText (stmt, 3, dc.GetStrategyLabel ());
+  BindText (stmt, 4, dc.GetInputLabel ());
+  BindText (stmt, 5, dc.GetDescription ());
+  Step (stmt);
+  sqlite3_finalize (stmt);
 
   Exec ("create table if not exists Metadata ( run text, key text, value)");
 
+  stmt = Prepare ("insert into Metadata (run,key,value) values (?,?,?)");
   for (MetadataList::iterator i = dc.MetadataBegin ();
        i != dc.MetadataEnd (); i++) {
       std::pair<std::string, std::string> blob = (*i);
-      Exec ("insert into Metadata (run,key,value) values ('" +
-            run + "', '" +
-            blob.first + "', '" +
-            blob.second + "')");
-    }
-
-  Exec ("BEGIN");
-  SqliteOutputCallback callback (this, run);
-  for (DataCalculatorList::iterator i = dc.DataCalculatorBegin ();
-       i != dc.DataCalculatorEnd (); i++) {
-      (*i)->Output (callback);
+      BindText (stmt, 1, run);
+      BindText (stmt, 2, blob.first);
+      BindText (stmt, 3, blob.second);
+      Step (stmt);
     }
+  sqlite3_finalize (stmt);
+
+  {
+    // The callback statement must be released before closing the database
+    SqliteOutputCallback callback (this, run);
+    for (DataCalculatorList::iterator i = dc.DataCalculatorBegin ();
+         i != dc.DataCalculatorEnd (); i++) {
+        (*i)->Output (callback);
+      }
+  }
   Exec ("COMMIT");
 
   sqlite3_close (m_db);
@@ -152,15 +210,34 @@ SqliteDataOutput::Output (DataCollector &dc)
 SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback
   (Ptr<SqliteDataOutput> owner, std::string run) :
   m_owner (owner),
-  m_runLabel (run)
+  m_runLabel (run),
+  m_insertSingleton (0)
 {
   NS_LOG_FUNCTION (this << owner << run);
 
   m_owner->Exec ("create table if not exists Singletons ( run text, name text, variable text, value )");
+  m_insertSingleton = m_owner->Prepare ("insert into Singletons (run,name,variable,value) values (?,?,?,?)");
 
   // end SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback
 }
 
+SqliteDataOutput::SqliteOutputCallback::~SqliteOutputCallback ()
+{
+  NS_LOG_FUNCTION (this);
+
+  sqlite3_finalize (m_insertSingleton);
+}
+
+void
+SqliteDataOutput::SqliteOutputCallback::InsertSingleton (std::string key,
+                                                         std::string variable)
+{
+  BindText (m_insertSingleton, 1, m_runLabel);
+  BindText (m_insertSingleton, 2, key);
+  BindText (m_insertSingleton, 3, variable);
+  m_owner->Step (m_insertSingleton);
+}
+
 void
 SqliteDataOutput::SqliteOutputCallback::OutputStatistic (std::string key,
                                                          std::string variable,
@@ -189,13 +266,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', " <<
-  val << ")";
-  m_owner->Exec (sstr.str ());
+  if (m_insertSingleton != 0) {
+      sqlite3_bind_int (m_insertSingleton, 4, val);
+    }
+  InsertSingleton (key, variable);
 
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
@@ -206,13 +280,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', " <<
-  val << ")";
-  m_owner->Exec (sstr.str ());
+  if (m_insertSingleton != 0) {
+      sqlite3_bind_int64 (m_insertSingleton, 4, val);
+    }
+  InsertSingleton (key, variable);
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
 void
@@ -222,13 +293,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', " <<
-  val << ")";
-  m_owner->Exec (sstr.str ());
+  if (m_insertSingleton != 0) {
+      sqlite3_bind_double (m_insertSingleton, 4, val);
+    }
+  InsertSingleton (key, variable);
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
 void
@@ -238,13 +306,8 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', '" <<
-  val << "')";
-  m_owner->Exec (sstr.str ());
+  BindText (m_insertSingleton, 4, val);
+  InsertSingleton (key, variable);
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
 void
@@ -254,12 +317,9 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', " <<
-  val.GetTimeStep () << ")";
-  m_owner->Exec (sstr.str ());
+  if (m_insertSingleton != 0) {
+      sqlite3_bind_int64 (m_insertSingleton, 4, val.GetTimeStep ());
+    }
+  InsertSingleton (key, variable);
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
@@ -28,6 +28,7 @@
 #define STATS_HAS_SQLITE3
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace ns3 {
 
@@ -37,6 +38,12 @@ namespace ns3 {
  * \ingroup dataoutput
  * \class SqliteDataOutput
  * \brief Outputs data in a format compatible with SQLite
+ *
+ * Each call to Output () writes the run description, the metadata and
+ * the output of all the data calculators of the DataCollector in a
+ * single transaction, with prepared insert statements.  The database
+ * uses write-ahead logging, so that other processes may read it while
+ * the runs of a parameter sweep append to it.
  */
 class SqliteDataOutput : public DataOutputInterface {
 public:
@@ -63,6 +70,11 @@ public:
      */
     SqliteOutputCallback(Ptr<SqliteDataOutput> owner, std::string run);
 
+    /**
+     * Destructor, releases the prepared statement
+     */
+    ~SqliteOutputCallback ();
+
     /**
      * \brief Generates data statistics
      * \param key the SQL key to use
@@ -124,8 +136,17 @@ public:
                           Time val);
 
 private:
+    /**
+     * \brief Inserts a singleton whose value is already bound
+     * \param key the SQL key to use
+     * \param variable the variable name
+     */
+    void InsertSingleton (std::string key,
+                          std::string variable);
+
     Ptr<SqliteDataOutput> m_owner; //!< the instance this object belongs to
     std::string m_runLabel; //!< Run label
+    sqlite3_stmt *m_insertSingleton; //!< Prepared singleton insert statement
 
     // end class SqliteOutputCallback
   };
@@ -140,6 +161,21 @@ private:
    */
   int Exec (std::string exe);
 
+  /**
+   * \brief Prepare a sqlite3 statement
+   * \param sql the statement, with '?' parameters
+   * \return the prepared statement, or 0 on error.
+   */
+  sqlite3_stmt * Prepare (std::string sql);
+
+  /**
+   * \brief Execute a prepared statement whose parameters are bound,
+   * and reset it for the next execution
+   * \param stmt the prepared statement
+   * \return sqlite return code.
+   */
+  int Step (sqlite3_stmt *stmt);
+
   // end class SqliteDataOutput
 };
 
@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "window-collector.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WindowCollector");
+
+NS_OBJECT_ENSURE_REGISTERED (WindowCollector);
+
+/// The number of histogram buckets per power of two.
+static const int32_t WINDOW_COLLECTOR_SUB_BUCKETS = 128;
+
+TypeId
+WindowCollector::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WindowCollector")
+    .SetParent<DataCollectionObject> ()
+    .SetGroupName ("Stats")
+    .AddConstructor<WindowCollector> ()
+    .AddAttribute ("Interval",
+                   "The duration of the windows.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&WindowCollector::m_interval),
+                   MakeTimeChecker (TimeStep (1)))
+    .AddAttribute ("Percentile",
+                   "The percentile of the values output for each window, "
+                   "in percent.",
+                   DoubleValue (99),
+                   MakeDoubleAccessor (&WindowCollector::m_percentile),
+                   MakeDoubleChecker<double> (0, 100))
+    .AddTraceSource ("Output",
+                     "The end time of the window, in seconds, and the "
+                     "count, sum, minimum, maximum, mean and percentile "
+                     "of its values",
+                     MakeTraceSourceAccessor (&WindowCollector::m_output),
+                     "ns3::WindowCollector::OutputTracedCallback")
+    .AddTraceSource ("Count",
+                     "The end time of the window versus the number of values",
+                     MakeTraceSourceAccessor (&WindowCollector::m_countTrace),
+                     "ns3::WindowCollector::StatisticTracedCallback")
+    .AddTraceSource ("Sum",
+                     "The end time of the window versus the sum of the values",
+                     MakeTraceSourceAccessor (&WindowCollector::m_sumTrace),
+                     "ns3::WindowCollector::StatisticTracedCallback")
+    .AddTraceSource ("Min",
+                     "The end time of the window versus the minimum value",
+                     MakeTraceSourceAccessor (&WindowCollector::m_minTrace),
+                     "ns3::WindowCollector::StatisticTracedCallback")
+    .AddTraceSource ("Max",
+                     "The end time of the window versus the maximum value",
+                     MakeTraceSourceAccessor (&WindowCollector::m_maxTrace),
+                     "ns3::WindowCollector::StatisticTracedCallback")
+    .AddTraceSource ("Mean",
+                     "The end time of the window versus the mean value",
+                     MakeTraceSourceAccessor (&WindowCollector::m_meanTrace),
+                     "ns3::WindowCollector::StatisticTracedCallback")
+    .AddTraceSource ("Percentile",
+                     "The end time of the window versus the percentile "
+                     "of the values",
+                     MakeTraceSourceAccessor (&WindowCollector::m_percentileTrace),
+                     "ns3::WindowCollector::StatisticTracedCallback")
+  ;
+  return tid;
+}
+
+WindowCollector::WindowCollector ()
+  : m_count (0),
+    m_sum (0),
+    m_min (0),
+    m_max (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WindowCollector::~WindowCollector ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+WindowCollector::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_endWindow.Cancel ();
+  DataCollectionObject::DoDispose ();
+}
+
+void
+WindowCollector::TraceSinkDouble (double oldData, double newData)
+{
+  NS_LOG_FUNCTION (this << oldData << newData);
+  Add (newData);
+}
+
+void
+WindowCollector::TraceSinkBoolean (bool oldData, bool newData)
+{
+  NS_LOG_FUNCTION (this << oldData << newData);
+  Add (newData ? 1 : 0);
+}
+
+void
+WindowCollector::TraceSinkUinteger8 (uint8_t oldData, uint8_t newData)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (oldData) << static_cast<uint32_t> (newData));
+  Add (newData);
+}
+
+void
+WindowCollector::TraceSinkUinteger16 (uint16_t oldData, uint16_t newData)
+{
+  NS_LOG_FUNCTION (this << oldData << newData);
+  Add (newData);
+}
+
+void
+WindowCollector::TraceSinkUinteger32 (uint32_t oldData, uint32_t newData)
+{
+  NS_LOG_FUNCTION (this << oldData << newData);
+  Add (newData);
+}
+
+void
+WindowCollector::Add (double value)
+{
+  if (!IsEnabled ())
+    {
+      NS_LOG_DEBUG ("Window collector not enabled");
+      return;
+    }
+  // Neither NaN nor the infinities have a place in the histogram
+  if (value - value != 0)
+    {
+      NS_LOG_DEBUG ("Ignoring " << value);
+      return;
+    }
+
+  if (m_count == 0)
+    {
+      m_min = value;
+      m_max = value;
+      if (!m_endWindow.IsRunning ())
+        {
+          // The window ends at the next multiple of the interval
+          int64_t now = Simulator::Now ().GetTimeStep ();
+          int64_t interval = m_interval.GetTimeStep ();
+          Time end = TimeStep ((now / interval + 1) * interval);
+          m_endWindow = Simulator::Schedule (end - Simulator::Now (), &WindowCollector::EndWindow, this);
+        }
+    }
+  else
+    {
+      m_min = std::min (m_min, value);
+      m_max = std::max (m_max, value);
+    }
+  m_count++;
+  m_sum += value;
+  m_histogram[GetBucket (value)]++;
+}
+
+void
+WindowCollector::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_endWindow.Cancel ();
+  if (m_count > 0)
+    {
+      EndWindow ();
+    }
+}
+
+void
+WindowCollector::EndWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+  double time = Simulator::Now ().GetSeconds ();
+  double mean = m_sum / m_count;
+  double percentile = GetPercentile (m_percentile / 100);
+  m_output (time, m_count, m_sum, m_min, m_max, mean, percentile);
+  m_countTrace (time, m_count);
+  m_sumTrace (time, m_sum);
+  m_minTrace (time, m_min);
+  m_maxTrace (time, m_max);
+  m_meanTrace (time, mean);
+  m_percentileTrace (time, percentile);
+
+  m_count = 0;
+  m_sum = 0;
+  m_histogram.clear ();
+}
+
+double
+WindowCollector::GetPercentile (double fraction) const
+{
+  // The rank of the percentile among the sorted values, from 1
+  uint32_t rank = static_cast<uint32_t> (std::ceil (fraction * m_count));
+  rank = std::max (rank, 1u);
+  uint32_t seen = 0;
+  for (std::map<int32_t, uint32_t>::const_iterator i = m_histogram.begin ();
+       i != m_histogram.end (); ++i)
+    {
+      seen += i->second;
+      if (seen >= rank)
+        {
+          // The extreme values are known exactly
+          return std::min (std::max (GetBucketValue (i->first), m_min), m_max);
+        }
+    }
+  return m_max;
+}
+
+int32_t
+WindowCollector::GetBucket (double value)
+{
+  if (value == 0)
+    {
+      return 0;
+    }
+  if (value < 0)
+    {
+      return -GetBucket (-value);
+    }
+  // value = mantissa * 2^exponent, with mantissa in [0.5, 1)
+  int exponent;
+  double mantissa = std::frexp (value, &exponent);
+  int32_t sub = static_cast<int32_t> ((mantissa - 0.5) * 2 * WINDOW_COLLECTOR_SUB_BUCKETS);
+  // The exponents of the doubles are above -1100
+  return 1 + (exponent + 1100) * WINDOW_COLLECTOR_SUB_BUCKETS + sub;
+}
+
+double
+WindowCollector::GetBucketValue (int32_t bucket)
+{
+  if (bucket == 0)
+    {
+      return 0;
+    }
+  if (bucket < 0)
+    {
+      return -GetBucketValue (-bucket);
+    }
+  int32_t exponent = (bucket - 1) / WINDOW_COLLECTOR_SUB_BUCKETS - 1100;
+  int32_t sub = (bucket - 1) % WINDOW_COLLECTOR_SUB_BUCKETS;
+  double mantissa = 0.5 + (sub + 0.5) / (2 * WINDOW_COLLECTOR_SUB_BUCKETS);
+  return std::ldexp (mantissa, exponent);
+}
+
+} // namespace ns3
@@ -0,0 +1,354 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "ns3/columnar-file-aggregator.h"
+#include "ns3/file-aggregator.h"
+#include "ns3/file-helper.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/names.h"
+#include "ns3/traced-value.h"
+#include "ns3/trace-source-accessor.h"
+
+using namespace ns3;
+
+/**
+ * \param fileName a file name.
+ * \return the contents of the file.
+ */
+static std::string
+ReadFile (const std::string &fileName)
+{
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+  std::ostringstream contents;
+  contents << file.rdbuf ();
+  return contents.str ();
+}
+
+/**
+ * Check the text files written by FileAggregator.
+ */
+class FileAggregatorTestCase : public TestCase
+{
+public:
+  FileAggregatorTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+FileAggregatorTestCase::FileAggregatorTestCase ()
+  : TestCase ("FileAggregator text files")
+{
+}
+
+void
+FileAggregatorTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("file-aggregator.txt");
+  Ptr<FileAggregator> aggregator = CreateObject<FileAggregator> (fileName, FileAggregator::COMMA_SEPARATED);
+  aggregator->SetHeading ("Time,Value");
+  aggregator->Enable ();
+  aggregator->Write2d ("a", 1, 2.5);
+  aggregator->Write2d ("a", 2, 3);
+  aggregator->Write1d ("a", 4);
+  aggregator = 0;
+
+  NS_TEST_ASSERT_MSG_EQ (ReadFile (fileName), "Time,Value\n1,2.5\n2,3\n4\n", "Wrong file contents");
+}
+
+/**
+ * Check the CSV files written by ColumnarFileAggregator.
+ */
+class ColumnarFileAggregatorCsvTestCase : public TestCase
+{
+public:
+  ColumnarFileAggregatorCsvTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+ColumnarFileAggregatorCsvTestCase::ColumnarFileAggregatorCsvTestCase ()
+  : TestCase ("ColumnarFileAggregator CSV files")
+{
+}
+
+void
+ColumnarFileAggregatorCsvTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("columnar.csv");
+  Ptr<ColumnarFileAggregator> aggregator = CreateObject<ColumnarFileAggregator> (fileName);
+  // Small blocks, to write several of them
+  aggregator->SetBlockSize (200);
+  aggregator->Enable ();
+
+  std::ostringstream expected;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      if (i < 3)
+        {
+          expected << "# probe " << i << " /probe/" << i << "\n";
+        }
+      std::ostringstream context;
+      context << "/probe/" << i % 3;
+      aggregator->Write2d (context.str (), i * 0.001, i + 0.5);
+      expected << i % 3 << "," << i * 0.001 << "," << i + 0.5 << "\n";
+    }
+  aggregator->Write1d ("/probe/1", 7);
+  expected << "1,7\n";
+  aggregator->Write3d ("/other", 1, 2, 3);
+  expected << "# probe 3 /other\n3,1,2,3\n";
+  aggregator->Write1d ("/last", 8);
+  expected << "# probe 4 /last\n4,8\n";
+  NS_TEST_EXPECT_MSG_EQ (aggregator->GetProbeId ("/probe/2"), 2, "Wrong probe id");
+  NS_TEST_EXPECT_MSG_EQ (aggregator->GetProbeId ("/unknown"), -1, "Wrong probe id");
+
+  // The file is written by blocks
+  std::string contents = ReadFile (fileName);
+  NS_TEST_EXPECT_MSG_GT (contents.size (), 0, "No block written");
+  NS_TEST_EXPECT_MSG_LT (contents.size (), expected.str ().size (), "Samples not buffered");
+  NS_TEST_EXPECT_MSG_EQ (expected.str ().compare (0, contents.size (), contents), 0, "Wrong block contents");
+
+  aggregator->Disable ();
+  aggregator->Write1d ("/last", 8);
+  aggregator = 0;
+  NS_TEST_ASSERT_MSG_EQ (ReadFile (fileName), expected.str (), "Wrong file contents");
+}
+
+/**
+ * Check the binary files written by ColumnarFileAggregator.
+ */
+class ColumnarFileAggregatorBinaryTestCase : public TestCase
+{
+public:
+  ColumnarFileAggregatorBinaryTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+ColumnarFileAggregatorBinaryTestCase::ColumnarFileAggregatorBinaryTestCase ()
+  : TestCase ("ColumnarFileAggregator binary files")
+{
+}
+
+void
+ColumnarFileAggregatorBinaryTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("columnar.bin");
+  Ptr<ColumnarFileAggregator> aggregator = CreateObject<ColumnarFileAggregator> (fileName, ColumnarFileAggregator::BINARY);
+  aggregator->SetBlockSize (100);
+  aggregator->Enable ();
+
+  const uint32_t nSamples = 1000;
+  for (uint32_t i = 0; i < nSamples; i++)
+    {
+      std::ostringstream context;
+      context << "/probe/" << i % 7;
+      aggregator->Write2d (context.str (), i * 0.1, i * 1.1);
+      if (i % 10 == 0)
+        {
+          aggregator->Write1d ("/one", i);
+        }
+    }
+  aggregator = 0;
+
+  std::string contents = ReadFile (fileName);
+  NS_TEST_ASSERT_MSG_GT (contents.size (), 8, "File too short");
+  const char *data = contents.data ();
+  uint32_t magic;
+  uint16_t major;
+  memcpy (&magic, data, 4);
+  memcpy (&major, data + 4, 2);
+  NS_TEST_ASSERT_MSG_EQ (magic, 0x6e73636c, "Wrong magic number");
+  NS_TEST_ASSERT_MSG_EQ (major, 1, "Wrong version");
+
+  // Read the probes and the blocks
+  std::map<uint32_t, std::string> probes;
+  std::vector<std::string> samples2d;
+  std::vector<double> samples1d;
+  uint32_t nBlocks = 0;
+  size_t offset = 8;
+  while (offset + 8 <= contents.size ())
+    {
+      uint32_t type, size;
+      memcpy (&type, data + offset, 4);
+      memcpy (&size, data + offset + 4, 4);
+      offset += 8;
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (offset + size, contents.size (), "Truncated record");
+      if (type == 1)
+        {
+          uint32_t id;
+          memcpy (&id, data + offset, 4);
+          NS_TEST_ASSERT_MSG_EQ (probes.count (id), 0, "Probe defined twice");
+          probes[id] = std::string (data + offset + 4, size - 4);
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (type, 2, "Unknown record type");
+          uint32_t dimension, n;
+          memcpy (&dimension, data + offset, 4);
+          memcpy (&n, data + offset + 4, 4);
+          NS_TEST_ASSERT_MSG_EQ (size, 8 + n * (4 + 8 * dimension), "Wrong block size");
+          const char *ids = data + offset + 8;
+          const char *columns = ids + 4 * n;
+          for (uint32_t i = 0; i < n; i++)
+            {
+              uint32_t id;
+              double v1;
+              memcpy (&id, ids + 4 * i, 4);
+              memcpy (&v1, columns + 8 * i, 8);
+              NS_TEST_ASSERT_MSG_EQ (probes.count (id), 1, "Probe used before its definition");
+              if (dimension == 1)
+                {
+                  NS_TEST_ASSERT_MSG_EQ (probes[id], "/one", "Wrong 1D probe");
+                  samples1d.push_back (v1);
+                }
+              else
+                {
+                  NS_TEST_ASSERT_MSG_EQ (dimension, 2, "Wrong dimension");
+                  double v2;
+                  memcpy (&v2, columns + 8 * n + 8 * i, 8);
+                  std::ostringstream sample;
+                  sample << probes[id] << " " << v1 << " " << v2;
+                  samples2d.push_back (sample.str ());
+                }
+            }
+          nBlocks++;
+        }
+      offset += size;
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset, contents.size (), "Trailing data");
+  NS_TEST_EXPECT_MSG_GT (nBlocks, 2, "Samples not written in blocks");
+  NS_TEST_ASSERT_MSG_EQ (probes.size (), 8, "Wrong number of probes");
+
+  NS_TEST_ASSERT_MSG_EQ (samples2d.size (), nSamples, "Wrong number of 2D samples");
+  for (uint32_t i = 0; i < nSamples; i++)
+    {
+      std::ostringstream sample;
+      sample << "/probe/" << i % 7 << " " << i * 0.1 << " " << i * 1.1;
+      NS_TEST_ASSERT_MSG_EQ (samples2d[i], sample.str (), "Wrong 2D sample " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (samples1d.size (), nSamples / 10, "Wrong number of 1D samples");
+  for (uint32_t i = 0; i < nSamples / 10; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (samples1d[i], i * 10, "Wrong 1D sample " << i);
+    }
+}
+
+/**
+ * An object with a traced value, probed by the FileHelper test.
+ */
+class ColumnarTestEmitter : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \param value the new value.
+   */
+  void Set (double value)
+  {
+    m_value = value;
+  }
+private:
+  TracedValue<double> m_value;  //!< The traced value
+};
+
+TypeId
+ColumnarTestEmitter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ColumnarTestEmitter")
+    .SetParent<Object> ()
+    .AddConstructor<ColumnarTestEmitter> ()
+    .AddTraceSource ("Value", "The value",
+                     MakeTraceSourceAccessor (&ColumnarTestEmitter::m_value),
+                     "ns3::TracedValue::DoubleCallback")
+  ;
+  return tid;
+}
+
+/**
+ * Check that FileHelper writes several probes to one columnar file.
+ */
+class FileHelperColumnarTestCase : public TestCase
+{
+public:
+  FileHelperColumnarTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+FileHelperColumnarTestCase::FileHelperColumnarTestCase ()
+  : TestCase ("FileHelper columnar file")
+{
+}
+
+void
+FileHelperColumnarTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("file-helper.csv");
+  Ptr<ColumnarTestEmitter> emitters[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      emitters[i] = CreateObject<ColumnarTestEmitter> ();
+      std::ostringstream name;
+      name << "ColumnarTestEmitter" << i;
+      Names::Add (name.str (), emitters[i]);
+      Simulator::Schedule (Seconds (1 + i), &ColumnarTestEmitter::Set, emitters[i], 10 + i);
+    }
+
+  {
+    FileHelper helper;
+    helper.ConfigureColumnarFile (fileName);
+    helper.WriteProbe ("ns3::DoubleProbe", "/Names/ColumnarTestEmitter0/Value", "Output");
+    helper.WriteProbe ("ns3::DoubleProbe", "/Names/ColumnarTestEmitter1/Value", "Output");
+    Simulator::Run ();
+    Simulator::Destroy ();
+  }
+
+  NS_TEST_ASSERT_MSG_EQ (ReadFile (fileName),
+                         "# probe 0 /Names/ColumnarTestEmitter0/Value/Output\n0,1,10\n"
+                         "# probe 1 /Names/ColumnarTestEmitter1/Value/Output\n1,2,11\n",
+                         "Wrong file contents");
+}
+
+/**
+ * File aggregator test suite.
+ */
+class FileAggregatorTestSuite : public TestSuite
+{
+public:
+  FileAggregatorTestSuite ();
+};
+
+FileAggregatorTestSuite::FileAggregatorTestSuite ()
+  : TestSuite ("file-aggregator", UNIT)
+{
+  AddTestCase (new FileAggregatorTestCase, TestCase::QUICK);
+  AddTestCase (new ColumnarFileAggregatorCsvTestCase, TestCase::QUICK);
+  AddTestCase (new ColumnarFileAggregatorBinaryTestCase, TestCase::QUICK);
+  AddTestCase (new FileHelperColumnarTestCase, TestCase::QUICK);
+}
+
+static FileAggregatorTestSuite g_fileAggregatorTestSuite;
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sqlite3.h>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/data-collector.h"
+#include "ns3/basic-data-calculators.h"
+#include "ns3/sqlite-data-output.h"
+#include "ns3/sqlite-aggregator.h"
+#include "ns3/time-series-adaptor.h"
+
+using namespace ns3;
+
+/**
+ * Run a query returning a single value.
+ * \param db The database file name.
+ * \param sql The query.
+ * \returns The value, as text, or an empty string on error.
+ */
+static std::string
+QueryValue (const std::string &db, const std::string &sql)
+{
+  std::string value;
+  sqlite3 *handle;
+  if (sqlite3_open (db.c_str (), &handle) == SQLITE_OK)
+    {
+      sqlite3_stmt *stmt;
+      if (sqlite3_prepare_v2 (handle, sql.c_str (), -1, &stmt, 0) == SQLITE_OK)
+        {
+          if (sqlite3_step (stmt) == SQLITE_ROW && sqlite3_column_text (stmt, 0))
+            {
+              value = reinterpret_cast<const char *> (sqlite3_column_text (stmt, 0));
+            }
+          sqlite3_finalize (stmt);
+        }
+    }
+  sqlite3_close (handle);
+  return value;
+}
+
+// ===========================================================================
+// Test case for the SqliteDataOutput
+// ===========================================================================
+
+class SqliteDataOutputTestCase : public TestCase
+{
+public:
+  SqliteDataOutputTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SqliteDataOutputTestCase::SqliteDataOutputTestCase ()
+  : TestCase ("Check the SqliteDataOutput tables")
+{
+}
+
+void
+SqliteDataOutputTestCase::DoRun (void)
+{
+  std::string prefix = CreateTempDirFilename ("data");
+  std::string db = prefix + ".db";
+  const uint32_t nRuns = 3;
+  const uint32_t nCalculators = 50;
+  for (uint32_t run = 0; run < nRuns; ++run)
+    {
+      std::ostringstream label;
+      label << "run-" << run;
+      Ptr<DataCollector> dc = CreateObject<DataCollector> ();
+      // The quotes used to break the generated SQL
+      dc->DescribeRun ("experiment", "strategy", "input", label.str (), "Joe's run");
+      dc->AddMetadata ("author", "O'Brien");
+      for (uint32_t i = 0; i < nCalculators; ++i)
+        {
+          Ptr<CounterCalculator<uint32_t> > counter = CreateObject<CounterCalculator<uint32_t> > ();
+          std::ostringstream key;
+          key << "counter-" << i;
+          counter->SetKey (key.str ());
+          counter->SetContext ("node'0");
+          counter->Update (i);
+          dc->AddDataCalculator (counter);
+        }
+      Ptr<MinMaxAvgTotalCalculator<double> > stats = CreateObject<MinMaxAvgTotalCalculator<double> > ();
+      stats->SetKey ("delay");
+      stats->SetContext ("node'0");
+      stats->Update (0.125);
+      stats->Update (1.0 / 3);
+      dc->AddDataCalculator (stats);
+
+      Ptr<SqliteDataOutput> output = CreateObject<SqliteDataOutput> ();
+      output->SetFilePrefix (prefix);
+      output->Output (*dc);
+      dc->Dispose ();
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (QueryValue (db, "PRAGMA journal_mode"), "wal", "Database not in WAL mode");
+  NS_TEST_ASSERT_MSG_EQ (QueryValue (db, "select count(*) from Experiments"), "3", "Wrong number of runs");
+  NS_TEST_ASSERT_MSG_EQ (QueryValue (db, "select description from Experiments where run='run-2'"), "Joe's run",
+                         "Wrong run description");
+  NS_TEST_ASSERT_MSG_EQ (QueryValue (db, "select value from Metadata where run='run-1' and key='author'"), "O'Brien",
+                         "Wrong metadata");
+  NS_TEST_ASSERT_MSG_EQ (QueryValue (db, "select count(*) from Singletons where run='run-0' and name='node''0'"), "56",
+                         "Wrong number of singletons");
+  NS_TEST_ASSERT_MSG_EQ (QueryValue (db, "select value from Singletons where run='run-2' and variable='counter-7'"), "7",
+                         "Wrong counter value");
+  // The doubles are stored with their full precision
+  NS_TEST_ASSERT_MSG_EQ (QueryValue (db, "select value = 1.0 / 3 from Singletons where run='run-2' and variable='delay-max'"), "1",
+                         "Wrong double value");
+}
+
+// ===========================================================================
+// Test case for the SqliteAggregator
+// ===========================================================================
+
+class SqliteAggregatorTestCase : public TestCase
+{
+public:
+  SqliteAggregatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the rows committed so far.
+   * \param expected The expected number of rows.
+   */
+  void CheckRows (std::string expected);
+
+  std::string m_db;     //!< The database file name
+};
+
+SqliteAggregatorTestCase::SqliteAggregatorTestCase ()
+  : TestCase ("Check the SqliteAggregator time series")
+{
+}
+
+void
+SqliteAggregatorTestCase::CheckRows (std::string expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (QueryValue (m_db, "select count(*) from Series"), expected,
+                         "Wrong number of rows at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+SqliteAggregatorTestCase::DoRun (void)
+{
+  m_db = CreateTempDirFilename ("series.db");
+  Ptr<SqliteAggregator> aggregator = CreateObject<SqliteAggregator> (m_db, "Series");
+  aggregator->SetCommitInterval (100);
+  Ptr<TimeSeriesAdaptor> adaptor = CreateObject<TimeSeriesAdaptor> ();
+  adaptor->TraceConnect ("Output", "adaptor", MakeCallback (&SqliteAggregator::Write2d, aggregator));
+
+  for (uint32_t i = 0; i < 250; ++i)
+    {
+      Simulator::Schedule (MilliSeconds (i), &TimeSeriesAdaptor::TraceSinkDouble, adaptor, 0.0, 2.0 * i);
+    }
+  // The rows are visible to other readers once committed
+  Simulator::Schedule (MicroSeconds (50500), &SqliteAggregatorTestCase::CheckRows, this, "0");
+  Simulator::Schedule (MicroSeconds (220500), &SqliteAggregatorTestCase::CheckRows, this, "200");
+  Simulator::Run ();
+  Simulator::Destroy ();
+  adaptor = 0;
+  aggregator = 0;
+
+  CheckRows ("250");
+  NS_TEST_ASSERT_MSG_EQ (QueryValue (m_db, "select value from Series where context='adaptor' and abs (time - 0.1) < 1e-9"), "200.0",
+                         "Wrong time series value");
+}
+
+class SqliteDataOutputTestSuite : public TestSuite
+{
+public:
+  SqliteDataOutputTestSuite ();
+};
+
+SqliteDataOutputTestSuite::SqliteDataOutputTestSuite ()
+  : TestSuite ("sqlite-data-output", UNIT)
+{
+  AddTestCase (new SqliteDataOutputTestCase, TestCase::QUICK);
+  AddTestCase (new SqliteAggregatorTestCase, TestCase::QUICK);
+}
+
+static SqliteDataOutputTestSuite sqliteDataOutputTestSuite;
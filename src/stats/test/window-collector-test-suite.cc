@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/window-collector.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+
+using namespace ns3;
+
+/**
+ * Check the records of WindowCollector.
+ */
+class WindowCollectorTestCase : public TestCase
+{
+public:
+  WindowCollectorTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Add values to the collector.
+   * \param first the first value.
+   * \param n the number of values.
+   */
+  void AddValues (uint32_t first, uint32_t n);
+  /**
+   * The Output trace sink.
+   * \param time The end of the window.
+   * \param count The number of values.
+   * \param sum The sum of the values.
+   * \param min The minimum value.
+   * \param max The maximum value.
+   * \param mean The mean of the values.
+   * \param percentile The percentile of the values.
+   */
+  void Output (double time, double count, double sum, double min,
+               double max, double mean, double percentile);
+  /**
+   * The Mean trace sink.
+   * \param time The end of the window.
+   * \param mean The mean of the values.
+   */
+  void Mean (double time, double mean);
+
+  Ptr<WindowCollector> m_collector;     //!< The collector
+  std::vector<std::vector<double> > m_records; //!< The Output records
+  std::vector<double> m_means;          //!< The Mean records
+};
+
+WindowCollectorTestCase::WindowCollectorTestCase ()
+  : TestCase ("WindowCollector records")
+{
+}
+
+void
+WindowCollectorTestCase::AddValues (uint32_t first, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      m_collector->TraceSinkUinteger32 (0, first + i);
+    }
+}
+
+void
+WindowCollectorTestCase::Output (double time, double count, double sum, double min,
+                                 double max, double mean, double percentile)
+{
+  std::vector<double> record;
+  record.push_back (time);
+  record.push_back (count);
+  record.push_back (sum);
+  record.push_back (min);
+  record.push_back (max);
+  record.push_back (mean);
+  record.push_back (percentile);
+  m_records.push_back (record);
+}
+
+void
+WindowCollectorTestCase::Mean (double time, double mean)
+{
+  m_means.push_back (mean);
+}
+
+void
+WindowCollectorTestCase::DoRun (void)
+{
+  m_collector = CreateObject<WindowCollector> ();
+  m_collector->SetAttribute ("Percentile", DoubleValue (90));
+  m_collector->TraceConnectWithoutContext ("Output", MakeCallback (&WindowCollectorTestCase::Output, this));
+  m_collector->TraceConnectWithoutContext ("Mean", MakeCallback (&WindowCollectorTestCase::Mean, this));
+
+  // 1000 values in the first window, in 10 bursts
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::Schedule (MilliSeconds (50 + 90 * i), &WindowCollectorTestCase::AddValues, this, 1 + 100 * i, 100);
+    }
+  // Nothing in the second window, then two values in the third one
+  Simulator::Schedule (Seconds (2.5), &WindowCollector::Add, m_collector, 5);
+  Simulator::Schedule (Seconds (2.6), &WindowCollector::Add, m_collector, -3);
+  // A value before the end of the simulation, flushed
+  Simulator::Schedule (Seconds (3.5), &WindowCollector::Add, m_collector, 7);
+  Simulator::Schedule (Seconds (3.6), &WindowCollector::Flush, m_collector);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_records.size (), 3, "Wrong number of windows");
+  NS_TEST_ASSERT_MSG_EQ (m_means.size (), 3, "Wrong number of means");
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_records[0][0], 1, 1e-9, "Wrong end of window");
+  NS_TEST_EXPECT_MSG_EQ (m_records[0][1], 1000, "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (m_records[0][2], 500500, "Wrong sum");
+  NS_TEST_EXPECT_MSG_EQ (m_records[0][3], 1, "Wrong minimum");
+  NS_TEST_EXPECT_MSG_EQ (m_records[0][4], 1000, "Wrong maximum");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_records[0][5], 500.5, 1e-9, "Wrong mean");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_records[0][6], 900, 900 * 0.004, "Wrong percentile");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_means[0], 500.5, 1e-9, "Wrong mean trace");
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_records[1][0], 3, 1e-9, "Wrong end of window");
+  NS_TEST_EXPECT_MSG_EQ (m_records[1][1], 2, "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (m_records[1][3], -3, "Wrong minimum");
+  NS_TEST_EXPECT_MSG_EQ (m_records[1][4], 5, "Wrong maximum");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_records[1][5], 1, 1e-9, "Wrong mean");
+  NS_TEST_EXPECT_MSG_EQ (m_records[1][6], 5, "Wrong percentile");
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_records[2][0], 3.6, 1e-9, "Wrong flush time");
+  NS_TEST_EXPECT_MSG_EQ (m_records[2][1], 1, "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (m_records[2][6], 7, "Wrong percentile");
+  m_collector = 0;
+}
+
+/**
+ * WindowCollector test suite.
+ */
+class WindowCollectorTestSuite : public TestSuite
+{
+public:
+  WindowCollectorTestSuite ();
+};
+
+WindowCollectorTestSuite::WindowCollectorTestSuite ()
+  : TestSuite ("window-collector", UNIT)
+{
+  AddTestCase (new WindowCollectorTestCase, TestCase::QUICK);
+}
+
+static WindowCollectorTestSuite g_windowCollectorTestSuite;
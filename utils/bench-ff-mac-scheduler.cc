@@ -0,0 +1,290 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/ff-mac-scheduler.h"
+#include "ns3/ff-mac-sched-sap.h"
+#include "ns3/ff-mac-csched-sap.h"
+#include "ns3/lte-ffr-algorithm.h"
+#include "ns3/lte-common.h"
+
+using namespace ns3;
+
+/*
+ * Benchmark the FF MAC schedulers of the LTE module with many UEs.
+ *
+ * Each scheduler is driven directly through its SAPs, without PHY nor
+ * simulator events: every TTI all the UEs report a wideband CQI, a DL
+ * RLC buffer and a BSR, the scheduler is triggered for the DL and the
+ * UL, and the DL transmissions of 4 TTIs before are acknowledged.
+ */
+
+#define LOG(x)   std::cout << x << std::endl
+
+/// Output field width
+int g_fwidth = 14;
+
+/**
+ * Scheduler SAP users, counting the allocations and keeping the DL
+ * ones for the HARQ feedback.
+ */
+class BenchSapUser : public FfMacSchedSapUser,
+                     public FfMacCschedSapUser
+{
+public:
+  BenchSapUser ()
+    : m_dlAllocations (0),
+      m_ulAllocations (0)
+  {
+  }
+  virtual void SchedDlConfigInd (const struct SchedDlConfigIndParameters& params)
+  {
+    m_dlAllocations += params.m_buildDataList.size ();
+    m_dlData.push_back (params.m_buildDataList);
+  }
+  virtual void SchedUlConfigInd (const struct SchedUlConfigIndParameters& params)
+  {
+    m_ulAllocations += params.m_dciList.size ();
+  }
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+
+  uint64_t m_dlAllocations;  //!< The DL allocations
+  uint64_t m_ulAllocations;  //!< The UL allocations
+  /// The DL allocations of the last TTIs, oldest first
+  std::deque<std::vector<BuildDataListElement_s> > m_dlData;
+};
+
+/**
+ * Print a result row.
+ *
+ * \param [in] name The scheduler.
+ * \param [in] ttis The number of TTIs scheduled.
+ * \param [in] user The SAP user of the scheduler.
+ * \param [in] ms The elapsed wall clock time, in ms.
+ */
+void
+Report (const std::string & name, const uint32_t ttis,
+        const BenchSapUser & user, const int64_t ms)
+{
+  LOG (std::left << std::setw (2 * g_fwidth) << name <<
+       std::right << std::setw (g_fwidth) << ms / 1000.0 <<
+       std::setw (g_fwidth) << (ms * 1000.0 / ttis) <<
+       std::setw (g_fwidth) << (double) user.m_dlAllocations / ttis <<
+       std::setw (g_fwidth) << (double) user.m_ulAllocations / ttis);
+}
+
+/**
+ * Run a scheduler.
+ *
+ * \param [in] type The TypeId name of the scheduler.
+ * \param [in] nUes The number of UEs.
+ * \param [in] ttis The number of TTIs.
+ * \param [in] bandwidth The bandwidth, in RBs.
+ */
+void
+Run (const std::string & type, uint16_t nUes, uint32_t ttis, uint8_t bandwidth)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  Ptr<FfMacScheduler> sched = factory.Create<FfMacScheduler> ();
+  factory.SetTypeId ("ns3::LteFrNoOpAlgorithm");
+  Ptr<LteFfrAlgorithm> ffr = factory.Create<LteFfrAlgorithm> ();
+  ffr->SetDlBandwidth (bandwidth);
+  ffr->SetUlBandwidth (bandwidth);
+
+  BenchSapUser user;
+  sched->SetFfMacSchedSapUser (&user);
+  sched->SetFfMacCschedSapUser (&user);
+  sched->SetLteFfrSapProvider (ffr->GetLteFfrSapProvider ());
+  ffr->SetLteFfrSapUser (sched->GetLteFfrSapUser ());
+  sched->Initialize ();
+  ffr->Initialize ();
+  FfMacSchedSapProvider *schedSap = sched->GetFfMacSchedSapProvider ();
+  FfMacCschedSapProvider *cschedSap = sched->GetFfMacCschedSapProvider ();
+
+  FfMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+  cellParams.m_ulBandwidth = bandwidth;
+  cellParams.m_dlBandwidth = bandwidth;
+  cschedSap->CschedCellConfigReq (cellParams);
+
+  // One non-GBR data bearer per UE, with RNTIs allocated as the RRC does
+  for (uint16_t rnti = 1; rnti <= nUes; rnti++)
+    {
+      FfMacCschedSapProvider::CschedUeConfigReqParameters ueParams;
+      ueParams.m_rnti = rnti;
+      ueParams.m_transmissionMode = 0;
+      ueParams.m_reconfigureFlag = false;
+      cschedSap->CschedUeConfigReq (ueParams);
+
+      FfMacCschedSapProvider::CschedLcConfigReqParameters lcParams;
+      lcParams.m_rnti = rnti;
+      lcParams.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lc;
+      lc.m_logicalChannelIdentity = 3;
+      lc.m_logicalChannelGroup = 0;
+      lc.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lc.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lc.m_qci = 9;
+      lc.m_eRabMaximulBitrateUl = 0;
+      lc.m_eRabMaximulBitrateDl = 0;
+      lc.m_eRabGuaranteedBitrateUl = 0;
+      lc.m_eRabGuaranteedBitrateDl = 0;
+      lcParams.m_logicalChannelConfigList.push_back (lc);
+      cschedSap->CschedLcConfigReq (lcParams);
+    }
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  SystemWallClockMs timer;
+  timer.Start ();
+  for (uint32_t tti = 0; tti < ttis; tti++)
+    {
+      uint32_t frame = 1 + tti / 10;
+      uint32_t subframe = 1 + tti % 10;
+      uint16_t sfnSf = ((0x3FF & frame) << 4) | (0xF & subframe);
+
+      FfMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiParams;
+      cqiParams.m_sfnSf = sfnSf;
+      FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrParams;
+      bsrParams.m_sfnSf = sfnSf;
+      for (uint16_t rnti = 1; rnti <= nUes; rnti++)
+        {
+          FfMacSchedSapProvider::SchedDlRlcBufferReqParameters rlcParams;
+          rlcParams.m_rnti = rnti;
+          rlcParams.m_logicalChannelIdentity = 3;
+          rlcParams.m_rlcTransmissionQueueSize = 2000;
+          rlcParams.m_rlcTransmissionQueueHolDelay = 10;
+          rlcParams.m_rlcRetransmissionQueueSize = 0;
+          rlcParams.m_rlcRetransmissionHolDelay = 0;
+          rlcParams.m_rlcStatusPduSize = 0;
+          schedSap->SchedDlRlcBufferReq (rlcParams);
+
+          CqiListElement_s cqi;
+          cqi.m_rnti = rnti;
+          cqi.m_ri = 1;
+          cqi.m_cqiType = CqiListElement_s::P10;
+          cqi.m_wbCqi.push_back (rng->GetInteger (1, 15));
+          cqi.m_wbPmi = 0;
+          cqiParams.m_cqiList.push_back (cqi);
+
+          MacCeListElement_s bsr;
+          bsr.m_rnti = rnti;
+          bsr.m_macCeType = MacCeListElement_s::BSR;
+          bsr.m_macCeValue.m_bufferStatus.push_back (BufferSizeLevelBsr::BufferSize2BsrId (2000));
+          bsr.m_macCeValue.m_bufferStatus.push_back (0);
+          bsr.m_macCeValue.m_bufferStatus.push_back (0);
+          bsr.m_macCeValue.m_bufferStatus.push_back (0);
+          bsrParams.m_macCeList.push_back (bsr);
+        }
+      schedSap->SchedDlCqiInfoReq (cqiParams);
+      schedSap->SchedUlMacCtrlInfoReq (bsrParams);
+
+      FfMacSchedSapProvider::SchedDlTriggerReqParameters dlParams;
+      dlParams.m_sfnSf = sfnSf;
+      if (user.m_dlData.size () == 4)
+        {
+          std::vector<BuildDataListElement_s> &data = user.m_dlData.front ();
+          for (uint32_t i = 0; i < data.size (); i++)
+            {
+              DlInfoListElement_s info;
+              info.m_rnti = data[i].m_rnti;
+              info.m_harqProcessId = data[i].m_dci.m_harqProcess;
+              for (uint32_t j = 0; j < data[i].m_dci.m_ndi.size (); j++)
+                {
+                  info.m_harqStatus.push_back (DlInfoListElement_s::ACK);
+                }
+              dlParams.m_dlInfoList.push_back (info);
+            }
+          user.m_dlData.pop_front ();
+        }
+      schedSap->SchedDlTriggerReq (dlParams);
+
+      FfMacSchedSapProvider::SchedUlTriggerReqParameters ulParams;
+      ulParams.m_sfnSf = sfnSf;
+      schedSap->SchedUlTriggerReq (ulParams);
+    }
+  int64_t ms = timer.End ();
+
+  Report (type.substr (5), ttis, user, ms);
+  sched->Dispose ();
+  ffr->Dispose ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nUes = 1000;
+  uint32_t ttis = 1000;
+  uint32_t bandwidth = 100;
+  std::string schedulers = "ns3::RrFfMacScheduler ns3::PfFfMacScheduler "
+    "ns3::FdMtFfMacScheduler ns3::TdMtFfMacScheduler ns3::TtaFfMacScheduler "
+    "ns3::FdBetFfMacScheduler ns3::TdBetFfMacScheduler "
+    "ns3::FdTbfqFfMacScheduler ns3::TdTbfqFfMacScheduler "
+    "ns3::PssFfMacScheduler ns3::CqaFfMacScheduler";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the FF MAC schedulers of the LTE module.\n"
+             "\n"
+             "Every TTI each UE reports a wideband CQI, a DL RLC buffer\n"
+             "and a BSR, then the DL and UL schedulers are triggered.");
+  cmd.AddValue ("ues",        "number of UEs (default 1000)", nUes);
+  cmd.AddValue ("ttis",       "number of TTIs (default 1000)", ttis);
+  cmd.AddValue ("bandwidth",  "bandwidth in RBs (default 100)", bandwidth);
+  cmd.AddValue ("schedulers", "space separated TypeIds of the schedulers", schedulers);
+  cmd.Parse (argc, argv);
+  const std::string me = cmd.GetName () + ": ";
+
+  LOG (me << "UEs: " << nUes << ", TTIs: " << ttis << ", RBs: " << bandwidth);
+  LOG ("");
+  LOG (std::left << std::setw (2 * g_fwidth) << "Scheduler" <<
+       std::right << std::setw (g_fwidth) << "Time (s)" <<
+       std::setw (g_fwidth) << "Per (us/TTI)" <<
+       std::setw (g_fwidth) << "DL DCI/TTI" <<
+       std::setw (g_fwidth) << "UL DCI/TTI");
+
+  std::istringstream iss (schedulers);
+  std::string type;
+  while (iss >> type)
+    {
+      Run (type, nUes, ttis, bandwidth);
+    }
+  LOG ("");
+  return 0;
+}
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/*
+ * Benchmark the int64x64_t operations behind Time arithmetic.
+ *
+ * The int64x64_t implementation is chosen at configure time, so to
+ * compare the backends configure and run this program once for each:
+ *
+ *   ./waf configure --int64x64=int128
+ *   ./waf configure --int64x64=cairo
+ *   ./waf configure --int64x64=double
+ */
+
+#define LOG(x)   std::cout << x << std::endl
+
+/// Sink for results, so the compiler can't discard the loops.
+int64_t g_sink = 0;
+
+/// Output field width
+int g_fwidth = 14;
+
+/**
+ * Time one workload and print a result row.
+ *
+ * \param [in] name The workload label.
+ * \param [in] n The number of operations performed.
+ * \param [in] ms The elapsed wall clock time, in ms.
+ */
+void
+Report (const std::string & name, const uint32_t n, const int64_t ms)
+{
+  const double s = ms / 1000.0;
+  LOG (std::left << std::setw (2 * g_fwidth) << name <<
+       std::right << std::setw (g_fwidth) << s <<
+       std::setw (g_fwidth) << (s > 0 ? n / s : 0) <<
+       std::setw (g_fwidth) << (s * 1e9 / n));
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 10000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark int64x64_t multiply and divide on Time workloads.\n"
+             "\n"
+             "Each workload is a loop over precomputed operands which\n"
+             "mimics a common use of Time arithmetic in the models.\n"
+             "To compare implementations reconfigure with\n"
+             "--int64x64={int128,cairo,double} and run again.");
+  cmd.AddValue ("n",    "number of operations per workload (default 1E7)", n);
+  cmd.Parse (argc, argv);
+  const std::string me = cmd.GetName () + ": ";
+
+  std::string impl;
+  switch (int64x64_t::implementation)
+    {
+    case (int64x64_t::int128_impl) : impl = "int128_impl"; break;
+    case (int64x64_t::cairo_impl)  : impl = "cairo_impl";  break;
+    case (int64x64_t::ld_impl)     : impl = "ld_impl";     break;
+    default :                        impl = "unknown!";
+    }
+  LOG (me << "int64x64_t::implementation: " << impl);
+  LOG (me << "operations per workload: " << n);
+
+  // Operands, cycled through by each workload
+  const uint32_t POOL = 1024;
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<double> bits (POOL);        // packet sizes, in bits
+  std::vector<double> distance (POOL);    // link lengths, in m
+  std::vector<Time> times (POOL);         // event times
+  std::vector<int64x64_t> ratios (POOL);  // fractional scale factors
+  for (uint32_t i = 0; i < POOL; ++i)
+    {
+      bits[i] = 8 * rng->GetInteger (64, 1500);
+      distance[i] = rng->GetValue (1, 5000);
+      times[i] = NanoSeconds (rng->GetInteger (0, 1000000000));
+      ratios[i] = int64x64_t (rng->GetValue (0, 1));
+    }
+  const double bitRate = 1e9;
+  const double speed = 299792458.0;
+
+  LOG ("");
+  LOG (std::left << std::setw (2 * g_fwidth) << "Workload" <<
+       std::right << std::setw (g_fwidth) << "Time (s)" <<
+       std::setw (g_fwidth) << "Rate (op/s)" <<
+       std::setw (g_fwidth) << "Per (ns/op)");
+
+  SystemWallClockMs timer;
+  int64_t sink = 0;
+
+  // DataRate::CalculateTxTime: Seconds (double)
+  timer.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      sink += Seconds (bits[i % POOL] / bitRate).GetTimeStep ();
+    }
+  Report ("CalculateTxTime", n, timer.End ());
+
+  // Propagation delay: Seconds (distance / speed)
+  timer.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      sink += Seconds (distance[i % POOL] / speed).GetTimeStep ();
+    }
+  Report ("PropagationDelay", n, timer.End ());
+
+  // Time::GetSeconds: multiply by the inverse of the unit
+  timer.Start ();
+  double seconds = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      seconds += times[i % POOL].GetSeconds ();
+    }
+  sink += (int64_t)seconds;
+  Report ("Time::GetSeconds", n, timer.End ());
+
+  // Time::To (PS): multiply by an integer factor
+  timer.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      sink += times[i % POOL].To (Time::PS).GetHigh ();
+    }
+  Report ("Time::To (PS)", n, timer.End ());
+
+  // Time scaled by a fraction, as in mobility and fading updates
+  timer.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      int64x64_t v (times[i % POOL]);
+      v *= ratios[(i + 1) % POOL];
+      sink += v.GetHigh ();
+    }
+  Report ("Time * fraction", n, timer.End ());
+
+  // Time divided by an integer count, as in averages
+  timer.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      int64x64_t v (times[i % POOL]);
+      v /= int64x64_t (1 + (i % 1000));
+      sink += v.GetHigh ();
+    }
+  Report ("Time / integer", n, timer.End ());
+
+  // Time divided by a fraction
+  timer.Start ();
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      int64x64_t v (times[i % POOL]);
+      v /= ratios[(i + 1) % POOL] + int64x64_t (1);
+      sink += v.GetHigh ();
+    }
+  Report ("Time / fraction", n, timer.End ());
+
+  g_sink = sink;
+  LOG ("");
+  return 0;
+}
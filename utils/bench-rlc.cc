@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/packet.h"
+#include "ns3/lte-rlc.h"
+#include "ns3/lte-rlc-um.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/lte-mac-sap.h"
+
+using namespace ns3;
+
+/*
+ * Benchmark the UM and AM RLC entities of the LTE module with full
+ * buffers and many bearers.
+ *
+ * Each bearer is a pair of RLC entities connected back to back through
+ * their MAC SAPs.  The transmitting entity is filled with SDUs at the
+ * start, then every TTI both entities get a transmission opportunity,
+ * so that the SDUs are segmented, sent, reassembled and, in AM, acked.
+ */
+
+#define LOG(x)   std::cout << x << std::endl
+
+/// Output field width
+int g_fwidth = 14;
+
+/**
+ * MAC SAP provider delivering the PDUs to the peer RLC entity.
+ */
+class BenchMacSapProvider : public LteMacSapProvider
+{
+public:
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+    Simulator::ScheduleNow (&BenchMacSapProvider::Deliver, this, params.pdu);
+  }
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+  }
+  /**
+   * Deliver a PDU to the peer.
+   * \param [in] p The PDU.
+   */
+  void Deliver (Ptr<Packet> p)
+  {
+    m_peer->GetLteMacSapUser ()->ReceivePdu (p);
+  }
+
+  Ptr<LteRlc> m_peer;  //!< The peer RLC entity
+};
+
+/**
+ * RLC SAP user counting the SDUs delivered.
+ */
+class BenchRlcSapUser : public LteRlcSapUser
+{
+public:
+  BenchRlcSapUser ()
+    : m_sdus (0)
+  {
+  }
+  virtual void ReceivePdcpPdu (Ptr<Packet> p)
+  {
+    m_sdus++;
+  }
+
+  uint64_t m_sdus;  //!< The SDUs delivered
+};
+
+/**
+ * A bearer, made of two RLC entities back to back.
+ */
+struct BenchBearer
+{
+  Ptr<LteRlc> m_tx;            //!< The transmitting entity
+  Ptr<LteRlc> m_rx;            //!< The receiving entity
+  BenchMacSapProvider m_txMac; //!< The MAC SAP of m_tx
+  BenchMacSapProvider m_rxMac; //!< The MAC SAP of m_rx
+  BenchRlcSapUser m_txUser;    //!< The RLC SAP user of m_tx
+  BenchRlcSapUser m_rxUser;    //!< The RLC SAP user of m_rx
+};
+
+/**
+ * Give a transmission opportunity to all the RLC entities, and schedule
+ * the next TTI.
+ *
+ * \param [in] bearers The bearers.
+ * \param [in] bytes The size of the transmission opportunities.
+ */
+void
+Tti (std::vector<BenchBearer *> *bearers, uint32_t bytes)
+{
+  for (uint32_t i = 0; i < bearers->size (); i++)
+    {
+      (*bearers)[i]->m_tx->GetLteMacSapUser ()->NotifyTxOpportunity (bytes, 0, 0);
+      (*bearers)[i]->m_rx->GetLteMacSapUser ()->NotifyTxOpportunity (bytes, 0, 0);
+    }
+  Simulator::Schedule (MilliSeconds (1), &Tti, bearers, bytes);
+}
+
+/**
+ * Run the RLC entities of a mode.
+ *
+ * \param [in] type The TypeId name of the RLC entities.
+ * \param [in] nBearers The number of bearers.
+ * \param [in] nSdus The number of SDUs queued in each bearer.
+ * \param [in] sduSize The size of the SDUs.
+ * \param [in] bytes The size of the transmission opportunities.
+ * \param [in] ttis The number of TTIs.
+ */
+void
+Run (const std::string & type, uint32_t nBearers, uint32_t nSdus,
+     uint32_t sduSize, uint32_t bytes, uint32_t ttis)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  std::vector<BenchBearer *> bearers;
+  for (uint32_t i = 0; i < nBearers; i++)
+    {
+      BenchBearer *bearer = new BenchBearer;
+      bearer->m_tx = factory.Create<LteRlc> ();
+      bearer->m_rx = factory.Create<LteRlc> ();
+      bearer->m_txMac.m_peer = bearer->m_rx;
+      bearer->m_rxMac.m_peer = bearer->m_tx;
+      bearer->m_tx->SetLteMacSapProvider (&bearer->m_txMac);
+      bearer->m_rx->SetLteMacSapProvider (&bearer->m_rxMac);
+      bearer->m_tx->SetLteRlcSapUser (&bearer->m_txUser);
+      bearer->m_rx->SetLteRlcSapUser (&bearer->m_rxUser);
+      bearer->m_tx->SetRnti (1 + i);
+      bearer->m_rx->SetRnti (1 + i);
+      bearer->m_tx->SetLcId (3);
+      bearer->m_rx->SetLcId (3);
+      bearers.push_back (bearer);
+    }
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  for (uint32_t i = 0; i < nBearers; i++)
+    {
+      for (uint32_t j = 0; j < nSdus; j++)
+        {
+          LteRlcSapProvider::TransmitPdcpPduParameters params;
+          params.pdcpPdu = Create<Packet> (sduSize);
+          params.rnti = 1 + i;
+          params.lcid = 3;
+          bearers[i]->m_tx->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+        }
+    }
+  Simulator::Schedule (MilliSeconds (1), &Tti, &bearers, bytes);
+  Simulator::Stop (MilliSeconds (1 + ttis));
+  Simulator::Run ();
+  int64_t ms = timer.End ();
+
+  uint64_t sdus = 0;
+  for (uint32_t i = 0; i < nBearers; i++)
+    {
+      sdus += bearers[i]->m_rxUser.m_sdus;
+      bearers[i]->m_tx->Dispose ();
+      bearers[i]->m_rx->Dispose ();
+      delete bearers[i];
+    }
+  Simulator::Destroy ();
+
+  LOG (std::left << std::setw (2 * g_fwidth) << type.substr (5) <<
+       std::right << std::setw (g_fwidth) << ms / 1000.0 <<
+       std::setw (g_fwidth) << (ms * 1000.0 / ttis) <<
+       std::setw (g_fwidth) << sdus);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nBearers = 50;
+  uint32_t nSdus = 2000;
+  uint32_t sduSize = 1400;
+  uint32_t bytes = 300;
+  uint32_t ttis = 2000;
+  std::string types = "ns3::LteRlcUm ns3::LteRlcAm";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the UM and AM RLC entities of the LTE module.\n"
+             "\n"
+             "Every bearer is filled with SDUs, then every TTI each RLC\n"
+             "entity gets a transmission opportunity.");
+  cmd.AddValue ("bearers", "number of bearers (default 50)", nBearers);
+  cmd.AddValue ("sdus",    "SDUs queued in each bearer (default 2000)", nSdus);
+  cmd.AddValue ("size",    "SDU size in bytes (default 1400)", sduSize);
+  cmd.AddValue ("bytes",   "transmission opportunity in bytes (default 300)", bytes);
+  cmd.AddValue ("ttis",    "number of TTIs (default 2000)", ttis);
+  cmd.AddValue ("types",   "space separated TypeIds of the RLC entities", types);
+  cmd.Parse (argc, argv);
+  const std::string me = cmd.GetName () + ": ";
+
+  // full buffer: the UM transmission buffer must hold all the SDUs
+  Config::SetDefault ("ns3::LteRlcUm::MaxTxBufferSize", UintegerValue (nSdus * sduSize));
+
+  LOG (me << "bearers: " << nBearers << ", SDUs: " << nSdus << " x " << sduSize <<
+       " bytes, TX opportunity: " << bytes << " bytes, TTIs: " << ttis);
+  LOG ("");
+  LOG (std::left << std::setw (2 * g_fwidth) << "RLC" <<
+       std::right << std::setw (g_fwidth) << "Time (s)" <<
+       std::setw (g_fwidth) << "Per (us/TTI)" <<
+       std::setw (g_fwidth) << "SDUs rx");
+
+  std::istringstream iss (types);
+  std::string type;
+  while (iss >> type)
+    {
+      Run (type, nBearers, nSdus, sduSize, bytes, ttis);
+    }
+  LOG ("");
+  return 0;
+}
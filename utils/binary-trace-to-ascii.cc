@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include <fstream>
+#include "ns3/core-module.h"
+#include "ns3/binary-trace-file.h"
+
+using namespace ns3;
+
+/*
+ * Convert a binary trace written through
+ * AsciiTraceHelper::CreateBinaryFileStream () to the ascii trace text.
+ *
+ * This program links all the enabled modules, so that the headers and
+ * trailers of the trace can be printed.
+ */
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+  std::string ops = "+-dr";
+  CommandLine cmd;
+  cmd.AddValue ("input", "The binary trace file", input);
+  cmd.AddValue ("output", "The ascii trace file (default: standard output)", output);
+  cmd.AddValue ("ops", "The trace operations to convert, among \"+-dr\"", ops);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "Usage: binary-trace-to-ascii --input=<file> [--output=<file>] [--ops=+-dr]" << std::endl;
+      return 1;
+    }
+
+  BinaryTraceReader reader;
+  if (!reader.Open (input))
+    {
+      std::cerr << "Could not read binary trace " << input << std::endl;
+      return 1;
+    }
+
+  std::ofstream file;
+  std::ostream *os = &std::cout;
+  if (!output.empty ())
+    {
+      file.open (output.c_str ());
+      if (!file.is_open ())
+        {
+          std::cerr << "Could not open " << output << std::endl;
+          return 1;
+        }
+      os = &file;
+    }
+
+  BinaryTraceReader::Record record;
+  while (reader.Read (record))
+    {
+      if (ops.find (record.op) != std::string::npos)
+        {
+          BinaryTraceReader::PrintAscii (*os, record);
+        }
+    }
+  return 0;
+}